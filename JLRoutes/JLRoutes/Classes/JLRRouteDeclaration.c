@@ -0,0 +1,63 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "JLRRouteDeclaration.h"
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#include <mach-o/getsect.h>
+#else
+/// 链接器为名字是合法标识符的段生成的起止符号；没有任何声明时为 NULL
+extern const jlr_route_declaration __start_jlr_routes[] __attribute__((weak, visibility("hidden")));
+extern const jlr_route_declaration __stop_jlr_routes[] __attribute__((weak, visibility("hidden")));
+#endif
+
+
+static size_t JLRVisitDeclarations(const jlr_route_declaration *start, size_t count, jlr_route_declaration_visitor visitor, void *context)
+{
+    size_t visited = 0;
+    for (size_t i = 0; i < count; i++) {
+        // 段中可能有对齐产生的空白
+        if (start[i].pattern == NULL) {
+            continue;
+        }
+        if (visitor) {
+            visitor(&start[i], context);
+        }
+        visited++;
+    }
+    return visited;
+}
+
+size_t jlr_route_declarations_enumerate(jlr_route_declaration_visitor visitor, void *context)
+{
+    size_t visited = 0;
+#if defined(__APPLE__)
+    uint32_t imageCount = _dyld_image_count();
+    for (uint32_t i = 0; i < imageCount; i++) {
+        unsigned long size = 0;
+#if __LP64__
+        const uint8_t *data = getsectiondata((const struct mach_header_64 *)_dyld_get_image_header(i), "__DATA", "__jlr_routes", &size);
+#else
+        const uint8_t *data = getsectiondata(_dyld_get_image_header(i), "__DATA", "__jlr_routes", &size);
+#endif
+        if (data != NULL) {
+            visited += JLRVisitDeclarations((const jlr_route_declaration *)(const void *)data, size / sizeof(jlr_route_declaration), visitor, context);
+        }
+    }
+#else
+    if (__start_jlr_routes != NULL && __stop_jlr_routes != NULL) {
+        visited += JLRVisitDeclarations(__start_jlr_routes, (size_t)(__stop_jlr_routes - __start_jlr_routes), visitor, context);
+    }
+#endif
+    return visited;
+}
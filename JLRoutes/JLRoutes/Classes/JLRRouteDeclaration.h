@@ -0,0 +1,67 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JLRRouteDeclaration_h
+#define JLRRouteDeclaration_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 链接期声明的路由
+ * JLR_ROUTE_DECLARE 把静态的路由记录放进专门的段（Mach-O 为 __DATA,__jlr_routes，ELF 为 jlr_routes），启动时不执行任何代码；
+ * JLRoutes 在第一次分发时读取所有记录并注册，见 +[JLRoutes setDeclaredRouteHandlerProvider:]
+ */
+typedef struct {
+    /// 路由所属的 scheme，NULL 表示全局路由
+    const char *scheme;
+    const char *pattern;
+    uint64_t priority;
+    /// 处理路由的目标类名，由调用方解释
+    const char *target;
+    /// 附加信息，由调用方解释，可以为 NULL
+    const char *metadata;
+} jlr_route_declaration;
+
+#if defined(__APPLE__)
+#define JLR_ROUTE_SECTION_ATTRIBUTES __attribute__((used, section("__DATA,__jlr_routes"), aligned(8)))
+#elif defined(__has_attribute) && __has_attribute(retain)
+#define JLR_ROUTE_SECTION_ATTRIBUTES __attribute__((used, retain, section("jlr_routes"), aligned(8)))
+#else
+#define JLR_ROUTE_SECTION_ATTRIBUTES __attribute__((used, section("jlr_routes"), aligned(8)))
+#endif
+
+/** 声明一个路由，在文件作用域使用
+ * @param identifier 在同一个文件内唯一的标识符
+ * 例如：JLR_ROUTE_DECLARE(reader, "YLRouterMain", "reader", 0, "YLReaderViewController", "navigationItemTitle=阅读器");
+ */
+#define JLR_ROUTE_DECLARE(identifier, scheme_, pattern_, priority_, target_, metadata_) \
+    static const jlr_route_declaration jlr_route_declaration_##identifier JLR_ROUTE_SECTION_ATTRIBUTES = { \
+        (scheme_), (pattern_), (priority_), (target_), (metadata_) \
+    }
+
+typedef void (*jlr_route_declaration_visitor)(const jlr_route_declaration *declaration, void *context);
+
+/** 按链接顺序遍历所有声明的路由
+ * Mach-O 上遍历所有已加载的镜像（主程序与动态库）；ELF 上遍历包含 JLRoutes 的模块
+ * @returns 声明的数量
+ */
+size_t jlr_route_declarations_enumerate(jlr_route_declaration_visitor visitor, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JLRRouteDeclaration_h */
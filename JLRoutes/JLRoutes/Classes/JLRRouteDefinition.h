@@ -82,6 +82,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (JLRRouteResponse *)routeResponseForRequest:(JLRRouteRequest *)request;
 
 
+/** 是否沿用默认的匹配规则，即没有重写 -routeResponseForRequest: 与 -routeVariablesForRequest:
+ * 沿用时 JLRoutes 可以用 JLRRouteFilter 与 JLRRouter 按 pattern 预先筛选
+ */
++ (BOOL)usesDefaultMatching;
+
+
 /** 匹配成功后，使用指定的参数调用路由模型对象的 handlerBlock
  * @param parameters 传递给handlerBlock的参数
  * @note 可能会被子类覆盖
@@ -121,11 +127,14 @@ NS_ASSUME_NONNULL_BEGIN
  * 例如注册路由为 YLRouterMain://mainTabBar/:name
  * 则发起        YLRouterMain://mainTabBar/user
  * 解析变量 @{"name":"user"}
+ *
+ * 变量可以带约束，如 :id<int>、:code<[a-z]{2}>、:uuid<uuid>，不满足约束时不匹配（语法见 jlr_constraint_create）
  */
 - (nullable NSDictionary <NSString *, NSString *> *)routeVariablesForRequest:(JLRRouteRequest *)request;
 
 /**
  * 当字符串长度大于 1 时，去掉字符串开头的 ':'
+ * 去掉结尾的约束 '<spec>'
  * 当字符串长度大于 1 时，去掉字符串结尾的 '#'
  */
 - (NSString *)routeVariableNameForValue:(NSString *)value;
@@ -13,9 +13,16 @@
 #import "JLRRouteDefinition.h"
 #import "JLRoutes.h"
 #import "JLRParsingUtilities.h"
+#import "JLRRouter.h"
 
 
 @interface JLRRouteDefinition ()
+{
+    /// 与 patternPathComponents 一一对应的变量约束，没有约束的路径组件为 NULL；整个路由没有约束时为 NULL
+    jlr_constraint **_constraints;
+    /// 有约束未能编译（语法错误或内存不足），此时路由不匹配任何请求，与 jlr_route_add 拒绝该路由一致
+    BOOL _hasInvalidConstraint;
+}
 
 @property (nonatomic, copy) NSString *pattern;
 @property (nonatomic, copy) NSString *scheme;
@@ -42,10 +49,44 @@
         }
         
         self.patternPathComponents = [pattern componentsSeparatedByString:@"/"];
+        [self compileConstraints];
     }
     return self;
 }
 
+- (void)dealloc{
+    if (_constraints) {
+        for (NSUInteger i = 0; i < self.patternPathComponents.count; i++) {
+            jlr_constraint_destroy(_constraints[i]);
+        }
+        free(_constraints);
+    }
+}
+
+/// 注册时编译 :name<spec> 中的约束，匹配时不再解析
+- (void)compileConstraints{
+    NSUInteger count = self.patternPathComponents.count;
+    for (NSUInteger i = 0; i < count; i++) {
+        const char *component = [self.patternPathComponents[i] UTF8String];
+        jlr_span name, constraint;
+        if (component == NULL || !jlr_pattern_variable_parse(component, strlen(component), &name, &constraint) || constraint.length == 0) {
+            continue;
+        }
+        if (_constraints == NULL) {
+            _constraints = calloc(count, sizeof(jlr_constraint *));
+            if (_constraints == NULL) {
+                _hasInvalidConstraint = YES;
+                return;
+            }
+        }
+        _constraints[i] = jlr_constraint_create(component + constraint.offset, constraint.length);
+        if (_constraints[i] == NULL) {
+            NSLog(@"[JLRoutes]: Invalid constraint in route pattern: %@", self.pattern);
+            _hasInvalidConstraint = YES;
+        }
+    }
+}
+
 - (NSString *)description{
     return [NSString stringWithFormat:@"<%@ %p %@> - %@ (priority: %@) \n patternPathComponents : %@", NSStringFromClass([self class]), self ,self.scheme, self.pattern, @(self.priority),self.patternPathComponents];
 }
@@ -120,6 +161,14 @@
     }
 }
 
++ (BOOL)usesDefaultMatching{
+    if (self == [JLRRouteDefinition class]) {
+        return YES;
+    }
+    return [self instanceMethodForSelector:@selector(routeResponseForRequest:)] == [JLRRouteDefinition instanceMethodForSelector:@selector(routeResponseForRequest:)] &&
+           [self instanceMethodForSelector:@selector(routeVariablesForRequest:)] == [JLRRouteDefinition instanceMethodForSelector:@selector(routeVariablesForRequest:)];
+}
+
 - (BOOL)callHandlerBlockWithParameters:(NSDictionary *)parameters{
     if (self.handlerBlock == nil) {
         return YES;
@@ -144,6 +193,9 @@
  *       所以，注册路由时的 URL 一定不能包含参数，否则永远不可能匹配到有效响应
  */
 - (NSDictionary <NSString *, NSString *> *)routeVariablesForRequest:(JLRRouteRequest *)request{
+    if (_hasInvalidConstraint) {
+        return nil;
+    }
     NSMutableDictionary *routeVariables = [NSMutableDictionary dictionary];
     BOOL isMatch = YES;
     NSUInteger index = 0;
@@ -163,6 +215,15 @@
             // : 开头的路径是一个变量, 将该变量设置到参数 params 中
             NSAssert(URLComponent != nil, @"URLComponent cannot be nil");
             
+            /// 变量带约束 :name<spec> 时，未解码的 URLComponent 须满足约束
+            if (_constraints != NULL && _constraints[index] != NULL) {
+                const char *value = URLComponent.UTF8String;
+                if (value == NULL || !jlr_constraint_match(_constraints[index], value, strlen(value))) {
+                    isMatch = NO;
+                    break;
+                }
+            }
+            
             ///当字符串长度大于 1 时，去掉字符串开头的 ':' 与 字符串结尾的 '#'
             NSString *variableName = [self routeVariableNameForValue:patternComponent];
             ///对 URLComponent 解码，去掉字符串结尾的 '#'
@@ -200,6 +261,7 @@
 
 /**
  * 当字符串长度大于 1 时，去掉字符串开头的 ':'
+ * 去掉结尾的约束 '<spec>'
  * 当字符串长度大于 1 时，去掉字符串结尾的 '#'
  */
 - (NSString *)routeVariableNameForValue:(NSString *)value{
@@ -209,6 +271,14 @@
         name = [name substringFromIndex:1];
     }
     
+    /// 去掉结尾的约束 '<spec>'
+    if (value.length > 2 && [name hasSuffix:@">"]) {
+        NSUInteger location = [name rangeOfString:@"<"].location;
+        if (location != NSNotFound) {
+            name = [name substringToIndex:location];
+        }
+    }
+    
     /// 去掉字符串结尾的 '#'
     if (name.length > 1 && [name characterAtIndex:name.length - 1] == '#') {
         name = [name substringToIndex:name.length - 1];
@@ -0,0 +1,50 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "JLRRouteRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class JLRRouteDefinition;
+
+
+/** 路由表的概率签名：以路径组件数量与第一个路径组件为键的计数布隆过滤器
+ * 注册、移除路由时同步更新；URL 的键不在过滤器中时，一定没有路由能匹配，无需创建 JLRRouteRequest
+ * 第一个路径组件是变量（:name）的路由只以路径组件数量为键；
+ * 含通配符或重写了匹配方法的路由无法用键描述，路由表中有这类路由时总是返回 YES
+ */
+@interface JLRRouteFilter : NSObject
+
+/// 已加入的路由数量
+@property (nonatomic, assign, readonly) NSUInteger routeCount;
+
+/// 计数器数量，随路由数量成倍增长，保持每个路由至少 16 个计数器
+@property (nonatomic, assign, readonly) NSUInteger bucketCount;
+
+- (void)addRoute:(JLRRouteDefinition *)route;
+
+/// route 须是之前加入过的路由（或与之相等的路由）；按键在散列表中查找，期望 O(1)
+- (void)removeRoute:(JLRRouteDefinition *)route;
+
+- (void)removeAllRoutes;
+
+/** URL 是否可能匹配某个路由
+ * 按 JLRRouteRequest 的规则计算 URL 的路径组件；URL 含 fragment、端口、用户信息等不常见的部分时直接返回 YES
+ * @returns 返回 NO 时一定没有路由能匹配；返回 YES 时仍需逐个匹配
+ */
+- (BOOL)mayMatchURL:(NSURL *)URL options:(JLRRouteRequestOptions)options;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
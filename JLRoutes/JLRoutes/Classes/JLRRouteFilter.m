@@ -0,0 +1,448 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "JLRRouteFilter.h"
+#import "JLRRouteDefinition.h"
+
+
+/// 每个键对应的计数器个数
+static const NSUInteger JLRRouteFilterHashCount = 3;
+/// 每个路由至少对应的计数器数量；k = 3 时误判率在 0.07%～0.5% 之间
+static const NSUInteger JLRRouteFilterBucketsPerRoute = 16;
+static const NSUInteger JLRRouteFilterMinimumBucketCount = 64;
+/// URL 超过该长度时不做预筛
+#define JLRRouteFilterMaxURLLength 1024
+
+
+@interface JLRRouteFilter ()
+{
+    uint8_t *_counters;
+    /// 可以用键描述的路由的键与对应的路由数量，扩容时据此重建计数器
+    /// 开放寻址（线性探测），容量为 2 的幂，路由数量为 0 的位置为空
+    uint64_t *_keys;
+    NSUInteger *_keyRouteCounts;
+    NSUInteger _keySlotCount;
+    NSUInteger _distinctKeyCount;
+    /// 可以用键描述的路由数量
+    NSUInteger _keyCount;
+    /// 含通配符或重写了匹配方法的路由数量
+    NSUInteger _unfilteredCount;
+}
+
+@property (nonatomic, assign) NSUInteger bucketCount;
+
+@end
+
+
+#pragma mark - 键
+
+/// 对路径组件数量与第一个路径组件做 FNV-1a 哈希；isVariable 表示第一个路径组件是变量，不参与哈希
+static uint64_t JLRRouteFilterHash(NSUInteger componentCount, const unichar *chars, NSUInteger length, BOOL isVariable)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = (hash ^ componentCount) * 1099511628211ULL;
+    hash = (hash ^ (isVariable ? 1 : 2)) * 1099511628211ULL;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash = (hash ^ chars[i]) * 1099511628211ULL;
+    }
+    // 混合高低位，下面拆成两个 32 位哈希使用
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static uint64_t JLRRouteFilterHashString(NSUInteger componentCount, NSString *string)
+{
+    NSUInteger length = string.length;
+    unichar buffer[128];
+    unichar *chars = length <= 128 ? buffer : malloc(length * sizeof(unichar));
+    [string getCharacters:chars range:NSMakeRange(0, length)];
+    uint64_t hash = JLRRouteFilterHash(componentCount, chars, length, NO);
+    if (chars != buffer) {
+        free(chars);
+    }
+    return hash;
+}
+
+/// 路由的键；含通配符或重写了匹配方法时返回 NO
+static BOOL JLRRouteFilterKeyForRoute(JLRRouteDefinition *route, uint64_t *key)
+{
+    NSArray <NSString *> *components = route.patternPathComponents;
+    if (![[route class] usesDefaultMatching] || [components containsObject:@"*"]) {
+        return NO;
+    }
+    NSString *firstComponent = components.firstObject ?: @"";
+    if ([firstComponent hasPrefix:@":"]) {
+        *key = JLRRouteFilterHash(components.count, NULL, 0, YES);
+    } else {
+        *key = JLRRouteFilterHashString(components.count, firstComponent);
+    }
+    return YES;
+}
+
+static BOOL JLRIsSchemeCharacter(unichar c, BOOL isFirst)
+{
+    BOOL isAlpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    if (isFirst) {
+        return isAlpha;
+    }
+    return isAlpha || (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.';
+}
+
+/** 按 JLRRouteRequest 的规则计算 URL 的键，不创建 NSURLComponents
+ * @param key 第一个路径组件为字面量时的键
+ * @param variableKey 第一个路径组件为变量时的键
+ * @returns URL 含 fragment、端口、用户信息、百分号编码的 host 等情况时返回 NO
+ */
+static BOOL JLRRouteFilterKeysForURL(NSURL *URL, BOOL treatsHostAsPathComponent, uint64_t *key, uint64_t *variableKey)
+{
+    NSString *string = [URL absoluteString];
+    NSUInteger length = string.length;
+    if (length > JLRRouteFilterMaxURLLength) {
+        return NO;
+    }
+    unichar chars[JLRRouteFilterMaxURLLength];
+    [string getCharacters:chars range:NSMakeRange(0, length)];
+    
+    // fragment 可能拼接到路径中，不做预筛
+    NSUInteger end = length;
+    for (NSUInteger i = 0; i < length; i++) {
+        if (chars[i] == '#') {
+            return NO;
+        }
+        if (chars[i] == '?' && end == length) {
+            end = i;
+        }
+    }
+    
+    // scheme
+    NSUInteger position = 0;
+    for (NSUInteger i = 0; i < end && chars[i] != '/'; i++) {
+        if (chars[i] == ':') {
+            if (i == 0) {
+                return NO;
+            }
+            position = i + 1;
+            break;
+        }
+        if (!JLRIsSchemeCharacter(chars[i], i == 0)) {
+            break;
+        }
+    }
+    if (position == 0) {
+        // 没有 scheme 时，冒号只能出现在第一个 / 之后
+        for (NSUInteger i = 0; i < end && chars[i] != '/'; i++) {
+            if (chars[i] == ':') {
+                return NO;
+            }
+        }
+    }
+    
+    // host
+    NSUInteger hostStart = position, hostEnd = position;
+    if (position + 1 < end && chars[position] == '/' && chars[position + 1] == '/') {
+        hostStart = hostEnd = position + 2;
+        while (hostEnd < end && chars[hostEnd] != '/') {
+            unichar c = chars[hostEnd];
+            if (c == '@' || c == ':' || c == '[' || c == ']' || c == '%') {
+                return NO;
+            }
+            hostEnd++;
+        }
+    }
+    NSUInteger hostLength = hostEnd - hostStart;
+    BOOL hostContainsDot = NO;
+    for (NSUInteger i = hostStart; i < hostEnd; i++) {
+        hostContainsDot = hostContainsDot || chars[i] == '.';
+    }
+    static const unichar localhost[] = {'l', 'o', 'c', 'a', 'l', 'h', 'o', 's', 't'};
+    BOOL isLocalhost = hostLength == 9 && memcmp(chars + hostStart, localhost, sizeof(localhost)) == 0;
+    BOOL hostIsPathComponent = hostLength > 0 && (treatsHostAsPathComponent || (!isLocalhost && !hostContainsDot));
+    
+    // path：去掉开头与结尾的一个斜杠
+    NSUInteger pathStart = hostEnd, pathEnd = end;
+    if (hostIsPathComponent) {
+        // host 通过 stringByAppendingPathComponent: 拼接到 path，会规范化多余的斜杠与 . 组件
+        for (NSUInteger i = pathStart; i < pathEnd; i++) {
+            if (chars[i] == '/' && i + 1 < pathEnd && (chars[i + 1] == '/' || chars[i + 1] == '.')) {
+                return NO;
+            }
+        }
+    }
+    if (pathStart < pathEnd && chars[pathStart] == '/') {
+        pathStart++;
+    }
+    if (pathStart < pathEnd && chars[pathEnd - 1] == '/') {
+        pathEnd--;
+    }
+    NSUInteger slashCount = 0;
+    NSUInteger firstSlash = pathEnd;
+    for (NSUInteger i = pathStart; i < pathEnd; i++) {
+        if (chars[i] == '/') {
+            slashCount++;
+            firstSlash = MIN(firstSlash, i);
+        }
+    }
+    
+    NSUInteger componentCount;
+    if (hostIsPathComponent) {
+        componentCount = 1 + (pathEnd > pathStart ? slashCount + 1 : 0);
+        *key = JLRRouteFilterHash(componentCount, chars + hostStart, hostLength, NO);
+    } else {
+        componentCount = slashCount + 1;
+        *key = JLRRouteFilterHash(componentCount, chars + pathStart, firstSlash - pathStart, NO);
+    }
+    *variableKey = JLRRouteFilterHash(componentCount, NULL, 0, YES);
+    return YES;
+}
+
+
+#pragma mark -
+
+@implementation JLRRouteFilter
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        _bucketCount = JLRRouteFilterMinimumBucketCount;
+        _counters = calloc(_bucketCount, sizeof(uint8_t));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_counters);
+    free(_keys);
+    free(_keyRouteCounts);
+}
+
+- (NSUInteger)routeCount
+{
+    return _keyCount + _unfilteredCount;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p> - routes: %@, buckets: %@, unfiltered: %@", NSStringFromClass([self class]), self, @(self.routeCount), @(self.bucketCount), @(_unfilteredCount)];
+}
+
+#pragma mark - 计数器
+
+static inline NSUInteger JLRRouteFilterBucket(uint64_t key, NSUInteger index, NSUInteger bucketCount)
+{
+    uint32_t low = (uint32_t)key;
+    uint32_t high = (uint32_t)(key >> 32) | 1;
+    return (NSUInteger)(low + index * high) & (bucketCount - 1);
+}
+
+/// 计数器达到 UINT8_MAX 后不再增减，只会多返回 YES
+- (void)insertKey:(uint64_t)key
+{
+    for (NSUInteger i = 0; i < JLRRouteFilterHashCount; i++) {
+        uint8_t *counter = &_counters[JLRRouteFilterBucket(key, i, _bucketCount)];
+        if (*counter < UINT8_MAX) {
+            (*counter)++;
+        }
+    }
+}
+
+- (void)deleteKey:(uint64_t)key
+{
+    for (NSUInteger i = 0; i < JLRRouteFilterHashCount; i++) {
+        uint8_t *counter = &_counters[JLRRouteFilterBucket(key, i, _bucketCount)];
+        if (*counter > 0 && *counter < UINT8_MAX) {
+            (*counter)--;
+        }
+    }
+}
+
+- (BOOL)containsKey:(uint64_t)key
+{
+    for (NSUInteger i = 0; i < JLRRouteFilterHashCount; i++) {
+        if (_counters[JLRRouteFilterBucket(key, i, _bucketCount)] == 0) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/// 以新的计数器数量重建；内存不足时保持原样并返回 NO
+- (BOOL)rebuildWithBucketCount:(NSUInteger)bucketCount
+{
+    uint8_t *counters = calloc(bucketCount, sizeof(uint8_t));
+    if (counters == NULL) {
+        return NO;
+    }
+    free(_counters);
+    _counters = counters;
+    _bucketCount = bucketCount;
+    for (NSUInteger i = 0; i < _keySlotCount; i++) {
+        // 超过 UINT8_MAX 次的插入不再改变计数器
+        for (NSUInteger j = 0; j < MIN(_keyRouteCounts[i], UINT8_MAX); j++) {
+            [self insertKey:_keys[i]];
+        }
+    }
+    return YES;
+}
+
+#pragma mark - 键表
+
+static inline NSUInteger JLRRouteFilterKeySlot(uint64_t key, NSUInteger slotCount)
+{
+    return (NSUInteger)(key ^ (key >> 29)) & (slotCount - 1);
+}
+
+/// 键所在的位置，不存在时为探测到的空位
+- (NSUInteger)slotForKey:(uint64_t)key
+{
+    NSUInteger mask = _keySlotCount - 1;
+    NSUInteger slot = JLRRouteFilterKeySlot(key, _keySlotCount);
+    while (_keyRouteCounts[slot] > 0 && _keys[slot] != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/// 保证还能再放入一个键，装载率不超过 1/2；内存不足时返回 NO
+- (BOOL)reserveKeySlot
+{
+    if ((_distinctKeyCount + 1) * 2 <= _keySlotCount) {
+        return YES;
+    }
+    NSUInteger slotCount = MAX(_keySlotCount * 2, 32);
+    uint64_t *keys = calloc(slotCount, sizeof(uint64_t));
+    NSUInteger *routeCounts = calloc(slotCount, sizeof(NSUInteger));
+    if (keys == NULL || routeCounts == NULL) {
+        free(keys);
+        free(routeCounts);
+        return NO;
+    }
+    for (NSUInteger i = 0; i < _keySlotCount; i++) {
+        if (_keyRouteCounts[i] > 0) {
+            NSUInteger slot = JLRRouteFilterKeySlot(_keys[i], slotCount);
+            while (routeCounts[slot] > 0) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            keys[slot] = _keys[i];
+            routeCounts[slot] = _keyRouteCounts[i];
+        }
+    }
+    free(_keys);
+    free(_keyRouteCounts);
+    _keys = keys;
+    _keyRouteCounts = routeCounts;
+    _keySlotCount = slotCount;
+    return YES;
+}
+
+/// 清空一个位置，把后面探测链上的键前移，不留墓碑
+- (void)clearKeySlot:(NSUInteger)slot
+{
+    NSUInteger mask = _keySlotCount - 1;
+    NSUInteger next = slot;
+    while (YES) {
+        next = (next + 1) & mask;
+        if (_keyRouteCounts[next] == 0) {
+            break;
+        }
+        NSUInteger home = JLRRouteFilterKeySlot(_keys[next], _keySlotCount);
+        BOOL stays = (slot <= next) ? (slot < home && home <= next) : (slot < home || home <= next);
+        if (!stays) {
+            _keys[slot] = _keys[next];
+            _keyRouteCounts[slot] = _keyRouteCounts[next];
+            slot = next;
+        }
+    }
+    _keyRouteCounts[slot] = 0;
+}
+
+#pragma mark - 路由
+
+- (void)addRoute:(JLRRouteDefinition *)route
+{
+    uint64_t key = 0;
+    if (!JLRRouteFilterKeyForRoute(route, &key)) {
+        _unfilteredCount++;
+        return;
+    }
+    if (![self reserveKeySlot]) {
+        // 无法记录时视为无法过滤，保证不会误拒
+        _unfilteredCount++;
+        return;
+    }
+    NSUInteger slot = [self slotForKey:key];
+    if (_keyRouteCounts[slot] == 0) {
+        _keys[slot] = key;
+        _distinctKeyCount++;
+    }
+    _keyRouteCounts[slot]++;
+    _keyCount++;
+    if (_keyCount * JLRRouteFilterBucketsPerRoute <= _bucketCount || ![self rebuildWithBucketCount:_bucketCount * 2]) {
+        [self insertKey:key];
+    }
+}
+
+- (void)removeRoute:(JLRRouteDefinition *)route
+{
+    uint64_t key = 0;
+    if (!JLRRouteFilterKeyForRoute(route, &key)) {
+        if (_unfilteredCount > 0) {
+            _unfilteredCount--;
+        }
+        return;
+    }
+    NSUInteger slot = _keySlotCount > 0 ? [self slotForKey:key] : NSNotFound;
+    if (slot != NSNotFound && _keyRouteCounts[slot] > 0) {
+        if (--_keyRouteCounts[slot] == 0) {
+            _distinctKeyCount--;
+            [self clearKeySlot:slot];
+        }
+        _keyCount--;
+        [self deleteKey:key];
+        return;
+    }
+    // 加入时内存不足，按无法过滤的路由计数
+    if (_unfilteredCount > 0) {
+        _unfilteredCount--;
+    }
+}
+
+- (void)removeAllRoutes
+{
+    _keyCount = 0;
+    _distinctKeyCount = 0;
+    _unfilteredCount = 0;
+    if (_keyRouteCounts != NULL) {
+        memset(_keyRouteCounts, 0, _keySlotCount * sizeof(NSUInteger));
+    }
+    memset(_counters, 0, _bucketCount * sizeof(uint8_t));
+}
+
+- (BOOL)mayMatchURL:(NSURL *)URL options:(JLRRouteRequestOptions)options
+{
+    if (_unfilteredCount > 0) {
+        return YES;
+    }
+    if (_keyCount == 0) {
+        return NO;
+    }
+    BOOL treatsHostAsPathComponent = ((options & JLRRouteRequestOptionTreatHostAsPathComponent) == JLRRouteRequestOptionTreatHostAsPathComponent);
+    uint64_t key = 0, variableKey = 0;
+    if (!JLRRouteFilterKeysForURL(URL, treatsHostAsPathComponent, &key, &variableKey)) {
+        return YES;
+    }
+    return [self containsKey:key] || [self containsKey:variableKey];
+}
+
+@end
@@ -75,6 +75,17 @@ NS_ASSUME_NONNULL_BEGIN
 // 讨论：JLRoutes不会保留或拥有此创建的对象。预计通过完成的回调传递的创建对象将被调用应用程序使用并拥有。
 + (BOOL (^__nonnull)(NSDictionary<NSString *, id> *parameters))handlerBlockForTargetClass:(Class)targetClass completion:(BOOL (^)(id <JLRRouteHandlerTarget> createdObject))completionHandler;
 
+
+/** 每个可复用的目标类最多缓存的实例数量，默认为 4；设为 0 时不再缓存，并清空已缓存的实例
+ * @see JLRReusableRouteHandlerTarget
+ */
++ (void)setMaximumReusableTargetCount:(NSUInteger)maximumReusableTargetCount;
+
++ (NSUInteger)maximumReusableTargetCount;
+
+/// 清空所有已缓存的可复用目标，如收到内存警告时
++ (void)removeAllReusableTargets;
+
 @end
 
 
@@ -97,4 +108,21 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 
+/** 可复用的路由处理目标，适用于频繁路由且不保存状态的目标（如埋点、切换 Tab）
+ * handlerBlockForTargetClass:completion: 为这类目标维护一个小的对象池：
+ * 池中有实例时取出并调用 prepareForReuseWithRouteParameters:，没有时才调用 initWithRouteParameters: 创建；
+ * completionHandler 返回后实例放回池中，所以 completionHandler 不能在返回后继续持有该实例
+ */
+@protocol JLRReusableRouteHandlerTarget <JLRRouteHandlerTarget>
+
+@required
+
+/** 复用前调用，重置上一次路由留下的状态，并以本次的参数重新配置
+ * @param parameters 与 initWithRouteParameters: 的参数相同
+ */
+- (void)prepareForReuseWithRouteParameters:(NSDictionary <NSString *, id> *)parameters;
+
+@end
+
+
 NS_ASSUME_NONNULL_END
@@ -13,8 +13,21 @@
 #import "JLRRouteHandler.h"
 
 
+static NSUInteger JLRGlobal_maximumReusableTargetCount = 4;
+
+/// 目标类 -> 空闲实例；访问时对其加锁
+static NSMutableDictionary <NSString *, NSMutableArray *> *JLRGlobal_reusableTargets = nil;
+
+
 @implementation JLRRouteHandler
 
++ (void)initialize
+{
+    if (self == [JLRRouteHandler class]) {
+        JLRGlobal_reusableTargets = [NSMutableDictionary dictionary];
+    }
+}
+
 + (BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlockForWeakTarget:(__weak id <JLRRouteHandlerTarget>)weakTarget
 {
     NSParameterAssert([weakTarget respondsToSelector:@selector(handleRouteWithParameters:)]);
@@ -30,10 +43,83 @@
     NSParameterAssert([targetClass instancesRespondToSelector:@selector(initWithRouteParameters:)]);
     NSParameterAssert(completionHandler != nil); // we want to force external ownership of the newly created object by handing it back.
     
+    if ([targetClass conformsToProtocol:@protocol(JLRReusableRouteHandlerTarget)]) {
+        return ^BOOL(NSDictionary<NSString *, id> *parameters) {
+            id <JLRReusableRouteHandlerTarget> reusedObject = [self dequeueReusableTargetOfClass:targetClass];
+            if (reusedObject == nil) {
+                reusedObject = [[targetClass alloc] initWithRouteParameters:parameters];
+            } else {
+                [reusedObject prepareForReuseWithRouteParameters:parameters];
+            }
+            BOOL didHandle = completionHandler(reusedObject);
+            [self enqueueReusableTarget:reusedObject ofClass:targetClass];
+            return didHandle;
+        };
+    }
+    
     return ^BOOL(NSDictionary<NSString *, id> *parameters) {
         id <JLRRouteHandlerTarget> createdObject = [[targetClass alloc] initWithRouteParameters:parameters];
         return completionHandler(createdObject);
     };
 }
 
+#pragma mark - 可复用的目标
+
+/// 取出一个空闲实例；同一个实例同时只会交给一次路由，嵌套路由同一个类时会创建新实例
++ (nullable id <JLRReusableRouteHandlerTarget>)dequeueReusableTargetOfClass:(Class)targetClass
+{
+    @synchronized (JLRGlobal_reusableTargets) {
+        NSMutableArray *targets = JLRGlobal_reusableTargets[NSStringFromClass(targetClass)];
+        id <JLRReusableRouteHandlerTarget> target = [targets lastObject];
+        [targets removeLastObject];
+        return target;
+    }
+}
+
+/// 放回池中；池已满时丢弃
++ (void)enqueueReusableTarget:(nullable id <JLRReusableRouteHandlerTarget>)target ofClass:(Class)targetClass
+{
+    if (target == nil) {
+        return;
+    }
+    NSString *key = NSStringFromClass(targetClass);
+    @synchronized (JLRGlobal_reusableTargets) {
+        NSMutableArray *targets = JLRGlobal_reusableTargets[key];
+        if (targets.count >= JLRGlobal_maximumReusableTargetCount) {
+            return;
+        }
+        if (targets == nil) {
+            targets = [NSMutableArray arrayWithCapacity:JLRGlobal_maximumReusableTargetCount];
+            JLRGlobal_reusableTargets[key] = targets;
+        }
+        [targets addObject:target];
+    }
+}
+
++ (void)setMaximumReusableTargetCount:(NSUInteger)maximumReusableTargetCount
+{
+    @synchronized (JLRGlobal_reusableTargets) {
+        JLRGlobal_maximumReusableTargetCount = maximumReusableTargetCount;
+        for (NSMutableArray *targets in [JLRGlobal_reusableTargets allValues]) {
+            if (targets.count > maximumReusableTargetCount) {
+                [targets removeObjectsInRange:NSMakeRange(maximumReusableTargetCount, targets.count - maximumReusableTargetCount)];
+            }
+        }
+    }
+}
+
++ (NSUInteger)maximumReusableTargetCount
+{
+    @synchronized (JLRGlobal_reusableTargets) {
+        return JLRGlobal_maximumReusableTargetCount;
+    }
+}
+
++ (void)removeAllReusableTargets
+{
+    @synchronized (JLRGlobal_reusableTargets) {
+        [JLRGlobal_reusableTargets removeAllObjects];
+    }
+}
+
 @end
@@ -0,0 +1,820 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "JLRRouter.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef enum {
+    JLRSegmentLiteral,
+    JLRSegmentVariable,
+    JLRSegmentWildcard,
+} JLRSegmentType;
+
+/// 路由模式中的一个路径组件；offset 相对 pattern
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    /// 变量名（去掉 :、约束与结尾的 #）
+    uint32_t name_offset;
+    uint32_t name_length;
+    JLRSegmentType type;
+    /// 变量的约束，没有时为 NULL
+    jlr_constraint *constraint;
+} JLRSegment;
+
+/// 路由与其路径组件、pattern 在一次分配中
+typedef struct {
+    uint64_t route_id;
+    uint64_t priority;
+    /// 在 routes 中的位置
+    size_t slot;
+    size_t segment_count;
+    size_t variable_count;
+    bool has_wildcard;
+    const char *pattern;
+    JLRSegment segments[];
+} JLRRoute;
+
+struct jlr_router {
+    /// 按优先级排列；移除的路由留下 NULL，空位过半时整理
+    JLRRoute **routes;
+    /// routes 中已使用的位置数，含空位
+    size_t length;
+    size_t capacity;
+    /// 路由数量，不含空位
+    size_t count;
+    /// 以 route_id 为键的开放寻址散列表（线性探测），容量为 2 的幂，装载率不超过 1/2
+    JLRRoute **index;
+    size_t index_capacity;
+};
+
+
+// MARK: - 变量约束
+
+/// 约束最多展开的字符数，状态集合用一个 uint64_t 表示（第 JLRConstraintMaxUnits 位为接受状态）
+#define JLRConstraintMaxUnits 63
+
+enum {
+    /// 可以不出现
+    JLRUnitOptional = 1 << 0,
+    /// 可以重复任意次
+    JLRUnitRepeat = 1 << 1,
+};
+
+/// 一个字符位置：可接受的字节集合
+typedef struct {
+    uint8_t bitmap[32];
+    uint8_t flags;
+} JLRConstraintUnit;
+
+/** 编译后的约束：一串字符位置组成的 NFA
+ * 量词展开为多个位置，如 [a-z]{2,3} 展开为两个必须的位置与一个可选的位置，+ 展开为一个必须的位置与一个可重复的位置
+ */
+struct jlr_constraint {
+    size_t count;
+    JLRConstraintUnit units[JLRConstraintMaxUnits];
+};
+
+static const struct {
+    const char *name;
+    const char *spec;
+} JLRNamedConstraints[] = {
+    {"int", "[0-9]+"},
+    {"alpha", "[a-zA-Z]+"},
+    {"alnum", "[a-zA-Z0-9]+"},
+    {"hex", "[0-9a-fA-F]+"},
+    {"uuid", "[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}"},
+};
+
+static inline void JLRBitmapSet(uint8_t *bitmap, uint8_t c)
+{
+    bitmap[c >> 3] |= (uint8_t)(1 << (c & 7));
+}
+
+static inline bool JLRBitmapTest(const uint8_t *bitmap, uint8_t c)
+{
+    return (bitmap[c >> 3] >> (c & 7)) & 1;
+}
+
+static bool JLRIsSpecialCharacter(char c)
+{
+    return c != '\0' && strchr("[]{}()*+?|\\.<>^$/", c) != NULL;
+}
+
+/// 解析 {n}、{n,}、{n,m} 中的数字
+static bool JLRParseCount(const char *spec, size_t length, size_t *position, size_t *value)
+{
+    size_t start = *position;
+    *value = 0;
+    while (*position < length && spec[*position] >= '0' && spec[*position] <= '9') {
+        *value = *value * 10 + (size_t)(spec[*position] - '0');
+        if (*value > JLRConstraintMaxUnits) {
+            return false;
+        }
+        (*position)++;
+    }
+    return *position > start;
+}
+
+/// 解析一个字符位置：[...]、\x、. 或普通字符
+static bool JLRParseAtom(const char *spec, size_t length, size_t *position, uint8_t *bitmap)
+{
+    memset(bitmap, 0, 32);
+    char c = spec[(*position)++];
+    if (c == '.') {
+        memset(bitmap, 0xFF, 32);
+        bitmap['/' >> 3] &= (uint8_t)~(1 << ('/' & 7));
+        return true;
+    }
+    if (c == '\\') {
+        if (*position >= length) {
+            return false;
+        }
+        JLRBitmapSet(bitmap, (uint8_t)spec[(*position)++]);
+        return true;
+    }
+    if (c != '[') {
+        if (JLRIsSpecialCharacter(c)) {
+            return false;
+        }
+        JLRBitmapSet(bitmap, (uint8_t)c);
+        return true;
+    }
+    bool negated = *position < length && spec[*position] == '^';
+    if (negated) {
+        (*position)++;
+    }
+    size_t first = *position;
+    while (*position < length && (spec[*position] != ']' || *position == first)) {
+        uint8_t low = (uint8_t)spec[(*position)++];
+        if (low == '\\') {
+            if (*position >= length) {
+                return false;
+            }
+            low = (uint8_t)spec[(*position)++];
+        }
+        uint8_t high = low;
+        if (*position + 1 < length && spec[*position] == '-' && spec[*position + 1] != ']') {
+            high = (uint8_t)spec[*position + 1];
+            *position += 2;
+            if (high < low) {
+                return false;
+            }
+        }
+        for (unsigned int b = low; b <= high; b++) {
+            JLRBitmapSet(bitmap, (uint8_t)b);
+        }
+    }
+    if (*position >= length) {
+        return false;
+    }
+    (*position)++;
+    if (negated) {
+        for (size_t i = 0; i < 32; i++) {
+            bitmap[i] = (uint8_t)~bitmap[i];
+        }
+        bitmap['/' >> 3] &= (uint8_t)~(1 << ('/' & 7));
+    }
+    return true;
+}
+
+static bool JLRConstraintAppend(jlr_constraint *constraint, const uint8_t *bitmap, uint8_t flags)
+{
+    if (constraint->count >= JLRConstraintMaxUnits) {
+        return false;
+    }
+    JLRConstraintUnit *unit = &constraint->units[constraint->count++];
+    memcpy(unit->bitmap, bitmap, 32);
+    unit->flags = flags;
+    return true;
+}
+
+static bool JLRConstraintCompile(jlr_constraint *constraint, const char *spec, size_t length)
+{
+    for (size_t i = 0; i < sizeof(JLRNamedConstraints) / sizeof(JLRNamedConstraints[0]); i++) {
+        if (strlen(JLRNamedConstraints[i].name) == length && memcmp(JLRNamedConstraints[i].name, spec, length) == 0) {
+            spec = JLRNamedConstraints[i].spec;
+            length = strlen(spec);
+            break;
+        }
+    }
+    constraint->count = 0;
+    size_t position = 0;
+    while (position < length) {
+        uint8_t bitmap[32];
+        if (!JLRParseAtom(spec, length, &position, bitmap)) {
+            return false;
+        }
+        size_t minimum = 1, maximum = 1;
+        bool unbounded = false;
+        if (position < length) {
+            switch (spec[position]) {
+                case '?':
+                    minimum = 0;
+                    position++;
+                    break;
+                case '*':
+                    minimum = 0;
+                    unbounded = true;
+                    position++;
+                    break;
+                case '+':
+                    unbounded = true;
+                    position++;
+                    break;
+                case '{':
+                    position++;
+                    if (!JLRParseCount(spec, length, &position, &minimum)) {
+                        return false;
+                    }
+                    maximum = minimum;
+                    if (position < length && spec[position] == ',') {
+                        position++;
+                        unbounded = !JLRParseCount(spec, length, &position, &maximum);
+                    }
+                    if (position >= length || spec[position] != '}' || (!unbounded && maximum < minimum)) {
+                        return false;
+                    }
+                    position++;
+                    break;
+                default:
+                    break;
+            }
+        }
+        for (size_t i = 0; i < minimum; i++) {
+            if (!JLRConstraintAppend(constraint, bitmap, 0)) {
+                return false;
+            }
+        }
+        if (unbounded) {
+            if (!JLRConstraintAppend(constraint, bitmap, JLRUnitOptional | JLRUnitRepeat)) {
+                return false;
+            }
+        } else {
+            for (size_t i = minimum; i < maximum; i++) {
+                if (!JLRConstraintAppend(constraint, bitmap, JLRUnitOptional)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+jlr_constraint *jlr_constraint_create(const char *spec, size_t length)
+{
+    if (spec == NULL || length == 0) {
+        return NULL;
+    }
+    jlr_constraint *constraint = malloc(sizeof(jlr_constraint));
+    if (constraint == NULL) {
+        return NULL;
+    }
+    if (!JLRConstraintCompile(constraint, spec, length)) {
+        free(constraint);
+        return NULL;
+    }
+    return constraint;
+}
+
+void jlr_constraint_destroy(jlr_constraint *constraint)
+{
+    free(constraint);
+}
+
+/// 加入可以跳过的位置之后的状态
+static inline uint64_t JLRConstraintClosure(const jlr_constraint *constraint, uint64_t states)
+{
+    for (size_t i = 0; i < constraint->count; i++) {
+        if (((states >> i) & 1) && (constraint->units[i].flags & JLRUnitOptional)) {
+            states |= (uint64_t)1 << (i + 1);
+        }
+    }
+    return states;
+}
+
+bool jlr_constraint_match(const jlr_constraint *constraint, const char *value, size_t length)
+{
+    if (constraint == NULL) {
+        return true;
+    }
+    uint64_t states = JLRConstraintClosure(constraint, 1);
+    for (size_t position = 0; position < length && states; position++) {
+        uint8_t c = (uint8_t)value[position];
+        uint64_t next = 0;
+        for (size_t i = 0; i < constraint->count; i++) {
+            const JLRConstraintUnit *unit = &constraint->units[i];
+            if (((states >> i) & 1) && JLRBitmapTest(unit->bitmap, c)) {
+                next |= (uint64_t)1 << ((unit->flags & JLRUnitRepeat) ? i : i + 1);
+            }
+        }
+        states = JLRConstraintClosure(constraint, next);
+    }
+    return (states >> constraint->count) & 1;
+}
+
+bool jlr_pattern_variable_parse(const char *component, size_t length, jlr_span *name, jlr_span *constraint)
+{
+    if (length == 0 || component[0] != ':') {
+        return false;
+    }
+    *name = (jlr_span){0, length};
+    *constraint = (jlr_span){0, 0};
+    // 长度大于 1 时去掉开头的 :
+    if (length > 1) {
+        name->offset = 1;
+        name->length = length - 1;
+    }
+    // 结尾的 <...> 为约束
+    if (length > 2 && component[length - 1] == '>') {
+        const char *open = memchr(component + name->offset, '<', name->length);
+        if (open != NULL) {
+            size_t start = (size_t)(open - component);
+            *constraint = (jlr_span){start + 1, length - start - 2};
+            name->length = start - name->offset;
+        }
+    }
+    // 长度大于 1 时去掉结尾的 #
+    if (name->length > 1 && component[name->offset + name->length - 1] == '#') {
+        name->length--;
+    }
+    return true;
+}
+
+
+// MARK: - 路由表
+
+jlr_router *jlr_router_create(void)
+{
+    return calloc(1, sizeof(jlr_router));
+}
+
+void jlr_router_destroy(jlr_router *router)
+{
+    if (router == NULL) {
+        return;
+    }
+    jlr_router_remove_all(router);
+    free(router->routes);
+    free(router->index);
+    free(router);
+}
+
+static void JLRRouteDestroy(JLRRoute *route)
+{
+    for (size_t i = 0; i < route->segment_count; i++) {
+        jlr_constraint_destroy(route->segments[i].constraint);
+    }
+    free(route);
+}
+
+/** 与 JLRRouteDefinition 一致：去掉开头的 /，按 / 分割，不去掉结尾的 /
+ * 约束无法解析时返回 NULL
+ */
+static JLRRoute *JLRRouteCreate(const char *pattern, size_t length, uint64_t priority, uint64_t route_id)
+{
+    if (length > 0 && pattern[0] == '/') {
+        pattern++;
+        length--;
+    }
+    if (length > UINT32_MAX) {
+        return NULL;
+    }
+    size_t segment_count = 1;
+    for (size_t i = 0; i < length; i++) {
+        segment_count += pattern[i] == '/';
+    }
+    JLRRoute *route = malloc(sizeof(JLRRoute) + segment_count * sizeof(JLRSegment) + length + 1);
+    if (route == NULL) {
+        return NULL;
+    }
+    char *copy = (char *)(route->segments + segment_count);
+    memcpy(copy, pattern, length);
+    copy[length] = '\0';
+    route->route_id = route_id;
+    route->priority = priority;
+    route->slot = 0;
+    route->segment_count = segment_count;
+    route->variable_count = 0;
+    route->has_wildcard = false;
+    route->pattern = copy;
+    
+    size_t start = 0;
+    for (size_t i = 0; i < segment_count; i++) {
+        size_t end = start;
+        while (end < length && copy[end] != '/') {
+            end++;
+        }
+        JLRSegment *segment = &route->segments[i];
+        segment->offset = (uint32_t)start;
+        segment->length = (uint32_t)(end - start);
+        segment->name_offset = segment->offset;
+        segment->name_length = segment->length;
+        segment->constraint = NULL;
+        jlr_span name, constraint;
+        if (segment->length == 1 && copy[start] == '*') {
+            segment->type = JLRSegmentWildcard;
+            route->has_wildcard = true;
+        } else if (jlr_pattern_variable_parse(copy + start, end - start, &name, &constraint)) {
+            segment->type = JLRSegmentVariable;
+            segment->name_offset = (uint32_t)(start + name.offset);
+            segment->name_length = (uint32_t)name.length;
+            if (constraint.length > 0) {
+                segment->constraint = jlr_constraint_create(copy + start + constraint.offset, constraint.length);
+                if (segment->constraint == NULL) {
+                    route->segment_count = i;
+                    JLRRouteDestroy(route);
+                    return NULL;
+                }
+            }
+        } else {
+            segment->type = JLRSegmentLiteral;
+        }
+        start = end + 1;
+    }
+    // 只统计第一个 * 之前的变量，* 之后的路径组件不参与匹配
+    for (size_t i = 0; i < segment_count && route->segments[i].type != JLRSegmentWildcard; i++) {
+        route->variable_count += route->segments[i].type == JLRSegmentVariable;
+    }
+    return route;
+}
+
+// MARK: - ID 索引
+
+static inline size_t JLRIndexBucket(uint64_t route_id, size_t mask)
+{
+    route_id ^= route_id >> 33;
+    route_id *= 0xff51afd7ed558ccdULL;
+    route_id ^= route_id >> 33;
+    return (size_t)route_id & mask;
+}
+
+static void JLRIndexInsert(JLRRoute **index, size_t capacity, JLRRoute *route)
+{
+    size_t mask = capacity - 1;
+    size_t i = JLRIndexBucket(route->route_id, mask);
+    while (index[i] != NULL) {
+        i = (i + 1) & mask;
+    }
+    index[i] = route;
+}
+
+/// 保证还能再放入一个路由
+static bool JLRIndexReserve(jlr_router *router)
+{
+    if ((router->count + 1) * 2 <= router->index_capacity) {
+        return true;
+    }
+    size_t capacity = router->index_capacity ? router->index_capacity * 2 : 32;
+    JLRRoute **index = calloc(capacity, sizeof(JLRRoute *));
+    if (index == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < router->index_capacity; i++) {
+        if (router->index[i] != NULL) {
+            JLRIndexInsert(index, capacity, router->index[i]);
+        }
+    }
+    free(router->index);
+    router->index = index;
+    router->index_capacity = capacity;
+    return true;
+}
+
+/// 删除第 i 个位置，把后面探测链上的条目前移，不留墓碑
+static void JLRIndexDelete(jlr_router *router, size_t i)
+{
+    size_t mask = router->index_capacity - 1;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        JLRRoute *route = router->index[j];
+        if (route == NULL) {
+            break;
+        }
+        size_t home = JLRIndexBucket(route->route_id, mask);
+        // home 不在 (i, j] 内时，条目可以前移到 i
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            router->index[i] = route;
+            i = j;
+        }
+    }
+    router->index[i] = NULL;
+}
+
+/// 去掉 routes 中的空位，路由的相对顺序不变
+static void JLRRouterCompact(jlr_router *router)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < router->length; i++) {
+        JLRRoute *route = router->routes[i];
+        if (route != NULL) {
+            route->slot = kept;
+            router->routes[kept++] = route;
+        }
+    }
+    router->length = kept;
+}
+
+
+// MARK: - 加入与移除
+
+bool jlr_route_add(jlr_router *router, const char *pattern, size_t length, uint64_t priority, uint64_t route_id)
+{
+    if (router == NULL || (pattern == NULL && length > 0)) {
+        return false;
+    }
+    if (router->length == router->capacity && router->count < router->length) {
+        JLRRouterCompact(router);
+    }
+    if (router->length == router->capacity) {
+        size_t capacity = router->capacity ? router->capacity * 2 : 16;
+        JLRRoute **routes = realloc(router->routes, capacity * sizeof(JLRRoute *));
+        if (routes == NULL) {
+            return false;
+        }
+        router->routes = routes;
+        router->capacity = capacity;
+    }
+    if (!JLRIndexReserve(router)) {
+        return false;
+    }
+    JLRRoute *route = JLRRouteCreate(pattern ?: "", length, priority, route_id);
+    if (route == NULL) {
+        return false;
+    }
+    // 与 JLRoutes 一致：插入到第一个优先级更低的路由之前
+    size_t index = router->length;
+    if (priority > 0) {
+        for (size_t i = 0; i < router->length; i++) {
+            if (router->routes[i] != NULL && router->routes[i]->priority < priority) {
+                index = i;
+                break;
+            }
+        }
+    }
+    memmove(router->routes + index + 1, router->routes + index, (router->length - index) * sizeof(JLRRoute *));
+    router->routes[index] = route;
+    router->length++;
+    for (size_t i = index; i < router->length; i++) {
+        if (router->routes[i] != NULL) {
+            router->routes[i]->slot = i;
+        }
+    }
+    JLRIndexInsert(router->index, router->index_capacity, route);
+    router->count++;
+    return true;
+}
+
+size_t jlr_route_remove(jlr_router *router, uint64_t route_id)
+{
+    if (router == NULL || router->count == 0) {
+        return 0;
+    }
+    size_t mask = router->index_capacity - 1;
+    size_t i = JLRIndexBucket(route_id, mask);
+    size_t removed = 0;
+    while (router->index[i] != NULL) {
+        JLRRoute *route = router->index[i];
+        if (route->route_id == route_id) {
+            // 后面的条目前移到 i，不前进
+            JLRIndexDelete(router, i);
+            router->routes[route->slot] = NULL;
+            JLRRouteDestroy(route);
+            removed++;
+        } else {
+            i = (i + 1) & mask;
+        }
+    }
+    router->count -= removed;
+    if ((router->length - router->count) * 2 > router->length) {
+        JLRRouterCompact(router);
+    }
+    return removed;
+}
+
+void jlr_router_remove_all(jlr_router *router)
+{
+    if (router == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < router->length; i++) {
+        if (router->routes[i] != NULL) {
+            JLRRouteDestroy(router->routes[i]);
+        }
+    }
+    if (router->index != NULL) {
+        memset(router->index, 0, router->index_capacity * sizeof(JLRRoute *));
+    }
+    router->length = 0;
+    router->count = 0;
+}
+
+size_t jlr_router_count(const jlr_router *router)
+{
+    return router ? router->count : 0;
+}
+
+
+// MARK: - URL
+
+/// URL 拆分后的路径
+typedef struct {
+    /// 去掉开头与结尾的一个 / 之后的路径；host 视为路径组件时从 host 开始
+    size_t path_start;
+    size_t path_end;
+    size_t component_count;
+    jlr_span query;
+    jlr_span fragment;
+} JLRURLPath;
+
+static bool JLRIsSchemeCharacter(char c, bool is_first)
+{
+    bool is_alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    if (is_first) {
+        return is_alpha;
+    }
+    return is_alpha || (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.';
+}
+
+/// 按 JLRRouteRequest 的规则拆分 URL；无法保证一致时返回 false
+static bool JLRURLPathParse(const char *url, size_t length, uint32_t options, JLRURLPath *result)
+{
+    memset(result, 0, sizeof(JLRURLPath));
+    size_t end = length;
+    size_t fragment = length;
+    for (size_t i = 0; i < length; i++) {
+        if (url[i] == '#') {
+            fragment = i;
+            result->fragment = (jlr_span){i + 1, length - i - 1};
+            break;
+        }
+        if (url[i] == '?' && end == length) {
+            end = i;
+        }
+    }
+    if (end > fragment) {
+        end = fragment;
+    }
+    if (end < fragment) {
+        result->query = (jlr_span){end + 1, fragment - end - 1};
+    }
+    
+    // scheme
+    size_t position = 0;
+    for (size_t i = 0; i < end && url[i] != '/'; i++) {
+        if (url[i] == ':') {
+            if (i == 0) {
+                return false;
+            }
+            position = i + 1;
+            break;
+        }
+        if (!JLRIsSchemeCharacter(url[i], i == 0)) {
+            break;
+        }
+    }
+    if (position == 0) {
+        // 没有 scheme 时，冒号只能出现在第一个 / 之后
+        for (size_t i = 0; i < end && url[i] != '/'; i++) {
+            if (url[i] == ':') {
+                return false;
+            }
+        }
+    }
+    
+    // host
+    size_t host_start = position, host_end = position;
+    if (position + 1 < end && url[position] == '/' && url[position + 1] == '/') {
+        host_start = host_end = position + 2;
+        while (host_end < end && url[host_end] != '/') {
+            char c = url[host_end];
+            if (c == '@' || c == ':' || c == '[' || c == ']' || c == '%') {
+                return false;
+            }
+            host_end++;
+        }
+    }
+    size_t host_length = host_end - host_start;
+    bool host_contains_dot = memchr(url + host_start, '.', host_length) != NULL;
+    bool is_localhost = host_length == 9 && memcmp(url + host_start, "localhost", 9) == 0;
+    bool host_is_path = host_length > 0 && ((options & JLR_OPTION_TREAT_HOST_AS_PATH) || (!is_localhost && !host_contains_dot));
+    
+    size_t path_start = host_end, path_end = end;
+    if (host_is_path) {
+        // host 通过 stringByAppendingPathComponent: 拼接到 path，会规范化多余的斜杠与 . 组件
+        for (size_t i = path_start; i + 1 < path_end; i++) {
+            if (url[i] == '/' && (url[i + 1] == '/' || url[i + 1] == '.')) {
+                return false;
+            }
+        }
+        path_start = host_start;
+    } else if (path_start < path_end && url[path_start] == '/') {
+        path_start++;
+    }
+    if (path_start < path_end && url[path_end - 1] == '/') {
+        path_end--;
+    }
+    result->path_start = path_start;
+    result->path_end = path_end;
+    result->component_count = 1;
+    for (size_t i = path_start; i < path_end; i++) {
+        result->component_count += url[i] == '/';
+    }
+    return true;
+}
+
+
+// MARK: - 匹配
+
+static bool JLRRouteMatch(const JLRRoute *route, const char *url, const JLRURLPath *path, jlr_match *match, jlr_variable *variables, size_t capacity)
+{
+    if (!route->has_wildcard && route->segment_count != path->component_count) {
+        return false;
+    }
+    // 先比较字面量与变量约束，全部符合后再写入变量
+    size_t component_start = path->path_start;
+    for (size_t i = 0; i < route->segment_count; i++) {
+        const JLRSegment *segment = &route->segments[i];
+        if (segment->type == JLRSegmentWildcard) {
+            break;
+        }
+        if (i >= path->component_count) {
+            return false;
+        }
+        const char *component_end = memchr(url + component_start, '/', path->path_end - component_start);
+        size_t component_length = component_end ? (size_t)(component_end - url) - component_start : path->path_end - component_start;
+        if (segment->type == JLRSegmentLiteral &&
+            (segment->length != component_length || memcmp(route->pattern + segment->offset, url + component_start, component_length) != 0)) {
+            return false;
+        }
+        if (segment->constraint != NULL && !jlr_constraint_match(segment->constraint, url + component_start, component_length)) {
+            return false;
+        }
+        component_start += component_length + 1;
+    }
+    
+    match->route_id = route->route_id;
+    match->variable_count = route->variable_count;
+    match->has_wildcard = false;
+    match->wildcard = (jlr_span){0, 0};
+    size_t variable_index = 0;
+    component_start = path->path_start;
+    for (size_t i = 0; i < route->segment_count; i++) {
+        const JLRSegment *segment = &route->segments[i];
+        if (segment->type == JLRSegmentWildcard) {
+            match->has_wildcard = true;
+            if (i < path->component_count) {
+                match->wildcard = (jlr_span){component_start, path->path_end - component_start};
+            } else {
+                match->wildcard = (jlr_span){path->path_end, 0};
+            }
+            break;
+        }
+        const char *component_end = memchr(url + component_start, '/', path->path_end - component_start);
+        size_t component_length = component_end ? (size_t)(component_end - url) - component_start : path->path_end - component_start;
+        if (segment->type == JLRSegmentVariable) {
+            if (variables != NULL && variable_index < capacity) {
+                jlr_variable *variable = &variables[variable_index];
+                variable->name = route->pattern + segment->name_offset;
+                variable->name_length = segment->name_length;
+                variable->value = (jlr_span){component_start, component_length};
+            }
+            variable_index++;
+        }
+        component_start += component_length + 1;
+    }
+    return true;
+}
+
+jlr_match_result jlr_route_match(const jlr_router *router, const char *url, size_t length, uint32_t options, size_t start, jlr_match *match, jlr_variable *variables, size_t capacity)
+{
+    if (router == NULL || match == NULL || (url == NULL && length > 0)) {
+        return JLR_MATCH_NONE;
+    }
+    JLRURLPath path;
+    if (!JLRURLPathParse(url ?: "", length, options, &path)) {
+        return JLR_MATCH_UNSUPPORTED;
+    }
+    for (size_t i = start; i < router->length; i++) {
+        if (router->routes[i] != NULL && JLRRouteMatch(router->routes[i], url, &path, match, variables, capacity)) {
+            match->index = i;
+            match->query = path.query;
+            match->fragment = path.fragment;
+            return JLR_MATCH_FOUND;
+        }
+    }
+    return JLR_MATCH_NONE;
+}
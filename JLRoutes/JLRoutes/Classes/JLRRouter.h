@@ -0,0 +1,131 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JLRRouter_h
+#define JLRRouter_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 路由匹配引擎的 C 接口，直接处理 UTF-8 字节，可在 App 扩展、C/C++ 代码中使用
+ * 匹配规则与 JLRRouteDefinition 默认的规则一致：字面量逐字节比较，:name 为变量，* 匹配剩余的路径组件；
+ * 路由按优先级排序，优先级相同时按加入的顺序；URL 的路径组件按 JLRRouteRequest 的规则拆分（含 host 视为路径组件的规则）
+ * 变量可以带约束 :name<spec>，见 jlr_constraint_create；约束无法解析时 jlr_route_add 返回 false
+ * 不展开可选路由 (/a)(/b)，需要时由调用方展开后分别加入
+ * 匹配过程不分配内存；jlr_route_match 可以并发调用，加入、移除路由需由调用方保证互斥
+ */
+typedef struct jlr_router jlr_router;
+
+/// URL 中的一段，offset 为相对 URL 开头的字节偏移
+typedef struct {
+    size_t offset;
+    size_t length;
+} jlr_span;
+
+/// 路由变量；name 指向路由表保存的路由模式，移除该路由前有效；value 未做百分号解码
+typedef struct {
+    const char *name;
+    size_t name_length;
+    jlr_span value;
+} jlr_variable;
+
+typedef struct {
+    /// jlr_route_add 时传入的路由 ID
+    uint64_t route_id;
+    /// 路由在路由表中的位置，以 index + 1 作为 start 再次匹配可以继续查找后面的路由
+    size_t index;
+    /// 变量总数，可能大于传入的 capacity，超出的部分没有写入
+    size_t variable_count;
+    /// 路由模式含 * 时为 true，wildcard 为 * 匹配的剩余路径（可能为空）
+    bool has_wildcard;
+    jlr_span wildcard;
+    /// 不含 ? 与 #，没有时 length 为 0
+    jlr_span query;
+    jlr_span fragment;
+} jlr_match;
+
+typedef enum {
+    JLR_MATCH_NONE = 0,
+    JLR_MATCH_FOUND = 1,
+    /// URL 含端口、用户信息、百分号编码的 host，或路径需要规范化，无法保证与 JLRRouteRequest 的拆分一致
+    JLR_MATCH_UNSUPPORTED = -1,
+} jlr_match_result;
+
+typedef enum {
+    /// 总是把 host 视为第一个路径组件，对应 JLRRouteRequestOptionTreatHostAsPathComponent
+    JLR_OPTION_TREAT_HOST_AS_PATH = 1 << 0,
+} jlr_options;
+
+// MARK: - 变量约束
+
+/** 编译后的路径变量约束，匹配时逐字节检查，不使用正则表达式库
+ * spec 可以是内置的名字：int（十进制数字）、alpha、alnum、hex、uuid；
+ * 或者由字符位置组成的简单模式：[a-z]、[^-]、\x、. 或普通字符，后面可跟 ?、*、+、{n}、{n,}、{n,m}；不支持分组与 |
+ * 展开量词后最多 63 个字符位置；检查的是未做百分号解码的路径组件
+ */
+typedef struct jlr_constraint jlr_constraint;
+
+/// spec 无法解析时返回 NULL
+jlr_constraint *jlr_constraint_create(const char *spec, size_t length);
+void jlr_constraint_destroy(jlr_constraint *constraint);
+
+/// constraint 为 NULL 时总是返回 true
+bool jlr_constraint_match(const jlr_constraint *constraint, const char *value, size_t length);
+
+/** 解析路由模式中的变量路径组件 :name<spec>#
+ * 与 JLRRouteDefinition 一致：长度大于 1 时去掉开头的 : 与结尾的 #；结尾的 <...> 为约束
+ * @param name 变量名在 component 中的位置
+ * @param constraint 约束在 component 中的位置，没有约束时 length 为 0
+ * @returns component 不是变量时返回 false
+ */
+bool jlr_pattern_variable_parse(const char *component, size_t length, jlr_span *name, jlr_span *constraint);
+
+
+// MARK: - 路由表
+
+jlr_router *jlr_router_create(void);
+void jlr_router_destroy(jlr_router *router);
+
+/** 加入路由；pattern 会被复制，开头的一个 / 会被忽略
+ * @param priority 优先级高的排在前面
+ * @param route_id 调用方自定义的 ID，匹配时原样返回；可以重复
+ * @returns 内存不足时返回 false
+ */
+bool jlr_route_add(jlr_router *router, const char *pattern, size_t length, uint64_t priority, uint64_t route_id);
+
+/** 移除所有 ID 为 route_id 的路由，返回移除的数量
+ * 按 ID 的散列索引查找，其余路由的相对顺序不变；期望 O(1)（另加同 ID 路由的数量），空位过半时整理一次
+ */
+size_t jlr_route_remove(jlr_router *router, uint64_t route_id);
+
+void jlr_router_remove_all(jlr_router *router);
+
+size_t jlr_router_count(const jlr_router *router);
+
+/** 从第 start 个路由开始，查找第一个能匹配 URL 的路由
+ * @param url UTF-8 编码，不必以 \0 结尾
+ * @param options jlr_options 的组合
+ * @param match 匹配成功时写入
+ * @param variables 调用方提供的缓冲区，最多写入 capacity 个变量；可以为 NULL
+ */
+jlr_match_result jlr_route_match(const jlr_router *router, const char *url, size_t length, uint32_t options, size_t start, jlr_match *match, jlr_variable *variables, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JLRRouter_h */
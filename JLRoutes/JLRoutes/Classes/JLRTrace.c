@@ -0,0 +1,250 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "JLRTrace.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+
+bool jlr_trace_enabled = false;
+const size_t jlr_trace_buffer_capacity = 1024;
+
+
+// MARK: - 环形缓冲区
+
+/// 每个线程一个，只有持有它的线程写入；线程退出后可被其他线程接管
+typedef struct JLRTraceBuffer {
+    struct JLRTraceBuffer *next;
+    /// 是否有线程持有
+    atomic_bool in_use;
+    /// 已写入的事件总数，写完一个事件后递增
+    atomic_size_t head;
+    uint64_t thread_id;
+    jlr_trace_event events[];
+} JLRTraceBuffer;
+
+/// 所有缓冲区组成的链表，只增不减
+static _Atomic(JLRTraceBuffer *) JLRTraceBuffers = NULL;
+static __thread JLRTraceBuffer *JLRTraceCurrentBuffer = NULL;
+static pthread_key_t JLRTraceThreadKey;
+static pthread_once_t JLRTraceThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static jlr_trace_sink JLRTraceSink = NULL;
+static void *JLRTraceSinkContext = NULL;
+
+static uint64_t JLRTraceThreadID(void)
+{
+#if defined(__APPLE__)
+    uint64_t thread_id = 0;
+    pthread_threadid_np(NULL, &thread_id);
+    return thread_id;
+#elif defined(__linux__)
+    return (uint64_t)syscall(SYS_gettid);
+#else
+    return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+static uint64_t JLRTraceTimestamp(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+
+/// 线程退出时归还缓冲区
+static void JLRTraceThreadDidExit(void *value)
+{
+    JLRTraceBuffer *buffer = value;
+    atomic_store_explicit(&buffer->in_use, false, memory_order_release);
+}
+
+static void JLRTraceCreateThreadKey(void)
+{
+    pthread_key_create(&JLRTraceThreadKey, JLRTraceThreadDidExit);
+}
+
+/// 优先接管已退出线程的缓冲区，没有时新建；内存不足时返回 NULL
+static JLRTraceBuffer *JLRTraceAcquireBuffer(void)
+{
+    pthread_once(&JLRTraceThreadKeyOnce, JLRTraceCreateThreadKey);
+    JLRTraceBuffer *buffer = NULL;
+    for (JLRTraceBuffer *candidate = atomic_load_explicit(&JLRTraceBuffers, memory_order_acquire); candidate; candidate = candidate->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&candidate->in_use, &expected, true)) {
+            buffer = candidate;
+            break;
+        }
+    }
+    if (buffer == NULL) {
+        buffer = calloc(1, sizeof(JLRTraceBuffer) + jlr_trace_buffer_capacity * sizeof(jlr_trace_event));
+        if (buffer == NULL) {
+            return NULL;
+        }
+        atomic_init(&buffer->in_use, true);
+        atomic_init(&buffer->head, 0);
+        JLRTraceBuffer *head = atomic_load_explicit(&JLRTraceBuffers, memory_order_relaxed);
+        do {
+            buffer->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&JLRTraceBuffers, &head, buffer, memory_order_release, memory_order_relaxed));
+    }
+    buffer->thread_id = JLRTraceThreadID();
+    pthread_setspecific(JLRTraceThreadKey, buffer);
+    return buffer;
+}
+
+static void JLRTraceCopyString(char *destination, size_t capacity, const char *source)
+{
+    size_t length = source ? strnlen(source, capacity - 1) : 0;
+    memcpy(destination, source ?: "", length);
+    destination[length] = '\0';
+}
+
+
+// MARK: - 记录
+
+void jlr_trace_set_enabled(bool enabled)
+{
+    jlr_trace_enabled = enabled;
+}
+
+void jlr_trace_set_sink(jlr_trace_sink sink, void *context)
+{
+    JLRTraceSink = sink;
+    JLRTraceSinkContext = context;
+}
+
+void jlr_trace_record(const char *name, char phase, const char *pattern, const char *scheme)
+{
+    jlr_trace_event event;
+    event.name = name;
+    event.phase = phase;
+    event.timestamp = JLRTraceTimestamp();
+    
+    if (JLRTraceSink != NULL) {
+        event.thread_id = JLRTraceThreadID();
+        JLRTraceCopyString(event.pattern, sizeof(event.pattern), pattern);
+        JLRTraceCopyString(event.scheme, sizeof(event.scheme), scheme);
+        JLRTraceSink(&event, JLRTraceSinkContext);
+        return;
+    }
+    
+    JLRTraceBuffer *buffer = JLRTraceCurrentBuffer;
+    if (buffer == NULL) {
+        buffer = JLRTraceCurrentBuffer = JLRTraceAcquireBuffer();
+        if (buffer == NULL) {
+            return;
+        }
+    }
+    size_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    jlr_trace_event *slot = &buffer->events[head % jlr_trace_buffer_capacity];
+    slot->name = name;
+    slot->phase = phase;
+    slot->timestamp = event.timestamp;
+    slot->thread_id = buffer->thread_id;
+    JLRTraceCopyString(slot->pattern, sizeof(slot->pattern), pattern);
+    JLRTraceCopyString(slot->scheme, sizeof(slot->scheme), scheme);
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+void jlr_trace_clear(void)
+{
+    for (JLRTraceBuffer *buffer = atomic_load_explicit(&JLRTraceBuffers, memory_order_acquire); buffer; buffer = buffer->next) {
+        atomic_store_explicit(&buffer->head, 0, memory_order_release);
+    }
+}
+
+
+// MARK: - 导出
+
+static bool JLRTraceWriteJSONString(FILE *file, const char *string)
+{
+    if (fputc('"', file) == EOF) {
+        return false;
+    }
+    for (const unsigned char *c = (const unsigned char *)string; *c; c++) {
+        int result;
+        if (*c == '"' || *c == '\\') {
+            result = fprintf(file, "\\%c", *c);
+        } else if (*c < 0x20) {
+            result = fprintf(file, "\\u%04x", *c);
+        } else {
+            result = fputc(*c, file);
+        }
+        if (result < 0) {
+            return false;
+        }
+    }
+    return fputc('"', file) != EOF;
+}
+
+static bool JLRTraceWriteEvent(FILE *file, const jlr_trace_event *event, bool first)
+{
+    if (fprintf(file, "%s\n{\"name\":", first ? "" : ",") < 0 || !JLRTraceWriteJSONString(file, event->name ?: "")) {
+        return false;
+    }
+    if (fprintf(file, ",\"cat\":\"jlroutes\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":%" PRIu64,
+                event->phase, event->timestamp / 1000, event->timestamp % 1000, (int)getpid(), event->thread_id) < 0) {
+        return false;
+    }
+    if (event->phase == 'B') {
+        if (fputs(",\"args\":{\"pattern\":", file) == EOF || !JLRTraceWriteJSONString(file, event->pattern) ||
+            fputs(",\"scheme\":", file) == EOF || !JLRTraceWriteJSONString(file, event->scheme) || fputc('}', file) == EOF) {
+            return false;
+        }
+    }
+    return fputc('}', file) != EOF;
+}
+
+bool jlr_trace_write_chrome_json(FILE *file)
+{
+    if (file == NULL) {
+        return false;
+    }
+    jlr_trace_event *events = malloc(jlr_trace_buffer_capacity * sizeof(jlr_trace_event));
+    if (events == NULL || fputs("{\"traceEvents\":[", file) == EOF) {
+        free(events);
+        return false;
+    }
+    bool first = true;
+    bool success = true;
+    for (JLRTraceBuffer *buffer = atomic_load_explicit(&JLRTraceBuffers, memory_order_acquire); buffer && success; buffer = buffer->next) {
+        size_t end = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        size_t start = end > jlr_trace_buffer_capacity ? end - jlr_trace_buffer_capacity : 0;
+        for (size_t i = start; i < end; i++) {
+            events[i - start] = buffer->events[i % jlr_trace_buffer_capacity];
+        }
+        // 复制期间写入线程可能覆盖了最旧的事件，丢弃这部分。写入线程先写第 head 个槽位再发布 head + 1，
+        // 读到 latest 时第 latest 个事件（与第 latest - capacity 个共用槽位）可能正在写入，也一并丢弃
+        atomic_thread_fence(memory_order_acquire);
+        size_t latest = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+        if (latest < end) {
+            // 期间被清空
+            continue;
+        }
+        size_t valid = latest >= jlr_trace_buffer_capacity ? latest - jlr_trace_buffer_capacity + 1 : 0;
+        for (size_t i = (valid > start ? valid : start); i < end && success; i++) {
+            success = JLRTraceWriteEvent(file, &events[i - start], first);
+            first = false;
+        }
+    }
+    free(events);
+    return success && fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file) != EOF;
+}
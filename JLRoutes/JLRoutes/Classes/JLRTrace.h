@@ -0,0 +1,91 @@
+/*
+ Copyright (c) 2017, Joel Levin
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ Neither the name of JLRoutes nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JLRTrace_h
+#define JLRTrace_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 路由分发的追踪事件
+ * 在 _routeURL: 的各个阶段（预筛、创建请求、匹配、handler、全局路由兜底）与调用方的跳转流程前后记录开始/结束事件，
+ * 默认写入每个线程各自的环形缓冲区（写入不加锁），可导出为 Chrome trace-event JSON，用 chrome://tracing 或 Perfetto 查看
+ * 未开启时 JLR_TRACE_BEGIN / JLR_TRACE_END 只有一次分支判断，参数不会被求值
+ */
+
+/// 只读，用 jlr_trace_set_enabled 修改
+extern bool jlr_trace_enabled;
+
+#define JLR_TRACE_PATTERN_LENGTH 64
+#define JLR_TRACE_SCHEME_LENGTH 32
+
+typedef struct {
+    /// 阶段名，须是静态字符串
+    const char *name;
+    /// 'B' 开始，'E' 结束
+    char phase;
+    /// 单调时钟，纳秒
+    uint64_t timestamp;
+    uint64_t thread_id;
+    /// 路由模式（或 URL）与 scheme，超长时截断；没有时为空字符串
+    char pattern[JLR_TRACE_PATTERN_LENGTH];
+    char scheme[JLR_TRACE_SCHEME_LENGTH];
+} jlr_trace_event;
+
+/** 自定义事件的去向，在记录事件的线程上同步调用
+ * @param event 只在调用期间有效
+ */
+typedef void (*jlr_trace_sink)(const jlr_trace_event *event, void *context);
+
+void jlr_trace_set_enabled(bool enabled);
+
+/// 替换默认的环形缓冲区；sink 为 NULL 时恢复默认。应在开启追踪前设置
+void jlr_trace_set_sink(jlr_trace_sink sink, void *context);
+
+/// 记录事件；通常通过 JLR_TRACE_BEGIN / JLR_TRACE_END 调用。pattern、scheme 可以为 NULL
+void jlr_trace_record(const char *name, char phase, const char *pattern, const char *scheme);
+
+/// 清空所有线程的环形缓冲区；应在没有事件写入时调用
+void jlr_trace_clear(void);
+
+/** 把所有线程环形缓冲区中的事件写为 Chrome trace-event JSON
+ * 每个线程只保留最近的 jlr_trace_buffer_capacity 个事件；导出期间被覆盖的事件会被丢弃
+ * @returns 写入失败时返回 false
+ */
+bool jlr_trace_write_chrome_json(FILE *file);
+
+/// 每个线程的环形缓冲区最多保存的事件数量
+extern const size_t jlr_trace_buffer_capacity;
+
+#define JLR_TRACE_BEGIN(name, pattern, scheme) do { \
+    if (__builtin_expect(jlr_trace_enabled, 0)) { \
+        jlr_trace_record((name), 'B', (pattern), (scheme)); \
+    } \
+} while (0)
+
+#define JLR_TRACE_END(name) do { \
+    if (__builtin_expect(jlr_trace_enabled, 0)) { \
+        jlr_trace_record((name), 'E', NULL, NULL); \
+    } \
+} while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JLRTrace_h */
@@ -16,6 +16,10 @@
 #import "JLRRouteHandler.h"
 #import "JLRRouteRequest.h"
 #import "JLRRouteResponse.h"
+#import "JLRRouteFilter.h"
+#import "JLRRouter.h"
+#import "JLRTrace.h"
+#import "JLRRouteDeclaration.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -37,6 +41,17 @@ extern NSString *const JLRoutesGlobalRoutesScheme;
 
 
 
+/** 注册路由时返回的凭证，用于移除这次注册的路由
+ * 可选路由模式展开出的多个路由共用一个凭证
+ */
+@interface JLRRouteHandle : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+
 /** JLRoutes 类是 JLRoutes 框架的主要入口点: 用于访问 Schemes、管理 routes 、routing URLs
  *
  * JLRoutes 是通过解析URL不同的参数，并用block回调的方式处理页面间的传值以及跳转。
@@ -86,11 +101,18 @@ extern NSString *const JLRoutesGlobalRoutesScheme;
  * @param handler 处理路由时间，返回值表示是否处理
  *                返回一个BOOL值，表示 handlerBlock 是否真的处理了该路由。如果返回NO, JLRoutes将继续寻找匹配的路由
  * @param routeDefinition 定制路由逻辑：将每一条注册数据（pattern、priority、handler）封装在JLRouteDefinition对象中
+ * @returns 注册凭证，可以用 -removeRouteWithHandle: 移除这次注册的路由
+ */
+- (JLRRouteHandle *)addRoute:(JLRRouteDefinition *)routeDefinition;
+- (JLRRouteHandle *)addRoute:(NSString *)routePattern handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
+- (JLRRouteHandle *)addRoute:(NSString *)routePattern priority:(NSUInteger)priority handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
+- (JLRRouteHandle *)addRoutes:(NSArray<NSString *> *)routePatterns handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
+
+/** 移除凭证对应的路由，其余路由的相对顺序不变
+ * 不比较路由是否相等，期望 O(1)：只做标记，标记过半时整理一次 mutableRoutes
+ * 凭证不属于当前 scheme、或路由已经被移除时什么也不做
  */
-- (void)addRoute:(JLRRouteDefinition *)routeDefinition;
-- (void)addRoute:(NSString *)routePattern handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
-- (void)addRoute:(NSString *)routePattern priority:(NSUInteger)priority handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
-- (void)addRoutes:(NSArray<NSString *> *)routePatterns handler:(BOOL (^__nullable)(NSDictionary<NSString *, id> *parameters))handlerBlock;
+- (void)removeRouteWithHandle:(JLRRouteHandle *)handle;
 
 // 从接收scheme中移除路由
 - (void)removeRoute:(JLRRouteDefinition *)routeDefinition;
@@ -168,12 +190,32 @@ extern NSString *const JLRoutesGlobalRoutesScheme;
 ///  判断 URL host 是否始终被视为路径组件。默认为NO。
 + (BOOL)alwaysTreatsHostAsPathComponent;
 
+/// 配置: 匹配前是否先用每个 JLRoutes 的 JLRRouteFilter 排除一定不匹配的 URL。默认为 YES
++ (void)setRouteFilterEnabled:(BOOL)routeFilterEnabled;
+
+/// 是否先用 JLRRouteFilter 排除一定不匹配的 URL。默认为 YES
++ (BOOL)isRouteFilterEnabled;
+
 /// 配置: 创建 Route 时使用的默认类; 默认为 JLRRouteDefinition
 + (void)setDefaultRouteDefinitionClass:(Class)routeDefinitionClass;
 
 /// 获取创建 Route 时使用的类; 默认为JLRRouteDefinition
 + (Class)defaultRouteDefinitionClass;
 
+/** 为 JLR_ROUTE_DECLARE 声明的路由创建 handler；返回 nil 时跳过该声明
+ * @param declaration 链接期声明的路由记录，在程序运行期间一直有效
+ */
+typedef BOOL (^ _Nullable (^JLRDeclaredRouteHandlerProvider)(const jlr_route_declaration *declaration))(NSDictionary<NSString *, id> *parameters);
+
+/** 配置: 声明路由的 handler 提供者；默认为 nil，不注册声明的路由
+ * 设置后，第一次分发 URL 时读取所有声明并按 scheme（NULL 为全局）与 priority 注册，只读取一次；
+ * unregisterAllRouteSchemes 之后的下一次分发会重新注册
+ */
++ (void)setDeclaredRouteHandlerProvider:(nullable JLRDeclaredRouteHandlerProvider)provider;
+
+/// 声明路由的 handler 提供者
++ (nullable JLRDeclaredRouteHandlerProvider)declaredRouteHandlerProvider;
+
 @end
 
 
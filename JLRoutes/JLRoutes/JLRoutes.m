@@ -13,6 +13,10 @@
 #import "JLRoutes.h"
 #import "JLRRouteDefinition.h"
 #import "JLRParsingUtilities.h"
+#import "JLRRouteFilter.h"
+#import "JLRRouter.h"
+#import "JLRTrace.h"
+#import "JLRRouteDeclaration.h"
 
 
 NSString *const JLRoutePatternKey = @"JLRoutePattern";
@@ -32,19 +36,56 @@ static NSMutableDictionary *JLRGlobal_routeControllersMap = nil;
 static BOOL JLRGlobal_verboseLoggingEnabled;///是否开启日志
 static BOOL JLRGlobal_shouldDecodePlusSymbols;///是否替换符号 +
 static BOOL JLRGlobal_alwaysTreatsHostAsPathComponent;
+static BOOL JLRGlobal_routeFilterEnabled;///是否先用 JLRRouteFilter 排除一定不匹配的 URL
 static Class JLRGlobal_routeDefinitionClass;/// 默认类
+static JLRDeclaredRouteHandlerProvider JLRGlobal_declaredRouteHandlerProvider;/// 为声明的路由创建 handler
+static BOOL JLRGlobal_declaredRoutesRegistered;/// 声明的路由是否已注册
 
 
 @interface JLRoutes ()
+{
+    /// 沿用默认匹配规则的路由，以路由对象的地址为 ID，与 mutableRoutes 同步更新
+    jlr_router *_router;
+    /// 重写了匹配方法，或未能加入 _router 的路由，按对象地址比较；不为空时逐个匹配所有路由
+    NSHashTable<JLRRouteDefinition *> *_unroutableRoutes;
+    /// 已注册且没有被移除的路由，按对象地址比较
+    NSHashTable<JLRRouteDefinition *> *_registeredRoutes;
+    /// 通过凭证移除、仍留在 mutableRoutes 中的路由，按对象地址比较；过半时整理 mutableRoutes
+    NSHashTable<JLRRouteDefinition *> *_removedRoutes;
+}
 
 @property (nonatomic, strong) NSMutableArray<JLRRouteDefinition *> *mutableRoutes;
 @property (nonatomic, strong) NSString *scheme;
+/// mutableRoutes 的概率签名，与 mutableRoutes 同步更新
+@property (nonatomic, strong) JLRRouteFilter *routeFilter;
 
 - (JLRRouteRequestOptions)_routeRequestOptions;
 
 @end
 
 
+@interface JLRRouteHandle ()
+
+@property (nonatomic, weak) JLRoutes *routesController;
+@property (nonatomic, copy) NSArray<JLRRouteDefinition *> *routeDefinitions;
+
+@end
+
+
+@implementation JLRRouteHandle
+
+- (instancetype)initWithRoutesController:(JLRoutes *)routesController routeDefinitions:(NSArray<JLRRouteDefinition *> *)routeDefinitions
+{
+    if ((self = [super init])) {
+        _routesController = routesController;
+        _routeDefinitions = [routeDefinitions copy];
+    }
+    return self;
+}
+
+@end
+
+
 #pragma mark -
 
 @implementation JLRoutes
@@ -56,6 +97,7 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
         JLRGlobal_verboseLoggingEnabled = NO;
         JLRGlobal_shouldDecodePlusSymbols = YES;
         JLRGlobal_alwaysTreatsHostAsPathComponent = NO;
+        JLRGlobal_routeFilterEnabled = YES;
         JLRGlobal_routeDefinitionClass = [JLRRouteDefinition class];
     }
 }
@@ -64,13 +106,23 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
 {
     if ((self = [super init])) {
         self.mutableRoutes = [NSMutableArray array];
+        self.routeFilter = [[JLRRouteFilter alloc] init];
+        _router = jlr_router_create();
+        _registeredRoutes = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        _removedRoutes = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        _unroutableRoutes = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
     }
     return self;
 }
 
+- (void)dealloc
+{
+    jlr_router_destroy(_router);
+}
+
 - (NSString *)description
 {
-    return [self.mutableRoutes description];
+    return [self.routes description];
 }
 
 + (NSDictionary <NSString *, NSArray <JLRRouteDefinition *> *> *)allRoutes;
@@ -79,7 +131,7 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     
     for (NSString *namespace in [JLRGlobal_routeControllersMap copy]) {
         JLRoutes *routesController = JLRGlobal_routeControllersMap[namespace];
-        dictionary[namespace] = [routesController.mutableRoutes copy];
+        dictionary[namespace] = routesController.routes;
     }
     
     return [dictionary copy];
@@ -125,23 +177,27 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
 + (void)unregisterAllRouteSchemes
 {
     [JLRGlobal_routeControllersMap removeAllObjects];
+    JLRGlobal_declaredRoutesRegistered = NO;
 }
 
 
 #pragma mark - 注册 Routes
 
-- (void)addRoute:(JLRRouteDefinition *)routeDefinition{
+- (JLRRouteHandle *)addRoute:(JLRRouteDefinition *)routeDefinition{
     [self _registerRoute:routeDefinition];
+    return [[JLRRouteHandle alloc] initWithRoutesController:self routeDefinitions:@[routeDefinition]];
 }
 
-- (void)addRoute:(NSString *)routePattern handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
-    [self addRoute:routePattern priority:0 handler:handlerBlock];
+- (JLRRouteHandle *)addRoute:(NSString *)routePattern handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
+    return [self addRoute:routePattern priority:0 handler:handlerBlock];
 }
 
-- (void)addRoutes:(NSArray<NSString *> *)routePatterns handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
+- (JLRRouteHandle *)addRoutes:(NSArray<NSString *> *)routePatterns handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
+    NSMutableArray<JLRRouteDefinition *> *routeDefinitions = [NSMutableArray array];
     for (NSString *routePattern in routePatterns) {
-        [self addRoute:routePattern handler:handlerBlock];
+        [routeDefinitions addObjectsFromArray:[self addRoute:routePattern handler:handlerBlock].routeDefinitions];
     }
+    return [[JLRRouteHandle alloc] initWithRoutesController:self routeDefinitions:routeDefinitions];
 }
 
 /** 注册路由
@@ -149,8 +205,9 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
  * 2、根据 routePattern、priority、handlerBlock 封装一个路由模型 JLRRouteDefinition
  * 3、如果有可选路由模式，则注册可选路由；并结束不再向下执行
  * 4、如果没有可选路由，则注册 routePattern 对应的路由模型 JLRRouteDefinition
+ * 5、返回包含所有注册的路由的凭证
  */
-- (void)addRoute:(NSString *)routePattern priority:(NSUInteger)priority handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
+- (JLRRouteHandle *)addRoute:(NSString *)routePattern priority:(NSUInteger)priority handler:(BOOL (^)(NSDictionary<NSString *, id> *parameters))handlerBlock{
     
     // 为 routePattern 展开可选路由模式
     NSArray <NSString *> *optionalRoutePatterns = [JLRParsingUtilities expandOptionalRoutePatternsForPattern:routePattern];
@@ -161,26 +218,59 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     // 如果optionalRoutePatterns大于0, 即有可选路由模式，注册可选路由
     if (optionalRoutePatterns.count > 0) {
         /// 有可选参数，需要解析和添加它们
+        NSMutableArray<JLRRouteDefinition *> *optionalRoutes = [NSMutableArray arrayWithCapacity:optionalRoutePatterns.count];
         for (NSString *pattern in optionalRoutePatterns) {
             JLRRouteDefinition *optionalRoute = [[JLRGlobal_routeDefinitionClass alloc] initWithPattern:pattern priority:priority handlerBlock:handlerBlock];
             [self _registerRoute:optionalRoute];/// 注册可选路由
+            [optionalRoutes addObject:optionalRoute];
             [self _verboseLog:@"Automatically created optional route: %@", optionalRoute];
         }
         // 如果有可选路由模式，则不需注册 routePattern
-        return;
+        return [[JLRRouteHandle alloc] initWithRoutesController:self routeDefinitions:optionalRoutes];
     }
     
     // 如果没有可选路由模式，注册 routePattern
     [self _registerRoute:route];
+    return [[JLRRouteHandle alloc] initWithRoutesController:self routeDefinitions:@[route]];
+}
+
+- (void)removeRouteWithHandle:(JLRRouteHandle *)handle
+{
+    if (handle.routesController != self) {
+        return;
+    }
+    for (JLRRouteDefinition *route in handle.routeDefinitions) {
+        if (![_registeredRoutes containsObject:route]) {
+            continue;
+        }
+        [_registeredRoutes removeObject:route];
+        [_removedRoutes addObject:route];
+        [self.routeFilter removeRoute:route];
+        [self _removeNativeRoute:route];
+    }
+    handle.routeDefinitions = @[];
+    if (_removedRoutes.count * 2 > self.mutableRoutes.count) {
+        [self _compactRoutes];
+    }
 }
 
 - (void)removeRoute:(JLRRouteDefinition *)routeDefinition
 {
+    [self _compactRoutes];
+    // removeObject: 会移除所有相等的路由
+    for (JLRRouteDefinition *route in self.mutableRoutes) {
+        if ([route isEqual:routeDefinition]) {
+            [self.routeFilter removeRoute:route];
+            [self _removeNativeRoute:route];
+            [_registeredRoutes removeObject:route];
+        }
+    }
     [self.mutableRoutes removeObject:routeDefinition];
 }
 
 - (void)removeRouteWithPattern:(NSString *)routePattern
-{   
+{
+    [self _compactRoutes];
     NSInteger routeIndex = NSNotFound;
     NSInteger index = 0;
     
@@ -193,6 +283,9 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     }
     
     if (routeIndex != NSNotFound) {
+        [self.routeFilter removeRoute:self.mutableRoutes[(NSUInteger)routeIndex]];
+        [self _removeNativeRoute:self.mutableRoutes[(NSUInteger)routeIndex]];
+        [_registeredRoutes removeObject:self.mutableRoutes[(NSUInteger)routeIndex]];
         [self.mutableRoutes removeObjectAtIndex:(NSUInteger)routeIndex];
     }
 }
@@ -200,6 +293,11 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
 - (void)removeAllRoutes
 {
     [self.mutableRoutes removeAllObjects];
+    [_registeredRoutes removeAllObjects];
+    [_removedRoutes removeAllObjects];
+    [self.routeFilter removeAllRoutes];
+    jlr_router_remove_all(_router);
+    [_unroutableRoutes removeAllObjects];
 }
 
 - (void)setObject:(id)handlerBlock forKeyedSubscript:(NSString *)routePatten
@@ -209,6 +307,7 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
 
 - (NSArray <JLRRouteDefinition *> *)routes;
 {
+    [self _compactRoutes];
     return [self.mutableRoutes copy];
 }
 
@@ -254,14 +353,45 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     if (URL == nil) {
         return nil;
     }
+    [self _registerDeclaredRoutesIfNeeded];
     return JLRGlobal_routeControllersMap[URL.scheme] ?: [JLRoutes globalRoutes];
 }
 
+/// 注册一条链接期声明的路由
+static void JLRRegisterDeclaredRoute(const jlr_route_declaration *declaration, void *context)
+{
+    NSString *pattern = [NSString stringWithUTF8String:declaration->pattern];
+    NSString *scheme = declaration->scheme ? [NSString stringWithUTF8String:declaration->scheme] : JLRoutesGlobalRoutesScheme;
+    if (pattern == nil || scheme == nil) {
+        return;
+    }
+    BOOL (^handlerBlock)(NSDictionary *) = JLRGlobal_declaredRouteHandlerProvider(declaration);
+    if (handlerBlock == nil) {
+        return;
+    }
+    NSUInteger priority = declaration->priority > NSUIntegerMax ? NSUIntegerMax : (NSUInteger)declaration->priority;
+    [[JLRoutes routesForScheme:scheme] addRoute:pattern priority:priority handler:handlerBlock];
+}
+
+/// 第一次分发时注册 JLR_ROUTE_DECLARE 声明的路由；没有 handler 提供者时不读取
++ (void)_registerDeclaredRoutesIfNeeded{
+    if (JLRGlobal_declaredRoutesRegistered || JLRGlobal_declaredRouteHandlerProvider == nil) {
+        return;
+    }
+    JLRGlobal_declaredRoutesRegistered = YES;
+    size_t count = jlr_route_declarations_enumerate(JLRRegisterDeclaredRoute, NULL);
+    [[JLRoutes globalRoutes] _verboseLog:@"Registered %zu declared routes", count];
+}
+
 /** 注册一个路由
  * 1、搜索现有路由，按优先级插入JLRoutes的数组中，优先级高的排列在前面
  * 2、为路由模型对象设置 scheme
  */
 - (void)_registerRoute:(JLRRouteDefinition *)route{
+    // 重新注册通过凭证移除的路由时，先去掉旧的位置
+    if (_removedRoutes.count > 0 && [_removedRoutes containsObject:route]) {
+        [self _compactRoutes];
+    }
     if (route.priority == 0 || self.mutableRoutes.count == 0) {
         [self.mutableRoutes addObject:route];
     } else {
@@ -280,11 +410,16 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
         }
     }
     
+    [_registeredRoutes addObject:route];
+    [self.routeFilter addRoute:route];
+    [self _addNativeRoute:route];
+    
     // 将JLRoutes的scheme赋值给传递进来的路由模型对象的scheme
     [route didBecomeRegisteredForScheme:self.scheme];
 }
 
 /** 调起路由，执行 handlerBlock
+ * 0、先用 routeFilter 预筛，一定不匹配时跳过第 1、2 步；再用 JLRRouter 按 pattern 选出候选路由
  * 1、根据 URL 创建一个请求 JLRRouteRequest
  * 2、在路由器的数组 mutableRoutes 中匹配已注册的对应路由，
  *     如果不匹配，中断当前循环，进入下一轮查询
@@ -300,17 +435,34 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
         return NO;
     }
     
+    [JLRoutes _registerDeclaredRoutesIfNeeded];
     [self _verboseLog:@"Trying to route URL %@", URL];
+    JLR_TRACE_BEGIN("JLRoutes.routeURL", URL.absoluteString.UTF8String, self.scheme.UTF8String);
     
     BOOL didRoute = NO;/// 标记是否已经路由
     
     JLRRouteRequestOptions options = [self _routeRequestOptions];
     
+    /// 预筛：URL 的路径组件数量与第一个路径组件不符合任何路由时，无需创建请求与逐个匹配
+    JLR_TRACE_BEGIN("JLRoutes.filter", NULL, self.scheme.UTF8String);
+    BOOL mayMatch = !JLRGlobal_routeFilterEnabled || [self.routeFilter mayMatchURL:URL options:options];
+    JLR_TRACE_END("JLRoutes.filter");
+    if (!mayMatch) {
+        [self _verboseLog:@"预筛排除了 %@", URL];
+    }
+    
     /// 创建路由请求
-    JLRRouteRequest *request = [[JLRRouteRequest alloc] initWithURL:URL options:options additionalParameters:parameters];
+    JLR_TRACE_BEGIN("JLRoutes.request", NULL, self.scheme.UTF8String);
+    JLRRouteRequest *request = mayMatch ? [[JLRRouteRequest alloc] initWithURL:URL options:options additionalParameters:parameters] : nil;
+    JLR_TRACE_END("JLRoutes.request");
+    
+    JLR_TRACE_BEGIN("JLRoutes.candidates", NULL, self.scheme.UTF8String);
+    NSArray <JLRRouteDefinition *> *candidates = mayMatch ? [self _candidateRoutesForURL:URL options:options] : nil;
+    JLR_TRACE_END("JLRoutes.candidates");
     
     /// 遍历已注册路由，查找能匹配的路由，执行 handlerBlock
-    for (JLRRouteDefinition *route in [self.mutableRoutes copy]) {
+    JLR_TRACE_BEGIN("JLRoutes.scan", NULL, self.scheme.UTF8String);
+    for (JLRRouteDefinition *route in candidates) {
         // 检查每个路由是否有匹配的响应
         JLRRouteResponse *response = [route routeResponseForRequest:request];
         if (!response.isMatch) {
@@ -321,19 +473,24 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
         
         // 没有执行block立即返回
         if (!executeRouteBlock) {
+            JLR_TRACE_END("JLRoutes.scan");
+            JLR_TRACE_END("JLRoutes.routeURL");
             return YES;
         }
         
         [self _verboseLog:@"Match parameters are %@", response.parameters];
         
         // 调用路由模型对象 handlerBlock
+        JLR_TRACE_BEGIN("JLRoutes.handler", route.pattern.UTF8String, self.scheme.UTF8String);
         didRoute = [route callHandlerBlockWithParameters:response.parameters];
+        JLR_TRACE_END("JLRoutes.handler");
         
         if (didRoute) {
             /// 如果成功路由，中断循环
             break;
         }
     }
+    JLR_TRACE_END("JLRoutes.scan");
     
     if (!didRoute) {
         [self _verboseLog:@"找不到匹配的路由"];
@@ -342,19 +499,88 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     /// 如果找不到匹配的路由，尝试去全局路由来匹配
     if (!didRoute && self.shouldFallbackToGlobalRoutes && ![self _isGlobalRoutesController]) {
         [self _verboseLog:@"Falling back to global routes..."];
+        JLR_TRACE_BEGIN("JLRoutes.fallback", NULL, JLRoutesGlobalRoutesScheme.UTF8String);
         didRoute = [[JLRoutes globalRoutes] _routeURL:URL withParameters:parameters executeRouteBlock:executeRouteBlock];
+        JLR_TRACE_END("JLRoutes.fallback");
     }
     
     /// 如果还是找不到匹配的路由，回调 unmatchedURLHandler()
     if (!didRoute && executeRouteBlock && self.unmatchedURLHandler) {
         [self _verboseLog:@"Falling back to the unmatched URL handler"];
+        JLR_TRACE_BEGIN("JLRoutes.unmatched", NULL, self.scheme.UTF8String);
         self.unmatchedURLHandler(self, URL, parameters);
+        JLR_TRACE_END("JLRoutes.unmatched");
     }
     
+    JLR_TRACE_END("JLRoutes.routeURL");
     // 返回是否已路由
     return didRoute;
 }
 
+#pragma mark - JLRRouter
+
+- (void)_addNativeRoute:(JLRRouteDefinition *)route{
+    const char *pattern = route.pattern.UTF8String;
+    if (![[route class] usesDefaultMatching] || pattern == NULL ||
+        !jlr_route_add(_router, pattern, strlen(pattern), route.priority, (uint64_t)(uintptr_t)(__bridge void *)route)) {
+        [_unroutableRoutes addObject:route];
+    }
+}
+
+- (void)_removeNativeRoute:(JLRRouteDefinition *)route{
+    // 只有加入时被记为无法路由的路由才从 _unroutableRoutes 中移除，重复移除不影响计数
+    if ([_unroutableRoutes containsObject:route]) {
+        [_unroutableRoutes removeObject:route];
+    } else {
+        jlr_route_remove(_router, (uint64_t)(uintptr_t)(__bridge void *)route);
+    }
+}
+
+/** 可能匹配 URL 的路由，按 mutableRoutes 的顺序
+ * 所有路由都沿用默认匹配规则时，由 JLRRouter 直接在 URL 的 UTF-8 字节上按 pattern 筛选，不创建中间字符串；
+ * 否则，或 URL 含 fragment（JLRRouteRequest 会把 fragment 拼接到路径中）等 JLRRouter 无法处理的情况，返回所有路由
+ */
+- (NSArray <JLRRouteDefinition *> *)_candidateRoutesForURL:(NSURL *)URL options:(JLRRouteRequestOptions)options{
+    if (_unroutableRoutes.count > 0 || URL.fragment != nil) {
+        return self.routes;
+    }
+    const char *string = URL.absoluteString.UTF8String;
+    if (string == NULL) {
+        return self.routes;
+    }
+    size_t length = strlen(string);
+    uint32_t nativeOptions = (options & JLRRouteRequestOptionTreatHostAsPathComponent) ? JLR_OPTION_TREAT_HOST_AS_PATH : 0;
+    
+    NSMutableArray <JLRRouteDefinition *> *candidates = [NSMutableArray array];
+    jlr_match match;
+    size_t start = 0;
+    jlr_match_result result;
+    while ((result = jlr_route_match(_router, string, length, nativeOptions, start, &match, NULL, 0)) == JLR_MATCH_FOUND) {
+        // ID 为 mutableRoutes 中路由对象的地址，筛选期间路由表不会变化
+        [candidates addObject:(__bridge JLRRouteDefinition *)(void *)(uintptr_t)match.route_id];
+        start = match.index + 1;
+    }
+    if (result == JLR_MATCH_UNSUPPORTED) {
+        return self.routes;
+    }
+    return candidates;
+}
+
+/// 从 mutableRoutes 中去掉通过凭证移除的路由，其余路由的相对顺序不变
+- (void)_compactRoutes{
+    if (_removedRoutes.count == 0) {
+        return;
+    }
+    NSMutableArray<JLRRouteDefinition *> *routes = [NSMutableArray arrayWithCapacity:self.mutableRoutes.count - _removedRoutes.count];
+    for (JLRRouteDefinition *route in self.mutableRoutes) {
+        if (![_removedRoutes containsObject:route]) {
+            [routes addObject:route];
+        }
+    }
+    self.mutableRoutes = routes;
+    [_removedRoutes removeAllObjects];
+}
+
 /// 判断当前对象是否是全局路由器
 - (BOOL)_isGlobalRoutesController{
     return [self.scheme isEqualToString:JLRoutesGlobalRoutesScheme];
@@ -421,6 +647,14 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     return JLRGlobal_alwaysTreatsHostAsPathComponent;
 }
 
++ (void)setRouteFilterEnabled:(BOOL)routeFilterEnabled{
+    JLRGlobal_routeFilterEnabled = routeFilterEnabled;
+}
+
++ (BOOL)isRouteFilterEnabled{
+    return JLRGlobal_routeFilterEnabled;
+}
+
 + (void)setDefaultRouteDefinitionClass:(Class)routeDefinitionClass{
     NSParameterAssert([routeDefinitionClass isSubclassOfClass:[JLRRouteDefinition class]]);
     JLRGlobal_routeDefinitionClass = routeDefinitionClass;
@@ -430,6 +664,14 @@ static Class JLRGlobal_routeDefinitionClass;/// 默认类
     return JLRGlobal_routeDefinitionClass;
 }
 
++ (void)setDeclaredRouteHandlerProvider:(JLRDeclaredRouteHandlerProvider)provider{
+    JLRGlobal_declaredRouteHandlerProvider = [provider copy];
+}
+
++ (JLRDeclaredRouteHandlerProvider)declaredRouteHandlerProvider{
+    return JLRGlobal_declaredRouteHandlerProvider;
+}
+
 @end
 
 
@@ -0,0 +1,795 @@
+//
+//  YLReaderBenchmark.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  阅读器排版流水线的基准测试，只依赖 YLTextCore，可在 Linux 上运行。
+//  生成中文与英文两份多兆的语料（内嵌 ImageLink 与 WebLink 标签），对每份语料测量：
+//    标签处理速度、单线程与多线程分页速度（页/秒）、首页耗时（处理并分页第一章）、
+//    分页期间的内存分配次数与堆内存峰值、点击查找行与段的耗时，
+//    UTF-8 校验与 GB18030、UTF-16 转码为 UTF-8 的速度（按输入字节计），以及在 UTF-8 正文中建立目录的速度；
+//    结果以 JSON 输出，便于跟踪回归。
+//
+//  编译（在本文件所在目录）：
+//    cc -O2 -std=gnu11 -pthread -I../YLReaderSDK/YLTextCore YLReaderBenchmark.c ../YLReaderSDK/YLTextCore/*.c -o YLReaderBenchmark
+//  在 Linux（glibc）上统计内存分配，需要加上：
+//    -DYL_BENCHMARK_COUNT_ALLOCATIONS -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+//  运行：
+//    ./YLReaderBenchmark [--chars 4000000] [--threads 0] [--iterations 3] [--seed 1] [--output result.json]
+//
+
+#include "YLBookFile.h"
+#include "YLBookTOC.h"
+#include "YLTextEncoding.h"
+#include "YLTextLayout.h"
+#include "YLTextMarkup.h"
+#include "YLTextGeometry.h"
+#include "YLTextParallelLayout.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uchar.h>
+#include <sys/resource.h>
+
+/// 页面尺寸与字号，与 iPhone 上的默认排版相近
+static const double kYLBenchPageWidth = 355;
+static const double kYLBenchPageHeight = 712;
+static const double kYLBenchFontSize = 15;
+/// 点击测试抽样的页数与每页的点击次数
+static const size_t kYLBenchHitTestPages = 512;
+static const size_t kYLBenchHitTestsPerPage = 1024;
+
+// MARK: - 内存分配统计
+
+/// 通过链接器的 --wrap 替换本程序与 YLTextCore 中的 malloc 等函数，不统计 libc 内部的分配
+#ifdef YL_BENCHMARK_COUNT_ALLOCATIONS
+#include <malloc.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+
+static atomic_size_t allocationCount;
+static atomic_size_t liveBytes;
+static atomic_size_t peakBytes;
+
+static void recordAllocation(void *pointer){
+    if (pointer == NULL) {
+        return;
+    }
+    atomic_fetch_add(&allocationCount, 1);
+    size_t live = atomic_fetch_add(&liveBytes, malloc_usable_size(pointer)) + malloc_usable_size(pointer);
+    size_t peak = atomic_load(&peakBytes);
+    while (live > peak && !atomic_compare_exchange_weak(&peakBytes, &peak, live)) {}
+}
+
+static void recordFree(void *pointer){
+    if (pointer) {
+        atomic_fetch_sub(&liveBytes, malloc_usable_size(pointer));
+    }
+}
+
+void *__wrap_malloc(size_t size){
+    void *pointer = __real_malloc(size);
+    recordAllocation(pointer);
+    return pointer;
+}
+
+void *__wrap_calloc(size_t count, size_t size){
+    void *pointer = __real_calloc(count, size);
+    recordAllocation(pointer);
+    return pointer;
+}
+
+void *__wrap_realloc(void *pointer, size_t size){
+    recordFree(pointer);
+    void *result = __real_realloc(pointer, size);
+    //失败时原内存仍然有效
+    recordAllocation(result ? result : (size ? pointer : NULL));
+    return result;
+}
+
+void __wrap_free(void *pointer){
+    recordFree(pointer);
+    __real_free(pointer);
+}
+
+static const bool countsAllocations = true;
+
+/// 开始统计：清零分配次数，峰值从当前占用开始
+static void resetAllocationCounters(void){
+    atomic_store(&allocationCount, 0);
+    atomic_store(&peakBytes, atomic_load(&liveBytes));
+}
+#else
+static const bool countsAllocations = false;
+static atomic_size_t allocationCount;
+static atomic_size_t liveBytes;
+static atomic_size_t peakBytes;
+static void resetAllocationCounters(void){}
+#endif
+
+// MARK: - 计时
+
+static double now(void){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/// 进程的常驻内存峰值（KB）
+static long maxResidentKB(void){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// MARK: - 语料生成
+
+typedef struct YLBenchBuffer {
+    uint16_t *chars;
+    size_t length;
+    size_t capacity;
+} YLBenchBuffer;
+
+static void bufferReserve(YLBenchBuffer *buffer, size_t length){
+    if (buffer->length + length <= buffer->capacity) {
+        return;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->length + length) {
+        capacity *= 2;
+    }
+    uint16_t *chars = realloc(buffer->chars, capacity * sizeof(uint16_t));
+    if (chars == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    buffer->chars = chars;
+    buffer->capacity = capacity;
+}
+
+static void bufferAppend(YLBenchBuffer *buffer, const uint16_t *chars, size_t length){
+    bufferReserve(buffer, length);
+    memcpy(buffer->chars + buffer->length, chars, length * sizeof(uint16_t));
+    buffer->length += length;
+}
+
+static void bufferAppendChar(YLBenchBuffer *buffer, uint16_t c){
+    bufferAppend(buffer, &c, 1);
+}
+
+static void bufferAppendASCII(YLBenchBuffer *buffer, const char *string){
+    size_t length = strlen(string);
+    bufferReserve(buffer, length);
+    for (size_t i = 0; i < length; i++) {
+        buffer->chars[buffer->length++] = (uint8_t)string[i];
+    }
+}
+
+/// 可复现的伪随机数（xorshift64）
+static uint64_t randomNext(uint64_t *state){
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static size_t randomIn(uint64_t *state, size_t low, size_t high){
+    return low + (size_t)(randomNext(state) % (high - low + 1));
+}
+
+static const char16_t kYLBenchHanzi[] = u"的一是在不了有和人这中大为上个国我以要他时来用们生到作地于出就分对成会可主发年动同工也能下过子说产种面而方后多定行学法所民得经十三之进着等部度家电力里如水化高自二理起小物现实加量都两体制机当使点从业本去把性好应开它合还因由其些然前外天政四日那社义事平形相全表间样与关各重新线内数正心反你明看原又么利比或但质气第向道命此变条只没结解问意建月公无系军很情者最立代想已通并提直题党程展五果料象员革位入常文总次品式活设及管特件长求老头基资边流路级少图山统接知较将组见计别她手角期根论运农指几九区强放决西被干做必战先回则任取据处队南给色光门即保治北造百规热领七海口东导器压志世金增争济阶油思术极交受联什认六共权收证改清己美再采转更单风切打白教速花带安场身车例真务具万每目至达走积示议声报斗完类八离华名确才科张信马节话米整空元况今集温传土许步群广石记需段研界拉林律叫且究观越织装影算低持音众书布复容儿须际商非验连断深难近矿千周委素技备半办青省列习响约支般史感劳便团往酸历市克何除消构府称太准精值号率族维划选标写存候毛亲快效斯院查江型眼王按格养易置派层片始却专状育厂京识适属圆包火住调满县局照参红细引听该铁价严";
+static const char16_t kYLBenchClauseEnds[] = u"，，，。。！？；";
+
+static void appendHanzi(YLBenchBuffer *buffer, uint64_t *state, size_t count){
+    size_t poolSize = sizeof(kYLBenchHanzi) / sizeof(char16_t) - 1;
+    bufferReserve(buffer, count);
+    for (size_t i = 0; i < count; i++) {
+        buffer->chars[buffer->length++] = kYLBenchHanzi[randomNext(state) % poolSize];
+    }
+}
+
+static const char *const kYLBenchWords[] = {
+    "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be", "by", "on", "not", "he",
+    "this", "are", "or", "his", "from", "at", "which", "but", "have", "an", "had", "they", "you", "were", "their",
+    "mountain", "village", "stone", "darkness", "quietly", "remembered", "extraordinary", "conversation", "nevertheless",
+    "well-known", "afternoon", "river", "(again)", "whispered", "lantern", "internationalization", "journey", "silence",
+};
+
+typedef enum YLBenchLanguage {
+    YLBenchLanguageChinese = 0,
+    YLBenchLanguageEnglish,
+} YLBenchLanguage;
+
+/// 生成的语料：带标签的原文，以及每章在原文中的起始位置
+typedef struct YLBenchCorpus {
+    const char *name;
+    YLBenchBuffer text;
+    size_t *chapterStarts;
+    size_t chapterCount;
+} YLBenchCorpus;
+
+static void appendLinks(YLBenchBuffer *text, uint64_t *state, size_t serial, bool image){
+    char tag[160];
+    if (image) {
+        snprintf(tag, sizeof(tag), "<ImageLink:https://img.example.com/book/%zu.jpg>\n", serial);
+        bufferAppendASCII(text, tag);
+    } else if (randomNext(state) % 2) {
+        snprintf(tag, sizeof(tag), "<WebLink:link=https://www.example.com/notes/%zu,title=", serial);
+        bufferAppendASCII(text, tag);
+        appendHanzi(text, state, randomIn(state, 2, 6));
+        bufferAppendChar(text, '>');
+    } else {
+        snprintf(tag, sizeof(tag), "<WebLink:link=https://www.example.com/ref?id=%zu,page=2,title=reference %zu>", serial, serial);
+        bufferAppendASCII(text, tag);
+    }
+}
+
+/** 生成约 length 个码元的语料
+ * 每章 4000～16000 码元；约每 20 段一张图片（独占一段），约每 8 段一个网页链接（段落中间）
+ */
+static YLBenchCorpus generateCorpus(YLBenchLanguage language, size_t length, uint64_t seed){
+    YLBenchCorpus corpus = {language == YLBenchLanguageChinese ? "cjk" : "latin", {NULL, 0, 0}, NULL, 0};
+    uint64_t state = seed * 2654435761u + language + 1;
+    size_t chapterCapacity = 0;
+    size_t serial = 0;
+    char heading[64];
+    while (corpus.text.length < length) {
+        if (corpus.chapterCount == chapterCapacity) {
+            chapterCapacity = chapterCapacity ? chapterCapacity * 2 : 64;
+            corpus.chapterStarts = realloc(corpus.chapterStarts, chapterCapacity * sizeof(size_t));
+        }
+        corpus.chapterStarts[corpus.chapterCount++] = corpus.text.length;
+        //英文章节以换页符开头，YLTextFindPageBreaks 同样据此分页
+        if (language == YLBenchLanguageChinese) {
+            bufferAppendChar(&corpus.text, u'第');
+            snprintf(heading, sizeof(heading), "%zu", corpus.chapterCount);
+            bufferAppendASCII(&corpus.text, heading);
+            bufferAppendChar(&corpus.text, u'章');
+            bufferAppendChar(&corpus.text, ' ');
+            appendHanzi(&corpus.text, &state, randomIn(&state, 2, 8));
+            bufferAppendChar(&corpus.text, '\n');
+        } else {
+            snprintf(heading, sizeof(heading), "\fChapter %zu\n", corpus.chapterCount);
+            bufferAppendASCII(&corpus.text, heading);
+        }
+        size_t chapterEnd = corpus.text.length + randomIn(&state, 4000, 16000);
+        while (corpus.text.length < chapterEnd) {
+            size_t kind = randomNext(&state) % 40;
+            if (kind < 2) {
+                appendLinks(&corpus.text, &state, serial++, true);
+                continue;
+            }
+            size_t sentenceCount = randomIn(&state, 2, 8);
+            if (language == YLBenchLanguageChinese) {
+                bufferAppendChar(&corpus.text, 0x3000);
+                bufferAppendChar(&corpus.text, 0x3000);
+                for (size_t i = 0; i < sentenceCount; i++) {
+                    appendHanzi(&corpus.text, &state, randomIn(&state, 4, 24));
+                    if (kind < 7 && i == sentenceCount / 2) {
+                        appendLinks(&corpus.text, &state, serial++, false);
+                    }
+                    bufferAppendChar(&corpus.text, kYLBenchClauseEnds[randomNext(&state) % 8]);
+                }
+            } else {
+                size_t wordCount = sizeof(kYLBenchWords) / sizeof(kYLBenchWords[0]);
+                for (size_t i = 0; i < sentenceCount; i++) {
+                    size_t words = randomIn(&state, 5, 20);
+                    for (size_t j = 0; j < words; j++) {
+                        bufferAppendASCII(&corpus.text, kYLBenchWords[randomNext(&state) % wordCount]);
+                        bufferAppendChar(&corpus.text, j + 1 == words ? '.' : ' ');
+                    }
+                    if (kind < 7 && i == sentenceCount / 2) {
+                        bufferAppendChar(&corpus.text, ' ');
+                        appendLinks(&corpus.text, &state, serial++, false);
+                    }
+                    bufferAppendChar(&corpus.text, ' ');
+                }
+            }
+            bufferAppendChar(&corpus.text, '\n');
+        }
+    }
+    return corpus;
+}
+
+static void destroyCorpus(YLBenchCorpus *corpus){
+    free(corpus->text.chars);
+    free(corpus->chapterStarts);
+}
+
+// MARK: - 编码
+
+/// 各编码的语料
+typedef struct YLBenchEncodedText {
+    uint8_t *utf8;
+    size_t utf8Length;
+    uint8_t *utf16;
+    size_t utf16Length;
+    uint8_t *gb18030;
+    size_t gb18030Length;
+} YLBenchEncodedText;
+
+/// 语料只含 BMP 字符；GB18030 只用到双字节码位，由解码表反查
+static YLBenchEncodedText encodeCorpus(const YLBenchCorpus *corpus){
+    uint16_t *gbCodes = calloc(65536, sizeof(uint16_t));
+    for (unsigned lead = 0x81; lead <= 0xFE; lead++) {
+        for (unsigned trail = 0x40; trail <= 0xFE; trail++) {
+            uint16_t c = YLTextGB18030DecodeTwoByte((uint8_t)lead, (uint8_t)trail);
+            if (c && gbCodes[c] == 0) {
+                gbCodes[c] = (uint16_t)(lead << 8 | trail);
+            }
+        }
+    }
+    const uint16_t *chars = corpus->text.chars;
+    size_t length = corpus->text.length;
+    YLBenchEncodedText encoded;
+    encoded.utf8 = malloc(length * 3);
+    encoded.utf16 = malloc(length * 2);
+    encoded.gb18030 = malloc(length * 2);
+    size_t utf8 = 0, gb18030 = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint16_t c = chars[i];
+        encoded.utf16[i * 2] = (uint8_t)c;
+        encoded.utf16[i * 2 + 1] = (uint8_t)(c >> 8);
+        if (c < 0x80) {
+            encoded.utf8[utf8++] = (uint8_t)c;
+            encoded.gb18030[gb18030++] = (uint8_t)c;
+            continue;
+        }
+        if (c < 0x800) {
+            encoded.utf8[utf8++] = (uint8_t)(0xC0 | (c >> 6));
+        } else {
+            encoded.utf8[utf8++] = (uint8_t)(0xE0 | (c >> 12));
+            encoded.utf8[utf8++] = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+        }
+        encoded.utf8[utf8++] = (uint8_t)(0x80 | (c & 0x3F));
+        if (gbCodes[c]) {
+            encoded.gb18030[gb18030++] = (uint8_t)(gbCodes[c] >> 8);
+            encoded.gb18030[gb18030++] = (uint8_t)gbCodes[c];
+        } else {
+            encoded.gb18030[gb18030++] = '?';
+        }
+    }
+    encoded.utf8Length = utf8;
+    encoded.utf16Length = length * 2;
+    encoded.gb18030Length = gb18030;
+    free(gbCodes);
+    return encoded;
+}
+
+static void destroyEncodedText(YLBenchEncodedText *encoded){
+    free(encoded->utf8);
+    free(encoded->utf16);
+    free(encoded->gb18030);
+}
+
+/// 与 YLBookFileOpen 一致，按块转码
+static double measureTranscode(YLTextEncoding encoding, const uint8_t *bytes, size_t length, uint8_t *output){
+    double start = now();
+    YLTextTranscoder *transcoder = YLTextTranscoderCreate(encoding);
+    for (size_t offset = 0; offset < length; offset += YLBookFileTranscodeChunkLength) {
+        size_t chunk = length - offset < YLBookFileTranscodeChunkLength ? length - offset : YLBookFileTranscodeChunkLength;
+        YLTextTranscoderConvert(transcoder, bytes + offset, chunk, offset + chunk >= length, output);
+    }
+    YLTextTranscoderDestroy(transcoder);
+    return now() - start;
+}
+
+// MARK: - 标签处理
+
+/// 处理标签后的正文：与 handleAttrString 一致，图片替换为占位符，网页链接替换为标题（没有标题时为地址），链接使用样式 1
+typedef struct YLBenchDocument {
+    YLBenchBuffer text;
+    YLTextStyleRun *runs;
+    size_t runCount;
+    size_t imageCount;
+    size_t linkCount;
+} YLBenchDocument;
+
+static void documentAddRun(YLBenchDocument *document, size_t *runCapacity, size_t location, size_t length, YLTextStyleID style){
+    if (length == 0) {
+        return;
+    }
+    if (document->runCount == *runCapacity) {
+        *runCapacity = *runCapacity ? *runCapacity * 2 : 256;
+        document->runs = realloc(document->runs, *runCapacity * sizeof(YLTextStyleRun));
+    }
+    document->runs[document->runCount++] = (YLTextStyleRun){location, length, style};
+}
+
+static YLBenchDocument handleMarkup(const uint16_t *chars, size_t length){
+    YLBenchDocument document;
+    memset(&document, 0, sizeof(YLBenchDocument));
+    size_t runCapacity = 0;
+    YLTextMarkupToken *tokens = NULL;
+    size_t tokenCount = YLTextMarkupScan(chars, length, &tokens);
+    bufferReserve(&document.text, length);
+    size_t location = 0;
+    size_t runStart = 0;
+    for (size_t i = 0; i < tokenCount; i++) {
+        const YLTextMarkupToken *token = &tokens[i];
+        bufferAppend(&document.text, chars + location, token->range.location - location);
+        if (token->kind == YLTextMarkupImageLink) {
+            bufferAppendChar(&document.text, YLTextAttachmentCharacter);
+            document.imageCount++;
+        } else {
+            documentAddRun(&document, &runCapacity, runStart, document.text.length - runStart, 0);
+            YLTextMarkupRange title = token->title.length ? token->title : token->link;
+            size_t titleStart = document.text.length;
+            bufferAppend(&document.text, chars + title.location, title.length);
+            documentAddRun(&document, &runCapacity, titleStart, title.length, 1);
+            runStart = document.text.length;
+            document.linkCount++;
+        }
+        location = token->range.location + token->range.length;
+    }
+    bufferAppend(&document.text, chars + location, length - location);
+    documentAddRun(&document, &runCapacity, runStart, document.text.length - runStart, 0);
+    free(tokens);
+    return document;
+}
+
+static void destroyDocument(YLBenchDocument *document){
+    free(document->text.chars);
+    free(document->runs);
+}
+
+static YLTextSource documentSource(const YLBenchDocument *document){
+    YLTextSource source = {document->text.chars, document->text.length, document->runs, document->runCount};
+    return source;
+}
+
+// MARK: - 点击测试
+
+/// 按样式段把一行切成若干段，记录到 geometry 中
+static void addLineToGeometry(YLTextGeometry *geometry, const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLine *line, size_t *runIndex, double *advances){
+    YLTextGeometryRect frame = {0, line->top, line->width, line->ascent + line->descent + line->leading};
+    YLTextFontMetrics font = {line->ascent, line->descent, line->leading};
+    YLTextGeometryAddLine(geometry, frame, font, line->location, line->length);
+    size_t end = line->location + line->length;
+    while (*runIndex + 1 < source->runCount && source->runs[*runIndex].location + source->runs[*runIndex].length <= line->location) {
+        (*runIndex)++;
+    }
+    double x = 0;
+    size_t location = line->location;
+    for (size_t i = *runIndex; i < source->runCount && location < end; i++) {
+        const YLTextStyleRun *run = &source->runs[i];
+        size_t runEnd = run->location + run->length < end ? run->location + run->length : end;
+        if (runEnd <= location) {
+            continue;
+        }
+        metrics->measure(metrics->context, run->style, source->chars + location, runEnd - location, advances);
+        double width = 0;
+        for (size_t j = 0; j < runEnd - location; j++) {
+            width += advances[j];
+        }
+        YLTextGeometryAddRun(geometry, x, x + width, location, runEnd - location);
+        x += width;
+        location = runEnd;
+    }
+}
+
+typedef struct YLBenchHitTest {
+    double buildMicroseconds; //每页建立几何索引的耗时
+    double hitNanoseconds;    //每次点击查找行与段的耗时
+    size_t checksum;          //防止查找被优化掉
+} YLBenchHitTest;
+
+static YLBenchHitTest measureHitTest(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutResult *layout, uint64_t seed){
+    YLBenchHitTest hitTest = {0, 0, 0};
+    size_t step = layout->pageCount > kYLBenchHitTestPages ? layout->pageCount / kYLBenchHitTestPages : 1;
+    double *advances = malloc(source->length * sizeof(double));
+    double *xs = malloc(kYLBenchHitTestsPerPage * 2 * sizeof(double));
+    uint64_t state = seed + 7;
+    double buildTime = 0, hitTime = 0;
+    size_t pageCount = 0, hitCount = 0;
+    size_t runIndex = 0;
+    for (size_t page = 0; page < layout->pageCount; page += step) {
+        const YLTextPage *textPage = &layout->pages[page];
+        YLTextGeometry geometry;
+        YLTextGeometryInit(&geometry);
+        double start = now();
+        for (size_t i = 0; i < textPage->lineCount; i++) {
+            addLineToGeometry(&geometry, source, metrics, &layout->lines[textPage->firstLine + i], &runIndex, advances);
+        }
+        buildTime += now() - start;
+
+        for (size_t i = 0; i < kYLBenchHitTestsPerPage; i++) {
+            xs[2 * i] = (double)(randomNext(&state) % (uint64_t)kYLBenchPageWidth);
+            xs[2 * i + 1] = (double)(randomNext(&state) % (uint64_t)kYLBenchPageHeight);
+        }
+        start = now();
+        for (size_t i = 0; i < kYLBenchHitTestsPerPage; i++) {
+            size_t line = YLTextGeometryLineAtPoint(&geometry, xs[2 * i], xs[2 * i + 1], 4);
+            if (line != YLTextGeometryNotFound) {
+                hitTest.checksum += YLTextGeometryRunAtX(&geometry, line, xs[2 * i]);
+            }
+        }
+        hitTime += now() - start;
+        hitCount += kYLBenchHitTestsPerPage;
+        pageCount++;
+        YLTextGeometryDestroy(&geometry);
+    }
+    free(advances);
+    free(xs);
+    hitTest.buildMicroseconds = pageCount ? buildTime / pageCount * 1e6 : 0;
+    hitTest.hitNanoseconds = hitCount ? hitTime / hitCount * 1e9 : 0;
+    return hitTest;
+}
+
+// MARK: - 基准测试
+
+typedef struct YLBenchOptions {
+    size_t chars;
+    size_t threads;
+    size_t iterations;
+    uint64_t seed;
+    const char *output;
+} YLBenchOptions;
+
+typedef struct YLBenchReport {
+    const char *name;
+    size_t chars;
+    size_t handledChars;
+    size_t chapters;
+    size_t images;
+    size_t links;
+    size_t pages;
+    double markupMBPerSecond;
+    double pagesPerSecond;
+    double parallelPagesPerSecond;
+    double timeToFirstPageMs;
+    double utf8ValidateMBPerSecond;
+    double gb18030ToUTF8MBPerSecond;
+    double utf16ToUTF8MBPerSecond;
+    double tocMBPerSecond;
+    size_t tocEntries;
+    double allocationsPerPage;
+    size_t peakHeapBytes;
+    YLBenchHitTest hitTest;
+} YLBenchReport;
+
+static void initMetrics(YLFixedTextStyle styles[2], YLFixedTextMetrics *fixed){
+    YLFixedTextStyleInit(&styles[0], kYLBenchFontSize);
+    YLFixedTextStyleInit(&styles[1], kYLBenchFontSize + 1);
+    memset(fixed, 0, sizeof(YLFixedTextMetrics));
+    fixed->styles = styles;
+    fixed->styleCount = 2;
+    fixed->defaultAttachmentSize = (YLTextSize){kYLBenchPageWidth, kYLBenchPageWidth * 0.6};
+}
+
+static YLTextLayoutConfig layoutConfig(bool storesLines, const size_t *breaks, size_t breakCount){
+    YLTextLayoutConfig config = {kYLBenchPageWidth, kYLBenchPageHeight, 4, 8, storesLines, breaks, breakCount};
+    return config;
+}
+
+/// 整篇文本的强制分页位置；内存不足时退出
+static size_t findPageBreaks(const YLTextSource *source, size_t **breaks){
+    size_t count = 0;
+    if (!YLTextFindPageBreaks(source, 0, source->length, breaks, &count)) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return count;
+}
+
+/// 首页耗时：与阅读器打开书籍时一致，处理第一章的标签并分页
+static double measureFirstPage(const YLBenchCorpus *corpus, const YLTextMetrics *metrics){
+    double start = now();
+    size_t length = corpus->chapterCount > 1 ? corpus->chapterStarts[1] : corpus->text.length;
+    YLBenchDocument document = handleMarkup(corpus->text.chars, length);
+    YLTextSource source = documentSource(&document);
+    size_t *breaks = NULL;
+    size_t breakCount = findPageBreaks(&source, &breaks);
+    YLTextLayoutConfig config = layoutConfig(true, breaks, breakCount);
+    YLTextLayoutResult result;
+    YLTextLayoutResultInit(&result);
+    YLTextLayoutPaginate(&source, metrics, &config, 0, source.length, &result);
+    double duration = now() - start;
+    YLTextLayoutResultDestroy(&result);
+    free(breaks);
+    destroyDocument(&document);
+    return duration;
+}
+
+static YLBenchReport runCorpus(YLBenchLanguage language, const YLBenchOptions *options, const YLTextMetrics *metrics){
+    YLBenchCorpus corpus = generateCorpus(language, options->chars, options->seed);
+    YLBenchReport report;
+    memset(&report, 0, sizeof(YLBenchReport));
+    report.name = corpus.name;
+    report.chars = corpus.text.length;
+    report.chapters = corpus.chapterCount;
+
+    double markupTime = 0, sequentialTime = 0, parallelTime = 0, firstPageTime = 0;
+    double validateTime = 0, gb18030Time = 0, utf16Time = 0, tocTime = 0;
+    YLBenchEncodedText encoded = encodeCorpus(&corpus);
+    uint8_t *transcoded = malloc(YLTextTranscoderMaxOutputLength(YLBookFileTranscodeChunkLength));
+    YLBookTOCMatcher *matcher = YLBookTOCMatcherCreate(YLBookTOCDefaultPatterns, YLBookTOCDefaultPatternCount);
+    for (size_t iteration = 0; iteration < options->iterations; iteration++) {
+        double start = now();
+        YLBenchDocument document = handleMarkup(corpus.text.chars, corpus.text.length);
+        double duration = now() - start;
+        markupTime = iteration == 0 || duration < markupTime ? duration : markupTime;
+        YLTextSource source = documentSource(&document);
+        size_t *breaks = NULL;
+        size_t breakCount = findPageBreaks(&source, &breaks);
+        report.handledChars = source.length;
+        report.images = document.imageCount;
+        report.links = document.linkCount;
+
+        //单线程分页，只保留页码范围；统计分配次数与堆内存峰值
+        YLTextLayoutConfig config = layoutConfig(false, breaks, breakCount);
+        YLTextLayoutResult result;
+        YLTextLayoutResultInit(&result);
+        size_t baselineBytes = atomic_load(&liveBytes);
+        resetAllocationCounters();
+        start = now();
+        YLTextLayoutPaginate(&source, metrics, &config, 0, source.length, &result);
+        duration = now() - start;
+        sequentialTime = iteration == 0 || duration < sequentialTime ? duration : sequentialTime;
+        report.pages = result.pageCount;
+        if (countsAllocations && result.pageCount) {
+            report.allocationsPerPage = (double)atomic_load(&allocationCount) / result.pageCount;
+            report.peakHeapBytes = atomic_load(&peakBytes) - baselineBytes;
+        }
+        YLTextLayoutResultDestroy(&result);
+
+        //多线程分页
+        YLTextLayoutResultInit(&result);
+        start = now();
+        YLTextLayoutPaginateParallel(&source, metrics, &config, 0, source.length, options->threads, &result);
+        duration = now() - start;
+        parallelTime = iteration == 0 || duration < parallelTime ? duration : parallelTime;
+        YLTextLayoutResultDestroy(&result);
+
+        //保留每一行再分页一次，用于点击测试
+        if (iteration == 0) {
+            config.storesLines = true;
+            YLTextLayoutResultInit(&result);
+            YLTextLayoutPaginate(&source, metrics, &config, 0, source.length, &result);
+            report.hitTest = measureHitTest(&source, metrics, &result, options->seed);
+            YLTextLayoutResultDestroy(&result);
+        }
+        free(breaks);
+        destroyDocument(&document);
+
+        duration = measureFirstPage(&corpus, metrics);
+        firstPageTime = iteration == 0 || duration < firstPageTime ? duration : firstPageTime;
+
+        start = now();
+        if (YLTextUTF8ValidLength(encoded.utf8, encoded.utf8Length) != encoded.utf8Length) {
+            fprintf(stderr, "%s: invalid UTF-8 corpus\n", corpus.name);
+        }
+        duration = now() - start;
+        validateTime = iteration == 0 || duration < validateTime ? duration : validateTime;
+        duration = measureTranscode(YLTextEncodingGB18030, encoded.gb18030, encoded.gb18030Length, transcoded);
+        gb18030Time = iteration == 0 || duration < gb18030Time ? duration : gb18030Time;
+        duration = measureTranscode(YLTextEncodingUTF16LE, encoded.utf16, encoded.utf16Length, transcoded);
+        utf16Time = iteration == 0 || duration < utf16Time ? duration : utf16Time;
+
+        //中文章节由「第…章」标题匹配，英文章节由换页符确定
+        YLBookTOCEntry *entries = NULL;
+        start = now();
+        YLBookTOCBuild(matcher, encoded.utf8, 0, encoded.utf8Length, options->threads, &entries, &report.tocEntries);
+        duration = now() - start;
+        tocTime = iteration == 0 || duration < tocTime ? duration : tocTime;
+        free(entries);
+    }
+    report.markupMBPerSecond = corpus.text.length * sizeof(uint16_t) / markupTime / (1024 * 1024);
+    report.pagesPerSecond = report.pages / sequentialTime;
+    report.parallelPagesPerSecond = report.pages / parallelTime;
+    report.timeToFirstPageMs = firstPageTime * 1000;
+    report.utf8ValidateMBPerSecond = encoded.utf8Length / validateTime / (1024 * 1024);
+    report.gb18030ToUTF8MBPerSecond = encoded.gb18030Length / gb18030Time / (1024 * 1024);
+    report.utf16ToUTF8MBPerSecond = encoded.utf16Length / utf16Time / (1024 * 1024);
+    report.tocMBPerSecond = encoded.utf8Length / tocTime / (1024 * 1024);
+    YLBookTOCMatcherDestroy(matcher);
+    free(transcoded);
+    destroyEncodedText(&encoded);
+    destroyCorpus(&corpus);
+    return report;
+}
+
+static void writeReport(FILE *file, const YLBenchOptions *options, const YLBenchReport *reports, size_t count){
+    fprintf(file, "{\n");
+    fprintf(file, "  \"benchmark\": \"YLReaderBenchmark\",\n");
+    fprintf(file, "  \"config\": {\"chars\": %zu, \"threads\": %zu, \"iterations\": %zu, \"seed\": %llu, \"pageWidth\": %g, \"pageHeight\": %g, \"fontSize\": %g},\n",
+            options->chars, options->threads, options->iterations, (unsigned long long)options->seed, kYLBenchPageWidth, kYLBenchPageHeight, kYLBenchFontSize);
+    fprintf(file, "  \"corpora\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        const YLBenchReport *report = &reports[i];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", report->name);
+        fprintf(file, "      \"chars\": %zu,\n", report->chars);
+        fprintf(file, "      \"handledChars\": %zu,\n", report->handledChars);
+        fprintf(file, "      \"chapters\": %zu,\n", report->chapters);
+        fprintf(file, "      \"images\": %zu,\n", report->images);
+        fprintf(file, "      \"links\": %zu,\n", report->links);
+        fprintf(file, "      \"pages\": %zu,\n", report->pages);
+        fprintf(file, "      \"markupMBPerSecond\": %.2f,\n", report->markupMBPerSecond);
+        fprintf(file, "      \"pagesPerSecond\": %.1f,\n", report->pagesPerSecond);
+        fprintf(file, "      \"parallelPagesPerSecond\": %.1f,\n", report->parallelPagesPerSecond);
+        fprintf(file, "      \"timeToFirstPageMs\": %.3f,\n", report->timeToFirstPageMs);
+        fprintf(file, "      \"utf8ValidateMBPerSecond\": %.1f,\n", report->utf8ValidateMBPerSecond);
+        fprintf(file, "      \"gb18030ToUTF8MBPerSecond\": %.1f,\n", report->gb18030ToUTF8MBPerSecond);
+        fprintf(file, "      \"utf16ToUTF8MBPerSecond\": %.1f,\n", report->utf16ToUTF8MBPerSecond);
+        fprintf(file, "      \"tocMBPerSecond\": %.1f,\n", report->tocMBPerSecond);
+        fprintf(file, "      \"tocEntries\": %zu,\n", report->tocEntries);
+        if (countsAllocations) {
+            fprintf(file, "      \"allocationsPerPage\": %.4f,\n", report->allocationsPerPage);
+            fprintf(file, "      \"peakHeapBytes\": %zu,\n", report->peakHeapBytes);
+        } else {
+            fprintf(file, "      \"allocationsPerPage\": null,\n");
+            fprintf(file, "      \"peakHeapBytes\": null,\n");
+        }
+        fprintf(file, "      \"geometryBuildMicrosecondsPerPage\": %.3f,\n", report->hitTest.buildMicroseconds);
+        fprintf(file, "      \"hitTestNanoseconds\": %.1f\n", report->hitTest.hitNanoseconds);
+        fprintf(file, "    }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ],\n");
+    fprintf(file, "  \"maxResidentKB\": %ld\n", maxResidentKB());
+    fprintf(file, "}\n");
+}
+
+static void printUsage(const char *name){
+    fprintf(stderr, "usage: %s [--chars N] [--threads N] [--iterations N] [--seed N] [--output PATH]\n", name);
+}
+
+int main(int argc, const char *argv[]){
+    YLBenchOptions options = {4000000, 0, 3, 1, NULL};
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--chars") == 0) {
+            options.chars = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--threads") == 0) {
+            options.threads = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--iterations") == 0) {
+            options.iterations = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--seed") == 0) {
+            options.seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--output") == 0) {
+            options.output = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.chars == 0 || options.iterations == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    YLFixedTextStyle styles[2];
+    YLFixedTextMetrics fixed;
+    initMetrics(styles, &fixed);
+    YLTextMetrics metrics = YLFixedTextMetricsMake(&fixed);
+
+    YLBenchReport reports[2];
+    reports[0] = runCorpus(YLBenchLanguageChinese, &options, &metrics);
+    reports[1] = runCorpus(YLBenchLanguageEnglish, &options, &metrics);
+
+    FILE *file = options.output ? fopen(options.output, "w") : stdout;
+    if (file == NULL) {
+        perror(options.output);
+        return 1;
+    }
+    writeReport(file, &options, reports, 2);
+    if (file != stdout) {
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+//
+//  YLBookAnnotations.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// 一条划线或笔记
+@interface YLBookAnnotation : NSObject
+
+@property (nonatomic, assign, readonly) uint64_t identifier;
+/// 全书字符范围（UTF-16，处理标签之前的原文位置），与检索结果、YLPageModel.bookLocation 一致
+@property (nonatomic, assign, readonly) NSRange range;
+/// 调用方定义的样式（如划线颜色）
+@property (nonatomic, assign, readonly) uint32_t style;
+@property (nonatomic, copy, readonly, nullable) NSString *note;
+
+@end
+
+
+/** 书籍的划线与笔记
+ * 按全书字符位置存储在区间树中（YLTextAnnotation），与分页无关，重新分页后标注仍在原来的文字上
+ * 修改后在后台保存
+ */
+@interface YLBookAnnotations : NSObject
+
+/** 打开书籍的标注，已保存的标注文件损坏时从空白开始
+ * @param path 书籍路径
+ */
+- (instancetype)initWithPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, copy, readonly) NSString *path;
+
+/** 标注文件路径
+ * 与书籍放在一起（书籍路径 + ".ylnotes"）；书籍所在目录不可写时（如 App 包内）放在 Application Support 目录
+ */
+@property (nonatomic, copy, readonly) NSString *storagePath;
+
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/** 添加标注
+ * @return range 为空时返回 nil
+ */
+- (nullable YLBookAnnotation *)addAnnotationWithRange:(NSRange)range style:(uint32_t)style note:(nullable NSString *)note;
+
+/** 修改样式与笔记，范围不变
+ * @return 修改后的标注；标注已被删除时返回 nil
+ */
+- (nullable YLBookAnnotation *)updateAnnotation:(YLBookAnnotation *)annotation style:(uint32_t)style note:(nullable NSString *)note;
+
+- (BOOL)removeAnnotation:(YLBookAnnotation *)annotation;
+
+/// 与 range 相交的标注，按位置排列
+- (NSArray<YLBookAnnotation *> *)annotationsInRange:(NSRange)range;
+
+/// 立即写入标注文件
+- (BOOL)save;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,163 @@
+//
+//  YLBookAnnotations.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLBookAnnotations.h"
+#import "YLTextAnnotation.h"
+
+/// 每页通常只有几条标注，超出时再按总数分配
+static const size_t kYLBookAnnotationsStackCount = 32;
+
+@interface YLBookAnnotation ()
+
+@property (nonatomic, assign, readwrite) uint64_t identifier;
+@property (nonatomic, assign, readwrite) NSRange range;
+@property (nonatomic, assign, readwrite) uint32_t style;
+@property (nonatomic, copy, readwrite) NSString *note;
+
+@end
+
+@implementation YLBookAnnotation
+
++ (instancetype)annotationWithValue:(const YLTextAnnotation *)value{
+    YLBookAnnotation *annotation = [[YLBookAnnotation alloc] init];
+    annotation.identifier = value->identifier;
+    annotation.range = NSMakeRange(value->location, value->length);
+    annotation.style = value->style;
+    annotation.note = value->note ? [NSString stringWithUTF8String:value->note] : nil;
+    return annotation;
+}
+
+@end
+
+
+@interface YLBookAnnotations ()
+{
+    YLTextAnnotationStore *_store;
+    /// 后台保存的串行队列
+    dispatch_queue_t _queue;
+    /// 已安排保存，尚未写入
+    BOOL _saveScheduled;
+}
+@end
+
+@implementation YLBookAnnotations
+
+- (instancetype)initWithPath:(NSString *)path{
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _queue = dispatch_queue_create("com.yl.bookAnnotations", DISPATCH_QUEUE_SERIAL);
+        NSString *directory = path.stringByDeletingLastPathComponent;
+        if ([NSFileManager.defaultManager isWritableFileAtPath:directory]) {
+            _storagePath = [path stringByAppendingPathExtension:@"ylnotes"];
+        } else {
+            NSString *support = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES).firstObject;
+            [NSFileManager.defaultManager createDirectoryAtPath:support withIntermediateDirectories:YES attributes:nil error:nil];
+            _storagePath = [[support stringByAppendingPathComponent:path.lastPathComponent] stringByAppendingPathExtension:@"ylnotes"];
+        }
+        _store = YLTextAnnotationStoreRead(_storagePath.fileSystemRepresentation) ?: YLTextAnnotationStoreCreate();
+    }
+    return self;
+}
+
+- (void)dealloc{
+    YLTextAnnotationStoreDestroy(_store);
+}
+
+- (NSUInteger)count{
+    @synchronized (self) {
+        return YLTextAnnotationStoreCount(_store);
+    }
+}
+
+- (YLBookAnnotation *)addAnnotationWithRange:(NSRange)range style:(uint32_t)style note:(NSString *)note{
+    @synchronized (self) {
+        uint64_t identifier = YLTextAnnotationStoreAdd(_store, range.location, range.length, style, note.UTF8String);
+        if (identifier == 0) {
+            return nil;
+        }
+        [self scheduleSave];
+        YLBookAnnotation *annotation = [[YLBookAnnotation alloc] init];
+        annotation.identifier = identifier;
+        annotation.range = range;
+        annotation.style = style;
+        annotation.note = note.length ? note : nil;
+        return annotation;
+    }
+}
+
+- (YLBookAnnotation *)updateAnnotation:(YLBookAnnotation *)annotation style:(uint32_t)style note:(NSString *)note{
+    @synchronized (self) {
+        if (!YLTextAnnotationStoreUpdate(_store, annotation.range.location, annotation.identifier, style, note.UTF8String)) {
+            return nil;
+        }
+        [self scheduleSave];
+        YLBookAnnotation *updated = [[YLBookAnnotation alloc] init];
+        updated.identifier = annotation.identifier;
+        updated.range = annotation.range;
+        updated.style = style;
+        updated.note = note.length ? note : nil;
+        return updated;
+    }
+}
+
+- (BOOL)removeAnnotation:(YLBookAnnotation *)annotation{
+    @synchronized (self) {
+        if (!YLTextAnnotationStoreRemove(_store, annotation.range.location, annotation.identifier)) {
+            return NO;
+        }
+        [self scheduleSave];
+        return YES;
+    }
+}
+
+- (NSArray<YLBookAnnotation *> *)annotationsInRange:(NSRange)range{
+    @synchronized (self) {
+        YLTextAnnotation stackResults[kYLBookAnnotationsStackCount];
+        YLTextAnnotation *results = stackResults;
+        size_t count = YLTextAnnotationStoreFind(_store, range.location, range.length, results, kYLBookAnnotationsStackCount);
+        if (count > kYLBookAnnotationsStackCount) {
+            results = malloc(count * sizeof(YLTextAnnotation));
+            if (results == NULL) {
+                return @[];
+            }
+            YLTextAnnotationStoreFind(_store, range.location, range.length, results, count);
+        }
+        NSMutableArray<YLBookAnnotation *> *annotations = [NSMutableArray arrayWithCapacity:count];
+        for (size_t i = 0; i < count; i++) {
+            [annotations addObject:[YLBookAnnotation annotationWithValue:&results[i]]];
+        }
+        if (results != stackResults) {
+            free(results);
+        }
+        return annotations;
+    }
+}
+
+#pragma mark - 保存
+
+- (BOOL)save{
+    @synchronized (self) {
+        return YLTextAnnotationStoreWrite(_store, self.storagePath.fileSystemRepresentation);
+    }
+}
+
+/// 连续的修改只保存一次
+- (void)scheduleSave{
+    if (_saveScheduled) {
+        return;
+    }
+    _saveScheduled = YES;
+    dispatch_async(_queue, ^{
+        @synchronized (self) {
+            self->_saveScheduled = NO;
+            YLTextAnnotationStoreWrite(self->_store, self.storagePath.fileSystemRepresentation);
+        }
+    });
+}
+
+@end
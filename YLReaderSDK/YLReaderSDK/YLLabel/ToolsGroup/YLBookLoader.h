@@ -0,0 +1,79 @@
+//
+//  YLBookLoader.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// 书籍中的一个章节
+@interface YLBookChapter : NSObject
+
+/// 章节在文件中的字节范围
+@property (nonatomic, assign) NSRange byteRange;
+/// 章节在全书中的字符范围（UTF-16）
+@property (nonatomic, assign) NSRange characterRange;
+/// 章节文本
+@property (nonatomic, copy) NSString *text;
+
+@end
+
+
+/// 目录中的一项
+@interface YLBookTOCItem : NSObject
+
+/// 标题文字
+@property (nonatomic, copy) NSString *title;
+/// 章节在文件中的字节位置
+@property (nonatomic, assign) NSUInteger byteOffset;
+
+@end
+
+
+/** 以内存映射方式读取书籍
+ * 打开时不读取全文，章节文本在需要时才解码，常驻内存与文件大小无关
+ * 支持 UTF-8、GB18030、UTF-16：非 UTF-8 的文件在打开时转码为 UTF-8，字节偏移以转码后的内容计算
+ */
+@interface YLBookLoader : NSObject
+
+/// 文件不存在或无法映射时返回 nil
+- (nullable instancetype)initWithPath:(NSString *)path;
+
+/// 文件原来的编码
+@property (nonatomic, readonly) NSStringEncoding sourceEncoding;
+
+/// 文件字节数（UTF-8）
+@property (nonatomic, readonly) NSUInteger byteLength;
+
+/// 第一章的字节位置（跳过 BOM）
+@property (nonatomic, readonly) NSUInteger contentStart;
+
+/** 读取从 byteOffset 开始的章节
+ * @return byteOffset 已到达文件末尾时返回 nil
+ */
+- (nullable YLBookChapter *)chapterAtByteOffset:(NSUInteger)byteOffset;
+
+/** 多线程查找章节标题，建立目录
+ * 之后 chapterAtByteOffset: 只在目录中的标题处分章，超过最大长度的章节仍在段落边界处切分
+ * 需要扫描全文，应在后台线程调用；查找期间不阻塞 chapterAtByteOffset:
+ * @param patterns 标题模式，语法见 YLBookTOC.h；为 nil 时使用默认模式（「第…章」等与「Chapter 1」）
+ * @return 模式有语法错误或内存不足时返回 nil，分章方式不变
+ */
+- (nullable NSArray<YLBookTOCItem *> *)buildTableOfContentsWithPatterns:(nullable NSArray<NSString *> *)patterns;
+
+/// 目录，建立之前为 nil
+@property (nonatomic, copy, readonly, nullable) NSArray<YLBookTOCItem *> *tableOfContents;
+
+/// 全书所有章节的字节范围，与从 contentStart 开始逐个读取章节得到的一致
+- (NSArray<NSValue *> *)chapterByteRanges;
+
+/// 字节偏移与字符偏移的换算
+- (NSUInteger)characterOffsetForByteOffset:(NSUInteger)byteOffset;
+- (NSUInteger)byteOffsetForCharacterOffset:(NSUInteger)characterOffset;
+
+@end
+
+NS_ASSUME_NONNULL_END
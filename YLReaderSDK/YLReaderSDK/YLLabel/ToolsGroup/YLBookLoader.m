@@ -0,0 +1,171 @@
+//
+//  YLBookLoader.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLBookLoader.h"
+#import "YLBookFile.h"
+#import "YLBookTOC.h"
+
+@implementation YLBookChapter
+
+@end
+
+
+@implementation YLBookTOCItem
+
+@end
+
+
+@interface YLBookLoader ()
+{
+    YLBookFile *_file;
+}
+@property (nonatomic, copy, readwrite) NSArray<YLBookTOCItem *> *tableOfContents;
+@end
+
+@implementation YLBookLoader
+
+- (void)dealloc{
+    YLBookFileClose(_file);
+}
+
+- (instancetype)initWithPath:(NSString *)path{
+    YLBookFile *file = path.length ? YLBookFileOpen(path.fileSystemRepresentation) : NULL;
+    if (file == NULL) {
+        return nil;
+    }
+    self = [super init];
+    if (self) {
+        _file = file;
+    } else {
+        YLBookFileClose(file);
+    }
+    return self;
+}
+
+- (NSStringEncoding)sourceEncoding{
+    switch (YLBookFileEncoding(_file)) {
+        case YLTextEncodingUTF16LE:
+            return NSUTF16LittleEndianStringEncoding;
+        case YLTextEncodingUTF16BE:
+            return NSUTF16BigEndianStringEncoding;
+        case YLTextEncodingGB18030:
+            return CFStringConvertEncodingToNSStringEncoding(kCFStringEncodingGB_18030_2000);
+        case YLTextEncodingUTF8:
+        default:
+            return NSUTF8StringEncoding;
+    }
+}
+
+- (NSUInteger)byteLength{
+    return YLBookFileLength(_file);
+}
+
+- (NSUInteger)contentStart{
+    return YLBookFileContentStart(_file);
+}
+
+- (YLBookChapter *)chapterAtByteOffset:(NSUInteger)byteOffset{
+    @synchronized (self) {
+        if (byteOffset >= YLBookFileLength(_file)) {
+            return nil;
+        }
+        byteOffset = MAX(byteOffset, YLBookFileContentStart(_file));
+        size_t byteEnd = YLBookFileChapterEnd(_file, byteOffset, YLBookFileDefaultChapterLength);
+        size_t length = YLBookFileCopyCharacters(_file, byteOffset, byteEnd, NULL);
+        unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+        if (characters == NULL) {
+            return nil;
+        }
+        YLBookFileCopyCharacters(_file, byteOffset, byteEnd, characters);
+
+        YLBookChapter *chapter = [[YLBookChapter alloc] init];
+        chapter.byteRange = NSMakeRange(byteOffset, byteEnd - byteOffset);
+        chapter.characterRange = NSMakeRange(YLBookFileCharacterOffset(_file, byteOffset), length);
+        chapter.text = [[NSString alloc] initWithCharactersNoCopy:characters length:length freeWhenDone:YES];
+        return chapter;
+    }
+}
+
+- (NSArray<YLBookTOCItem *> *)buildTableOfContentsWithPatterns:(NSArray<NSString *> *)patterns{
+    YLBookTOCMatcher *matcher;
+    if (patterns) {
+        const char *sources[MAX(patterns.count, 1)];
+        for (NSUInteger i = 0; i < patterns.count; i++) {
+            sources[i] = patterns[i].UTF8String;
+        }
+        matcher = YLBookTOCMatcherCreate(sources, patterns.count);
+    } else {
+        matcher = YLBookTOCMatcherCreate(YLBookTOCDefaultPatterns, YLBookTOCDefaultPatternCount);
+    }
+    if (matcher == NULL) {
+        return nil;
+    }
+    //映射的内容只读，查找标题与复制标题文字不必加锁，后台建立时不阻塞读取章节
+    YLBookTOCEntry *entries;
+    size_t count;
+    bool success = YLBookTOCBuild(matcher, YLBookFileBytes(_file), YLBookFileContentStart(_file), YLBookFileLength(_file), 0, &entries, &count);
+    YLBookTOCMatcherDestroy(matcher);
+    if (!success) {
+        return nil;
+    }
+    size_t *offsets = malloc(count * sizeof(size_t) + 1);
+    NSMutableArray<YLBookTOCItem *> *items = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; offsets && i < count; i++) {
+        offsets[i] = entries[i].byteOffset;
+        size_t titleEnd = entries[i].titleOffset + entries[i].titleLength;
+        size_t length = YLBookFileCopyCharacters(_file, entries[i].titleOffset, titleEnd, NULL);
+        unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+        if (characters == NULL) {
+            success = false;
+            break;
+        }
+        YLBookFileCopyCharacters(_file, entries[i].titleOffset, titleEnd, characters);
+
+        YLBookTOCItem *item = [[YLBookTOCItem alloc] init];
+        item.title = [[NSString alloc] initWithCharactersNoCopy:characters length:length freeWhenDone:YES];
+        item.byteOffset = entries[i].byteOffset;
+        [items addObject:item];
+    }
+    free(entries);
+    @synchronized (self) {
+        success = success && offsets && YLBookFileSetChapterHeadings(_file, offsets, count);
+        free(offsets);
+        if (!success) {
+            return nil;
+        }
+        self.tableOfContents = items;
+        return items;
+    }
+}
+
+- (NSArray<NSValue *> *)chapterByteRanges{
+    @synchronized (self) {
+        NSMutableArray<NSValue *> *ranges = [NSMutableArray array];
+        size_t length = YLBookFileLength(_file);
+        size_t byteOffset = YLBookFileContentStart(_file);
+        while (byteOffset < length) {
+            size_t byteEnd = YLBookFileChapterEnd(_file, byteOffset, YLBookFileDefaultChapterLength);
+            [ranges addObject:[NSValue valueWithRange:NSMakeRange(byteOffset, byteEnd - byteOffset)]];
+            byteOffset = byteEnd;
+        }
+        return ranges;
+    }
+}
+
+- (NSUInteger)characterOffsetForByteOffset:(NSUInteger)byteOffset{
+    @synchronized (self) {
+        return YLBookFileCharacterOffset(_file, byteOffset);
+    }
+}
+
+- (NSUInteger)byteOffsetForCharacterOffset:(NSUInteger)characterOffset{
+    @synchronized (self) {
+        return YLBookFileByteOffset(_file, characterOffset);
+    }
+}
+
+@end
@@ -0,0 +1,57 @@
+//
+//  YLBookSearch.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** 检索结果的回调，在主线程分批调用
+ * @param locations 本批命中的全书字符位置（UTF-16），升序
+ * @param finished 是否为最后一批
+ */
+typedef void(^YLBookSearchResultHandler)(NSArray<NSNumber *> *locations, BOOL finished);
+
+/** 全书检索
+ * 在后台读取全书建立 bigram 倒排索引（YLTextSearch），并保存到 indexPath；书籍未变化时直接读取已保存的索引
+ */
+@interface YLBookSearch : NSObject
+
+/// 书籍路径，UTF-8 编码
+- (instancetype)initWithPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, copy, readonly) NSString *path;
+
+/** 索引文件路径
+ * 默认与书籍放在一起（书籍路径 + ".ylsearch"）；书籍所在目录不可写时（如 App 包内）放在 Caches 目录
+ */
+@property (nonatomic, copy) NSString *indexPath;
+
+/// 索引是否已可用
+@property (nonatomic, readonly, getter=isIndexReady) BOOL indexReady;
+
+/** 在后台准备索引：读取已保存的索引，或建立新索引并保存
+ * @param completion 在主线程回调
+ */
+- (void)prepareIndexWithCompletion:(nullable void(^)(BOOL success))completion;
+
+/** 检索 text，结果分批回调；开始新的检索会取消之前的检索
+ * 索引未准备好时先准备索引
+ */
+- (void)searchText:(NSString *)text resultHandler:(YLBookSearchResultHandler)handler;
+
+/// 取消进行中的检索，之后不再回调
+- (void)cancelSearch;
+
+/** 同步检索，索引未准备好时返回空数组
+ * @param limit 最多返回的数量
+ */
+- (NSArray<NSNumber *> *)locationsOfText:(NSString *)text limit:(NSUInteger)limit;
+
+@end
+
+NS_ASSUME_NONNULL_END
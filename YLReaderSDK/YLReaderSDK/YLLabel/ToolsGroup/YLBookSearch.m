@@ -0,0 +1,194 @@
+//
+//  YLBookSearch.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLBookSearch.h"
+#import "YLBookLoader.h"
+#import "YLTextSearch.h"
+#import <stdatomic.h>
+
+/// 每批回调的最大结果数
+static const size_t kYLBookSearchBatchSize = 256;
+
+@interface YLBookSearch ()
+{
+    /// 只在 _queue 上访问
+    YLTextSearchIndex *_index;
+    dispatch_queue_t _queue;
+    /// 每次开始或取消检索时加一，旧的检索发现不一致即停止
+    atomic_ulong _generation;
+}
+@property (nonatomic, readwrite, getter=isIndexReady) BOOL indexReady;
+@end
+
+@implementation YLBookSearch
+
+- (instancetype)initWithPath:(NSString *)path{
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _queue = dispatch_queue_create("com.yl.bookSearch", DISPATCH_QUEUE_SERIAL);
+        atomic_init(&_generation, 0);
+        NSString *directory = path.stringByDeletingLastPathComponent;
+        if ([NSFileManager.defaultManager isWritableFileAtPath:directory]) {
+            _indexPath = [path stringByAppendingPathExtension:@"ylsearch"];
+        } else {
+            NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+            _indexPath = [[caches stringByAppendingPathComponent:path.lastPathComponent] stringByAppendingPathExtension:@"ylsearch"];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc{
+    YLTextSearchIndexDestroy(_index);
+}
+
+#pragma mark - 索引
+
+/// 书籍的大小与修改时间，书籍变化后已保存的索引失效
+- (uint64_t)bookStamp{
+    NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:self.path error:nil];
+    uint64_t size = [attributes fileSize];
+    uint64_t time = (uint64_t)([attributes fileModificationDate].timeIntervalSince1970 * 1000);
+    return (size << 32) ^ time;
+}
+
+/// 在 _queue 上调用
+- (BOOL)prepareIndex{
+    if (_index) {
+        return YES;
+    }
+    uint64_t stamp = [self bookStamp];
+    _index = YLTextSearchIndexRead(self.indexPath.fileSystemRepresentation, stamp);
+    if (_index == NULL) {
+        _index = [self buildIndex];
+        if (_index) {
+            YLTextSearchIndexWrite(_index, self.indexPath.fileSystemRepresentation, stamp);
+        }
+    }
+    self.indexReady = _index != NULL;
+    return self.indexReady;
+}
+
+/// 逐章读取全书，位置与 YLBookChapter.characterRange 一致
+- (YLTextSearchIndex *)buildIndex{
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    if (loader == nil) {
+        return NULL;
+    }
+    YLTextSearchIndex *index = YLTextSearchIndexCreate();
+    if (index == NULL) {
+        return NULL;
+    }
+    NSUInteger offset = loader.contentStart;
+    YLBookChapter *chapter;
+    while ((chapter = [loader chapterAtByteOffset:offset])) {
+        @autoreleasepool {
+            NSUInteger length = chapter.text.length;
+            unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+            BOOL success = characters != NULL;
+            if (success) {
+                [chapter.text getCharacters:characters range:NSMakeRange(0, length)];
+                success = YLTextSearchIndexAppend(index, characters, length);
+                free(characters);
+            }
+            if (!success) {
+                YLTextSearchIndexDestroy(index);
+                return NULL;
+            }
+            offset = NSMaxRange(chapter.byteRange);
+        }
+    }
+    if (!YLTextSearchIndexFinish(index)) {
+        YLTextSearchIndexDestroy(index);
+        return NULL;
+    }
+    return index;
+}
+
+- (void)prepareIndexWithCompletion:(void (^)(BOOL))completion{
+    dispatch_async(_queue, ^{
+        BOOL success = [self prepareIndex];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(success);
+            });
+        }
+    });
+}
+
+#pragma mark - 检索
+
+- (void)searchText:(NSString *)text resultHandler:(YLBookSearchResultHandler)handler{
+    unsigned long generation = atomic_fetch_add(&_generation, 1) + 1;
+    NSUInteger queryLength = text.length;
+    unichar *query = malloc(MAX(queryLength, 1) * sizeof(unichar));
+    if (query == NULL) {
+        return;
+    }
+    [text getCharacters:query range:NSMakeRange(0, queryLength)];
+    dispatch_async(_queue, ^{
+        if (atomic_load(&self->_generation) != generation || ![self prepareIndex] || queryLength == 0) {
+            free(query);
+            [self deliverLocations:@[] finished:YES generation:generation handler:handler];
+            return;
+        }
+        size_t hits[kYLBookSearchBatchSize];
+        size_t from = 0;
+        while (atomic_load(&self->_generation) == generation) {
+            size_t count = YLTextSearchIndexFind(self->_index, query, queryLength, from, hits, kYLBookSearchBatchSize);
+            NSMutableArray<NSNumber *> *locations = [NSMutableArray arrayWithCapacity:count];
+            for (size_t i = 0; i < count; i++) {
+                [locations addObject:@(hits[i])];
+            }
+            BOOL finished = count < kYLBookSearchBatchSize;
+            [self deliverLocations:locations finished:finished generation:generation handler:handler];
+            if (finished) {
+                break;
+            }
+            from = hits[count - 1] + 1;
+        }
+        free(query);
+    });
+}
+
+/// 在主线程回调，检索已被取消时丢弃
+- (void)deliverLocations:(NSArray<NSNumber *> *)locations finished:(BOOL)finished generation:(unsigned long)generation handler:(YLBookSearchResultHandler)handler{
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (atomic_load(&self->_generation) == generation) {
+            handler(locations, finished);
+        }
+    });
+}
+
+- (void)cancelSearch{
+    atomic_fetch_add(&_generation, 1);
+}
+
+- (NSArray<NSNumber *> *)locationsOfText:(NSString *)text limit:(NSUInteger)limit{
+    NSMutableArray<NSNumber *> *locations = [NSMutableArray array];
+    if (!self.indexReady || text.length == 0 || limit == 0) {
+        return locations;
+    }
+    NSUInteger queryLength = text.length;
+    unichar *query = malloc(queryLength * sizeof(unichar));
+    size_t *hits = malloc(limit * sizeof(size_t));
+    if (query && hits) {
+        [text getCharacters:query range:NSMakeRange(0, queryLength)];
+        dispatch_sync(_queue, ^{
+            size_t count = YLTextSearchIndexFind(self->_index, query, queryLength, 0, hits, limit);
+            for (size_t i = 0; i < count; i++) {
+                [locations addObject:@(hits[i])];
+            }
+        });
+    }
+    free(query);
+    free(hits);
+    return locations;
+}
+
+@end
@@ -0,0 +1,31 @@
+//
+//  YLCollectionScrollLayout.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** 小说阅读器：滚动
+ * 各页纵向排列，宽度与 collectionView 相同；按页高建立前缀和（YLPageOffsets），滚动时二分查找可见的页，
+ * 只在宽度变化时重新布局，布局属性在可见的页之间复用
+ */
+@interface YLCollectionScrollLayout : UICollectionViewLayout
+
+/** 第 item 页的高度，应取自分页时计算的 YLPageModel.contentHeight
+ * 只在数据变化（reloadData）或宽度变化时逐页读取一次；未设置时每页与 collectionView 等高
+ */
+@property (nonatomic ,copy ,nullable) CGFloat (^itemHeightProvider)(NSInteger item);
+
+/// 第 item 页的纵向起点
+- (CGFloat)offsetForItem:(NSInteger)item;
+
+/// 纵向偏移量 offset 所在的页，没有页时返回 NSNotFound
+- (NSInteger)itemAtOffset:(CGFloat)offset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,156 @@
+//
+//  YLCollectionScrollLayout.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLCollectionScrollLayout.h"
+#import "YLPageOffsets.h"
+
+/// 复用池中最多保留的布局属性
+static const NSUInteger kYLScrollLayoutReusableLimit = 8;
+
+@interface YLCollectionScrollLayout ()
+{
+    YLPageOffsets _pageOffsets;
+}
+
+/// 数据或宽度变化后需要重新建立前缀和
+@property (nonatomic ,assign) BOOL needsRebuild;
+@property (nonatomic ,assign) CGFloat layoutWidth;
+
+/// 上次返回的可见页的布局属性，按页序排列，第一项为 visibleFirstItem
+@property (nonatomic ,strong) NSMutableArray<UICollectionViewLayoutAttributes *> *visibleAttributes;
+@property (nonatomic ,assign) NSInteger visibleFirstItem;
+/// 移出可见区域的布局属性
+@property (nonatomic ,strong) NSMutableArray<UICollectionViewLayoutAttributes *> *reusableAttributes;
+
+@end
+
+@implementation YLCollectionScrollLayout
+
+- (instancetype)init{
+    self = [super init];
+    if (self) {
+        YLPageOffsetsInit(&_pageOffsets);
+        _needsRebuild = YES;
+        _visibleAttributes = [NSMutableArray array];
+        _reusableAttributes = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc{
+    YLPageOffsetsDestroy(&_pageOffsets);
+}
+
+#pragma mark - 前缀和
+
+- (void)prepareLayout{
+    [super prepareLayout];
+    CGFloat width = CGRectGetWidth(self.collectionView.bounds);
+    if (!self.needsRebuild && width == self.layoutWidth) {
+        return;
+    }
+    self.needsRebuild = NO;
+    self.layoutWidth = width;
+
+    YLPageOffsetsRemoveAll(&_pageOffsets);
+    NSInteger count = [self.collectionView numberOfSections] ? [self.collectionView numberOfItemsInSection:0] : 0;
+    CGFloat defaultHeight = CGRectGetHeight(self.collectionView.bounds);
+    for (NSInteger item = 0; item < count; item++) {
+        YLPageOffsetsAppend(&_pageOffsets, self.itemHeightProvider ? self.itemHeightProvider(item) : defaultHeight);
+    }
+    //位置都已改变，可见的布局属性全部放回复用池
+    [self recycleAttributes:self.visibleAttributes];
+    [self.visibleAttributes removeAllObjects];
+}
+
+- (void)invalidateLayoutWithContext:(UICollectionViewLayoutInvalidationContext *)context{
+    if (context.invalidateEverything || context.invalidateDataSourceCounts) {
+        self.needsRebuild = YES;
+    }
+    [super invalidateLayoutWithContext:context];
+}
+
+/// 滚动不改变任何页的位置，只有宽度变化时需要重新布局
+- (BOOL)shouldInvalidateLayoutForBoundsChange:(CGRect)newBounds{
+    return CGRectGetWidth(newBounds) != self.layoutWidth;
+}
+
+- (CGSize)collectionViewContentSize{
+    return CGSizeMake(self.layoutWidth, YLPageOffsetsTotal(&_pageOffsets));
+}
+
+- (CGFloat)offsetForItem:(NSInteger)item{
+    return YLPageOffsetsOrigin(&_pageOffsets, item);
+}
+
+- (NSInteger)itemAtOffset:(CGFloat)offset{
+    size_t item = YLPageOffsetsPageAt(&_pageOffsets, offset);
+    return item == YLPageOffsetsNotFound ? NSNotFound : (NSInteger)item;
+}
+
+#pragma mark - 布局属性
+
+- (NSArray<__kindof UICollectionViewLayoutAttributes *> *)layoutAttributesForElementsInRect:(CGRect)rect{
+    size_t first = 0;
+    size_t count = YLPageOffsetsVisibleRange(&_pageOffsets, CGRectGetMinY(rect), CGRectGetMaxY(rect), &first);
+
+    //与上次可见范围重叠的页直接沿用，其余的从复用池中取
+    NSInteger oldFirst = self.visibleFirstItem;
+    NSInteger oldEnd = oldFirst + self.visibleAttributes.count;
+    NSMutableArray<UICollectionViewLayoutAttributes *> *attributesArray = [NSMutableArray arrayWithCapacity:count];
+    for (NSInteger item = first; item < (NSInteger)(first + count); item++) {
+        if (item >= oldFirst && item < oldEnd) {
+            [attributesArray addObject:self.visibleAttributes[item - oldFirst]];
+        } else {
+            [attributesArray addObject:[self attributesForItem:item]];
+        }
+    }
+    for (NSInteger item = oldFirst; item < oldEnd; item++) {
+        if (item < (NSInteger)first || item >= (NSInteger)(first + count)) {
+            [self recycleAttributes:@[self.visibleAttributes[item - oldFirst]]];
+        }
+    }
+    self.visibleAttributes = attributesArray;
+    self.visibleFirstItem = first;
+    return [attributesArray copy];
+}
+
+- (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath{
+    NSInteger item = indexPath.item;
+    if (item >= self.visibleFirstItem && item < self.visibleFirstItem + (NSInteger)self.visibleAttributes.count) {
+        return self.visibleAttributes[item - self.visibleFirstItem];
+    }
+    if (item < 0 || item >= (NSInteger)_pageOffsets.count) {
+        return nil;
+    }
+    return [self attributesForItem:item];
+}
+
+/// 取复用池中的布局属性或新建，并设置第 item 页的位置
+- (UICollectionViewLayoutAttributes *)attributesForItem:(NSInteger)item{
+    NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:0];
+    UICollectionViewLayoutAttributes *attributes = self.reusableAttributes.lastObject;
+    if (attributes) {
+        [self.reusableAttributes removeLastObject];
+        attributes.indexPath = indexPath;
+    } else {
+        attributes = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+    }
+    attributes.frame = CGRectMake(0, YLPageOffsetsOrigin(&_pageOffsets, item), self.layoutWidth, YLPageOffsetsHeight(&_pageOffsets, item));
+    return attributes;
+}
+
+- (void)recycleAttributes:(NSArray<UICollectionViewLayoutAttributes *> *)attributesArray{
+    for (UICollectionViewLayoutAttributes *attributes in attributesArray) {
+        if (self.reusableAttributes.count >= kYLScrollLayoutReusableLimit) {
+            return;
+        }
+        [self.reusableAttributes addObject:attributes];
+    }
+}
+
+@end
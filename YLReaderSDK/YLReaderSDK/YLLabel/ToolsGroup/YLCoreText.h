@@ -53,6 +53,28 @@ NSMutableArray<NSValue *> *getRangeRects(NSRange range,CTFrameRef frameRef,NSStr
  */
 void handleAttrString(NSMutableAttributedString *attrString, CGRect rect);
 
+/** 处理文本，并记录处理后的位置与原文位置的对应关系
+ * @param sourceMap 每处替换追加一项：location 为替换内容之后的位置，length 为此后文字相对原文的偏移
+ */
+void handleAttrStringWithSourceMap(NSMutableAttributedString *attrString, CGRect rect, NSMutableArray<NSValue *> * _Nullable sourceMap);
+
+/** 与 handleAttrStringWithSourceMap 相同，但不开始加载图片
+ * 用于在后台线程处理、之后在主线程使用的文本：使用方接收文本后再对 pendingImages 调用 loadImageOfAttachment:drawSize:，
+ * 加载完成的通知不会早于使用方登记这些附件，后台排版期间 imageFrame 也不会被修改
+ * @param pendingImages 追加需要加载图片的附件；为 nil 时立即加载，与 handleAttrStringWithSourceMap 相同
+ */
+void handleAttrStringDeferringImageLoads(NSMutableAttributedString *attrString, CGRect rect, NSMutableArray<NSValue *> * _Nullable sourceMap, NSMutableArray<YLAttachment *> * _Nullable pendingImages);
+
+/** 处理后的位置对应的原文位置
+ * @param sourceMap handleAttrStringWithSourceMap 记录的对应关系
+ */
+NSUInteger getSourceLocation(NSArray<NSValue *> *sourceMap, NSUInteger location);
+
+/** 原文位置对应的处理后的位置，getSourceLocation 的逆运算
+ * 原文位置在被替换的标签内时，返回替换内容的末尾
+ */
+NSUInteger getHandledLocation(NSArray<NSValue *> *sourceMap, NSUInteger sourceLocation);
+
 @end
 
 
@@ -66,6 +88,19 @@ void handleAttrString(NSMutableAttributedString *attrString, CGRect rect);
  */
 NSMutableArray<NSValue *> *getPageRanges(NSAttributedString *attrString, CGRect rect);
 
+/** 使用可移植排版引擎 YLTextLayout 将文本分页，不依赖 CTFramesetter
+ * 章节标题总是从新的一页开始，各章节在多个线程上并行分页；内存不足时依次退回单线程与 CTFramesetter 分页
+ * @param attrString 内容
+ * @param rect 显示范围
+ * @return 返回每页需要展示的 Range
+ */
+NSMutableArray<NSValue *> *getPageRangesWithTextLayout(NSAttributedString *attrString, CGRect rect);
+
+/** 设置 getPageRanges 是否使用可移植排版引擎 YLTextLayout
+ * @param enabled 默认为 NO，使用 CTFramesetter 分页
+ */
+void setTextLayoutPaginationEnabled(BOOL enabled);
+
 /** 将内容分为多页
  * @param attrString 展示的内容
  * @prama rect 显示范围
@@ -113,19 +148,33 @@ CGSize getSizeWithCTLine(CTLineRef lineRef);
 + (NSAttributedString *)parseImage:(UIImage *)image drawSize:(CGSize)drawSize;
 
 /** 将图片链接处理为 CoreText
- * @param url 图片链接
+ * 不会阻塞读取图片：先按缓存或声明的尺寸占位，图片在后台加载解码，
+ * 完成后更新 YLAttachment 并发送 YLAttachmentImageDidLoadNotification
+ * @param url 图片链接，可在末尾声明尺寸，如 "http://a.com/b.png 300x200"
  * @param drawSize 画布的尺寸，图片的宽高不能超出 drawSize
  */
 + (NSAttributedString *)parseImageFromeTextWithURL:(NSString *)url drawSize:(CGSize)drawSize;
 
+/// @param loadsImage 为 NO 时只生成占位，之后由 loadImageOfAttachment:drawSize: 加载
++ (NSAttributedString *)parseImageFromeTextWithURL:(NSString *)url drawSize:(CGSize)drawSize loadsImage:(BOOL)loadsImage;
+
+/** 加载占位附件的图片，完成后在主线程更新 attachment 并发送 YLAttachmentImageDidLoadNotification
+ * @param drawSize 生成占位时的画布尺寸
+ */
++ (void)loadImageOfAttachment:(YLAttachment *)attachment drawSize:(CGSize)drawSize;
+
 @end
 
 
 
 
 /// CTFrame 上触摸事件的处理
+/// 查询通过 YLPageGeometry 二分查找；需要长期持有某页索引时可直接使用 YLPageGeometry
 @interface YLCoreText (Touch)
 
+/// 释放最近一次查询缓存的几何索引及其持有的 CTFrame；页面被替换或移除后调用
+void invalidatePageGeometryCache(void);
+
 /** 获取触摸位置所在的行 CTLine
  * @param point 触摸点
  */
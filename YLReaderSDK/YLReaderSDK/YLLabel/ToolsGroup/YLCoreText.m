@@ -7,11 +7,54 @@
 //
 
 #import "YLCoreText.h"
+#import "YLCoreTextMetrics.h"
+#import "YLTextParallelLayout.h"
+#import "YLTextMarkup.h"
+#import "YLImageCache.h"
+#import "YLPageGeometry.h"
 
 
 
-NSString * const kYLImageLinkRegula = @"(?<=\\<ImageLink:).*?(?=\\>)";
-NSString * const kYLWebLinkRegula = @"(?<=\\<WebLink:).*?(?=\\>)";
+/// 最近一次使用的几何索引，由 getPageGeometryLock() 保护；索引持有 CTFrame
+static YLPageGeometry *lastGeometry;
+
+static NSObject *getPageGeometryLock(void){
+    static NSObject *lock;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        lock = [[NSObject alloc] init];
+    });
+    return lock;
+}
+
+/** 获取 CTFrame 的几何索引
+ * 保留最近一次使用的索引：同一页上的连续查询（如拖动选择）不再重复遍历所有行
+ * 可在任意线程调用；建立索引时不持有锁
+ */
+static YLPageGeometry *getPageGeometry(CTFrameRef frameRef){
+    if (frameRef == nil) {
+        return nil;
+    }
+    YLPageGeometry *geometry;
+    @synchronized (getPageGeometryLock()) {
+        geometry = lastGeometry;
+    }
+    //索引持有 CTFrame，指针相同即为同一页
+    if (geometry.frameRef != frameRef) {
+        geometry = [[YLPageGeometry alloc] initWithCTFrame:frameRef];
+        @synchronized (getPageGeometryLock()) {
+            lastGeometry = geometry;
+        }
+    }
+    return geometry;
+}
+
+void invalidatePageGeometryCache(void){
+    @synchronized (getPageGeometryLock()) {
+        lastGeometry = nil;
+    }
+}
+
 
 @implementation NSString (YLLabel)
 
@@ -103,110 +146,112 @@ NSMutableArray<NSValue *> *getRangeRects_0(NSRange range,CTFrameRef frameRef){
 }
 
 NSMutableArray<NSValue *> *getRangeRects(NSRange range,CTFrameRef frameRef,NSString *content){
-    NSMutableArray<NSValue *> *rects = [NSMutableArray array];
-    if (frameRef == nil) { return rects; }
-    if (range.length == 0 || range.location == NSNotFound) { return rects; }
-    
-    CFArrayRef lines = CTFrameGetLines(frameRef);
-    int lineCount = (int)CFArrayGetCount(lines);
-    
-    if (lineCount < 1) {
+    if (frameRef == nil) { return [NSMutableArray array]; }
+    //行的度量与行首、行尾的去除位置按页缓存，拖动选择时不再逐行创建子串与正则
+    return [getPageGeometry(frameRef) rectsForRange:range content:content];
+}
 
-        return rects;
+/** 将正文中的 <ImageLink:...> 与 <WebLink:...> 标签替换为附件
+ * 一次扫描找出全部标签，再按顺序拼接出新的富文本，重复的链接各自替换在自己的位置
+ */
+void handleAttrString(NSMutableAttributedString *attrString, CGRect rect){
+    handleAttrStringWithSourceMap(attrString, rect, nil);
+}
+
+void handleAttrStringWithSourceMap(NSMutableAttributedString *attrString, CGRect rect, NSMutableArray<NSValue *> *sourceMap){
+    handleAttrStringDeferringImageLoads(attrString, rect, sourceMap, nil);
+}
+
+void handleAttrStringDeferringImageLoads(NSMutableAttributedString *attrString, CGRect rect, NSMutableArray<NSValue *> *sourceMap, NSMutableArray<YLAttachment *> *pendingImages){
+    NSString *string = attrString.string;
+    NSUInteger length = string.length;
+    if (length == 0) {
+        return;
     }
-    
-    CGPoint origins[lineCount];
-    for (int i = 0; i < lineCount; i++) {
-        origins[i] = CGPointZero;
+    unichar *characters = malloc(length * sizeof(unichar));
+    if (characters == NULL) {
+        return;
     }
-    CTFrameGetLineOrigins(frameRef, CFRangeMake(0, 0), origins);
-    
-    for (int i = 0; i < lineCount; i ++) {
-        CTLineRef line = CFArrayGetValueAtIndex(lines, i);
-        CFRange lineCFRange = CTLineGetStringRange(line);
-        NSRange lineRange = NSMakeRange(lineCFRange.location == kCFNotFound ? NSNotFound : lineCFRange.location, lineCFRange.length);
-        NSRange contentRange = NSMakeRange(NSNotFound, 0);
-        
-        if ((lineRange.location + lineRange.length) > range.location &&
-            lineRange.location < (range.location + range.length)) {
-            contentRange.location = MAX(lineRange.location, range.location);
-            CGFloat end = MIN(lineRange.location + lineRange.length, range.location + range.length);
-            contentRange.length = end - contentRange.location;
+    [string getCharacters:characters range:NSMakeRange(0, length)];
+    YLTextMarkupToken *tokens = NULL;
+    size_t tokenCount = YLTextMarkupScan(characters, length, &tokens);
+    free(characters);
+    if (tokenCount == 0) {
+        return;
+    }
+
+    NSMutableAttributedString *result = [[NSMutableAttributedString alloc] init];
+    [result beginEditing];
+    NSUInteger location = 0;
+    for (size_t i = 0; i < tokenCount; i++) {
+        YLTextMarkupToken token = tokens[i];
+        if (token.range.location > location) {
+            [result appendAttributedString:[attrString attributedSubstringFromRange:NSMakeRange(location, token.range.location - location)]];
         }
-        
-        if (contentRange.length > 0) {
-            
-            // 去掉 -> 开头空格 - 尾部换行符 - 所占用的区域
-            if (content.length > 0) {
-                NSString *tempContent = [content substringWithRange:contentRange];
-                NSArray<NSTextCheckingResult *> *spaceRanges = [tempContent matchesWithPattern:@"\\s\\s"];
-                if (spaceRanges.count) {
-                    NSRange spaceRange = spaceRanges.firstObject.range;
-                    contentRange = NSMakeRange(contentRange.location + spaceRange.length, contentRange.length - spaceRange.length);
-                }
-                NSArray<NSTextCheckingResult *> *enterRanges = [tempContent matchesWithPattern:@"\\n"];
-                if (enterRanges.count) {
-                    NSRange enterRange = enterRanges.firstObject.range;
-                    contentRange = NSMakeRange(contentRange.location, contentRange.length - enterRange.length);
-                }
+        location = token.range.location + token.range.length;
+
+        if (token.kind == YLTextMarkupImageLink) {
+            //文字中插入的图片
+            NSString *url = [string substringWithRange:NSMakeRange(token.value.location, token.value.length)];
+            NSAttributedString *placeholder = [YLCoreText parseImageFromeTextWithURL:url drawSize:rect.size loadsImage:pendingImages == nil];
+            YLAttachment *model = [placeholder attribute:kYLAttachmentAttributeName atIndex:0 effectiveRange:NULL];
+            if (pendingImages && model.image == nil) {
+                [pendingImages addObject:model];
+            }
+            [result appendAttributedString:placeholder];
+        } else {
+            //文字中插入的链接
+            YLAttachment *web = [[YLAttachment alloc] init];
+            web.url = [string substringWithRange:NSMakeRange(token.link.location, token.link.length)];
+            web.title = [string substringWithRange:NSMakeRange(token.title.location, token.title.length)];
+            NSString *text = web.title.length ? web.title : web.url;
+            if (text.length) {
+                [result appendAttributedString:[[NSAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName:[UIFont systemFontOfSize:16],NSForegroundColorAttributeName:UIColor.redColor,kYLAttachmentAttributeName:web}]];
             }
-            
-            // 正常使用(如果不需要排除段头空格跟段尾换行符可将上面代码删除)
-            
-            CGFloat xStart = CTLineGetOffsetForStringIndex(line, contentRange.location, nil);
-            CGFloat xEnd = CTLineGetOffsetForStringIndex(line, contentRange.location + contentRange.length, nil);
-            CGPoint origin = origins[i];
-            CGFloat lineAscent = 0;
-            CGFloat lineDescent = 0;
-            CGFloat lineLeading = 0;
-            CTLineGetTypographicBounds(line, &lineAscent, &lineDescent, &lineLeading);
-            
-            CGRect contentRect = CGRectMake(origin.x + xStart, origin.y - lineDescent, fabs(xEnd - xStart),lineAscent + lineDescent + lineLeading);
-            [rects addObject:[NSValue valueWithCGRect:contentRect]];
         }
+        //替换之后的文字相对原文的偏移
+        [sourceMap addObject:[NSValue valueWithRange:NSMakeRange(result.length, location - result.length)]];
+    }
+    if (location < length) {
+        [result appendAttributedString:[attrString attributedSubstringFromRange:NSMakeRange(location, length - location)]];
     }
-    return rects;
+    [result endEditing];
+    free(tokens);
+    [attrString setAttributedString:result];
 }
 
-void handleAttrString(NSMutableAttributedString *attrString, CGRect rect){
-    NSString *string = [attrString.string copy];
-    NSString *regula = [NSString stringWithFormat:@"%@|%@",kYLImageLinkRegula,kYLWebLinkRegula];
-    NSError *error;
-    NSRegularExpression *regularExpression = [NSRegularExpression regularExpressionWithPattern:regula options:NSRegularExpressionCaseInsensitive error:&error];
-    NSArray<NSTextCheckingResult *> *matches = [regularExpression matchesInString:string options:0 range:NSMakeRange(0, [string length])];
-    
-    if (matches.count) {
-        [matches enumerateObjectsUsingBlock:^(NSTextCheckingResult * _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-               NSString *matchString = [string substringWithRange:obj.range];
-               NSString *imageFormat = [NSString stringWithFormat:@"<ImageLink:%@>",matchString];//图片格式
-               NSString *webFormat = [NSString stringWithFormat:@"<WebLink:%@>",matchString];//网页格式
-
-               if ([string containsString:imageFormat]) {
-                   //文字中插入的图片
-                   NSRange subAllRange = [attrString.string rangeOfString:imageFormat];//在修改后的文本中查找替代的位置
-                   [attrString replaceCharactersInRange:subAllRange withAttributedString:[YLCoreText parseImageFromeTextWithURL:matchString drawSize:rect.size]];
-               }else if ([string containsString:webFormat]) {
-                   //文字中插入的链接
-                   NSRange subAllRange = [attrString.string rangeOfString:webFormat];//在修改后的文本中查找替代的位置
-                   NSArray *itemArray = [matchString componentsSeparatedByString:@","];
-                   
-                   YLAttachment *web = [[YLAttachment alloc] init];
-                   [itemArray enumerateObjectsUsingBlock:^(NSString * _Nonnull item, NSUInteger idx, BOOL * _Nonnull stop) {
-                       NSArray *itemDict = [item componentsSeparatedByString:@"="];
-                       NSString *key = itemDict.firstObject;
-                       NSString *value = itemDict.lastObject;
-                       if ([key isEqualToString:@"link"]) {
-                           web.url = value;
-                       }else if ([key isEqualToString:@"title"]){
-                           web.title = value;
-                       }
-                   }];
-                   NSLog(@"webFormat === %@",matchString);
-                                      
-                   [attrString replaceCharactersInRange:subAllRange withAttributedString:[[NSAttributedString alloc]initWithString:web.title attributes:@{NSFontAttributeName:[UIFont systemFontOfSize:16],NSForegroundColorAttributeName:UIColor.redColor,kYLAttachmentAttributeName:web}]];
-               }
-           }];
+NSUInteger getSourceLocation(NSArray<NSValue *> *sourceMap, NSUInteger location){
+    //最后一个起点不大于 location 的替换
+    NSUInteger low = 0, high = sourceMap.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (sourceMap[mid].rangeValue.location <= location) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low == 0 ? location : location + sourceMap[low - 1].rangeValue.length;
+}
+
+NSUInteger getHandledLocation(NSArray<NSValue *> *sourceMap, NSUInteger sourceLocation){
+    //最后一个原文终点不大于 sourceLocation 的替换
+    NSUInteger low = 0, high = sourceMap.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        NSRange entry = sourceMap[mid].rangeValue;
+        if (entry.location + entry.length <= sourceLocation) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    NSUInteger location = low == 0 ? sourceLocation : sourceLocation - sourceMap[low - 1].rangeValue.length;
+    //位于被替换的标签内时，对应到替换内容的末尾
+    if (low < sourceMap.count) {
+        location = MIN(location, sourceMap[low].rangeValue.location);
+    }
+    return location;
 }
 
 @end
@@ -219,12 +264,29 @@ void handleAttrString(NSMutableAttributedString *attrString, CGRect rect){
 
 @implementation YLCoreText (Page)
 
+/// getPageRanges 是否使用可移植排版引擎
+static BOOL YLTextLayoutPaginationEnabled = NO;
+
+static NSMutableArray<NSValue *> *getPageRangesWithFramesetter(NSAttributedString *attrString, CGRect rect);
+
+void setTextLayoutPaginationEnabled(BOOL enabled){
+    YLTextLayoutPaginationEnabled = enabled;
+}
+
 /** 根据页面 rect 将文本分页
  * @param attrString 内容
  * @param rect 显示范围
  * @return 返回每页需要展示的 Range
  */
 NSMutableArray<NSValue *> *getPageRanges(NSAttributedString *attrString, CGRect rect){
+    if (YLTextLayoutPaginationEnabled) {
+        return getPageRangesWithTextLayout(attrString, rect);
+    }
+    return getPageRangesWithFramesetter(attrString, rect);
+}
+
+/// 使用 CTFramesetter 逐页分页
+static NSMutableArray<NSValue *> *getPageRangesWithFramesetter(NSAttributedString *attrString, CGRect rect){
     NSMutableArray *rangeArray = [NSMutableArray array];
     CTFramesetterRef framesetter = CTFramesetterCreateWithAttributedString((CFAttributedStringRef)attrString);
     CGPathRef path = CGPathCreateWithRect(rect, nil);
@@ -242,6 +304,44 @@ NSMutableArray<NSValue *> *getPageRanges(NSAttributedString *attrString, CGRect
     return rangeArray;
 }
 
+/** 使用可移植排版引擎 YLTextLayout 将文本分页
+ * @param attrString 内容
+ * @param rect 显示范围
+ * @return 返回每页需要展示的 Range
+ */
+NSMutableArray<NSValue *> *getPageRangesWithTextLayout(NSAttributedString *attrString, CGRect rect){
+    NSMutableArray *rangeArray = [NSMutableArray array];
+    YLCoreTextMetrics *coreTextMetrics = [[YLCoreTextMetrics alloc] initWithAttributedString:attrString];
+    size_t *pageBreaks = NULL;
+    size_t pageBreakCount = 0;
+    if (!YLTextFindPageBreaks(coreTextMetrics.source, 0, attrString.length, &pageBreaks, &pageBreakCount)) {
+        return getPageRangesWithFramesetter(attrString, rect);
+    }
+    YLTextLayoutConfig config = {rect.size.width, rect.size.height, coreTextMetrics.lineSpacing, coreTextMetrics.paragraphSpacing, false, pageBreaks, pageBreakCount};
+    YLTextLayoutResult result;
+    YLTextLayoutResultInit(&result);
+    //章节之间互不影响，按章节并行分页；内存或线程不足时改为单线程，仍失败时使用 CTFramesetter，不返回缺页的结果
+    bool success = YLTextLayoutPaginateParallel(coreTextMetrics.source, coreTextMetrics.metrics, &config, 0, attrString.length, 0, &result);
+    if (!success) {
+        YLTextLayoutResultDestroy(&result);
+        YLTextLayoutResultInit(&result);
+        success = YLTextLayoutPaginate(coreTextMetrics.source, coreTextMetrics.metrics, &config, 0, attrString.length, &result);
+    }
+    free(pageBreaks);
+    if (!success) {
+        YLTextLayoutResultDestroy(&result);
+        return getPageRangesWithFramesetter(attrString, rect);
+    }
+    for (size_t i = 0; i < result.pageCount; i++) {
+        [rangeArray addObject:[NSValue valueWithRange:NSMakeRange(result.pages[i].location, result.pages[i].length)]];
+    }
+    YLTextLayoutResultDestroy(&result);
+    if (rangeArray.count == 0) {
+        [rangeArray addObject:[NSValue valueWithRange:NSMakeRange(0, 0)]];
+    }
+    return rangeArray;
+}
+
 /** 将内容分为多页
  * @param attrString 展示的内容
  * @prama rect 显示范围
@@ -430,19 +530,18 @@ static CGFloat widthCallback(void *ref){
     return model.imageFrame.size.width;
 }
 
-+ (NSAttributedString *)parseImage:(UIImage *)image drawSize:(CGSize)drawSize{
-    /**************** 计算图片宽高 **************/
-    CGSize imageShowSize = image.size;//屏幕上展示的图片尺寸
-    if (image.size.width > drawSize.width) {
-        imageShowSize = CGSizeMake(drawSize.width, image.size.height / image.size.width * drawSize.width);
+/// 图片在画布上的展示尺寸，宽度不能超出 drawSize
+static CGSize fitImageSize(CGSize imageSize, CGSize drawSize){
+    if (imageSize.width > drawSize.width) {
+        return CGSizeMake(drawSize.width, imageSize.height / imageSize.width * drawSize.width);
     }
-    
-    YLAttachment *model = [[YLAttachment alloc]init];
-    model.image = image;
-    model.imageFrame = CGRectMake(0, 0, imageShowSize.width, imageShowSize.height);
-    
-    //注意：此处返回的富文本，最主要的作用是占位！
-    //为图片的绘制留下空白区域
+    return imageSize;
+}
+
+/** 生成图片的占位富文本
+ * 注意：此处返回的富文本，最主要的作用是占位！为图片的绘制留下空白区域，大小由 model.imageFrame 决定
+ */
+static NSAttributedString *attachmentPlaceholder(YLAttachment *model){
     CTRunDelegateCallbacks callbacks;
     memset(&callbacks, 0, sizeof(CTRunDelegateCallbacks));
     callbacks.version = kCTRunDelegateVersion1;//设置回调版本，默认这个
@@ -460,46 +559,75 @@ static CGFloat widthCallback(void *ref){
     return placeholder;
 }
 
-+ (NSAttributedString *)parseImageFromeTextWithURL:(NSString *)url drawSize:(CGSize)drawSize{
-    NSData *data = [NSData dataWithContentsOfURL:[NSURL URLWithString:url]];
-    if (data == nil) {
-        NSAttributedString *imgaeString = [[NSAttributedString alloc] initWithString:@""];
-        return imgaeString;
+/** 解析标签中声明的图片尺寸：<ImageLink:图片地址 宽x高>
+ * @param url 输入标签内容，输出去掉尺寸后的图片地址
+ * @return 未声明时返回 CGSizeZero
+ */
+static CGSize declaredImageSize(NSString **url){
+    NSRange space = [*url rangeOfString:@" " options:NSBackwardsSearch];
+    if (space.location == NSNotFound) {
+        return CGSizeZero;
     }
-    UIImage *image = [UIImage imageWithData:data];
-    if (image == nil) {
-        NSAttributedString *imgaeString = [[NSAttributedString alloc] initWithString:@""];
-        return imgaeString;
+    NSArray<NSString *> *components = [[*url substringFromIndex:NSMaxRange(space)].lowercaseString componentsSeparatedByString:@"x"];
+    if (components.count != 2) {
+        return CGSizeZero;
     }
-    
+    CGFloat width = components[0].doubleValue, height = components[1].doubleValue;
+    if (width <= 0 || height <= 0) {
+        return CGSizeZero;
+    }
+    *url = [[*url substringToIndex:space.location] stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceCharacterSet];
+    return CGSizeMake(width, height);
+}
+
++ (NSAttributedString *)parseImage:(UIImage *)image drawSize:(CGSize)drawSize{
     /**************** 计算图片宽高 **************/
-    CGSize imageShowSize = image.size;//屏幕上展示的图片尺寸
-    if (image.size.width > drawSize.width) {
-        imageShowSize = CGSizeMake(drawSize.width, image.size.height / image.size.width * drawSize.width);
+    CGSize imageShowSize = fitImageSize(image.size, drawSize);//屏幕上展示的图片尺寸
+    
+    YLAttachment *model = [[YLAttachment alloc]init];
+    model.image = image;
+    model.imageFrame = CGRectMake(0, 0, imageShowSize.width, imageShowSize.height);
+    return attachmentPlaceholder(model);
+}
+
++ (NSAttributedString *)parseImageFromeTextWithURL:(NSString *)url drawSize:(CGSize)drawSize{
+    return [self parseImageFromeTextWithURL:url drawSize:drawSize loadsImage:YES];
+}
+
++ (NSAttributedString *)parseImageFromeTextWithURL:(NSString *)url drawSize:(CGSize)drawSize loadsImage:(BOOL)loadsImage{
+    /**************** 占位尺寸 **************/
+    //依次使用：缓存中的图片、缓存中记录的尺寸、标签声明的尺寸；都没有时按 16:9 预留，图片加载后再矫正
+    CGSize declaredSize = declaredImageSize(&url);
+    YLImageCache *cache = YLImageCache.sharedCache;
+    UIImage *image = [cache cachedImageForURL:url];
+    CGSize imageSize = image ? image.size : [cache cachedSizeForURL:url];
+    if (CGSizeEqualToSize(imageSize, CGSizeZero)) {
+        imageSize = declaredSize;
     }
-        
+    if (CGSizeEqualToSize(imageSize, CGSizeZero)) {
+        imageSize = CGSizeMake(drawSize.width, floor(drawSize.width * 9 / 16));
+    }
+    CGSize imageShowSize = fitImageSize(imageSize, drawSize);
+    
     YLAttachment *model = [[YLAttachment alloc]init];
     model.url = url;
     model.image = image;
     model.imageFrame = CGRectMake(0, 0, imageShowSize.width, imageShowSize.height);
-    
-    //注意：此处返回的富文本，最主要的作用是占位！
-    //为图片的绘制留下空白区域
-    CTRunDelegateCallbacks callbacks;
-    memset(&callbacks, 0, sizeof(CTRunDelegateCallbacks));
-    callbacks.version = kCTRunDelegateVersion1;//设置回调版本，默认这个
-    callbacks.getAscent = ascentCallback;//上行高度
-    callbacks.getDescent = descentCallback;//下行高度
-    callbacks.getWidth = widthCallback;//图片宽度
-    CTRunDelegateRef delegate = CTRunDelegateCreate(&callbacks, (__bridge void *)model);
-    
-    //使用0xFFFC作为空白占位符
-    unichar objectReplacementChar = 0xFFFC;
-    NSString *content = [NSString stringWithCharacters:&objectReplacementChar length:1];
-    NSMutableAttributedString *placeholder = [[NSMutableAttributedString alloc] initWithString:content attributes:@{kYLAttachmentAttributeName:model}];
-    CFAttributedStringSetAttribute((CFMutableAttributedStringRef)placeholder, CFRangeMake(0, 1), kCTRunDelegateAttributeName, delegate);
-    CFRelease(delegate);
-    return placeholder;
+    if (image == nil && loadsImage) {
+        [self loadImageOfAttachment:model drawSize:drawSize];
+    }
+    return attachmentPlaceholder(model);
+}
+
++ (void)loadImageOfAttachment:(YLAttachment *)attachment drawSize:(CGSize)drawSize{
+    //在后台加载与解码，完成后矫正占位尺寸
+    [YLImageCache.sharedCache loadImageWithURL:attachment.url completion:^(UIImage * _Nullable image) {
+        CGSize showSize = image ? fitImageSize(image.size, drawSize) : CGSizeZero;//加载失败时不再占位
+        BOOL sizeChanged = !CGSizeEqualToSize(showSize, attachment.imageFrame.size);
+        attachment.image = image;
+        attachment.imageFrame = (CGRect){attachment.imageFrame.origin, showSize};
+        [NSNotificationCenter.defaultCenter postNotificationName:YLAttachmentImageDidLoadNotification object:attachment userInfo:@{YLAttachmentImageSizeChangedKey: @(sizeChanged)}];
+    }];
 }
 
 @end
@@ -512,87 +640,30 @@ static CGFloat widthCallback(void *ref){
  * @param point 触摸点
  */
 CTLineRef getTouchLine(CGPoint point,CTFrameRef frameRef){
-    CTLineRef line = nil;
-    if (frameRef == nil) { return line; }
-    
-    CGPathRef path = CTFrameGetPath(frameRef);
-    CGRect bounds = CGPathGetBoundingBox(path);/// 页面边界
-    CGFloat pageWidth = CGRectGetWidth(bounds);/// 页面宽度
-    CGFloat pageHeight = CGRectGetHeight(bounds);/// 页面高度
-    
-    CFArrayRef lines = CTFrameGetLines(frameRef);
-    int lineCount = (int)CFArrayGetCount(lines);
-    if (lineCount < 1) {
-        return line;
-    }
-    
-    CGPoint origins[lineCount];
-    for (int i = 0; i < lineCount; i++) {
-        origins[i] = CGPointZero;
-    }
-    CTFrameGetLineOrigins(frameRef, CFRangeMake(0, 0), origins);
-    for (int i = 0; i < lineCount; i ++) {
-        CGPoint origin = origins[i];
-        CTLineRef tempLine = CFArrayGetValueAtIndex(lines, i);
-        CGFloat lineAscent = 0;  //上行高度
-        CGFloat lineDescent = 0; //下行高度
-        CGFloat lineLeading = 0; //行距
-        CTLineGetTypographicBounds(tempLine, &lineAscent, &lineDescent, &lineLeading);/// 获取CTLine的字形度量
-        CGFloat lineHeight = lineAscent + fabs(lineDescent) + lineLeading;
-        CGRect lineFrame = CGRectMake(origin.x, pageHeight - (origin.y + lineAscent), pageWidth, lineHeight);
-        lineFrame = CGRectInset(lineFrame, -5, -5);
-        if (CGRectContainsPoint(lineFrame, point)) {
-            line = tempLine;
-            break;
-        }
-    }
-    return line;
+    return [getPageGeometry(frameRef) lineAtPoint:point];
 }
 
 /** 获取触摸点的 CTRunRef
  * @param point 触摸点
  */
 CTRunRef getTouchRun(CGPoint point,CTFrameRef frameRef){
-    CTRunRef getRun = NULL;
-    CTLineRef lineRef = getTouchLine(point, frameRef);
-    CFArrayRef glyphRuns = CTLineGetGlyphRuns(lineRef);
-    int runCount = (int)CFArrayGetCount(glyphRuns);
-    CGFloat startPoint = 0;
-    for (int j = 0; j < runCount ; j ++) {
-        CTRunRef run = CFArrayGetValueAtIndex(glyphRuns, j);
-        CGFloat width = CTRunGetTypographicBounds(run, CFRangeMake(0, 0), NULL, NULL, NULL);//获取 CTRun 的宽度
-        if (point.x > startPoint && point.x < (startPoint + width)) {
-            getRun = run;
-            break;
-        }
-        startPoint += width;
-    }
-    return getRun;
+    return [getPageGeometry(frameRef) runAtPoint:point];
 }
 
 /** 获得触摸位置那一行文字范围 Range
  * @param point 触摸点
  */
 NSRange getTouchLineRange(CGPoint point,CTFrameRef frameRef){
-    NSRange range = NSMakeRange(NSNotFound, 0);
-    CTLineRef line = getTouchLine(point, frameRef);
-    if (line) {
-        CFRange lineRange = CTLineGetStringRange(line);
-        range = NSMakeRange(lineRange.location == kCFNotFound ? NSNotFound : lineRange.location, lineRange.length);
-    }
-    return range;
+    YLPageGeometry *geometry = getPageGeometry(frameRef);
+    return geometry ? [geometry lineRangeAtPoint:point] : NSMakeRange(NSNotFound, 0);
 }
 
 /** 获得触摸位置文字的Location
  * @param point 触摸点
  */
 signed long getTouchLocation(CGPoint point,CTFrameRef frameRef){
-    signed long location = -1;
-    CTLineRef line = getTouchLine(point,frameRef);
-    if (line != nil) {
-        location = CTLineGetStringIndexForPosition(line, point);
-    }
-    return location;
+    YLPageGeometry *geometry = getPageGeometry(frameRef);
+    return geometry ? [geometry locationAtPoint:point] : -1;
 }
 
 /** 获取触摸点的 YLAttachment
@@ -600,21 +671,7 @@ signed long getTouchLocation(CGPoint point,CTFrameRef frameRef){
  * @return 若没有，则返回 nil
  */
 YLAttachment *getTouchAttachment(CGPoint point,CTFrameRef frameRef){
-    YLAttachment *getAttachment = nil;
-    CTRunRef run = getTouchRun(point, frameRef);
-    if (run) {
-        CFDictionaryRef attributes = CTRunGetAttributes(run);
-        if (attributes) {
-            if (CFDictionaryContainsKey(attributes, kYLAttachmentAttributeName)) {
-                YLAttachment *attachment = CFDictionaryGetValue(attributes, kYLAttachmentAttributeName);;//获取属性
-                if (attachment) {
-                    getAttachment = attachment;
-                    NSLog(@"%@", attachment);
-                }
-            }
-        }
-    }
-    return getAttachment;
+    return [getPageGeometry(frameRef) attachmentAtPoint:point];
 }
 
 @end
@@ -0,0 +1,41 @@
+//
+//  YLCoreTextMetrics.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLModel.h"
+#import "YLTextLayout.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** 可移植排版引擎 YLTextLayout 在 iOS 上的度量实现
+ * 字体取自 NSFontAttributeName，字宽来自 CTFontGetAdvancesForGlyphs；
+ * 附件尺寸取自 kYLAttachmentAttributeName 对应 YLAttachment 的 imageFrame
+ */
+@interface YLCoreTextMetrics : NSObject
+
+/// 使用按字体共享的宽度缓存
+- (instancetype)initWithAttributedString:(NSAttributedString *)attrString;
+
+/** @param usesAdvanceCache 是否使用宽度缓存 YLTextAdvanceCache：ASCII 与汉字等直接查表，不再调用 CoreText；
+ *                          测量结果与不使用时完全相同
+ */
+- (instancetype)initWithAttributedString:(NSAttributedString *)attrString usesAdvanceCache:(BOOL)usesAdvanceCache;
+
+/// 待排版的文本，生命周期与当前对象一致
+@property (nonatomic, readonly) const YLTextSource *source;
+
+/// 度量接口，生命周期与当前对象一致
+@property (nonatomic, readonly) const YLTextMetrics *metrics;
+
+/// 取自第一个段落样式的行间距
+@property (nonatomic, readonly) CGFloat lineSpacing;
+
+/// 取自第一个段落样式的段间距
+@property (nonatomic, readonly) CGFloat paragraphSpacing;
+
+@end
+
+NS_ASSUME_NONNULL_END
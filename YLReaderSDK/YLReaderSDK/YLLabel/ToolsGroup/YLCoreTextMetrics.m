@@ -0,0 +1,172 @@
+//
+//  YLCoreTextMetrics.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLCoreTextMetrics.h"
+#import "YLTextAdvanceCache.h"
+
+@interface YLCoreTextMetrics ()
+{
+    YLTextSource _source;
+    YLTextMetrics _metrics;
+    CTFontRef *_fonts;
+    /// 与 _fonts 一一对应，未使用缓存时为 NULL
+    const YLTextAdvanceTable **_advanceTables;
+    NSUInteger _fontCount;
+}
+
+@property (nonatomic, strong) NSAttributedString *attrString;
+@property (nonatomic, strong) NSMutableData *charactersData;
+@property (nonatomic, strong) NSMutableData *runsData;
+
+@end
+
+static void coreTextMeasureGlyphs(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances);
+static void coreTextMeasure(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances);
+static YLTextFontMetrics coreTextFontMetrics(void *context, YLTextStyleID style);
+static YLTextSize coreTextAttachmentSize(void *context, size_t index);
+
+@implementation YLCoreTextMetrics
+
+- (void)dealloc{
+    for (NSUInteger i = 0; i < _fontCount; i++) {
+        CFRelease(_fonts[i]);
+    }
+    free(_fonts);
+    free(_advanceTables);
+}
+
+- (instancetype)initWithAttributedString:(NSAttributedString *)attrString{
+    return [self initWithAttributedString:attrString usesAdvanceCache:YES];
+}
+
+- (instancetype)initWithAttributedString:(NSAttributedString *)attrString usesAdvanceCache:(BOOL)usesAdvanceCache{
+    self = [super init];
+    if (self) {
+        _attrString = [attrString copy];
+        NSUInteger length = _attrString.length;
+
+        _charactersData = [NSMutableData dataWithLength:MAX(length, 1) * sizeof(unichar)];
+        [_attrString.string getCharacters:_charactersData.mutableBytes range:NSMakeRange(0, length)];
+
+        /// 每种字体对应一个样式；fontIndexes 由字体查样式，避免每个 run 线性查找
+        NSMutableArray *fonts = [NSMutableArray array];
+        NSMutableDictionary<id, NSNumber *> *fontIndexes = [NSMutableDictionary dictionary];
+        _runsData = [NSMutableData data];
+        [_attrString enumerateAttribute:NSFontAttributeName inRange:NSMakeRange(0, length) options:0 usingBlock:^(UIFont * _Nullable font, NSRange range, BOOL * _Nonnull stop) {
+            id key = font ?: NSNull.null;
+            NSNumber *number = fontIndexes[key];
+            NSUInteger index = number ? number.unsignedIntegerValue : fonts.count;
+            if (number == nil) {
+                fontIndexes[key] = @(index);
+                [fonts addObject:key];
+            }
+            YLTextStyleRun run = {range.location, range.length, (YLTextStyleID)index};
+            [self.runsData appendBytes:&run length:sizeof(YLTextStyleRun)];
+        }];
+
+        _fontCount = fonts.count;
+        _fonts = calloc(MAX(_fontCount, 1), sizeof(CTFontRef));
+        [fonts enumerateObjectsUsingBlock:^(id font, NSUInteger idx, BOOL * _Nonnull stop) {
+            if ([font isKindOfClass:UIFont.class]) {
+                self->_fonts[idx] = CTFontCreateWithName((__bridge CFStringRef)[font fontName], [font pointSize], NULL);
+            } else {
+                //与 CoreText 未设置字体时的默认字体一致
+                self->_fonts[idx] = CTFontCreateWithName(CFSTR("Helvetica"), 12, NULL);
+            }
+        }];
+
+        _advanceTables = calloc(MAX(_fontCount, 1), sizeof(YLTextAdvanceTable *));
+        for (NSUInteger i = 0; usesAdvanceCache && i < _fontCount; i++) {
+            //PostScript 名称与字号相同的字体共用一张宽度表
+            NSString *name = CFBridgingRelease(CTFontCopyPostScriptName(_fonts[i]));
+            NSString *key = [NSString stringWithFormat:@"%@ %.17g", name, CTFontGetSize(_fonts[i])];
+            _advanceTables[i] = YLTextAdvanceCacheGet(key.UTF8String, coreTextMeasureGlyphs, (__bridge void *)self, (YLTextStyleID)i);
+        }
+
+        NSParagraphStyle *paragraphStyle = length ? [_attrString attribute:NSParagraphStyleAttributeName atIndex:0 effectiveRange:NULL] : nil;
+        _lineSpacing = paragraphStyle.lineSpacing;
+        _paragraphSpacing = paragraphStyle.paragraphSpacing;
+
+        _source.chars = _charactersData.bytes;
+        _source.length = length;
+        _source.runs = _runsData.bytes;
+        _source.runCount = _runsData.length / sizeof(YLTextStyleRun);
+
+        _metrics.context = (__bridge void *)self;
+        _metrics.measure = coreTextMeasure;
+        _metrics.fontMetrics = coreTextFontMetrics;
+        _metrics.attachmentSize = coreTextAttachmentSize;
+    }
+    return self;
+}
+
+- (const YLTextSource *)source{
+    return &_source;
+}
+
+- (const YLTextMetrics *)metrics{
+    return &_metrics;
+}
+
+#pragma mark - YLTextMetrics
+
+static CTFontRef fontForStyle(YLCoreTextMetrics *coreTextMetrics, YLTextStyleID style){
+    return coreTextMetrics->_fonts[style < coreTextMetrics->_fontCount ? style : 0];
+}
+
+static void coreTextMeasure(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances){
+    YLCoreTextMetrics *coreTextMetrics = (__bridge YLCoreTextMetrics *)context;
+    const YLTextAdvanceTable *table = coreTextMetrics->_advanceTables[style < coreTextMetrics->_fontCount ? style : 0];
+    if (table) {
+        YLTextAdvanceTableMeasure(table, chars, length, advances, coreTextMeasureGlyphs, context, style);
+    } else {
+        coreTextMeasureGlyphs(context, style, chars, length, advances);
+    }
+}
+
+/// 逐个取字形与宽度，不经过缓存
+static void coreTextMeasureGlyphs(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances){
+    CTFontRef font = fontForStyle((__bridge YLCoreTextMetrics *)context, style);
+    CGGlyph stackGlyphs[256];
+    CGSize stackSizes[256];
+    CGGlyph *glyphs = length > 256 ? malloc(length * sizeof(CGGlyph)) : stackGlyphs;
+    CGSize *sizes = length > 256 ? malloc(length * sizeof(CGSize)) : stackSizes;
+
+    /// 代理对的低位码元对应的字形为 0，宽度也为 0
+    CTFontGetGlyphsForCharacters(font, chars, glyphs, length);
+    CTFontGetAdvancesForGlyphs(font, kCTFontOrientationHorizontal, glyphs, sizes, length);
+    for (size_t i = 0; i < length; i++) {
+        advances[i] = sizes[i].width;
+    }
+
+    if (glyphs != stackGlyphs) {
+        free(glyphs);
+        free(sizes);
+    }
+}
+
+static YLTextFontMetrics coreTextFontMetrics(void *context, YLTextStyleID style){
+    CTFontRef font = fontForStyle((__bridge YLCoreTextMetrics *)context, style);
+    YLTextFontMetrics fontMetrics;
+    fontMetrics.ascent = CTFontGetAscent(font);
+    fontMetrics.descent = CTFontGetDescent(font);
+    fontMetrics.leading = CTFontGetLeading(font);
+    return fontMetrics;
+}
+
+static YLTextSize coreTextAttachmentSize(void *context, size_t index){
+    YLCoreTextMetrics *coreTextMetrics = (__bridge YLCoreTextMetrics *)context;
+    YLAttachment *attachment = [coreTextMetrics.attrString attribute:kYLAttachmentAttributeName atIndex:index effectiveRange:NULL];
+    YLTextSize size = {0, 0};
+    if ([attachment isKindOfClass:YLAttachment.class]) {
+        size.width = attachment.imageFrame.size.width;
+        size.height = attachment.imageFrame.size.height;
+    }
+    return size;
+}
+
+@end
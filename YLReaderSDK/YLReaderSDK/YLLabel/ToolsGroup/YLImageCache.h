@@ -0,0 +1,53 @@
+//
+//  YLImageCache.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void(^YLImageCacheCompletion)(UIImage * _Nullable image);
+
+/** 正文图片的缓存
+ * 内存中保存解码后的图片，按像素字节数限制总量；磁盘中保存原始数据，超出上限时淘汰最久未使用的文件
+ * 下载与解码都在后台队列完成，同一地址的并发请求只加载一次
+ */
+@interface YLImageCache : NSObject
+
++ (instancetype)sharedCache;
+
+/// 使用指定的磁盘缓存目录
+- (instancetype)initWithDirectory:(NSString *)directory NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// 内存缓存上限（解码后的字节数），默认 32 MB
+@property (nonatomic, assign) NSUInteger memoryLimit;
+
+/// 磁盘缓存上限（字节），默认 100 MB
+@property (nonatomic, assign) NSUInteger diskLimit;
+
+/// 内存中已解码的图片
+- (nullable UIImage *)cachedImageForURL:(NSString *)url;
+
+/** 已知的图片尺寸，未知时返回 CGSizeZero
+ * 依次查找内存中的图片、尺寸记录，以及磁盘文件的头部信息（不解码）
+ */
+- (CGSize)cachedSizeForURL:(NSString *)url;
+
+/** 异步加载图片：先查磁盘，再从 url 读取（支持 http(s) 与 file），在后台解码
+ * @param completion 在主线程回调，失败时 image 为 nil
+ */
+- (void)loadImageWithURL:(NSString *)url completion:(YLImageCacheCompletion)completion;
+
+/// 清空内存缓存
+- (void)removeAllMemoryCache;
+
+/// 清空内存与磁盘缓存
+- (void)removeAllCache;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,283 @@
+//
+//  YLImageCache.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLImageCache.h"
+#import <CommonCrypto/CommonDigest.h>
+#import <ImageIO/ImageIO.h>
+
+/// 解码图片：kCGImageSourceShouldCacheImmediately 使解码在创建时完成，而不是推迟到首次绘制
+static UIImage *decodeImageData(NSData *data){
+    if (data.length == 0) {
+        return nil;
+    }
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (source == NULL) {
+        return nil;
+    }
+    CGImageRef imageRef = CGImageSourceCreateImageAtIndex(source, 0, (__bridge CFDictionaryRef)@{(id)kCGImageSourceShouldCacheImmediately: @YES});
+    CFRelease(source);
+    if (imageRef == NULL) {
+        return nil;
+    }
+    UIImage *image = [UIImage imageWithCGImage:imageRef];
+    CGImageRelease(imageRef);
+    return image;
+}
+
+/// 读取图片文件头中的像素尺寸，不解码
+static CGSize imageSizeAtPath(NSString *path){
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:path], NULL);
+    if (source == NULL) {
+        return CGSizeZero;
+    }
+    CGSize size = CGSizeZero;
+    CFDictionaryRef properties = CGImageSourceCopyPropertiesAtIndex(source, 0, NULL);
+    if (properties) {
+        NSNumber *width = CFDictionaryGetValue(properties, kCGImagePropertyPixelWidth);
+        NSNumber *height = CFDictionaryGetValue(properties, kCGImagePropertyPixelHeight);
+        size = CGSizeMake(width.doubleValue, height.doubleValue);
+        CFRelease(properties);
+    }
+    CFRelease(source);
+    return size;
+}
+
+/// 解码后占用的字节数
+static NSUInteger imageCost(UIImage *image){
+    CGImageRef imageRef = image.CGImage;
+    return imageRef ? CGImageGetBytesPerRow(imageRef) * CGImageGetHeight(imageRef) : 0;
+}
+
+
+@interface YLImageCache ()
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, strong) NSCache<NSString *, UIImage *> *memoryCache;
+@property (nonatomic, strong) NSCache<NSString *, NSValue *> *sizeCache;
+
+/// 磁盘读写与等待中的回调都在该串行队列上处理
+@property (nonatomic, strong) dispatch_queue_t ioQueue;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<YLImageCacheCompletion> *> *pendingCallbacks;
+/// 磁盘缓存的总字节数，首次写入时统计；-1 表示尚未统计
+@property (nonatomic, assign) long long diskSize;
+
+@end
+
+@implementation YLImageCache
+
++ (instancetype)sharedCache{
+    static YLImageCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        cache = [[YLImageCache alloc] initWithDirectory:[caches stringByAppendingPathComponent:@"YLImageCache"]];
+    });
+    return cache;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory{
+    self = [super init];
+    if (self) {
+        _directory = [directory copy];
+        _memoryCache = [[NSCache alloc] init];
+        _sizeCache = [[NSCache alloc] init];
+        _sizeCache.countLimit = 2048;
+        _ioQueue = dispatch_queue_create("com.yl.imageCache.io", DISPATCH_QUEUE_SERIAL);
+        _pendingCallbacks = [NSMutableDictionary dictionary];
+        _diskSize = -1;
+        _diskLimit = 100 * 1024 * 1024;
+        self.memoryLimit = 32 * 1024 * 1024;
+        [NSFileManager.defaultManager createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+    }
+    return self;
+}
+
+- (void)setMemoryLimit:(NSUInteger)memoryLimit{
+    _memoryLimit = memoryLimit;
+    self.memoryCache.totalCostLimit = memoryLimit;
+}
+
+- (NSString *)pathForURL:(NSString *)url{
+    NSData *data = [url dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(data.bytes, (CC_LONG)data.length, digest);
+    NSMutableString *name = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [name appendFormat:@"%02x", digest[i]];
+    }
+    return [self.directory stringByAppendingPathComponent:name];
+}
+
+#pragma mark - 查询
+
+- (UIImage *)cachedImageForURL:(NSString *)url{
+    return url ? [self.memoryCache objectForKey:url] : nil;
+}
+
+- (CGSize)cachedSizeForURL:(NSString *)url{
+    if (url.length == 0) {
+        return CGSizeZero;
+    }
+    UIImage *image = [self.memoryCache objectForKey:url];
+    if (image) {
+        return image.size;
+    }
+    NSValue *value = [self.sizeCache objectForKey:url];
+    if (value) {
+        return value.CGSizeValue;
+    }
+    CGSize size = imageSizeAtPath([self pathForURL:url]);
+    if (!CGSizeEqualToSize(size, CGSizeZero)) {
+        [self.sizeCache setObject:[NSValue valueWithCGSize:size] forKey:url];
+    }
+    return size;
+}
+
+#pragma mark - 加载
+
+- (void)loadImageWithURL:(NSString *)url completion:(YLImageCacheCompletion)completion{
+    UIImage *image = [self cachedImageForURL:url];
+    if (image || url.length == 0) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(image);
+        });
+        return;
+    }
+    dispatch_async(self.ioQueue, ^{
+        NSMutableArray *callbacks = self.pendingCallbacks[url];
+        if (callbacks) {
+            //同一地址正在加载，等待其结果
+            [callbacks addObject:[completion copy]];
+            return;
+        }
+        self.pendingCallbacks[url] = [NSMutableArray arrayWithObject:[completion copy]];
+
+        NSString *path = [self pathForURL:url];
+        NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+        if (data) {
+            //更新修改时间，磁盘淘汰按最久未使用的顺序
+            [NSFileManager.defaultManager setAttributes:@{NSFileModificationDate: NSDate.date} ofItemAtPath:path error:nil];
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self finishLoadingURL:url data:data fromDisk:YES];
+            });
+        } else {
+            [self fetchDataWithURL:url completion:^(NSData *data) {
+                [self finishLoadingURL:url data:data fromDisk:NO];
+            }];
+        }
+    });
+}
+
+/// 在后台线程读取原始数据
+- (void)fetchDataWithURL:(NSString *)url completion:(void(^)(NSData * _Nullable data))completion{
+    NSURL *URL = [NSURL URLWithString:url];
+    if (URL == nil) {
+        URL = [NSURL URLWithString:[url stringByAddingPercentEncodingWithAllowedCharacters:NSCharacterSet.URLQueryAllowedCharacterSet]];
+    }
+    if (URL == nil) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            completion(nil);
+        });
+        return;
+    }
+    if (URL.isFileURL) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            completion([NSData dataWithContentsOfURL:URL]);
+        });
+        return;
+    }
+    [[NSURLSession.sharedSession dataTaskWithURL:URL completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        NSInteger statusCode = [response isKindOfClass:NSHTTPURLResponse.class] ? ((NSHTTPURLResponse *)response).statusCode : 200;
+        completion(error == nil && statusCode < 400 ? data : nil);
+    }] resume];
+}
+
+/// 在后台线程解码并写入缓存，然后回调所有等待该地址的请求
+- (void)finishLoadingURL:(NSString *)url data:(NSData *)data fromDisk:(BOOL)fromDisk{
+    UIImage *image = decodeImageData(data);
+    if (image) {
+        [self.memoryCache setObject:image forKey:url cost:imageCost(image)];
+        [self.sizeCache setObject:[NSValue valueWithCGSize:image.size] forKey:url];
+    }
+    dispatch_async(self.ioQueue, ^{
+        if (image && !fromDisk) {
+            [self writeData:data forURL:url];
+        }
+        NSArray<YLImageCacheCompletion> *callbacks = self.pendingCallbacks[url];
+        [self.pendingCallbacks removeObjectForKey:url];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            for (YLImageCacheCompletion callback in callbacks) {
+                callback(image);
+            }
+        });
+    });
+}
+
+#pragma mark - 磁盘
+
+/// 在 ioQueue 上调用
+- (void)writeData:(NSData *)data forURL:(NSString *)url{
+    if (![data writeToFile:[self pathForURL:url] atomically:YES]) {
+        return;
+    }
+    if (self.diskSize < 0) {
+        self.diskSize = 0;
+        for (NSURL *fileURL in [self diskFiles]) {
+            NSNumber *size;
+            [fileURL getResourceValue:&size forKey:NSURLFileSizeKey error:nil];
+            self.diskSize += size.longLongValue;
+        }
+    } else {
+        self.diskSize += data.length;
+    }
+    if (self.diskSize > (long long)self.diskLimit) {
+        [self trimDiskToSize:self.diskLimit * 0.8];
+    }
+}
+
+- (NSArray<NSURL *> *)diskFiles{
+    return [NSFileManager.defaultManager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:self.directory] includingPropertiesForKeys:@[NSURLFileSizeKey, NSURLContentModificationDateKey] options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+}
+
+/// 按修改时间从旧到新删除文件，直到总大小不超过 size
+- (void)trimDiskToSize:(NSUInteger)size{
+    NSArray<NSURL *> *files = [[self diskFiles] sortedArrayUsingComparator:^NSComparisonResult(NSURL *obj1, NSURL *obj2) {
+        NSDate *date1, *date2;
+        [obj1 getResourceValue:&date1 forKey:NSURLContentModificationDateKey error:nil];
+        [obj2 getResourceValue:&date2 forKey:NSURLContentModificationDateKey error:nil];
+        return [date1 compare:date2];
+    }];
+    for (NSURL *fileURL in files) {
+        if (self.diskSize <= (long long)size) {
+            break;
+        }
+        NSNumber *fileSize;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+        if ([NSFileManager.defaultManager removeItemAtURL:fileURL error:nil]) {
+            self.diskSize -= fileSize.longLongValue;
+        }
+    }
+}
+
+#pragma mark - 清理
+
+- (void)removeAllMemoryCache{
+    [self.memoryCache removeAllObjects];
+    [self.sizeCache removeAllObjects];
+}
+
+- (void)removeAllCache{
+    [self removeAllMemoryCache];
+    dispatch_sync(self.ioQueue, ^{
+        for (NSURL *fileURL in [self diskFiles]) {
+            [NSFileManager.defaultManager removeItemAtURL:fileURL error:nil];
+        }
+        self.diskSize = 0;
+    });
+}
+
+@end
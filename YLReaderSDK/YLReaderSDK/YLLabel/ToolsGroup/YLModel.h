@@ -12,6 +12,11 @@
 
 UIKIT_EXTERN NSAttributedStringKey const _Nonnull kYLAttachmentAttributeName;
 
+/// 正文图片在后台加载完成，object 为对应的 YLAttachment
+UIKIT_EXTERN NSNotificationName const _Nonnull YLAttachmentImageDidLoadNotification;
+/// NSNumber(BOOL)，图片的展示尺寸与占位尺寸不同，需要重新分页
+UIKIT_EXTERN NSString * const _Nonnull YLAttachmentImageSizeChangedKey;
+
 NS_ASSUME_NONNULL_BEGIN
 
 //富文本中的链接（图片、网页）
@@ -39,6 +44,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) NSInteger page;
 /// 当前页文字范围
 @property (nonatomic, assign) NSRange range;
+/// 当前页在整本书中的起始位置（UTF-16），处理标签之前的原文位置
+@property (nonatomic, assign) NSUInteger bookLocation;
 /// 当前页 CTFrame
 @property (nonatomic ,assign) CTFrameRef frameRef;
 /// 当前页高度
@@ -9,6 +9,8 @@
 #import "YLModel.h"
 
 NSAttributedStringKey const kYLAttachmentAttributeName = @"com.yl.attachment";
+NSNotificationName const YLAttachmentImageDidLoadNotification = @"YLAttachmentImageDidLoadNotification";
+NSString * const YLAttachmentImageSizeChangedKey = @"YLAttachmentImageSizeChangedKey";
 
 @implementation YLAttachment
 
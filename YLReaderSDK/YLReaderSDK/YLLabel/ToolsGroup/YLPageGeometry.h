@@ -0,0 +1,58 @@
+//
+//  YLPageGeometry.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** 一页 CTFrame 的行、段几何索引
+ * 创建时遍历一次所有行与 CTRun，记录视图坐标系中的行矩形、文字范围与段的横向区间；
+ * 之后的点击测试都是二分查找，适合拖动选择这类高频查询
+ */
+@interface YLPageGeometry : NSObject
+
+- (instancetype)initWithCTFrame:(CTFrameRef)frameRef NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) CTFrameRef frameRef;
+@property (nonatomic, readonly) NSUInteger lineCount;
+
+/// 第 index 行的矩形（未扩展）
+- (CGRect)lineFrameAtIndex:(NSUInteger)index;
+
+/// 第 index 行的文字范围
+- (NSRange)lineRangeAtIndex:(NSUInteger)index;
+
+/// 触摸点所在的行，行矩形向外扩展 5pt；没有时返回 NSNotFound
+- (NSUInteger)lineIndexAtPoint:(CGPoint)point;
+
+/// 包含文字位置 location 的行，没有时返回 NSNotFound
+- (NSUInteger)lineIndexAtLocation:(NSUInteger)location;
+
+/// 触摸点所在的行 CTLine
+- (nullable CTLineRef)lineAtPoint:(CGPoint)point;
+
+/// 触摸点所在的 CTRun
+- (nullable CTRunRef)runAtPoint:(CGPoint)point;
+
+/// 触摸位置那一行文字范围，没有时 location 为 NSNotFound
+- (NSRange)lineRangeAtPoint:(CGPoint)point;
+
+/// 触摸位置文字的 Location，没有时返回 -1
+- (signed long)locationAtPoint:(CGPoint)point;
+
+/// 触摸点的 YLAttachment
+- (nullable YLAttachment *)attachmentAtPoint:(CGPoint)point;
+
+/** 文字范围所覆盖的区域，每行一个矩形，以左下角为原点（与 CTFrame 相同）
+ * @param content 页面文字，有值时去除每行开头的空白与结尾的换行符；每行的去除位置只计算一次
+ */
+- (NSMutableArray<NSValue *> *)rectsForRange:(NSRange)range content:(nullable NSString *)content;
+
+@end
+
+NS_ASSUME_NONNULL_END
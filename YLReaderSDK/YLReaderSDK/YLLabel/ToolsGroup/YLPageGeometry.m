@@ -0,0 +1,214 @@
+//
+//  YLPageGeometry.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLPageGeometry.h"
+#import "YLTextGeometry.h"
+
+/// 行矩形向外扩展的距离，便于点中行间空隙
+static const CGFloat kYLTouchLineInset = 5;
+
+@implementation YLPageGeometry
+{
+    YLTextGeometry _geometry;
+    CGFloat _pageHeight;
+    /// 计算行首空白与行尾换行符时使用的页面文字
+    NSString *_trimmedContent;
+}
+
+- (instancetype)initWithCTFrame:(CTFrameRef)frameRef{
+    self = [super init];
+    if (self) {
+        YLTextGeometryInit(&_geometry);
+        if (frameRef) {
+            _frameRef = (CTFrameRef)CFRetain(frameRef);
+            [self buildIndex];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc{
+    YLTextGeometryDestroy(&_geometry);
+    if (_frameRef) {
+        CFRelease(_frameRef);
+    }
+}
+
+/// CTFrame 以左下角为原点，转换为视图坐标系后记录
+- (void)buildIndex{
+    CGRect bounds = CGPathGetBoundingBox(CTFrameGetPath(_frameRef));/// 页面边界
+    CGFloat pageWidth = CGRectGetWidth(bounds);
+    CGFloat pageHeight = CGRectGetHeight(bounds);
+    _pageHeight = pageHeight;
+
+    CFArrayRef lines = CTFrameGetLines(_frameRef);
+    CFIndex lineCount = CFArrayGetCount(lines);
+    if (lineCount < 1) {
+        return;
+    }
+    CGPoint *origins = malloc(lineCount * sizeof(CGPoint));
+    if (origins == NULL) {
+        return;
+    }
+    CTFrameGetLineOrigins(_frameRef, CFRangeMake(0, 0), origins);
+    for (CFIndex i = 0; i < lineCount; i++) {
+        CGPoint origin = origins[i];
+        CTLineRef line = CFArrayGetValueAtIndex(lines, i);
+        CGFloat lineAscent = 0;  //上行高度
+        CGFloat lineDescent = 0; //下行高度
+        CGFloat lineLeading = 0; //行距
+        CTLineGetTypographicBounds(line, &lineAscent, &lineDescent, &lineLeading);
+        YLTextGeometryRect frame = {origin.x, pageHeight - (origin.y + lineAscent), pageWidth, lineAscent + fabs(lineDescent) + lineLeading};
+        YLTextFontMetrics metrics = {lineAscent, lineDescent, lineLeading};
+        CFRange lineRange = CTLineGetStringRange(line);
+        if (!YLTextGeometryAddLine(&_geometry, frame, metrics, lineRange.location, lineRange.length)) {
+            break;
+        }
+
+        CFArrayRef runs = CTLineGetGlyphRuns(line);
+        CFIndex runCount = CFArrayGetCount(runs);
+        for (CFIndex j = 0; j < runCount; j++) {
+            CTRunRef run = CFArrayGetValueAtIndex(runs, j);
+            if (CTRunGetGlyphCount(run) < 1) {
+                //保持段的序号与 CTLineGetGlyphRuns 一致
+                YLTextGeometryAddRun(&_geometry, INFINITY, INFINITY, 0, 0);
+                continue;
+            }
+            CGPoint position;
+            CTRunGetPositions(run, CFRangeMake(0, 1), &position);
+            CGFloat width = CTRunGetTypographicBounds(run, CFRangeMake(0, 0), NULL, NULL, NULL);
+            CFRange runRange = CTRunGetStringRange(run);
+            YLTextGeometryAddRun(&_geometry, origin.x + position.x, origin.x + position.x + width, runRange.location, runRange.length);
+        }
+    }
+    free(origins);
+}
+
+- (NSUInteger)lineCount{
+    return _geometry.lineCount;
+}
+
+- (CGRect)lineFrameAtIndex:(NSUInteger)index{
+    if (index >= _geometry.lineCount) {
+        return CGRectNull;
+    }
+    YLTextGeometryRect frame = _geometry.lines[index].frame;
+    return CGRectMake(frame.x, frame.y, frame.width, frame.height);
+}
+
+- (NSRange)lineRangeAtIndex:(NSUInteger)index{
+    if (index >= _geometry.lineCount) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    return NSMakeRange(_geometry.lines[index].location, _geometry.lines[index].length);
+}
+
+- (NSUInteger)lineIndexAtPoint:(CGPoint)point{
+    size_t index = YLTextGeometryLineAtPoint(&_geometry, point.x, point.y, kYLTouchLineInset);
+    return index == YLTextGeometryNotFound ? NSNotFound : index;
+}
+
+- (NSUInteger)lineIndexAtLocation:(NSUInteger)location{
+    size_t index = YLTextGeometryLineAtLocation(&_geometry, location);
+    return index == YLTextGeometryNotFound ? NSNotFound : index;
+}
+
+- (CTLineRef)lineAtPoint:(CGPoint)point{
+    NSUInteger index = [self lineIndexAtPoint:point];
+    if (index == NSNotFound) {
+        return NULL;
+    }
+    return CFArrayGetValueAtIndex(CTFrameGetLines(_frameRef), index);
+}
+
+- (CTRunRef)runAtPoint:(CGPoint)point{
+    NSUInteger index = [self lineIndexAtPoint:point];
+    if (index == NSNotFound) {
+        return NULL;
+    }
+    size_t run = YLTextGeometryRunAtX(&_geometry, index, point.x);
+    if (run == YLTextGeometryNotFound) {
+        return NULL;
+    }
+    CTLineRef line = CFArrayGetValueAtIndex(CTFrameGetLines(_frameRef), index);
+    return CFArrayGetValueAtIndex(CTLineGetGlyphRuns(line), _geometry.runs[run].index);
+}
+
+- (NSRange)lineRangeAtPoint:(CGPoint)point{
+    return [self lineRangeAtIndex:[self lineIndexAtPoint:point]];
+}
+
+- (signed long)locationAtPoint:(CGPoint)point{
+    CTLineRef line = [self lineAtPoint:point];
+    return line ? CTLineGetStringIndexForPosition(line, point) : -1;
+}
+
+- (YLAttachment *)attachmentAtPoint:(CGPoint)point{
+    CTRunRef run = [self runAtPoint:point];
+    if (run == NULL) {
+        return nil;
+    }
+    CFDictionaryRef attributes = CTRunGetAttributes(run);
+    if (attributes == NULL) {
+        return nil;
+    }
+    return (__bridge YLAttachment *)CFDictionaryGetValue(attributes, (__bridge CFStringRef)kYLAttachmentAttributeName);
+}
+
+#pragma mark - 选中区域
+
+/// 按页面文字计算每行的行首空白与行尾换行符，同一文字只计算一次
+- (void)updateTrimsWithContent:(NSString *)content{
+    if (content == _trimmedContent) {
+        return;
+    }
+    NSUInteger length = content.length;
+    unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+    if (characters == NULL) {
+        return;
+    }
+    [content getCharacters:characters range:NSMakeRange(0, length)];
+    YLTextGeometrySetTrims(&_geometry, characters, length);
+    free(characters);
+    _trimmedContent = content;
+}
+
+- (NSMutableArray<NSValue *> *)rectsForRange:(NSRange)range content:(NSString *)content{
+    NSMutableArray<NSValue *> *rects = [NSMutableArray array];
+    if (range.length == 0 || range.location == NSNotFound || _geometry.lineCount == 0) {
+        return rects;
+    }
+    BOOL trim = content.length > 0;
+    if (trim) {
+        [self updateTrimsWithContent:content];
+    }
+    size_t first = YLTextGeometryLineAtLocation(&_geometry, range.location);
+    if (first == YLTextGeometryNotFound) {
+        if (range.location >= _geometry.lines[0].location) {
+            return rects;
+        }
+        first = 0;
+    }
+    CFArrayRef lines = CTFrameGetLines(_frameRef);
+    for (size_t i = first; i < _geometry.lineCount && _geometry.lines[i].location < NSMaxRange(range); i++) {
+        size_t start, end;
+        if (!YLTextGeometryClipRange(&_geometry, i, range.location, range.length, trim, &start, &end)) {
+            continue;
+        }
+        const YLTextGeometryLine *info = &_geometry.lines[i];
+        CTLineRef line = CFArrayGetValueAtIndex(lines, i);
+        CGFloat xStart = CTLineGetOffsetForStringIndex(line, start, NULL);
+        CGFloat xEnd = CTLineGetOffsetForStringIndex(line, end, NULL);
+        //与 CTFrame 相同，以左下角为原点
+        CGFloat originY = _pageHeight - info->frame.y - info->metrics.ascent;
+        CGRect contentRect = CGRectMake(info->frame.x + MIN(xStart, xEnd), originY - info->metrics.descent, fabs(xEnd - xStart), info->metrics.ascent + info->metrics.descent + info->metrics.leading);
+        [rects addObject:[NSValue valueWithCGRect:contentRect]];
+    }
+    return rects;
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  YLPageRasterCache.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** 页面位图缓存
+ * 每次翻页后在后台渲染当前页与前后几页的 CTFrame（YLPageBitmapCache），
+ * 页面出现时直接使用位图，翻页动画期间主线程不再排版绘制文字
+ */
+@interface YLPageRasterCache : NSObject
+
+/** @param byteBudget 位图占用内存的上限
+ * @param prefetchCount 阅读方向上预先渲染的页数，反方向渲染一半
+ */
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget prefetchCount:(NSUInteger)prefetchCount NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/** 翻页后调用，在后台渲染窗口内缺少的页
+ * @param pageModels 全部页面，只记录窗口内的页面供后台渲染
+ * @note 须在主线程调用，此时复制页面中的图片与位置，后台渲染不再读取 YLAttachment
+ */
+- (void)setCurrentPage:(NSInteger)page pageModels:(NSArray<YLPageModel *> *)pageModels;
+
+/// 页面内容或页码变化（重排、图片加载）后调用，丢弃所有位图
+- (void)removeAllImages;
+
+/// 已渲染的第 page 页位图，没有时返回 nil
+- (nullable UIImage *)imageForPage:(NSInteger)page;
+
+@end
+
+NS_ASSUME_NONNULL_END
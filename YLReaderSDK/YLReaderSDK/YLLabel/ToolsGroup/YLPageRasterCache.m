@@ -0,0 +1,162 @@
+//
+//  YLPageRasterCache.m
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#import "YLPageRasterCache.h"
+#import "YLCoreText.h"
+#import "YLPageBitmapCache.h"
+
+/// 后台渲染一页所需的内容；图片与位置在主线程从 YLAttachment 复制，后台不再读取 YLAttachment
+@interface YLPageRasterSnapshot : NSObject
+@property (nonatomic, strong) YLPageModel *model;
+@property (nonatomic, copy) NSArray<UIImage *> *images;
+@property (nonatomic, copy) NSArray<NSValue *> *imageFrames;
+@end
+
+@implementation YLPageRasterSnapshot
+@end
+
+@interface YLPageRasterCache ()
+{
+    YLPageBitmapCache *_cache;
+    dispatch_queue_t _renderQueue;
+}
+@property (nonatomic, assign) NSUInteger prefetchCount;
+@property (nonatomic, assign) CGFloat scale;
+/// 窗口内的页面，后台渲染时读取，访问时加锁
+@property (nonatomic, copy) NSDictionary<NSNumber *, YLPageRasterSnapshot *> *windowSnapshots;
+
+@end
+
+@implementation YLPageRasterCache
+
+#pragma mark - YLPageRasterizer
+
+/// 在后台线程把第 page 页的 CTFrame 与图片绘制为位图，坐标与 -[YLLabel drawRect:] 相同
+static bool YLPageRasterCacheRender(void *context, size_t page, YLPageBitmap *bitmap){
+    YLPageRasterCache *rasterCache = (__bridge YLPageRasterCache *)context;
+    YLPageRasterSnapshot *snapshot;
+    @synchronized (rasterCache) {
+        snapshot = rasterCache.windowSnapshots[@(page)];
+    }
+    YLPageModel *model = snapshot.model;
+    if (model == nil || model.frameRef == NULL) {
+        return false;
+    }
+    CGFloat scale = rasterCache.scale;
+    CGSize size = CGSizeMake(CGRectGetWidth(CGPathGetBoundingBox(CTFrameGetPath(model.frameRef))), model.contentHeight);
+    size_t width = (size_t)ceil(size.width * scale);
+    size_t height = (size_t)ceil(size.height * scale);
+    if (width == 0 || height == 0) {
+        return false;
+    }
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef ctx = CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace, kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Host);
+    CGColorSpaceRelease(colorSpace);
+    if (ctx == NULL) {
+        return false;
+    }
+    //位图本身就是 CoreText 坐标系（左下角为原点），只需缩放
+    CGContextScaleCTM(ctx, scale, scale);
+    CGContextSetTextMatrix(ctx, CGAffineTransformIdentity);
+    CTFrameDraw(model.frameRef, ctx);
+    [snapshot.images enumerateObjectsUsingBlock:^(UIImage * _Nonnull image, NSUInteger idx, BOOL * _Nonnull stop) {
+        CGContextDrawImage(ctx, snapshot.imageFrames[idx].CGRectValue, image.CGImage);
+    }];
+    CGImageRef image = CGBitmapContextCreateImage(ctx);
+    CGContextRelease(ctx);
+    if (image == NULL) {
+        return false;
+    }
+    bitmap->image = (void *)image;
+    bitmap->byteCount = CGImageGetBytesPerRow(image) * height;
+    return true;
+}
+
+static void YLPageRasterCacheRetain(void *context, YLPageBitmap bitmap){
+    CGImageRetain((CGImageRef)bitmap.image);
+}
+
+static void YLPageRasterCacheRelease(void *context, YLPageBitmap bitmap){
+    CGImageRelease((CGImageRef)bitmap.image);
+}
+
+#pragma mark - 初始化
+
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget prefetchCount:(NSUInteger)prefetchCount{
+    self = [super init];
+    if (self) {
+        YLPageRasterizer rasterizer = {(__bridge void *)self, YLPageRasterCacheRender, YLPageRasterCacheRetain, YLPageRasterCacheRelease};
+        _cache = YLPageBitmapCacheCreate(rasterizer, byteBudget, prefetchCount);
+        _renderQueue = dispatch_queue_create("com.yl.pageRaster", DISPATCH_QUEUE_SERIAL);
+        _prefetchCount = prefetchCount;
+        _scale = UIScreen.mainScreen.scale;
+    }
+    return self;
+}
+
+- (void)dealloc{
+    YLPageBitmapCacheDestroy(_cache);
+}
+
+#pragma mark - 接口
+
+- (void)setCurrentPage:(NSInteger)page pageModels:(NSArray<YLPageModel *> *)pageModels{
+    if (_cache == NULL || page < 0 || page >= (NSInteger)pageModels.count) {
+        return;
+    }
+    NSInteger first = MAX(0, page - (NSInteger)self.prefetchCount);
+    NSInteger last = MIN((NSInteger)pageModels.count - 1, page + (NSInteger)self.prefetchCount);
+    NSMutableDictionary<NSNumber *, YLPageRasterSnapshot *> *windowSnapshots = [NSMutableDictionary dictionary];
+    for (NSInteger i = first; i <= last; i++) {
+        windowSnapshots[@(i)] = [self snapshotOfPageModel:pageModels[i]];
+    }
+    @synchronized (self) {
+        self.windowSnapshots = windowSnapshots;
+    }
+    YLPageBitmapCacheSetPageCount(_cache, pageModels.count);
+    YLPageBitmapCacheSetCurrentPage(_cache, page);
+    dispatch_async(_renderQueue, ^{
+        YLPageBitmapCacheRenderPending(self->_cache, SIZE_MAX);
+    });
+}
+
+/// 在主线程调用：图片加载完成时 YLAttachment 在主线程更新
+- (YLPageRasterSnapshot *)snapshotOfPageModel:(YLPageModel *)pageModel{
+    YLPageRasterSnapshot *snapshot = [[YLPageRasterSnapshot alloc] init];
+    snapshot.model = pageModel;
+    NSMutableArray<UIImage *> *images = [NSMutableArray array];
+    NSMutableArray<NSValue *> *imageFrames = [NSMutableArray array];
+    if (pageModel.frameRef) {
+        for (YLAttachment *attachment in [YLCoreText getImagesWithCTFrame:pageModel.frameRef]) {
+            if (attachment.image) {
+                [images addObject:attachment.image];
+                [imageFrames addObject:[NSValue valueWithCGRect:attachment.imageFrame]];
+            }
+        }
+    }
+    snapshot.images = images;
+    snapshot.imageFrames = imageFrames;
+    return snapshot;
+}
+
+- (void)removeAllImages{
+    if (_cache) {
+        YLPageBitmapCacheRemoveAll(_cache);
+    }
+}
+
+- (UIImage *)imageForPage:(NSInteger)page{
+    YLPageBitmap bitmap;
+    if (_cache == NULL || page < 0 || !YLPageBitmapCacheCopyBitmap(_cache, page, &bitmap)) {
+        return nil;
+    }
+    UIImage *image = [UIImage imageWithCGImage:(CGImageRef)bitmap.image scale:self.scale orientation:UIImageOrientationUp];
+    YLPageBitmapCacheReleaseBitmap(_cache, bitmap);
+    return image;
+}
+
+@end
@@ -24,6 +24,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// 当前页内容(使用固定范围绘制)
 @property (nonatomic ,assign) CTFrameRef frameRef;
 
+/// 后台预先渲染的当前页位图（YLPageRasterCache），有值时直接绘制位图；设置 frameRef 时清空
+@property (nonatomic ,strong ,nullable) UIImage *rasterImage;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -7,12 +7,15 @@
 //
 
 #import "YLLabel.h"
+#import "YLPageGeometry.h"
 
 @interface YLLabel ()
 {
     UITapGestureRecognizer *_tapGestureRecognizer;
 }
 @property (nonatomic ,assign) BOOL isTap;
+/// 当前页的几何索引，首次点击时创建
+@property (nonatomic ,strong) YLPageGeometry *geometry;
 
 @end
 
@@ -68,7 +71,7 @@
 
 - (void)tapGestureRecognizerClick:(UITapGestureRecognizer *)tapRecognizer{
     CGPoint point = [tapRecognizer locationInView:self];
-    YLAttachment *attachment = getTouchAttachment(point, _frameRef);
+    YLAttachment *attachment = [self.geometry attachmentAtPoint:point];
     if (attachment && attachment.url) {
          if (self.delegate && [self.delegate respondsToSelector:@selector(touchYLLabel:url:)]) {
              [self.delegate touchYLLabel:self url:attachment.url];
@@ -77,8 +80,19 @@
 }
 
 
+- (YLPageGeometry *)geometry{
+    if (_geometry == nil && _frameRef) {
+        _geometry = [[YLPageGeometry alloc] initWithCTFrame:_frameRef];
+    }
+    return _geometry;
+}
+
 /// 绘制
 - (void)drawRect:(CGRect)rect{
+    if (_rasterImage) {
+        [_rasterImage drawInRect:CGRectMake(0, 0, _rasterImage.size.width, _rasterImage.size.height)];
+        return;
+    }
     if (_frameRef == nil) {
         return;
     }
@@ -105,9 +119,16 @@
     }
     _frameRef = frameRef;
     CFRetain(frameRef);
+    _geometry = nil;
+    _rasterImage = nil;
     if (frameRef) {
         [self setNeedsDisplay];
     }
 }
 
+- (void)setRasterImage:(UIImage *)rasterImage{
+    _rasterImage = rasterImage;
+    [self setNeedsDisplay];
+}
+
 @end
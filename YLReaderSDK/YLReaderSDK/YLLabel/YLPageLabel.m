@@ -8,6 +8,7 @@
 
 #import "YLPageLabel.h"
 #import "YLLabel.h"
+#import "YLCollectionScrollLayout.h"
 
 @interface YLPageCollectionCell : UICollectionViewCell
 @property (nonatomic ,strong) YLLabel *label;
@@ -29,6 +30,7 @@
 - (void)setModel:(YLPageModel *)model{
     _model = model;
     self.label.frameRef = model.frameRef;
+    self.label.rasterImage = [YLReaderManager.shareReader.rasterCache imageForPage:model.page];
     self.label.frame = CGRectMake(0, 0, CGRectGetWidth(self.contentView.bounds), _model.contentHeight);
 }
 
@@ -41,7 +43,14 @@
 YLLabelDelegate>
 
 @property (nonatomic ,strong) UICollectionView *collectionView;
+/// 翻页模式的布局
+@property (nonatomic ,strong) YLCollectionTransitionAnimationLayout *transitionLayout;
+/// 滚动模式的布局
+@property (nonatomic ,strong) YLCollectionScrollLayout *scrollLayout;
 @property (nonatomic ,strong) NSMutableArray<YLLabel *> *labelsArray;
+/// 滚动模式下可见的页与滚过的距离；页面更新后据此恢复位置，插入的页面不会把可见内容挤开
+@property (nonatomic ,strong) YLPageModel *visiblePageModel;
+@property (nonatomic ,assign) CGFloat visibleOffsetInPage;
 
 @end
 
@@ -56,10 +65,41 @@ YLLabelDelegate>
     if (self) {
         self.backgroundColor = UIColor.clearColor;
         [self addSubview:self.collectionView];
+        [NSNotificationCenter.defaultCenter addObserver:self selector:@selector(readerManagerDidLoadChapter) name:YLReaderManagerDidLoadChapterNotification object:nil];
+        [NSNotificationCenter.defaultCenter addObserver:self selector:@selector(readerManagerDidUpdatePages) name:YLReaderManagerDidUpdatePagesNotification object:nil];
     }
     return self;
 }
 
+/// 新章节的页面已追加到 pageModelsArray
+- (void)readerManagerDidLoadChapter{
+    [self.collectionView reloadData];
+}
+
+/// 图片加载、重排或读取上一章节后页面有更新，当前页的页码可能平移
+- (void)readerManagerDidUpdatePages{
+    [self.collectionView reloadData];
+    [self.collectionView layoutIfNeeded];
+    if (self.transitionType != YLCollectionTransitionScroll) {
+        [self scrollToPage];
+        return;
+    }
+    //可见的页仍在时保持它在屏幕上的位置，否则（如被重新分页）滚动到当前页
+    YLPageModel *model = self.visiblePageModel;
+    NSInteger page = model.page;
+    CGFloat offsetInPage = self.visibleOffsetInPage;
+    if (model == nil || page < 0 || page >= (NSInteger)self.pageModelsArray.count || self.pageModelsArray[page] != model) {
+        page = YLReaderManager.shareReader.page;
+        offsetInPage = 0;
+    }
+    if (page < 0 || page >= (NSInteger)self.pageModelsArray.count) {
+        return;
+    }
+    CGFloat maxOffset = MAX(0, self.collectionView.contentSize.height - CGRectGetHeight(self.collectionView.bounds));
+    CGFloat offset = MIN(MAX(0, [self.scrollLayout offsetForItem:page] + offsetInPage), maxOffset);
+    self.collectionView.contentOffset = CGPointMake(self.collectionView.contentOffset.x, offset);
+}
+
 #pragma mark - YLLabelDelegate
 
 - (void)touchYLLabel:(YLLabel *)label url:(NSString *)url{
@@ -74,20 +114,26 @@ YLLabelDelegate>
     [self.collectionView scrollToItemAtIndexPath:[NSIndexPath indexPathForRow:YLReaderManager.shareReader.page inSection:0] atScrollPosition:UICollectionViewScrollPositionNone animated:NO];
 }
 
+/// 只在所在页变化时更新 YLReaderManager.page，滚动过程中的其余回调不触发读取章节与渲染
 - (void)scrollViewDidScroll:(UIScrollView *)scrollView{
+    NSInteger page = NSNotFound;
     if (self.transitionType == YLCollectionTransitionScroll) {
-        
-    }else{
-        YLReaderManager.shareReader.page = (NSInteger)scrollView.contentOffset.x / CGRectGetWidth(scrollView.bounds);
+        page = [self.scrollLayout itemAtOffset:scrollView.contentOffset.y];
+        if (page != NSNotFound && page < (NSInteger)self.pageModelsArray.count) {
+            self.visiblePageModel = self.pageModelsArray[page];
+            self.visibleOffsetInPage = scrollView.contentOffset.y - [self.scrollLayout offsetForItem:page];
+        }
+    }else if (CGRectGetWidth(scrollView.bounds) > 0) {
+        page = (NSInteger)(scrollView.contentOffset.x / CGRectGetWidth(scrollView.bounds));
+    }
+    if (page != NSNotFound && page != YLReaderManager.shareReader.page) {
+        YLReaderManager.shareReader.page = page;
     }
 }
 
+/// 只有翻页模式的 YLCollectionTransitionAnimationLayout 会调用；滚动模式的页高由 YLCollectionScrollLayout 一次读取
 - (CGSize)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout*)collectionViewLayout sizeForItemAtIndexPath:(NSIndexPath *)indexPath{
-    if (self.transitionType == YLCollectionTransitionScroll) {
-        return CGSizeMake(CGRectGetWidth(collectionView.bounds), self.pageModelsArray[indexPath.row].contentHeight);
-    }else{
-        return CGSizeMake(CGRectGetWidth(collectionView.bounds), CGRectGetHeight(collectionView.bounds));
-    }
+    return CGSizeMake(CGRectGetWidth(collectionView.bounds), CGRectGetHeight(collectionView.bounds));
 }
 
 - (NSInteger)collectionView:(UICollectionView *)collectionView numberOfItemsInSection:(NSInteger)section{
@@ -116,28 +162,46 @@ YLLabelDelegate>
 }
 
 - (void)setTransitionType:(YLCollectionTransitionType)transitionType{
-    YLCollectionTransitionAnimationLayout *transitionLayout = (YLCollectionTransitionAnimationLayout *)self.collectionView.collectionViewLayout;
-    transitionLayout.transitionType = transitionType;
+    _transitionType = transitionType;
     if (transitionType == YLCollectionTransitionScroll) {
         self.collectionView.pagingEnabled = NO;
+        if (self.collectionView.collectionViewLayout != self.scrollLayout) {
+            [self.collectionView setCollectionViewLayout:self.scrollLayout animated:NO];
+        }
     }else{
         self.collectionView.pagingEnabled = YES;
+        self.transitionLayout.transitionType = transitionType;
+        if (self.collectionView.collectionViewLayout != self.transitionLayout) {
+            [self.collectionView setCollectionViewLayout:self.transitionLayout animated:NO];
+        }
     }
     [self.collectionView reloadData];
 }
 
-- (YLCollectionTransitionType)transitionType{
-    YLCollectionTransitionAnimationLayout *transitionLayout = (YLCollectionTransitionAnimationLayout *)self.collectionView.collectionViewLayout;
-    return transitionLayout.transitionType;
+- (YLCollectionTransitionAnimationLayout *)transitionLayout{
+    if (_transitionLayout == nil) {
+        _transitionLayout = [[YLCollectionTransitionAnimationLayout alloc] init];
+        _transitionLayout.transitionType = YLCollectionTransitionOpen;
+        _transitionLayout.scrollDirection = UICollectionViewScrollDirectionHorizontal;
+    }
+    return _transitionLayout;
+}
+
+- (YLCollectionScrollLayout *)scrollLayout{
+    if (_scrollLayout == nil) {
+        _scrollLayout = [[YLCollectionScrollLayout alloc] init];
+        __weak typeof(self) weakSelf = self;
+        _scrollLayout.itemHeightProvider = ^CGFloat(NSInteger item) {
+            return weakSelf.pageModelsArray[item].contentHeight;
+        };
+    }
+    return _scrollLayout;
 }
 
 - (UICollectionView *)collectionView{
     if (_collectionView == nil){
-        YLCollectionTransitionAnimationLayout *flowLayout = [[YLCollectionTransitionAnimationLayout alloc] init];
-        flowLayout.transitionType = YLCollectionTransitionOpen;
-        flowLayout.scrollDirection = UICollectionViewScrollDirectionHorizontal;
-        
-        _collectionView = [[UICollectionView alloc] initWithFrame:UIScreen.mainScreen.bounds collectionViewLayout:flowLayout];
+        _transitionType = YLCollectionTransitionOpen;
+        _collectionView = [[UICollectionView alloc] initWithFrame:UIScreen.mainScreen.bounds collectionViewLayout:self.transitionLayout];
         _collectionView.showsVerticalScrollIndicator = NO;
         _collectionView.showsHorizontalScrollIndicator = NO;
         _collectionView.delegate = self;
@@ -17,6 +17,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)controllerWithCTFrame:(CTFrameRef)frameRef;
 
+/// 优先使用 YLPageRasterCache 中已渲染的位图
++ (instancetype)controllerWithPageModel:(YLPageModel *)model;
+
 @end
 
 NS_ASSUME_NONNULL_END
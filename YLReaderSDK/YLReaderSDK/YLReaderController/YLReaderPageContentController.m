@@ -20,6 +20,12 @@
     return controller;
 }
 
++ (instancetype)controllerWithPageModel:(YLPageModel *)model{
+    YLReaderPageContentController *controller = [self controllerWithCTFrame:model.frameRef];
+    controller.label.rasterImage = [YLReaderManager.shareReader.rasterCache imageForPage:model.page];
+    return controller;
+}
+
 
 - (void)viewDidLoad {
     [super viewDidLoad];
@@ -114,7 +114,7 @@ NSString *const TapIsGestureRecognizerEnabled = @"TapIsGestureRecognizerEnabled"
     bgVC.targetView = self.view;
 
     /// 初始页面
-    [self setViewControllers:@[[YLReaderPageContentController controllerWithCTFrame:YLReaderManager.shareReader.currentModel.frameRef]] direction:UIPageViewControllerNavigationDirectionForward animated:NO completion:^(BOOL finished) {}];
+    [self setViewControllers:@[[YLReaderPageContentController controllerWithPageModel:YLReaderManager.shareReader.currentModel]] direction:UIPageViewControllerNavigationDirectionForward animated:NO completion:^(BOOL finished) {}];
 }
 
 - (void)rightBarButtonItemClick{
@@ -163,7 +163,7 @@ NSString *const TapIsGestureRecognizerEnabled = @"TapIsGestureRecognizerEnabled"
         YLReaderPageBGController *bgVC = [[YLReaderPageBGController alloc] init];
         bgVC.targetView = self.view;
         
-        [self setViewControllers:@[[YLReaderPageContentController controllerWithCTFrame:YLReaderManager.shareReader.currentModel.frameRef],bgVC] direction:UIPageViewControllerNavigationDirectionReverse animated:YES completion:^(BOOL finished) {
+        [self setViewControllers:@[[YLReaderPageContentController controllerWithPageModel:YLReaderManager.shareReader.currentModel],bgVC] direction:UIPageViewControllerNavigationDirectionReverse animated:YES completion:^(BOOL finished) {
             NSLog(@"动画左边");
         }];
     }else if (touchPoint.x > (CGRectGetWidth(UIScreen.mainScreen.bounds) - RightWidth)) { // 右边
@@ -172,7 +172,7 @@ NSString *const TapIsGestureRecognizerEnabled = @"TapIsGestureRecognizerEnabled"
         YLReaderPageBGController *bgVC = [[YLReaderPageBGController alloc] init];
         bgVC.targetView = self.view;
         
-        [self setViewControllers:@[[YLReaderPageContentController controllerWithCTFrame:YLReaderManager.shareReader.currentModel.frameRef],bgVC] direction:UIPageViewControllerNavigationDirectionForward animated:YES completion:^(BOOL finished) {
+        [self setViewControllers:@[[YLReaderPageContentController controllerWithPageModel:YLReaderManager.shareReader.currentModel],bgVC] direction:UIPageViewControllerNavigationDirectionForward animated:YES completion:^(BOOL finished) {
         }];
     }
 }
@@ -182,7 +182,7 @@ NSString *const TapIsGestureRecognizerEnabled = @"TapIsGestureRecognizerEnabled"
 - (nullable UIViewController *)pageViewController:(UIPageViewController *)pageViewController viewControllerBeforeViewController:(UIViewController *)viewController{
     if (YLReaderManager.shareReader.page) {
         YLReaderManager.shareReader.page --;
-        return [YLReaderPageContentController controllerWithCTFrame:YLReaderManager.shareReader.currentModel.frameRef];
+        return [YLReaderPageContentController controllerWithPageModel:YLReaderManager.shareReader.currentModel];
     }else{
         return nil;
     }
@@ -191,7 +191,7 @@ NSString *const TapIsGestureRecognizerEnabled = @"TapIsGestureRecognizerEnabled"
 - (nullable UIViewController *)pageViewController:(UIPageViewController *)pageViewController viewControllerAfterViewController:(UIViewController *)viewController{
     if (YLReaderManager.shareReader.page < YLReaderManager.shareReader.pageModelsArray.count - 1) {
         YLReaderManager.shareReader.page ++;
-        return [YLReaderPageContentController controllerWithCTFrame:YLReaderManager.shareReader.currentModel.frameRef];
+        return [YLReaderPageContentController controllerWithPageModel:YLReaderManager.shareReader.currentModel];
     }else{
         return nil;
     }
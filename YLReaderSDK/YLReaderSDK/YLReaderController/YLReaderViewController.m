@@ -32,6 +32,13 @@
     self.pageLabel.frame = CGRectMake(10, 10, CGRectGetWidth(self.view.bounds) - 10 * 2.0, CGRectGetHeight(self.view.bounds) - 10 * 2.0);
 }
 
+/// 旋转屏幕后按新的尺寸重排，保持阅读位置
+- (void)viewWillTransitionToSize:(CGSize)size withTransitionCoordinator:(id<UIViewControllerTransitionCoordinator>)coordinator{
+    [super viewWillTransitionToSize:size withTransitionCoordinator:coordinator];
+    YLReaderManager *reader = YLReaderManager.shareReader;
+    [reader reflowWithFont:reader.font pageRect:CGRectMake(0, 0, size.width - 20, size.height - 100) completion:nil];
+}
+
 - (void)viewDidAppear:(BOOL)animated{
     [super viewDidAppear:animated];
     self.pageLabel.pageModelsArray = YLReaderManager.shareReader.pageModelsArray;
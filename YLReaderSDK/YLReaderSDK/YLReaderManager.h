@@ -9,8 +9,28 @@
 #import <Foundation/Foundation.h>
 #import "YLCoreText.h"
 
+@class YLBookAnnotation;
+@class YLBookAnnotations;
+@class YLBookSearch;
+@class YLBookTOCItem;
+@class YLPageRasterCache;
+
 NS_ASSUME_NONNULL_BEGIN
 
+/// 读取新章节、pageModelsArray 追加了页面后发送
+FOUNDATION_EXPORT NSNotificationName const YLReaderManagerDidLoadChapterNotification;
+/// 正文图片加载完成或重排后发送，已加载的页面可能重新分页，page 可能平移
+FOUNDATION_EXPORT NSNotificationName const YLReaderManagerDidUpdatePagesNotification;
+
+/// 阅读位置：第 chapter 章（全书中的序号）的第 page 页（章节内的页码）
+typedef struct YLReaderCursor {
+    NSInteger chapter;
+    NSInteger page;
+} YLReaderCursor;
+
+/// 已到全书的开头或末尾
+FOUNDATION_EXPORT YLReaderCursor const YLReaderCursorNotFound;
+
 @interface YLReaderManager : NSObject
 
 @property (nonatomic, strong) NSMutableArray<YLPageModel *> *pageModelsArray;
@@ -23,6 +43,84 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)shareReader;
 
+/// 全书检索，索引在第一次查询时于后台建立
+@property (nonatomic, strong, readonly) YLBookSearch *bookSearch;
+
+/** 读取并分页下一章节，页面追加到 pageModelsArray 末尾
+ * @note 翻到已加载的最后一页时会自动调用
+ * @return 已读到文件末尾时返回 NO
+ */
+- (BOOL)loadNextChapter;
+
+/** 读取并分页已加载的第一个章节的上一章节，页面插入到 pageModelsArray 开头，page 随之平移
+ * @note 翻到已加载的第一页时会自动调用
+ * @return 已是第一章时返回 NO
+ */
+- (BOOL)loadPreviousChapter;
+
+/** 已加载章节（富文本、排版结果与已解码的正文图片）的内存预算，默认 32MB
+ * 章节是读取、分页与淘汰的单位：pageModelsArray 只包含已加载的章节，超出预算时从离阅读位置较远的一端淘汰，
+ * 当前章节与下一章节不会被淘汰；淘汰前面的章节时 page 随之平移，并发送 YLReaderManagerDidUpdatePagesNotification
+ * 读到已加载的最后一个章节的最后几页时，在后台预先分页下一章节
+ */
+@property (nonatomic, assign) NSUInteger memoryBudget;
+/// 已加载章节占用的内存估算
+@property (nonatomic, assign, readonly) NSUInteger memoryCost;
+
+/** 以章节与章节内页码表示的阅读位置，不随章节的加载与淘汰变化
+ * 设置时先读取所在章节，页码超出章节时取最后一页
+ */
+@property (nonatomic, assign) YLReaderCursor cursor;
+/// 下一页的位置，跨章节时为下一章的第 0 页；已到全书末尾时返回 YLReaderCursorNotFound
+- (YLReaderCursor)cursorAfter:(YLReaderCursor)cursor;
+/// 上一页的位置，跨章节时为上一章的最后一页；已到全书开头时返回 YLReaderCursorNotFound
+- (YLReaderCursor)cursorBefore:(YLReaderCursor)cursor;
+/// 位置对应的页面，所在章节未加载时返回 nil
+- (nullable YLPageModel *)pageModelAtCursor:(YLReaderCursor)cursor;
+
+/** 目录，打开书籍后在后台多线程查找章节标题建立，建立之前为空数组
+ * 首屏先按内置规则分章；目录建立后章节在目录的标题处划分（过长的章节仍按段落切分），全书的章节序号随即确定，
+ * 阅读位置所在的章节重新分页，并发送 YLReaderManagerDidUpdatePagesNotification
+ */
+@property (nonatomic, copy, readonly) NSArray<YLBookTOCItem *> *tableOfContents;
+/// 目录项所在章节的第一页，设置给 cursor 即可跳转
+- (YLReaderCursor)cursorForTableOfContentsItem:(YLBookTOCItem *)item;
+
+/// 划线与笔记，按全书字符位置保存，重新分页后仍在原来的文字上
+@property (nonatomic, strong, readonly) YLBookAnnotations *annotations;
+/// 与页面相交的标注，按位置排列；页面已不在 pageModelsArray 中时返回空数组
+- (NSArray<YLBookAnnotation *> *)annotationsOnPageModel:(YLPageModel *)pageModel;
+/** 标注在页面中的范围（相对 pageModel.content），可用于 getRangeRects 绘制划线
+ * @return 标注与页面不相交时 location 为 NSNotFound
+ */
+- (NSRange)rangeOfAnnotation:(YLBookAnnotation *)annotation onPageModel:(YLPageModel *)pageModel;
+/** 页面中的范围（如选中的文字，相对 pageModel.content）对应的全书字符范围，用于添加标注
+ * @return 页面已不在 pageModelsArray 中时 location 为 NSNotFound
+ */
+- (NSRange)bookRangeOfPageRange:(NSRange)range pageModel:(YLPageModel *)pageModel;
+
+/// 翻页时预先渲染的页面位图，翻页后自动更新
+@property (nonatomic, strong, readonly) YLPageRasterCache *rasterCache;
+
+/// 正文字体，默认 PingFang SC 15
+@property (nonatomic, strong, readonly) UIFont *font;
+/// 页面的显示范围
+@property (nonatomic, assign, readonly) CGRect pageRect;
+
+/** 以新的字体、显示范围（如旋转屏幕后）重新分页已读取的章节，保持阅读位置
+ * 当前页所在章节同步分页：从当前页的第一个字符另起一页，前后两部分分别分页，返回时 page 已指向该页；
+ * 其余章节在后台分页，先向后再向前逐章插入 pageModelsArray，每次插入都会发送通知
+ * 重排过程中再次调用会取消之前的重排；章节的正文图片在章节插入之后才开始加载，加载完成后按新的排版重新分页
+ * @param completion 全部章节分页完成后在主线程回调；被取消时不回调
+ */
+- (void)reflowWithFont:(UIFont *)font pageRect:(CGRect)pageRect completion:(nullable void(^)(void))completion;
+
+/** 全书字符位置（如检索结果）所在的页码
+ * 按页面的起始位置二分查找；位置所在章节尚未读取时，先读取到该章节
+ * @return 没有任何页面时返回 NSNotFound
+ */
+- (NSInteger)pageForBookLocation:(NSUInteger)location;
+
 @end
 
 NS_ASSUME_NONNULL_END
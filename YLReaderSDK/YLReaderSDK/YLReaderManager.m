@@ -7,6 +7,108 @@
 //
 
 #import "YLReaderManager.h"
+#import "YLBookAnnotations.h"
+#import "YLBookLoader.h"
+#import "YLBookSearch.h"
+#import "YLPageRasterCache.h"
+
+NSNotificationName const YLReaderManagerDidLoadChapterNotification = @"YLReaderManagerDidLoadChapterNotification";
+NSNotificationName const YLReaderManagerDidUpdatePagesNotification = @"YLReaderManagerDidUpdatePagesNotification";
+YLReaderCursor const YLReaderCursorNotFound = {NSNotFound, NSNotFound};
+
+/// 距离已加载的最后一页不足这些页时，在后台分页下一章节
+static const NSInteger kYLReaderPrefetchPageCount = 3;
+
+/// 已分页的章节
+@interface YLReaderChapter : NSObject
+
+/// 处理过标签的章节内容，页面内容都是它的子串
+@property (nonatomic, strong) NSMutableAttributedString *content;
+/// 第一页在 pageModelsArray 中的位置
+@property (nonatomic, assign) NSInteger firstPage;
+@property (nonatomic, assign) NSInteger pageCount;
+/// 章节在文件中的字节范围，重排时据此重新读取
+@property (nonatomic, assign) NSRange byteRange;
+/// 章节在全书中的序号
+@property (nonatomic, assign) NSInteger index;
+/// 文字与排版结果占用内存的估算，分页时计算
+@property (nonatomic, assign) NSUInteger layoutCost;
+/// 章节中的正文图片，图片按解码后的大小计入内存
+@property (nonatomic, strong) NSArray<YLAttachment *> *attachments;
+/// 章节在全书中的字符范围
+@property (nonatomic, assign) NSUInteger bookLocation;
+@property (nonatomic, assign) NSUInteger bookLength;
+/// 处理标签后的位置与原文位置的对应关系，见 handleAttrStringWithSourceMap
+@property (nonatomic, strong) NSMutableArray<NSValue *> *sourceMap;
+/// 尚未开始加载的图片：章节在后台分页，接收到主线程、登记附件之后才加载，加载完成的通知不会丢失
+@property (nonatomic, strong) NSMutableArray<YLAttachment *> *pendingImages;
+/// 分页时的页面尺寸，图片按它缩放
+@property (nonatomic, assign) CGSize drawSize;
+
+@end
+
+@implementation YLReaderChapter
+
+@end
+
+
+/** 章节的文字与排版结果占用内存的估算
+ * 富文本按每个码元 4 字节（字符与属性），CTFrame 按每个码元 32 字节（字形、位置与行信息）
+ */
+static NSUInteger getLayoutCost(NSAttributedString *content, NSArray<YLPageModel *> *pageModels){
+    NSUInteger cost = content.length * 4;
+    for (YLPageModel *pageModel in pageModels) {
+        cost += pageModel.range.length * 32;
+    }
+    return cost;
+}
+
+/// 分页 content 的一部分，页面的 range 仍是在 content 中的位置
+static NSMutableArray<YLPageModel *> *getPageModelsInRange(NSMutableAttributedString *content, NSRange range, CGRect rect){
+    if (range.location == 0 && range.length == content.length) {
+        return getPageModels(content, rect);
+    }
+    NSMutableAttributedString *part = [[content attributedSubstringFromRange:range] mutableCopy];
+    NSMutableArray<YLPageModel *> *pageModels = getPageModels(part, rect);
+    for (YLPageModel *pageModel in pageModels) {
+        pageModel.range = NSMakeRange(pageModel.range.location + range.location, pageModel.range.length);
+    }
+    return pageModels;
+}
+
+
+@interface YLReaderManager ()
+
+@property (nonatomic, strong) YLBookLoader *bookLoader;
+@property (nonatomic, strong, readwrite) YLBookSearch *bookSearch;
+@property (nonatomic, strong, readwrite) YLBookAnnotations *annotations;
+@property (nonatomic, strong, readwrite) YLPageRasterCache *rasterCache;
+/// 下一章节在文件中的字节位置
+@property (nonatomic, assign) NSUInteger nextChapterOffset;
+@property (nonatomic, strong, readwrite) UIFont *font;
+@property (nonatomic, assign, readwrite) CGRect pageRect;
+/// 每次重排加一，后台分页发现与之不一致即停止
+@property (atomic, assign) NSUInteger reflowGeneration;
+/// 重排时后台分页的串行队列
+@property (nonatomic, strong) dispatch_queue_t layoutQueue;
+
+/// 已加载的章节，在全书中连续，页面按顺序排列在 pageModelsArray 中
+@property (nonatomic, strong) NSMutableArray<YLReaderChapter *> *chapters;
+/// 已发现的所有章节在文件中的字节范围，按序号排列；淘汰的章节据此重新读取
+@property (nonatomic, strong) NSMutableArray<NSValue *> *chapterTable;
+/// 已读到文件末尾，chapterTable 包含了全部章节
+@property (nonatomic, assign) BOOL reachedEnd;
+/// 目录建立后 chapterTable 即包含了全部章节
+@property (nonatomic, assign) BOOL chapterTableComplete;
+@property (nonatomic, copy, readwrite) NSArray<YLBookTOCItem *> *tableOfContents;
+/// 正在后台分页下一章节
+@property (nonatomic, assign) BOOL prefetching;
+/// 正在读取上一章节；期间页面更新引起的 setPage: 不再重复读取
+@property (nonatomic, assign) BOOL loadingPreviousChapter;
+/// 正文图片所在的章节
+@property (nonatomic, strong) NSMapTable<YLAttachment *, YLReaderChapter *> *attachmentChapters;
+
+@end
 
 @implementation YLReaderManager
 
@@ -22,20 +124,648 @@
     return manager;
 }
 
+/// 映射书籍文件，只分页第一章，其余章节在翻页时按需读取
 - (void)loadData{
     NSString *dataPath = [NSBundle.mainBundle pathForResource:@"Data" ofType:@"txt"];
-    NSString *text = [NSString stringWithContentsOfFile:dataPath encoding:NSUTF8StringEncoding error:nil];
-    NSMutableAttributedString *string = [[NSMutableAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName: [UIFont fontWithName:@"PingFang SC" size:15],NSForegroundColorAttributeName: [UIColor colorWithRed:51/255.0 green:51/255.0 blue:51/255.0 alpha:1.0]}];
-    CGRect rect = CGRectMake(0, 0, CGRectGetWidth(UIScreen.mainScreen.bounds) - 20, CGRectGetHeight(UIScreen.mainScreen.bounds) - 100);
-    handleAttrString(string, rect);
-    self.pageModelsArray = getPageModels(string, rect);
+    self.bookLoader = [[YLBookLoader alloc] initWithPath:dataPath];
+    self.bookSearch = [[YLBookSearch alloc] initWithPath:dataPath];
+    self.annotations = [[YLBookAnnotations alloc] initWithPath:dataPath];
+    //当前页与阅读方向上的 2 页、反方向的 1 页，3x 屏幕下每页约 10MB
+    self.rasterCache = [[YLPageRasterCache alloc] initWithByteBudget:64 * 1024 * 1024 prefetchCount:2];
+    self.nextChapterOffset = self.bookLoader.contentStart;
+    self.font = [UIFont fontWithName:@"PingFang SC" size:15];
+    self.layoutQueue = dispatch_queue_create("com.yl.readerLayout", DISPATCH_QUEUE_SERIAL);
+    self.pageRect = CGRectMake(0, 0, CGRectGetWidth(UIScreen.mainScreen.bounds) - 20, CGRectGetHeight(UIScreen.mainScreen.bounds) - 100);
+    self.pageModelsArray = [NSMutableArray array];
+    self.chapters = [NSMutableArray array];
+    self.chapterTable = [NSMutableArray array];
+    self.tableOfContents = @[];
+    self.memoryBudget = 32 * 1024 * 1024;
+    self.attachmentChapters = [NSMapTable weakToWeakObjectsMapTable];
+    [NSNotificationCenter.defaultCenter addObserver:self selector:@selector(attachmentImageDidLoad:) name:YLAttachmentImageDidLoadNotification object:nil];
+    //首屏按内置规则分章，不等待扫描全文
+    [self loadNextChapter];
+    [self buildTableOfContents];
+}
+
+/// 在后台查找章节标题建立目录，完成后在主线程改为按目录分章
+- (void)buildTableOfContents{
+    YLBookLoader *bookLoader = self.bookLoader;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSArray<YLBookTOCItem *> *items = [bookLoader buildTableOfContentsWithPatterns:nil];
+        NSArray<NSValue *> *chapterByteRanges = items ? [bookLoader chapterByteRanges] : nil;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (items) {
+                [self adoptTableOfContents:items chapterByteRanges:chapterByteRanges];
+            }
+        });
+    });
+}
+
+/** 建立目录后章节在标题处划分，全部章节的范围随即确定
+ * 已加载的章节按之前的规则划分，序号与目录不一致：只重新分页阅读位置所在的章节，其余章节翻页时再读取
+ */
+- (void)adoptTableOfContents:(NSArray<YLBookTOCItem *> *)items chapterByteRanges:(NSArray<NSValue *> *)chapterByteRanges{
+    self.tableOfContents = items;
+    self.chapterTable = [chapterByteRanges mutableCopy];
+    self.chapterTableComplete = YES;
+    if (self.chapters.count == 0) {
+        return;
+    }
+    //取消进行中的重排与预读，它们按之前的分章读取
+    self.reflowGeneration += 1;
+    NSUInteger anchor = self.currentModel.bookLocation;
+    NSInteger index = [self tableIndexContainingByteOffset:[self.bookLoader byteOffsetForCharacterOffset:anchor]];
+    YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:self.chapterTable[MAX(index, 0)].rangeValue.location];
+    if (chapter == nil) {
+        return;
+    }
+    NSArray<YLPageModel *> *pageModels;
+    YLReaderChapter *record = [self layoutChapter:chapter anchor:anchor font:self.font pageRect:self.pageRect pageModels:&pageModels];
+    [self.pageModelsArray removeAllObjects];
+    [self.chapters removeAllObjects];
+    [self.attachmentChapters removeAllObjects];
+    self.reachedEnd = NO;
+    [self appendChapter:record pageModels:pageModels];
+    _page = [self pageForBookLocation:anchor];
+    [self postPagesUpdate];
+}
+
+- (BOOL)loadNextChapter{
+    YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:self.nextChapterOffset];
+    if (chapter == nil) {
+        self.reachedEnd = YES;
+        return NO;
+    }
+    NSArray<YLPageModel *> *pageModels;
+    YLReaderChapter *record = [self layoutChapter:chapter anchor:NSNotFound font:self.font pageRect:self.pageRect pageModels:&pageModels];
+    [self appendChapter:record pageModels:pageModels];
+    [NSNotificationCenter.defaultCenter postNotificationName:YLReaderManagerDidLoadChapterNotification object:self];
+    return YES;
+}
+
+- (BOOL)loadPreviousChapter{
+    NSInteger index = self.chapters.firstObject.index - 1;
+    if (self.loadingPreviousChapter || self.chapters.count == 0 || index < 0) {
+        return NO;
+    }
+    YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:self.chapterTable[index].rangeValue.location];
+    if (chapter == nil) {
+        return NO;
+    }
+    self.loadingPreviousChapter = YES;
+    NSArray<YLPageModel *> *pageModels;
+    YLReaderChapter *record = [self layoutChapter:chapter anchor:NSNotFound font:self.font pageRect:self.pageRect pageModels:&pageModels];
+    [self prependChapter:record pageModels:pageModels];
+    [self postPagesUpdate];
+    self.loadingPreviousChapter = NO;
+    return YES;
+}
+
+/// 读到已加载的最后一个章节的最后几页时，在后台分页下一章节，翻页时不必同步读取
+- (void)prefetchNextChapterIfNeeded{
+    YLReaderChapter *last = self.chapters.lastObject;
+    if (self.prefetching || self.reachedEnd || last == nil || self.page < last.firstPage + last.pageCount - kYLReaderPrefetchPageCount) {
+        return;
+    }
+    self.prefetching = YES;
+    NSUInteger offset = self.nextChapterOffset;
+    NSUInteger generation = self.reflowGeneration;
+    UIFont *font = self.font;
+    CGRect pageRect = self.pageRect;
+    dispatch_async(self.layoutQueue, ^{
+        YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:offset];
+        NSArray<YLPageModel *> *pageModels;
+        YLReaderChapter *record = chapter ? [self layoutChapter:chapter anchor:NSNotFound font:font pageRect:pageRect pageModels:&pageModels] : nil;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            self.prefetching = NO;
+            if (chapter == nil) {
+                self.reachedEnd = self.nextChapterOffset == offset;
+                return;
+            }
+            //期间重排过，或翻页时已经同步读取了该章节
+            if (self.reflowGeneration == generation && self.nextChapterOffset == record.byteRange.location) {
+                [self appendChapter:record pageModels:pageModels];
+                [NSNotificationCenter.defaultCenter postNotificationName:YLReaderManagerDidLoadChapterNotification object:self];
+                [self evictChaptersIfNeeded];
+            }
+        });
+    });
+}
+
+/** 处理标签并分页一个章节；不修改 YLReaderManager 的状态，可在后台线程调用
+ * @param anchor 全书字符位置，位于章节内时从该位置另起一页，前后两部分分别分页
+ * @param pageModels 章节的页面，页码在插入 pageModelsArray 时设置
+ */
+- (YLReaderChapter *)layoutChapter:(YLBookChapter *)chapter anchor:(NSUInteger)anchor font:(UIFont *)font pageRect:(CGRect)pageRect pageModels:(NSArray<YLPageModel *> **)pageModels{
+    NSMutableAttributedString *string = [[NSMutableAttributedString alloc] initWithString:chapter.text attributes:@{NSFontAttributeName: font,NSForegroundColorAttributeName: [UIColor colorWithRed:51/255.0 green:51/255.0 blue:51/255.0 alpha:1.0]}];
+    NSMutableArray<NSValue *> *sourceMap = [NSMutableArray array];
+    NSMutableArray<YLAttachment *> *pendingImages = [NSMutableArray array];
+    handleAttrStringDeferringImageLoads(string, pageRect, sourceMap, pendingImages);
+
+    NSUInteger split = 0;
+    if (NSLocationInRange(anchor, chapter.characterRange)) {
+        split = MIN(getHandledLocation(sourceMap, anchor - chapter.characterRange.location), string.length);
+    }
+    NSMutableArray<YLPageModel *> *pages = [NSMutableArray array];
+    if (split > 0) {
+        [pages addObjectsFromArray:getPageModelsInRange(string, NSMakeRange(0, split), pageRect)];
+    }
+    if (split < string.length || pages.count == 0) {
+        [pages addObjectsFromArray:getPageModelsInRange(string, NSMakeRange(split, string.length - split), pageRect)];
+    }
+    for (YLPageModel *pageModel in pages) {
+        pageModel.bookLocation = chapter.characterRange.location + getSourceLocation(sourceMap, pageModel.range.location);
+    }
+    *pageModels = pages;
+
+    YLReaderChapter *record = [[YLReaderChapter alloc] init];
+    record.content = string;
+    record.byteRange = chapter.byteRange;
+    record.bookLocation = chapter.characterRange.location;
+    record.bookLength = chapter.characterRange.length;
+    record.sourceMap = sourceMap;
+    record.pendingImages = pendingImages;
+    record.drawSize = pageRect.size;
+    record.layoutCost = getLayoutCost(string, pages);
+    return record;
+}
+
+/// 章节的页面追加到 pageModelsArray 末尾
+- (void)appendChapter:(YLReaderChapter *)record pageModels:(NSArray<YLPageModel *> *)pageModels{
+    NSInteger pageOffset = self.pageModelsArray.count;
+    [pageModels enumerateObjectsUsingBlock:^(YLPageModel * _Nonnull pageModel, NSUInteger idx, BOOL * _Nonnull stop) {
+        pageModel.page = pageOffset + idx;
+    }];
+    [self.pageModelsArray addObjectsFromArray:pageModels];
+    record.firstPage = pageOffset;
+    record.pageCount = pageModels.count;
+    record.index = [self tableIndexOfByteRange:record.byteRange];
+    [self.chapters addObject:record];
+    self.nextChapterOffset = NSMaxRange(record.byteRange);
+    [self registerAttachmentsOfChapter:record];
+}
+
+/// 章节的页面插入到 pageModelsArray 开头，已有页面的页码与当前页随之平移
+- (void)prependChapter:(YLReaderChapter *)record pageModels:(NSArray<YLPageModel *> *)pageModels{
+    NSInteger count = pageModels.count;
+    [self.pageModelsArray insertObjects:pageModels atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, count)]];
+    [self.pageModelsArray enumerateObjectsUsingBlock:^(YLPageModel * _Nonnull pageModel, NSUInteger idx, BOOL * _Nonnull stop) {
+        pageModel.page = idx;
+    }];
+    for (YLReaderChapter *chapter in self.chapters) {
+        chapter.firstPage += count;
+    }
+    record.firstPage = 0;
+    record.pageCount = count;
+    record.index = [self tableIndexOfByteRange:record.byteRange];
+    [self.chapters insertObject:record atIndex:0];
+    _page += count;
+    [self registerAttachmentsOfChapter:record];
+}
+
+- (void)registerAttachmentsOfChapter:(YLReaderChapter *)record{
+    NSMutableAttributedString *string = record.content;
+    NSMutableArray<YLAttachment *> *attachments = [NSMutableArray array];
+    [string enumerateAttribute:kYLAttachmentAttributeName inRange:NSMakeRange(0, string.length) options:0 usingBlock:^(YLAttachment *attachment, NSRange range, BOOL * _Nonnull stop) {
+        if (attachment) {
+            [self.attachmentChapters setObject:record forKey:attachment];
+            [attachments addObject:attachment];
+        }
+    }];
+    record.attachments = attachments;
+    //登记之后再加载，图片只在主线程修改 imageFrame，不会与后台排版同时访问
+    for (YLAttachment *attachment in record.pendingImages) {
+        [YLCoreText loadImageOfAttachment:attachment drawSize:record.drawSize];
+    }
+    record.pendingImages = nil;
+}
+
+/// 章节在 chapterTable 中的序号，新发现的章节追加到末尾
+- (NSInteger)tableIndexOfByteRange:(NSRange)byteRange{
+    NSUInteger low = 0, high = self.chapterTable.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (self.chapterTable[mid].rangeValue.location < byteRange.location) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < self.chapterTable.count && self.chapterTable[low].rangeValue.location == byteRange.location) {
+        return low;
+    }
+    [self.chapterTable addObject:[NSValue valueWithRange:byteRange]];
+    return self.chapterTable.count - 1;
+}
+
+#pragma mark - 内存预算
+
+/// 章节占用的内存：文字与排版结果的估算，加上已解码的正文图片
+- (NSUInteger)memoryCostOfChapter:(YLReaderChapter *)chapter{
+    NSUInteger cost = chapter.layoutCost;
+    for (YLAttachment *attachment in chapter.attachments) {
+        CGImageRef image = attachment.image.CGImage;
+        if (image) {
+            cost += CGImageGetBytesPerRow(image) * CGImageGetHeight(image);
+        }
+    }
+    return cost;
+}
+
+- (NSUInteger)memoryCost{
+    NSUInteger cost = 0;
+    for (YLReaderChapter *chapter in self.chapters) {
+        cost += [self memoryCostOfChapter:chapter];
+    }
+    return cost;
+}
+
+/** 超出内存预算时按章节淘汰
+ * 保留当前章节与下一章节，从离当前章节较远的一端开始；淘汰前面的章节时页码随之平移
+ */
+- (void)evictChaptersIfNeeded{
+    if (self.chapters.count <= 1) {
+        return;
+    }
+    NSInteger current = [self loadedIndexOfPage:self.page];
+    NSUInteger cost = self.memoryCost;
+    BOOL evicted = NO;
+    while (cost > self.memoryBudget) {
+        NSInteger front = current;
+        NSInteger back = (NSInteger)self.chapters.count - 2 - current;
+        if (front <= 0 && back <= 0) {
+            break;
+        }
+        if (front >= back) {
+            YLReaderChapter *chapter = self.chapters.firstObject;
+            cost -= [self memoryCostOfChapter:chapter];
+            [self removeChapter:chapter];
+            current--;
+        } else {
+            YLReaderChapter *chapter = self.chapters.lastObject;
+            cost -= [self memoryCostOfChapter:chapter];
+            [self removeChapter:chapter];
+        }
+        evicted = YES;
+    }
+    if (evicted) {
+        [self postPagesUpdate];
+    }
+}
+
+/// 移除第一个或最后一个已加载的章节
+- (void)removeChapter:(YLReaderChapter *)chapter{
+    for (YLAttachment *attachment in chapter.attachments) {
+        [self.attachmentChapters removeObjectForKey:attachment];
+    }
+    [self.pageModelsArray removeObjectsInRange:NSMakeRange(chapter.firstPage, chapter.pageCount)];
+    if (chapter == self.chapters.firstObject) {
+        [self.chapters removeObjectAtIndex:0];
+        [self.pageModelsArray enumerateObjectsUsingBlock:^(YLPageModel * _Nonnull pageModel, NSUInteger idx, BOOL * _Nonnull stop) {
+            pageModel.page = idx;
+        }];
+        for (YLReaderChapter *other in self.chapters) {
+            other.firstPage -= chapter.pageCount;
+        }
+        _page = MAX(0, _page - chapter.pageCount);
+    } else {
+        [self.chapters removeLastObject];
+        self.nextChapterOffset = chapter.byteRange.location;
+        _page = MIN(_page, (NSInteger)self.pageModelsArray.count - 1);
+    }
 }
 
+/// 第 page 页所在的章节在 chapters 中的位置
+- (NSInteger)loadedIndexOfPage:(NSInteger)page{
+    NSUInteger low = 0, high = self.chapters.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (self.chapters[mid].firstPage <= page) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low == 0 ? 0 : low - 1;
+}
+
+#pragma mark - 阅读位置
+
+/// 已加载的第 index 章，未加载时返回 nil
+- (YLReaderChapter *)loadedChapterAtIndex:(NSInteger)index{
+    NSInteger offset = index - self.chapters.firstObject.index;
+    if (self.chapters.count == 0 || offset < 0 || offset >= (NSInteger)self.chapters.count) {
+        return nil;
+    }
+    return self.chapters[offset];
+}
+
+- (YLReaderCursor)cursor{
+    if (self.chapters.count == 0) {
+        return YLReaderCursorNotFound;
+    }
+    YLReaderChapter *chapter = self.chapters[[self loadedIndexOfPage:self.page]];
+    return (YLReaderCursor){chapter.index, self.page - chapter.firstPage};
+}
+
+- (void)setCursor:(YLReaderCursor)cursor{
+    if (cursor.chapter < 0 || cursor.chapter == NSNotFound) {
+        return;
+    }
+    //读取章节，直到 cursor 所在章节已加载
+    while (self.chapters.count && cursor.chapter < self.chapters.firstObject.index && [self loadPreviousChapter]) {}
+    while ((self.chapters.count == 0 || cursor.chapter > self.chapters.lastObject.index) && [self loadNextChapter]) {}
+    YLReaderChapter *chapter = [self loadedChapterAtIndex:cursor.chapter];
+    if (chapter == nil) {
+        return;
+    }
+    self.page = chapter.firstPage + MIN(MAX(cursor.page, 0), chapter.pageCount - 1);
+}
+
+- (YLReaderCursor)cursorAfter:(YLReaderCursor)cursor{
+    YLReaderChapter *chapter = [self loadedChapterAtIndex:cursor.chapter];
+    if (chapter && cursor.page + 1 < chapter.pageCount) {
+        return (YLReaderCursor){cursor.chapter, cursor.page + 1};
+    }
+    if (cursor.chapter + 1 < (NSInteger)self.chapterTable.count || !(self.reachedEnd || self.chapterTableComplete)) {
+        return (YLReaderCursor){cursor.chapter + 1, 0};
+    }
+    return YLReaderCursorNotFound;
+}
+
+- (YLReaderCursor)cursorBefore:(YLReaderCursor)cursor{
+    if (cursor.page > 0) {
+        return (YLReaderCursor){cursor.chapter, cursor.page - 1};
+    }
+    if (cursor.chapter <= 0) {
+        return YLReaderCursorNotFound;
+    }
+    //上一章节未加载时页数未知，设置时取其最后一页
+    YLReaderChapter *previous = [self loadedChapterAtIndex:cursor.chapter - 1];
+    return (YLReaderCursor){cursor.chapter - 1, previous ? previous.pageCount - 1 : NSIntegerMax};
+}
+
+- (YLPageModel *)pageModelAtCursor:(YLReaderCursor)cursor{
+    YLReaderChapter *chapter = [self loadedChapterAtIndex:cursor.chapter];
+    if (chapter == nil || cursor.page < 0 || cursor.page >= chapter.pageCount) {
+        return nil;
+    }
+    return self.pageModelsArray[chapter.firstPage + cursor.page];
+}
+
+- (YLReaderCursor)cursorForTableOfContentsItem:(YLBookTOCItem *)item{
+    NSInteger index = [self tableIndexContainingByteOffset:item.byteOffset];
+    return index < 0 ? YLReaderCursorNotFound : (YLReaderCursor){index, 0};
+}
+
+/// 最后一个起始位置不大于 byteOffset 的章节在 chapterTable 中的序号，没有时返回 -1
+- (NSInteger)tableIndexContainingByteOffset:(NSUInteger)byteOffset{
+    NSUInteger low = 0, high = self.chapterTable.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (self.chapterTable[mid].rangeValue.location <= byteOffset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (NSInteger)low - 1;
+}
+
+#pragma mark - 划线与笔记
+
+/// 页面所在的已加载章节；页面已被淘汰或重新分页时返回 nil
+- (YLReaderChapter *)loadedChapterOfPageModel:(YLPageModel *)pageModel{
+    NSInteger page = pageModel.page;
+    if (page < 0 || page >= (NSInteger)self.pageModelsArray.count || self.pageModelsArray[page] != pageModel) {
+        return nil;
+    }
+    return self.chapters[[self loadedIndexOfPage:page]];
+}
+
+- (NSRange)bookRangeOfPageRange:(NSRange)range pageModel:(YLPageModel *)pageModel{
+    YLReaderChapter *chapter = [self loadedChapterOfPageModel:pageModel];
+    if (chapter == nil) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    NSUInteger start = getSourceLocation(chapter.sourceMap, pageModel.range.location + range.location);
+    NSUInteger end = getSourceLocation(chapter.sourceMap, pageModel.range.location + NSMaxRange(range));
+    return NSMakeRange(chapter.bookLocation + start, end - start);
+}
+
+- (NSArray<YLBookAnnotation *> *)annotationsOnPageModel:(YLPageModel *)pageModel{
+    NSRange range = [self bookRangeOfPageRange:NSMakeRange(0, pageModel.range.length) pageModel:pageModel];
+    if (range.location == NSNotFound) {
+        return @[];
+    }
+    return [self.annotations annotationsInRange:range];
+}
+
+- (NSRange)rangeOfAnnotation:(YLBookAnnotation *)annotation onPageModel:(YLPageModel *)pageModel{
+    YLReaderChapter *chapter = [self loadedChapterOfPageModel:pageModel];
+    NSRange bookRange = NSIntersectionRange(annotation.range, NSMakeRange(chapter.bookLocation, chapter.bookLength));
+    if (chapter == nil || bookRange.length == 0) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    //原文位置换算为章节富文本中的位置，再截取页面内的部分
+    NSUInteger start = getHandledLocation(chapter.sourceMap, bookRange.location - chapter.bookLocation);
+    NSUInteger end = getHandledLocation(chapter.sourceMap, NSMaxRange(bookRange) - chapter.bookLocation);
+    NSRange range = NSIntersectionRange(NSMakeRange(start, end - start), pageModel.range);
+    if (range.length == 0) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    return NSMakeRange(range.location - pageModel.range.location, range.length);
+}
+
+#pragma mark - 重排
+
+- (void)reflowWithFont:(UIFont *)font pageRect:(CGRect)pageRect completion:(void (^)(void))completion{
+    NSUInteger generation = self.reflowGeneration + 1;
+    self.reflowGeneration = generation;
+    self.font = font;
+    self.pageRect = pageRect;
+    if (self.chapters.count == 0) {
+        if (completion) {
+            completion();
+        }
+        return;
+    }
+
+    //阅读位置：当前页第一个字符在全书中的位置
+    NSUInteger anchor = self.currentModel.bookLocation;
+    NSUInteger anchorIndex = 0;
+    while (anchorIndex + 1 < self.chapters.count && self.chapters[anchorIndex + 1].firstPage <= self.page) {
+        anchorIndex++;
+    }
+    //先向后、再由近及远向前分页其余已读取的章节
+    NSMutableArray<NSValue *> *following = [NSMutableArray array];
+    NSMutableArray<NSValue *> *preceding = [NSMutableArray array];
+    [self.chapters enumerateObjectsUsingBlock:^(YLReaderChapter * _Nonnull chapter, NSUInteger idx, BOOL * _Nonnull stop) {
+        if (idx > anchorIndex) {
+            [following addObject:[NSValue valueWithRange:chapter.byteRange]];
+        } else if (idx < anchorIndex) {
+            [preceding insertObject:[NSValue valueWithRange:chapter.byteRange] atIndex:0];
+        }
+    }];
+
+    //阅读位置所在的章节同步分页，当前页立即可用
+    YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:self.chapters[anchorIndex].byteRange.location];
+    NSArray<YLPageModel *> *pageModels;
+    YLReaderChapter *record = [self layoutChapter:chapter anchor:anchor font:font pageRect:pageRect pageModels:&pageModels];
+    [self.pageModelsArray removeAllObjects];
+    [self.chapters removeAllObjects];
+    [self.attachmentChapters removeAllObjects];
+    [self appendChapter:record pageModels:pageModels];
+    _page = [self pageForBookLocation:anchor];
+    [self postPagesUpdate];
+
+    //后台分页的章节插入 pageModelsArray、登记附件之后才加载图片，图片在插入之前加载完成也不会丢失重新分页
+    dispatch_async(self.layoutQueue, ^{
+        for (NSValue *byteRange in following) {
+            if (self.reflowGeneration != generation) {
+                return;
+            }
+            YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:byteRange.rangeValue.location];
+            NSArray<YLPageModel *> *pageModels;
+            YLReaderChapter *record = [self layoutChapter:chapter anchor:NSNotFound font:font pageRect:pageRect pageModels:&pageModels];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                //翻页时可能已经按新的排版读取了该章节
+                if (self.reflowGeneration == generation && self.nextChapterOffset == record.byteRange.location) {
+                    [self appendChapter:record pageModels:pageModels];
+                    [NSNotificationCenter.defaultCenter postNotificationName:YLReaderManagerDidLoadChapterNotification object:self];
+                }
+            });
+        }
+        for (NSValue *byteRange in preceding) {
+            if (self.reflowGeneration != generation) {
+                return;
+            }
+            YLBookChapter *chapter = [self.bookLoader chapterAtByteOffset:byteRange.rangeValue.location];
+            NSArray<YLPageModel *> *pageModels;
+            YLReaderChapter *record = [self layoutChapter:chapter anchor:NSNotFound font:font pageRect:pageRect pageModels:&pageModels];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                if (self.reflowGeneration == generation && NSMaxRange(record.byteRange) == self.chapters.firstObject.byteRange.location) {
+                    [self prependChapter:record pageModels:pageModels];
+                    [self postPagesUpdate];
+                }
+            });
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (self.reflowGeneration == generation && completion) {
+                completion();
+            }
+        });
+    });
+}
+
+/// 图片加载完成：尺寸与占位相同时只需重绘，否则从图片所在页开始重新分页该章节
+- (void)attachmentImageDidLoad:(NSNotification *)notification{
+    YLAttachment *attachment = notification.object;
+    YLReaderChapter *chapter = [self.attachmentChapters objectForKey:attachment];
+    if (chapter == nil) {
+        return;
+    }
+    if ([notification.userInfo[YLAttachmentImageSizeChangedKey] boolValue]) {
+        [self relayoutChapter:chapter fromAttachment:attachment];
+    }
+    [self postPagesUpdate];
+    //解码后的图片计入内存预算
+    [self evictChaptersIfNeeded];
+}
+
+/// 图片之前的页面不受影响，只重新分页图片所在页及之后的页面，后续章节的页码随之平移
+- (void)relayoutChapter:(YLReaderChapter *)chapter fromAttachment:(YLAttachment *)attachment{
+    NSMutableAttributedString *content = chapter.content;
+    __block NSUInteger location = NSNotFound;
+    [content enumerateAttribute:kYLAttachmentAttributeName inRange:NSMakeRange(0, content.length) options:0 usingBlock:^(id value, NSRange range, BOOL * _Nonnull stop) {
+        if (value == attachment) {
+            location = range.location;
+            *stop = YES;
+        }
+    }];
+    if (location == NSNotFound) {
+        return;
+    }
+    NSInteger page = chapter.firstPage;
+    NSInteger lastPage = chapter.firstPage + chapter.pageCount;
+    while (page + 1 < lastPage && NSMaxRange(self.pageModelsArray[page].range) <= location) {
+        page++;
+    }
+
+    //重新分页后当前页的内容可能移到别的页，按当前页起始的书内位置重新定位
+    NSUInteger anchor = _page >= 0 && _page < (NSInteger)self.pageModelsArray.count ? self.pageModelsArray[_page].bookLocation : NSNotFound;
+    NSUInteger start = self.pageModelsArray[page].range.location;
+    NSMutableArray<YLPageModel *> *pageModels = getPageModelsInRange(content, NSMakeRange(start, content.length - start), self.pageRect);
+    [pageModels enumerateObjectsUsingBlock:^(YLPageModel * _Nonnull pageModel, NSUInteger idx, BOOL * _Nonnull stop) {
+        pageModel.page = page + idx;
+        pageModel.bookLocation = chapter.bookLocation + getSourceLocation(chapter.sourceMap, pageModel.range.location);
+    }];
+    NSInteger oldCount = lastPage - page;
+    [self.pageModelsArray replaceObjectsInRange:NSMakeRange(page, oldCount) withObjectsFromArray:pageModels];
+
+    NSInteger delta = (NSInteger)pageModels.count - oldCount;
+    chapter.pageCount += delta;
+    if (delta != 0) {
+        for (NSInteger i = page + pageModels.count; i < (NSInteger)self.pageModelsArray.count; i++) {
+            self.pageModelsArray[i].page = i;
+        }
+        for (NSUInteger i = [self.chapters indexOfObject:chapter] + 1; i < self.chapters.count; i++) {
+            self.chapters[i].firstPage += delta;
+        }
+    }
+    if (anchor != NSNotFound) {
+        _page = [self pageForBookLocation:anchor];
+    }
+    _page = MIN(_page, (NSInteger)self.pageModelsArray.count - 1);
+}
+
+
+- (NSInteger)pageForBookLocation:(NSUInteger)location{
+    //读取章节，直到已加载的页面覆盖 location
+    while (self.chapters.count && location < self.chapters.firstObject.bookLocation && [self loadPreviousChapter]) {}
+    while ((self.chapters.count == 0 || self.chapters.lastObject.bookLocation + self.chapters.lastObject.bookLength <= location) && [self loadNextChapter]) {}
+    NSUInteger count = self.pageModelsArray.count;
+    if (count == 0) {
+        return NSNotFound;
+    }
+    //最后一个起始位置不大于 location 的页面
+    NSUInteger low = 0, high = count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (self.pageModelsArray[mid].bookLocation <= location) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low == 0 ? 0 : low - 1;
+}
 
 - (void)setPage:(NSInteger)page{
+    //翻到已加载的第一页时读取上一章节，页码随之平移
+    if (page <= 0) {
+        NSInteger count = self.pageModelsArray.count;
+        if ([self loadPreviousChapter]) {
+            page += self.pageModelsArray.count - count;
+        }
+    }
+    //翻到已加载的最后一页时读取下一章节；通常已经在后台预先读取
+    while (page >= (NSInteger)self.pageModelsArray.count - 1 && [self loadNextChapter]) {}
     page = MAX(0, page);
     page = MIN(page, self.pageModelsArray.count - 1);
     _page = page;
+    [self evictChaptersIfNeeded];
+    [self prefetchNextChapterIfNeeded];
+    [self.rasterCache setCurrentPage:_page pageModels:self.pageModelsArray];
+}
+
+/// 页面内容或页码变化：丢弃已渲染的位图并按当前页重新渲染，通知页面刷新
+- (void)postPagesUpdate{
+    invalidatePageGeometryCache();
+    [self.rasterCache removeAllImages];
+    [self.rasterCache setCurrentPage:self.page pageModels:self.pageModelsArray];
+    [NSNotificationCenter.defaultCenter postNotificationName:YLReaderManagerDidUpdatePagesNotification object:self];
 }
 
 - (YLPageModel *)currentModel{
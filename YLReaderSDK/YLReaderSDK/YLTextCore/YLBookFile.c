@@ -0,0 +1,459 @@
+//
+//  YLBookFile.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLBookFile.h"
+#include "YLTextParallelLayout.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// 检查点：此处的字节偏移与字符偏移一一对应
+typedef struct YLBookFileCheckpoint {
+    size_t byteOffset;
+    size_t characterOffset;
+} YLBookFileCheckpoint;
+
+struct YLBookFile {
+    const uint8_t *bytes;
+    size_t length;
+    size_t contentStart;
+    YLTextEncoding encoding;
+
+    /// 第 i 个检查点位于 contentStart + i * YLBookFileIndexStride 之后的第一个字符边界
+    YLBookFileCheckpoint *checkpoints;
+    size_t checkpointCount;
+    size_t checkpointCapacity;
+
+    /// 章节的起始位置，升序；为 NULL 时按内置规则识别标题
+    size_t *headings;
+    size_t headingCount;
+};
+
+// MARK: - UTF-8
+
+/** 解码一个字符，非法或不完整的序列按单个字节解码为 U+FFFD
+ * @param consumed 输出占用的字节数
+ */
+static uint32_t decodeUTF8(const uint8_t *bytes, size_t length, size_t *consumed){
+    uint32_t c = bytes[0];
+    *consumed = 1;
+    if (c < 0x80) {
+        return c;
+    }
+    size_t count;
+    uint32_t min;
+    if (c >= 0xC2 && c <= 0xDF) {
+        count = 2; min = 0x80; c &= 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        count = 3; min = 0x800; c &= 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        count = 4; min = 0x10000; c &= 0x07;
+    } else {
+        return 0xFFFD;
+    }
+    if (count > length) {
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        c = (c << 6) | (bytes[i] & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        return 0xFFFD;
+    }
+    *consumed = count;
+    return c;
+}
+
+/** 从字符边界 byteOffset 开始解码，直到到达 byteLimit 或 characterLimit
+ * @param characterOffset 输入起始字符偏移，输出结束时的字符偏移
+ * @return 结束时的字节偏移，总是位于字符边界
+ */
+static size_t scanUTF8(const YLBookFile *file, size_t byteOffset, size_t byteLimit, size_t *characterOffset, size_t characterLimit){
+    const uint8_t *bytes = file->bytes;
+    size_t characters = *characterOffset;
+    while (byteOffset < byteLimit && characters < characterLimit) {
+        //ASCII 快速路径：一次检查 8 个字节
+        if (byteOffset + 8 <= byteLimit && characters + 8 <= characterLimit) {
+            uint64_t word;
+            memcpy(&word, bytes + byteOffset, sizeof(word));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                byteOffset += 8;
+                characters += 8;
+                continue;
+            }
+        }
+        size_t consumed;
+        uint32_t c = decodeUTF8(bytes + byteOffset, file->length - byteOffset, &consumed);
+        size_t units = c >= 0x10000 ? 2 : 1;
+        if (byteOffset + consumed > byteLimit || characters + units > characterLimit) {
+            break;
+        }
+        byteOffset += consumed;
+        characters += units;
+    }
+    *characterOffset = characters;
+    return byteOffset;
+}
+
+
+// MARK: - 打开与关闭
+
+static bool writeAll(int fd, const uint8_t *bytes, size_t length){
+    while (length > 0) {
+        ssize_t count = write(fd, bytes, length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return true;
+}
+
+/** 将 start 之后的内容分块转码为 UTF-8，写入临时文件后映射，替换原来的映射
+ * 临时文件创建后即删除，映射解除时由系统回收
+ */
+static bool transcodeFile(YLBookFile *file, size_t start){
+    const char *directory = getenv("TMPDIR");
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/YLBookFile.XXXXXX", directory && directory[0] ? directory : "/tmp");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(path);
+
+    YLTextTranscoder *transcoder = YLTextTranscoderCreate(file->encoding);
+    uint8_t *buffer = malloc(YLTextTranscoderMaxOutputLength(YLBookFileTranscodeChunkLength));
+    bool success = transcoder != NULL && buffer != NULL;
+    size_t length = 0;
+    for (size_t offset = start; success && offset < file->length; offset += YLBookFileTranscodeChunkLength) {
+        size_t chunk = file->length - offset < YLBookFileTranscodeChunkLength ? file->length - offset : YLBookFileTranscodeChunkLength;
+        size_t count = YLTextTranscoderConvert(transcoder, file->bytes + offset, chunk, offset + chunk >= file->length, buffer);
+        success = writeAll(fd, buffer, count);
+        length += count;
+    }
+    free(buffer);
+    YLTextTranscoderDestroy(transcoder);
+
+    void *bytes = NULL;
+    if (success && length > 0) {
+        bytes = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        success = bytes != MAP_FAILED;
+    }
+    close(fd);
+    if (!success) {
+        return false;
+    }
+    if (file->bytes) {
+        munmap((void *)file->bytes, file->length);
+    }
+    if (bytes) {
+        madvise(bytes, length, MADV_SEQUENTIAL);
+    }
+    file->bytes = bytes;
+    file->length = length;
+    file->contentStart = 0;
+    return true;
+}
+
+YLBookFile *YLBookFileOpen(const char *path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return NULL;
+    }
+    YLBookFile *file = calloc(1, sizeof(YLBookFile));
+    if (file == NULL) {
+        close(fd);
+        return NULL;
+    }
+    file->length = (size_t)info.st_size;
+    if (file->length > 0) {
+        void *bytes = mmap(NULL, file->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (bytes == MAP_FAILED) {
+            close(fd);
+            free(file);
+            return NULL;
+        }
+        madvise(bytes, file->length, MADV_SEQUENTIAL);
+        file->bytes = bytes;
+    }
+    close(fd);//映射建立后即可关闭文件
+
+    size_t bomLength;
+    file->encoding = YLTextEncodingDetect(file->bytes, file->length, &bomLength);
+    if (file->encoding == YLTextEncodingUTF8) {
+        file->contentStart = bomLength;
+    } else if (!transcodeFile(file, bomLength)) {
+        YLBookFileClose(file);
+        return NULL;
+    }
+    file->checkpointCapacity = 16;
+    file->checkpoints = malloc(file->checkpointCapacity * sizeof(YLBookFileCheckpoint));
+    if (file->checkpoints == NULL) {
+        YLBookFileClose(file);
+        return NULL;
+    }
+    file->checkpoints[0].byteOffset = file->contentStart;
+    file->checkpoints[0].characterOffset = 0;
+    file->checkpointCount = 1;
+    return file;
+}
+
+void YLBookFileClose(YLBookFile *file){
+    if (file == NULL) {
+        return;
+    }
+    if (file->bytes) {
+        munmap((void *)file->bytes, file->length);
+    }
+    free(file->checkpoints);
+    free(file->headings);
+    free(file);
+}
+
+YLTextEncoding YLBookFileEncoding(const YLBookFile *file){
+    return file->encoding;
+}
+
+size_t YLBookFileContentStart(const YLBookFile *file){
+    return file->contentStart;
+}
+
+size_t YLBookFileLength(const YLBookFile *file){
+    return file->length;
+}
+
+const uint8_t *YLBookFileBytes(const YLBookFile *file){
+    return file->bytes;
+}
+
+
+// MARK: - 偏移索引
+
+/// 追加一个检查点，返回是否成功
+static bool appendCheckpoint(YLBookFile *file){
+    const YLBookFileCheckpoint *last = &file->checkpoints[file->checkpointCount - 1];
+    size_t target = file->contentStart + file->checkpointCount * YLBookFileIndexStride;
+    if (target >= file->length) {
+        return false;
+    }
+    if (file->checkpointCount == file->checkpointCapacity) {
+        size_t capacity = file->checkpointCapacity * 2;
+        YLBookFileCheckpoint *checkpoints = realloc(file->checkpoints, capacity * sizeof(YLBookFileCheckpoint));
+        if (checkpoints == NULL) {
+            return false;
+        }
+        file->checkpoints = checkpoints;
+        file->checkpointCapacity = capacity;
+        last = &file->checkpoints[file->checkpointCount - 1];
+    }
+    size_t characterOffset = last->characterOffset;
+    size_t byteOffset = scanUTF8(file, last->byteOffset, target, &characterOffset, SIZE_MAX);
+    //target 位于多字节字符中间时，检查点后移到下一个字符边界
+    if (byteOffset < target) {
+        size_t consumed;
+        uint32_t c = decodeUTF8(file->bytes + byteOffset, file->length - byteOffset, &consumed);
+        characterOffset += c >= 0x10000 ? 2 : 1;
+        byteOffset += consumed;
+    }
+    file->checkpoints[file->checkpointCount].byteOffset = byteOffset;
+    file->checkpoints[file->checkpointCount].characterOffset = characterOffset;
+    file->checkpointCount++;
+    return true;
+}
+
+size_t YLBookFileCharacterOffset(YLBookFile *file, size_t byteOffset){
+    if (byteOffset > file->length) {
+        byteOffset = file->length;
+    }
+    if (byteOffset <= file->contentStart) {
+        return 0;
+    }
+    size_t index = (byteOffset - file->contentStart) / YLBookFileIndexStride;
+    while (file->checkpointCount <= index && appendCheckpoint(file)) {}
+    if (index >= file->checkpointCount) {
+        index = file->checkpointCount - 1;
+    }
+    //检查点可能因字符边界而略微后移
+    while (index > 0 && file->checkpoints[index].byteOffset > byteOffset) {
+        index--;
+    }
+    size_t characterOffset = file->checkpoints[index].characterOffset;
+    scanUTF8(file, file->checkpoints[index].byteOffset, byteOffset, &characterOffset, SIZE_MAX);
+    return characterOffset;
+}
+
+size_t YLBookFileByteOffset(YLBookFile *file, size_t characterOffset){
+    while (file->checkpoints[file->checkpointCount - 1].characterOffset < characterOffset && appendCheckpoint(file)) {}
+
+    size_t low = 0, high = file->checkpointCount;
+    while (low + 1 < high) {
+        size_t mid = low + (high - low) / 2;
+        if (file->checkpoints[mid].characterOffset <= characterOffset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    size_t characters = file->checkpoints[low].characterOffset;
+    return scanUTF8(file, file->checkpoints[low].byteOffset, file->length, &characters, characterOffset);
+}
+
+size_t YLBookFileCopyCharacters(const YLBookFile *file, size_t byteStart, size_t byteEnd, uint16_t *buffer){
+    if (byteEnd > file->length) {
+        byteEnd = file->length;
+    }
+    const uint8_t *bytes = file->bytes;
+    size_t count = 0;
+    size_t i = byteStart;
+    while (i < byteEnd) {
+        if (bytes[i] < 0x80) {
+            if (buffer) {
+                buffer[count] = bytes[i];
+            }
+            count++;
+            i++;
+            continue;
+        }
+        size_t consumed;
+        uint32_t c = decodeUTF8(bytes + i, byteEnd - i, &consumed);
+        if (c >= 0x10000) {
+            if (buffer) {
+                c -= 0x10000;
+                buffer[count] = (uint16_t)(0xD800 + (c >> 10));
+                buffer[count + 1] = (uint16_t)(0xDC00 + (c & 0x3FF));
+            }
+            count += 2;
+        } else {
+            if (buffer) {
+                buffer[count] = (uint16_t)c;
+            }
+            count++;
+        }
+        i += consumed;
+    }
+    return count;
+}
+
+
+// MARK: - 章节
+
+/// byteOffset 处的段落是否为章节标题
+static bool isChapterHeading(const YLBookFile *file, size_t byteOffset){
+    const uint8_t *bytes = file->bytes;
+    size_t consumed;
+    uint32_t c = 0;
+    while (byteOffset < file->length) {
+        c = decodeUTF8(bytes + byteOffset, file->length - byteOffset, &consumed);
+        byteOffset += consumed;
+        if (c != ' ' && c != '\t' && c != 0x3000 && c != 0x00A0) {
+            break;
+        }
+    }
+    if (c != 0x7B2C) {//第
+        return false;
+    }
+    size_t numerals = 0;
+    while (byteOffset < file->length) {
+        c = decodeUTF8(bytes + byteOffset, file->length - byteOffset, &consumed);
+        byteOffset += consumed;
+        if (!YLTextIsChapterNumeral(c)) {
+            break;
+        }
+        numerals++;
+    }
+    return numerals > 0 && YLTextIsChapterUnit(c);
+}
+
+bool YLBookFileSetChapterHeadings(YLBookFile *file, const size_t *offsets, size_t count){
+    size_t *headings = malloc(count * sizeof(size_t) + 1);
+    if (headings == NULL) {
+        return false;
+    }
+    if (count > 0) {
+        memcpy(headings, offsets, count * sizeof(size_t));
+    }
+    free(file->headings);
+    file->headings = headings;
+    file->headingCount = count;
+    return true;
+}
+
+/// byteStart 之后的第一个章节起始位置，没有时返回文件长度
+static size_t nextHeading(const YLBookFile *file, size_t byteStart){
+    size_t low = 0, high = file->headingCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (file->headings[mid] <= byteStart) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < file->headingCount ? file->headings[low] : file->length;
+}
+
+size_t YLBookFileChapterEnd(const YLBookFile *file, size_t byteStart, size_t maxLength){
+    const uint8_t *bytes = file->bytes;
+    size_t length = file->length;
+    size_t limit = (maxLength < length - byteStart) ? byteStart + maxLength : length;
+    size_t lastParagraph = byteStart;
+    if (file->headings) {
+        size_t next = nextHeading(file, byteStart);
+        if (next <= limit) {
+            return next;
+        }
+    }
+
+    //换行符都是 ASCII，不会出现在多字节字符中间，可以逐字节查找
+    for (size_t i = byteStart; i < length; i++) {
+        uint8_t c = bytes[i];
+        if (c != '\n' && c != '\r' && c != 0x0C) {
+            continue;
+        }
+        if (c == '\r' && i + 1 < length && bytes[i + 1] == '\n') {
+            continue;
+        }
+        size_t paragraph = i + 1;
+        if (paragraph > limit) {
+            break;
+        }
+        if (file->headings == NULL && paragraph < length && (c == 0x0C || isChapterHeading(file, paragraph))) {
+            return paragraph;
+        }
+        lastParagraph = paragraph;
+    }
+    if (limit >= length) {
+        return length;
+    }
+    if (lastParagraph > byteStart) {
+        return lastParagraph;
+    }
+    //整段超过 maxLength，退回到字符边界
+    while (limit > byteStart && (bytes[limit] & 0xC0) == 0x80) {
+        limit--;
+    }
+    return limit > byteStart ? limit : length;
+}
@@ -0,0 +1,83 @@
+//
+//  YLBookFile.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  以内存映射方式打开书籍文件，按需读取章节。
+//  UTF-8 的文件直接映射；GB18030、UTF-16 的文件在打开时流式转码为 UTF-8 临时文件再映射，之后的字节偏移都以转码后的内容计算。
+//  字节偏移与字符偏移（UTF-16 码元，与 NSString 一致）之间通过稀疏索引换算：
+//  每隔 YLBookFileIndexStride 字节记录一个检查点，索引只向前构建到访问过的位置，打开文件时不读取全文。
+//
+
+#ifndef YLBookFile_h
+#define YLBookFile_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "YLTextEncoding.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 索引检查点的间隔（字节）
+#define YLBookFileIndexStride 65536
+
+/// 转码时每次处理的字节数
+#define YLBookFileTranscodeChunkLength (256 * 1024)
+
+/// 单个章节的默认最大字节数，超过时在段落边界处切分
+#define YLBookFileDefaultChapterLength (512 * 1024)
+
+typedef struct YLBookFile YLBookFile;
+
+/// 打开文件并识别编码，失败时返回 NULL
+YLBookFile *YLBookFileOpen(const char *path);
+
+void YLBookFileClose(YLBookFile *file);
+
+/// 文件原来的编码
+YLTextEncoding YLBookFileEncoding(const YLBookFile *file);
+
+/// 正文的起止字节位置（跳过 UTF-8 BOM；转码后的内容不含 BOM）
+size_t YLBookFileContentStart(const YLBookFile *file);
+size_t YLBookFileLength(const YLBookFile *file);
+
+/// 文件内容（UTF-8），长度为 YLBookFileLength
+const uint8_t *YLBookFileBytes(const YLBookFile *file);
+
+/** 字节偏移对应的字符偏移
+ * byteOffset 位于多字节字符中间时，返回该字符的起始位置
+ * @note 索引会构建到 byteOffset 处；同一个 file 不能在多个线程中同时调用
+ */
+size_t YLBookFileCharacterOffset(YLBookFile *file, size_t byteOffset);
+
+/// 字符偏移对应的字节偏移，超出全文时返回文件长度
+size_t YLBookFileByteOffset(YLBookFile *file, size_t characterOffset);
+
+/** 将 [byteStart, byteEnd) 解码为 UTF-16，非法字节解码为 U+FFFD
+ * @param buffer 为 NULL 时只计算长度
+ * @return UTF-16 码元数
+ */
+size_t YLBookFileCopyCharacters(const YLBookFile *file, size_t byteStart, size_t byteEnd, uint16_t *buffer);
+
+/** 从 byteStart 开始的章节的结束位置
+ * 章节在下一个章节标题（「第…章」等开头的段落，设置了 YLBookFileSetChapterHeadings 时为其中的位置）或换页符之后的段落处结束；
+ * 超过 maxLength 字节时，在 byteStart + maxLength 之前的最后一个段落边界处切分
+ * @return 结束位置（不含），即下一章节的起始位置
+ */
+size_t YLBookFileChapterEnd(const YLBookFile *file, size_t byteStart, size_t maxLength);
+
+/** 设置章节的起始位置（如目录中各标题所在段落的位置），之后不再按内置规则识别标题
+ * @param offsets 升序排列，会被复制
+ * @return 内存不足时返回 false
+ */
+bool YLBookFileSetChapterHeadings(YLBookFile *file, const size_t *offsets, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLBookFile_h */
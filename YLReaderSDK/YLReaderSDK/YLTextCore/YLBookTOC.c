@@ -0,0 +1,640 @@
+//
+//  YLBookTOC.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLBookTOC.h"
+#include "YLTextParallelLayout.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// 每块至少包含的字节数
+#define YLBookTOCMinChunkLength (256 * 1024)
+
+/// 单个模式最多的项数
+#define YLBookTOCMaxAtomCount 32
+
+/// 匹配一行时回溯的步数上限，避免 .*.*.* 之类的模式在长行上耗时过多
+#define YLBookTOCMatchBudget 4096
+
+const char *const YLBookTOCDefaultPatterns[] = {
+    "第\\d+\\u",
+    "chapter\\s+\\d+",
+};
+const size_t YLBookTOCDefaultPatternCount = sizeof(YLBookTOCDefaultPatterns) / sizeof(YLBookTOCDefaultPatterns[0]);
+
+enum {
+    YLBookTOCClassNumeral = 1 << 0,
+    YLBookTOCClassUnit = 1 << 1,
+    YLBookTOCClassSpace = 1 << 2,
+};
+
+typedef struct YLBookTOCRange {
+    uint32_t first;
+    uint32_t last;
+} YLBookTOCRange;
+
+/// 模式中的一项：字符集合与出现次数；普通字符是只有一个字符的集合，. 是取反的空集合
+typedef struct YLBookTOCAtom {
+    uint32_t rangeStart;
+    uint32_t rangeCount;
+    uint8_t classes;
+    bool negated;
+    uint16_t min;
+    uint16_t max;
+} YLBookTOCAtom;
+
+typedef struct YLBookTOCPattern {
+    uint32_t atomStart;
+    uint32_t atomCount;
+    /// 以 $ 结尾
+    bool anchored;
+} YLBookTOCPattern;
+
+struct YLBookTOCMatcher {
+    YLBookTOCPattern *patterns;
+    size_t patternCount;
+    YLBookTOCAtom *atoms;
+    size_t atomCount;
+    size_t atomCapacity;
+    YLBookTOCRange *ranges;
+    size_t rangeCount;
+    size_t rangeCapacity;
+    /// 标题可能的首字节
+    bool firstBytes[256];
+};
+
+// MARK: - UTF-8
+
+/// 解码一个字符，非法或不完整的序列按单个字节解码为 U+FFFD
+static uint32_t decodeUTF8(const uint8_t *bytes, size_t length, size_t *consumed){
+    uint32_t c = bytes[0];
+    *consumed = 1;
+    if (c < 0x80) {
+        return c;
+    }
+    size_t count;
+    uint32_t min;
+    if (c >= 0xC2 && c <= 0xDF) {
+        count = 2; min = 0x80; c &= 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        count = 3; min = 0x800; c &= 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        count = 4; min = 0x10000; c &= 0x07;
+    } else {
+        return 0xFFFD;
+    }
+    if (count > length) {
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        c = (c << 6) | (bytes[i] & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        return 0xFFFD;
+    }
+    *consumed = count;
+    return c;
+}
+
+static uint8_t leadByte(uint32_t c){
+    if (c < 0x80) {
+        return (uint8_t)c;
+    } else if (c < 0x800) {
+        return (uint8_t)(0xC0 | (c >> 6));
+    } else if (c < 0x10000) {
+        return (uint8_t)(0xE0 | (c >> 12));
+    }
+    return (uint8_t)(0xF0 | (c >> 18));
+}
+
+static bool isSpace(uint32_t c){
+    return c == ' ' || c == '\t' || c == 0x3000 || c == 0x00A0;
+}
+
+static bool isSeparator(uint8_t c){
+    return c == '\n' || c == '\r' || c == 0x0C;
+}
+
+
+// MARK: - 编译
+
+static bool appendRange(YLBookTOCMatcher *matcher, uint32_t first, uint32_t last){
+    if (matcher->rangeCount == matcher->rangeCapacity) {
+        size_t capacity = matcher->rangeCapacity ? matcher->rangeCapacity * 2 : 16;
+        YLBookTOCRange *ranges = realloc(matcher->ranges, capacity * sizeof(YLBookTOCRange));
+        if (ranges == NULL) {
+            return false;
+        }
+        matcher->ranges = ranges;
+        matcher->rangeCapacity = capacity;
+    }
+    matcher->ranges[matcher->rangeCount++] = (YLBookTOCRange){first, last};
+    return true;
+}
+
+/// \d、\u、\s 对应的字符类，其他转义返回 0
+static uint8_t escapeClass(uint32_t c){
+    switch (c) {
+        case 'd': return YLBookTOCClassNumeral;
+        case 'u': return YLBookTOCClassUnit;
+        case 's': return YLBookTOCClassSpace;
+        default: return 0;
+    }
+}
+
+/** 解析 [...]，position 指向 [ 之后
+ * @return 失败时返回 false
+ */
+static bool parseSet(YLBookTOCMatcher *matcher, YLBookTOCAtom *atom, const uint8_t *pattern, size_t length, size_t *position){
+    size_t i = *position;
+    size_t consumed;
+    if (i < length && pattern[i] == '^') {
+        atom->negated = true;
+        i++;
+    }
+    bool first = true;
+    while (i < length && (pattern[i] != ']' || first)) {
+        first = false;
+        uint32_t c = decodeUTF8(pattern + i, length - i, &consumed);
+        i += consumed;
+        if (c == '\\') {
+            if (i >= length) {
+                return false;
+            }
+            c = decodeUTF8(pattern + i, length - i, &consumed);
+            i += consumed;
+            uint8_t classes = escapeClass(c);
+            if (classes) {
+                atom->classes |= classes;
+                continue;
+            }
+        }
+        uint32_t last = c;
+        if (i + 1 < length && pattern[i] == '-' && pattern[i + 1] != ']') {
+            i++;
+            last = decodeUTF8(pattern + i, length - i, &consumed);
+            i += consumed;
+            if (last == '\\') {
+                if (i >= length) {
+                    return false;
+                }
+                last = decodeUTF8(pattern + i, length - i, &consumed);
+                i += consumed;
+            }
+            if (last < c) {
+                return false;
+            }
+        }
+        if (!appendRange(matcher, c, last)) {
+            return false;
+        }
+        atom->rangeCount++;
+    }
+    if (i >= length) {//缺少 ]
+        return false;
+    }
+    *position = i + 1;
+    return true;
+}
+
+static bool compilePattern(YLBookTOCMatcher *matcher, const char *source, YLBookTOCPattern *program){
+    const uint8_t *pattern = (const uint8_t *)source;
+    size_t length = strlen(source);
+    program->atomStart = (uint32_t)matcher->atomCount;
+    program->atomCount = 0;
+    program->anchored = false;
+    size_t i = 0, consumed;
+    while (i < length) {
+        uint32_t c = decodeUTF8(pattern + i, length - i, &consumed);
+        i += consumed;
+        if (c == '$' && i == length) {
+            program->anchored = true;
+            break;
+        }
+        if (c == '?' || c == '*' || c == '+') {
+            //量词必须跟在一项之后，且不能重复
+            if (program->atomCount == 0) {
+                return false;
+            }
+            YLBookTOCAtom *atom = &matcher->atoms[matcher->atomCount - 1];
+            if (atom->min != 1 || atom->max != 1) {
+                return false;
+            }
+            atom->min = c == '+' ? 1 : 0;
+            atom->max = c == '?' ? 1 : UINT16_MAX;
+            continue;
+        }
+        if (program->atomCount == YLBookTOCMaxAtomCount) {
+            return false;
+        }
+        if (matcher->atomCount == matcher->atomCapacity) {
+            size_t capacity = matcher->atomCapacity ? matcher->atomCapacity * 2 : 16;
+            YLBookTOCAtom *atoms = realloc(matcher->atoms, capacity * sizeof(YLBookTOCAtom));
+            if (atoms == NULL) {
+                return false;
+            }
+            matcher->atoms = atoms;
+            matcher->atomCapacity = capacity;
+        }
+        YLBookTOCAtom *atom = &matcher->atoms[matcher->atomCount];
+        memset(atom, 0, sizeof(YLBookTOCAtom));
+        atom->rangeStart = (uint32_t)matcher->rangeCount;
+        atom->min = 1;
+        atom->max = 1;
+        if (c == '.') {
+            atom->negated = true;
+        } else if (c == '[') {
+            if (!parseSet(matcher, atom, pattern, length, &i)) {
+                return false;
+            }
+        } else {
+            if (c == '\\') {
+                if (i >= length) {
+                    return false;
+                }
+                c = decodeUTF8(pattern + i, length - i, &consumed);
+                i += consumed;
+                atom->classes = escapeClass(c);
+            }
+            if (atom->classes == 0) {
+                if (!appendRange(matcher, c, c)) {
+                    return false;
+                }
+                atom->rangeCount = 1;
+            }
+        }
+        matcher->atomCount++;
+        program->atomCount++;
+    }
+    return program->atomCount > 0;
+}
+
+static bool atomContains(const YLBookTOCMatcher *matcher, const YLBookTOCAtom *atom, uint32_t c){
+    if ((atom->classes & YLBookTOCClassNumeral) && YLTextIsChapterNumeral(c)) {
+        return true;
+    }
+    if ((atom->classes & YLBookTOCClassUnit) && YLTextIsChapterUnit(c)) {
+        return true;
+    }
+    if ((atom->classes & YLBookTOCClassSpace) && isSpace(c)) {
+        return true;
+    }
+    const YLBookTOCRange *ranges = matcher->ranges + atom->rangeStart;
+    for (uint32_t i = 0; i < atom->rangeCount; i++) {
+        if (c >= ranges[i].first && c <= ranges[i].last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// ASCII 字母不区分大小写
+static bool atomMatches(const YLBookTOCMatcher *matcher, const YLBookTOCAtom *atom, uint32_t c){
+    bool contains = atomContains(matcher, atom, c);
+    if (!contains && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
+        contains = atomContains(matcher, atom, c ^ 0x20);
+    }
+    return contains != atom->negated;
+}
+
+/// 汇总模式第一项可能的首字节；第一项可以不出现或是取反的集合时不做过滤
+static void collectFirstBytes(YLBookTOCMatcher *matcher, const YLBookTOCPattern *program){
+    const YLBookTOCAtom *atom = &matcher->atoms[program->atomStart];
+    if (atom->min == 0 || atom->negated) {
+        memset(matcher->firstBytes, true, sizeof(matcher->firstBytes));
+        return;
+    }
+    for (uint32_t c = 0; c < 0x10000; c++) {
+        if ((c < 0xD800 || c > 0xDFFF) && atomMatches(matcher, atom, c)) {
+            matcher->firstBytes[leadByte(c)] = true;
+        }
+    }
+    //增补平面的字符只按范围的两端计入
+    const YLBookTOCRange *ranges = matcher->ranges + atom->rangeStart;
+    for (uint32_t i = 0; i < atom->rangeCount; i++) {
+        if (ranges[i].last >= 0x10000) {
+            uint32_t first = ranges[i].first < 0x10000 ? 0x10000 : ranges[i].first;
+            for (uint32_t lead = leadByte(first); lead <= leadByte(ranges[i].last); lead++) {
+                matcher->firstBytes[lead] = true;
+            }
+        }
+    }
+}
+
+YLBookTOCMatcher *YLBookTOCMatcherCreate(const char *const *patterns, size_t count){
+    if (count == 0) {
+        return NULL;
+    }
+    YLBookTOCMatcher *matcher = calloc(1, sizeof(YLBookTOCMatcher));
+    if (matcher == NULL) {
+        return NULL;
+    }
+    matcher->patterns = calloc(count, sizeof(YLBookTOCPattern));
+    if (matcher->patterns == NULL) {
+        YLBookTOCMatcherDestroy(matcher);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!compilePattern(matcher, patterns[i], &matcher->patterns[i])) {
+            YLBookTOCMatcherDestroy(matcher);
+            return NULL;
+        }
+        matcher->patternCount++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        collectFirstBytes(matcher, &matcher->patterns[i]);
+    }
+    return matcher;
+}
+
+void YLBookTOCMatcherDestroy(YLBookTOCMatcher *matcher){
+    if (matcher == NULL) {
+        return;
+    }
+    free(matcher->patterns);
+    free(matcher->atoms);
+    free(matcher->ranges);
+    free(matcher);
+}
+
+
+// MARK: - 匹配
+
+/** 从第 index 项开始匹配 [position, length)，各项尽量多地匹配，不成功再逐次回退
+ * @return 是否匹配
+ */
+static bool matchAtoms(const YLBookTOCMatcher *matcher, const YLBookTOCPattern *program, uint32_t index, const uint8_t *bytes, size_t position, size_t length, size_t *budget){
+    if (*budget == 0) {
+        return false;
+    }
+    (*budget)--;
+    if (index == program->atomCount) {
+        //标题不能为空
+        if (position == 0) {
+            return false;
+        }
+        if (!program->anchored) {
+            return true;
+        }
+        size_t consumed;
+        while (position < length && isSpace(decodeUTF8(bytes + position, length - position, &consumed))) {
+            position += consumed;
+        }
+        return position == length;
+    }
+    const YLBookTOCAtom *atom = &matcher->atoms[program->atomStart + index];
+    //每次匹配后的位置，相对于 position；一行不超过 YLBookTOCMaxTitleLength 字节
+    uint16_t ends[YLBookTOCMaxTitleLength + 1];
+    size_t count = 0;
+    size_t end = position;
+    ends[0] = 0;
+    while (count < atom->max && end < length) {
+        size_t consumed;
+        uint32_t c = decodeUTF8(bytes + end, length - end, &consumed);
+        if (!atomMatches(matcher, atom, c)) {
+            break;
+        }
+        end += consumed;
+        ends[++count] = (uint16_t)(end - position);
+    }
+    for (size_t k = count + 1; k > atom->min;) {
+        k--;
+        if (matchAtoms(matcher, program, index + 1, bytes, position + ends[k], length, budget)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// [0, length) 为一行，不超过 YLBookTOCMaxTitleLength 字节
+static int matchLine(const YLBookTOCMatcher *matcher, const uint8_t *bytes, size_t length){
+    if (length == 0 || !matcher->firstBytes[bytes[0]]) {
+        return -1;
+    }
+    for (size_t i = 0; i < matcher->patternCount; i++) {
+        size_t budget = YLBookTOCMatchBudget;
+        if (matchAtoms(matcher, &matcher->patterns[i], 0, bytes, 0, length, &budget)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/// 行尾（第一个段落分隔符）的位置，不超过 limit
+static size_t lineEnd(const uint8_t *bytes, size_t position, size_t limit){
+    while (position < limit && !isSeparator(bytes[position])) {
+        position++;
+    }
+    return position;
+}
+
+/// 跳过缩进
+static size_t skipIndent(const uint8_t *bytes, size_t position, size_t end){
+    while (position < end) {
+        size_t consumed;
+        if (!isSpace(decodeUTF8(bytes + position, end - position, &consumed))) {
+            break;
+        }
+        position += consumed;
+    }
+    return position;
+}
+
+int YLBookTOCMatcherMatch(const YLBookTOCMatcher *matcher, const uint8_t *bytes, size_t length){
+    size_t limit = length < YLBookTOCMaxTitleLength ? length : YLBookTOCMaxTitleLength;
+    return matchLine(matcher, bytes, lineEnd(bytes, 0, limit));
+}
+
+
+// MARK: - 查找
+
+typedef struct YLBookTOCChunk {
+    size_t start;
+    size_t end;
+    YLBookTOCEntry *entries;
+    size_t count;
+    size_t capacity;
+} YLBookTOCChunk;
+
+typedef struct YLBookTOCJob {
+    const YLBookTOCMatcher *matcher;
+    const uint8_t *bytes;
+    size_t start;
+    size_t end;
+    YLBookTOCChunk *chunks;
+    size_t chunkCount;
+    atomic_size_t nextChunk;
+    atomic_bool failed;
+} YLBookTOCJob;
+
+/// position 处是否为段落开头：\r\n 中间不算
+static bool isParagraphStart(const uint8_t *bytes, size_t start, size_t end, size_t position){
+    if (position == start) {
+        return true;
+    }
+    uint8_t previous = bytes[position - 1];
+    if (previous == '\r') {
+        return position >= end || bytes[position] != '\n';
+    }
+    return previous == '\n' || previous == 0x0C;
+}
+
+/// 检查 paragraph 处的段落，是标题时追加到 chunk
+static bool checkParagraph(const YLBookTOCJob *job, YLBookTOCChunk *chunk, size_t paragraph){
+    const uint8_t *bytes = job->bytes;
+    size_t titleOffset = skipIndent(bytes, paragraph, job->end);
+    size_t limit = job->end - titleOffset < YLBookTOCMaxTitleLength ? job->end : titleOffset + YLBookTOCMaxTitleLength;
+    size_t titleEnd = lineEnd(bytes, titleOffset, limit);
+    bool afterFormFeed = paragraph > job->start && bytes[paragraph - 1] == 0x0C;
+    int pattern = -1;
+    if (!afterFormFeed) {
+        pattern = matchLine(job->matcher, bytes + titleOffset, titleEnd - titleOffset);
+        if (pattern < 0) {
+            return true;
+        }
+    }
+    //标题被截断时退回到字符边界，并去掉行尾的空白
+    if (titleEnd < job->end && !isSeparator(bytes[titleEnd])) {
+        while (titleEnd > titleOffset && (bytes[titleEnd] & 0xC0) == 0x80) {
+            titleEnd--;
+        }
+    }
+    while (titleEnd > titleOffset && (bytes[titleEnd - 1] == ' ' || bytes[titleEnd - 1] == '\t')) {
+        titleEnd--;
+    }
+    if (chunk->count == chunk->capacity) {
+        size_t capacity = chunk->capacity ? chunk->capacity * 2 : 64;
+        YLBookTOCEntry *entries = realloc(chunk->entries, capacity * sizeof(YLBookTOCEntry));
+        if (entries == NULL) {
+            return false;
+        }
+        chunk->entries = entries;
+        chunk->capacity = capacity;
+    }
+    chunk->entries[chunk->count++] = (YLBookTOCEntry){paragraph, titleOffset, titleEnd - titleOffset, pattern};
+    return true;
+}
+
+/// 检查起始位置落在 [chunk->start, chunk->end) 中的段落
+static bool scanChunk(const YLBookTOCJob *job, YLBookTOCChunk *chunk){
+    const uint8_t *bytes = job->bytes;
+    if (isParagraphStart(bytes, job->start, job->end, chunk->start) && !checkParagraph(job, chunk, chunk->start)) {
+        return false;
+    }
+    size_t i = chunk->start;
+    while (i < chunk->end) {
+        //一次检查 8 个字节中是否有小于 0x0E 的字节，分隔符都在其中
+        if (i + 8 <= chunk->end) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            if (((word - 0x0E0E0E0E0E0E0E0EULL) & ~word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        uint8_t c = bytes[i++];
+        if (!isSeparator(c) || i >= chunk->end) {
+            continue;
+        }
+        if (c == '\r' && bytes[i] == '\n') {
+            continue;
+        }
+        if (!checkParagraph(job, chunk, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *tocWorker(void *argument){
+    YLBookTOCJob *job = argument;
+    size_t index;
+    while ((index = atomic_fetch_add(&job->nextChunk, 1)) < job->chunkCount) {
+        if (!scanChunk(job, &job->chunks[index])) {
+            atomic_store(&job->failed, true);
+        }
+    }
+    return NULL;
+}
+
+bool YLBookTOCBuild(const YLBookTOCMatcher *matcher, const uint8_t *bytes, size_t start, size_t end, size_t threadCount, YLBookTOCEntry **entries, size_t *count){
+    *entries = NULL;
+    *count = 0;
+    if (end <= start) {
+        return true;
+    }
+    if (threadCount == 0) {
+        long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = cpuCount > 0 ? (size_t)cpuCount : 1;
+    }
+    //每个线程约 4 块，块的边界可以落在任意字节
+    size_t chunkCount = threadCount * 4;
+    if ((end - start) / chunkCount < YLBookTOCMinChunkLength) {
+        chunkCount = (end - start + YLBookTOCMinChunkLength - 1) / YLBookTOCMinChunkLength;
+    }
+    YLBookTOCChunk *chunks = calloc(chunkCount, sizeof(YLBookTOCChunk));
+    if (chunks == NULL) {
+        return false;
+    }
+    size_t chunkLength = (end - start + chunkCount - 1) / chunkCount;
+    for (size_t i = 0; i < chunkCount; i++) {
+        chunks[i].start = start + i * chunkLength;
+        chunks[i].end = i + 1 == chunkCount ? end : start + (i + 1) * chunkLength;
+    }
+
+    YLBookTOCJob job;
+    job.matcher = matcher;
+    job.bytes = bytes;
+    job.start = start;
+    job.end = end;
+    job.chunks = chunks;
+    job.chunkCount = chunkCount;
+    atomic_init(&job.nextChunk, 0);
+    atomic_init(&job.failed, false);
+
+    if (threadCount > chunkCount) {
+        threadCount = chunkCount;
+    }
+    pthread_t *threads = threadCount > 1 ? malloc((threadCount - 1) * sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    if (threads) {
+        while (started < threadCount - 1 && pthread_create(&threads[started], NULL, tocWorker, &job) == 0) {
+            started++;
+        }
+    }
+    //当前线程同样参与查找
+    tocWorker(&job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    //按块的顺序拼接
+    bool success = !atomic_load(&job.failed);
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        total += chunks[i].count;
+    }
+    if (success && total > 0) {
+        *entries = malloc(total * sizeof(YLBookTOCEntry));
+        success = *entries != NULL;
+    }
+    for (size_t i = 0; i < chunkCount; i++) {
+        if (success && chunks[i].count > 0) {
+            memcpy(*entries + *count, chunks[i].entries, chunks[i].count * sizeof(YLBookTOCEntry));
+            *count += chunks[i].count;
+        }
+        free(chunks[i].entries);
+    }
+    free(chunks);
+    return success;
+}
@@ -0,0 +1,76 @@
+//
+//  YLBookTOC.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  目录：在 UTF-8 的书籍内容中查找章节标题。
+//  标题模式预先编译，并汇总出标题可能的首字节，段落开头的字节不符合时不必逐个模式匹配；
+//  全文切成若干块由多个线程查找，每块只负责起始位置落在块内的段落，匹配可以越过块的末尾，因此结果与单线程一致。
+//
+//  模式从段落开头（跳过缩进）匹配标题行的前缀：
+//    普通字符按字面匹配，ASCII 字母不区分大小写；
+//    .   除换行外的任意字符
+//    \d  章节序号（阿拉伯数字、全角数字、中文数字）   \u  章节单位（章回节卷部篇集）   \s  空白（含全角空格）
+//    [...] 字符集合，可以包含 a-z 形式的范围与 \d 等，[^...] 取反
+//    ? * +  前一项出现 0～1 次、任意次、至少 1 次
+//    $   只能位于末尾，其后直到行尾只能有空白
+//    \   转义其他字符
+//
+
+#ifndef YLBookTOC_h
+#define YLBookTOC_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 标题行的最大字节数，超出部分不参与匹配，也不计入标题
+#define YLBookTOCMaxTitleLength 256
+
+/// 默认模式：「第…章」等，以及英文的「Chapter 1」
+extern const char *const YLBookTOCDefaultPatterns[];
+extern const size_t YLBookTOCDefaultPatternCount;
+
+typedef struct YLBookTOCMatcher YLBookTOCMatcher;
+
+/** 编译标题模式
+ * @return 模式有语法错误或内存不足时返回 NULL
+ */
+YLBookTOCMatcher *YLBookTOCMatcherCreate(const char *const *patterns, size_t count);
+void YLBookTOCMatcherDestroy(YLBookTOCMatcher *matcher);
+
+/** 匹配一行文本的开头
+ * @return 匹配的模式序号，不匹配时返回 -1
+ */
+int YLBookTOCMatcherMatch(const YLBookTOCMatcher *matcher, const uint8_t *bytes, size_t length);
+
+/// 一个章节标题
+typedef struct YLBookTOCEntry {
+    /// 标题所在段落的起始位置，即章节的起始位置
+    size_t byteOffset;
+    /// 标题文字的位置（跳过缩进，不含行尾的空白）
+    size_t titleOffset;
+    size_t titleLength;
+    /// 匹配的模式序号；换页符之后的段落为 -1
+    int pattern;
+} YLBookTOCEntry;
+
+/** 查找 [start, end) 中的章节标题
+ * 段落以 \n、\r、\r\n 或换页符分隔；换页符之后的段落总是作为章节开头
+ * @param threadCount 线程数；为 0 时使用 CPU 核数
+ * @param entries 输出按位置升序排列的标题，需调用方 free；没有时为 NULL
+ * @param count 输出标题数量
+ * @return 内存分配失败时返回 false
+ */
+bool YLBookTOCBuild(const YLBookTOCMatcher *matcher, const uint8_t *bytes, size_t start, size_t end, size_t threadCount, YLBookTOCEntry **entries, size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLBookTOC_h */
@@ -0,0 +1,329 @@
+//
+//  YLPageBitmapCache.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLPageBitmapCache.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct YLPageBitmapEntry {
+    size_t page;
+    YLPageBitmap bitmap;
+} YLPageBitmapEntry;
+
+struct YLPageBitmapCache {
+    pthread_mutex_t mutex;
+    YLPageRasterizer rasterizer;
+    size_t byteBudget;
+    size_t prefetchCount;
+    size_t pageCount;
+    size_t currentPage;
+    int direction;
+    size_t generation; //RemoveAll 时加一，之前开始的渲染结果作废
+
+    YLPageBitmapEntry *entries;
+    size_t entryCount;
+    size_t entryCapacity;
+    size_t byteCount;
+
+    size_t *rendering; //正在渲染的页
+    size_t renderingCount;
+    size_t renderingCapacity;
+};
+
+YLPageBitmapCache *YLPageBitmapCacheCreate(YLPageRasterizer rasterizer, size_t byteBudget, size_t prefetchCount){
+    YLPageBitmapCache *cache = calloc(1, sizeof(YLPageBitmapCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    if (pthread_mutex_init(&cache->mutex, NULL) != 0) {
+        free(cache);
+        return NULL;
+    }
+    cache->rasterizer = rasterizer;
+    cache->byteBudget = byteBudget;
+    cache->prefetchCount = prefetchCount;
+    cache->direction = 1;
+    return cache;
+}
+
+static void YLPageBitmapCacheRemoveEntry(YLPageBitmapCache *cache, size_t index){
+    YLPageBitmapEntry *entry = &cache->entries[index];
+    cache->byteCount -= entry->bitmap.byteCount;
+    cache->rasterizer.release(cache->rasterizer.context, entry->bitmap);
+    cache->entries[index] = cache->entries[--cache->entryCount];
+}
+
+void YLPageBitmapCacheDestroy(YLPageBitmapCache *cache){
+    if (cache == NULL) {
+        return;
+    }
+    while (cache->entryCount) {
+        YLPageBitmapCacheRemoveEntry(cache, cache->entryCount - 1);
+    }
+    free(cache->entries);
+    free(cache->rendering);
+    pthread_mutex_destroy(&cache->mutex);
+    free(cache);
+}
+
+// MARK: - 优先级
+
+/** 第 page 页的淘汰优先级，越大越先淘汰
+ * 窗口内的页按渲染顺序排列：当前页，然后阅读方向上的第 k 页与反方向的第 k 页交替；
+ * 窗口外的页按距离排列，反方向的距离加倍
+ */
+static size_t YLPageBitmapCacheRank(const YLPageBitmapCache *cache, size_t page){
+    long long delta = ((long long)page - (long long)cache->currentPage) * cache->direction;
+    size_t ahead = cache->prefetchCount;
+    size_t behind = (cache->prefetchCount + 1) / 2;
+    if (delta == 0) {
+        return 0;
+    }
+    if (delta > 0 && (size_t)delta <= ahead) {
+        size_t k = (size_t)delta;
+        return k <= behind ? 2 * k - 1 : behind + k;
+    }
+    if (delta < 0 && (size_t)-delta <= behind) {
+        return 2 * (size_t)-delta;
+    }
+    size_t distance = delta > 0 ? (size_t)delta : 2 * (size_t)-delta;
+    return ahead + behind + distance;
+}
+
+/// 窗口中第 rank 个渲染的页，越界时返回 false
+static bool YLPageBitmapCachePageAtRank(const YLPageBitmapCache *cache, size_t rank, size_t *page){
+    size_t ahead = cache->prefetchCount;
+    size_t behind = (cache->prefetchCount + 1) / 2;
+    long long delta;
+    if (rank == 0) {
+        delta = 0;
+    } else if (rank <= 2 * behind) {
+        delta = rank % 2 ? (long long)(rank + 1) / 2 : -(long long)rank / 2;
+    } else if (rank <= ahead + behind) {
+        delta = (long long)(rank - behind);
+    } else {
+        return false;
+    }
+    long long result = (long long)cache->currentPage + delta * cache->direction;
+    if (result < 0 || (unsigned long long)result >= cache->pageCount) {
+        *page = SIZE_MAX;
+        return true;
+    }
+    *page = (size_t)result;
+    return true;
+}
+
+static size_t YLPageBitmapCacheIndexOfPage(const YLPageBitmapCache *cache, size_t page){
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        if (cache->entries[i].page == page) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static bool YLPageBitmapCacheIsRendering(const YLPageBitmapCache *cache, size_t page){
+    for (size_t i = 0; i < cache->renderingCount; i++) {
+        if (cache->rendering[i] == page) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// 淘汰优先级最低（rank 最大）的位图，只淘汰 rank 大于 limit 的；没有可淘汰的返回 false
+static bool YLPageBitmapCacheEvictOne(YLPageBitmapCache *cache, size_t limit){
+    size_t victim = SIZE_MAX;
+    size_t victimRank = limit;
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        size_t rank = YLPageBitmapCacheRank(cache, cache->entries[i].page);
+        if (rank > victimRank) {
+            victim = i;
+            victimRank = rank;
+        }
+    }
+    if (victim == SIZE_MAX) {
+        return false;
+    }
+    YLPageBitmapCacheRemoveEntry(cache, victim);
+    return true;
+}
+
+// MARK: - 接口
+
+void YLPageBitmapCacheSetPageCount(YLPageBitmapCache *cache, size_t pageCount){
+    pthread_mutex_lock(&cache->mutex);
+    cache->pageCount = pageCount;
+    for (size_t i = cache->entryCount; i > 0; i--) {
+        if (cache->entries[i - 1].page >= pageCount) {
+            YLPageBitmapCacheRemoveEntry(cache, i - 1);
+        }
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+void YLPageBitmapCacheSetCurrentPage(YLPageBitmapCache *cache, size_t page){
+    pthread_mutex_lock(&cache->mutex);
+    if (page != cache->currentPage) {
+        cache->direction = page > cache->currentPage ? 1 : -1;
+        cache->currentPage = page;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+int YLPageBitmapCacheDirection(YLPageBitmapCache *cache){
+    pthread_mutex_lock(&cache->mutex);
+    int direction = cache->direction;
+    pthread_mutex_unlock(&cache->mutex);
+    return direction;
+}
+
+void YLPageBitmapCacheRemoveAll(YLPageBitmapCache *cache){
+    pthread_mutex_lock(&cache->mutex);
+    while (cache->entryCount) {
+        YLPageBitmapCacheRemoveEntry(cache, cache->entryCount - 1);
+    }
+    cache->generation++;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+bool YLPageBitmapCacheCopyBitmap(YLPageBitmapCache *cache, size_t page, YLPageBitmap *bitmap){
+    pthread_mutex_lock(&cache->mutex);
+    size_t index = YLPageBitmapCacheIndexOfPage(cache, page);
+    if (index != SIZE_MAX) {
+        *bitmap = cache->entries[index].bitmap;
+        cache->rasterizer.retain(cache->rasterizer.context, *bitmap);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    return index != SIZE_MAX;
+}
+
+void YLPageBitmapCacheReleaseBitmap(YLPageBitmapCache *cache, YLPageBitmap bitmap){
+    cache->rasterizer.release(cache->rasterizer.context, bitmap);
+}
+
+/// 窗口中下一个需要渲染的页；预算已被 rank 更小的页占满时返回 false
+static bool YLPageBitmapCacheNextPage(YLPageBitmapCache *cache, size_t *page){
+    size_t rank = 0;
+    size_t candidate;
+    while (YLPageBitmapCachePageAtRank(cache, rank, &candidate)) {
+        if (candidate != SIZE_MAX &&
+            YLPageBitmapCacheIndexOfPage(cache, candidate) == SIZE_MAX &&
+            !YLPageBitmapCacheIsRendering(cache, candidate)) {
+            //预算已满且没有比它更次要的位图可以淘汰
+            if (cache->byteCount >= cache->byteBudget) {
+                bool evictable = false;
+                for (size_t i = 0; i < cache->entryCount && !evictable; i++) {
+                    evictable = YLPageBitmapCacheRank(cache, cache->entries[i].page) > rank;
+                }
+                if (!evictable) {
+                    return false;
+                }
+            }
+            *page = candidate;
+            return true;
+        }
+        rank++;
+    }
+    return false;
+}
+
+static bool YLPageBitmapCacheMarkRendering(YLPageBitmapCache *cache, size_t page){
+    if (cache->renderingCount == cache->renderingCapacity) {
+        size_t capacity = cache->renderingCapacity ? cache->renderingCapacity * 2 : 4;
+        size_t *rendering = realloc(cache->rendering, capacity * sizeof(size_t));
+        if (rendering == NULL) {
+            return false;
+        }
+        cache->rendering = rendering;
+        cache->renderingCapacity = capacity;
+    }
+    cache->rendering[cache->renderingCount++] = page;
+    return true;
+}
+
+static void YLPageBitmapCacheUnmarkRendering(YLPageBitmapCache *cache, size_t page){
+    for (size_t i = 0; i < cache->renderingCount; i++) {
+        if (cache->rendering[i] == page) {
+            cache->rendering[i] = cache->rendering[--cache->renderingCount];
+            return;
+        }
+    }
+}
+
+/// 存入渲染结果，预算不足时淘汰比它次要的位图；仍放不下时返回 false
+static bool YLPageBitmapCacheStore(YLPageBitmapCache *cache, size_t page, YLPageBitmap bitmap){
+    size_t rank = YLPageBitmapCacheRank(cache, page);
+    while (cache->byteCount + bitmap.byteCount > cache->byteBudget) {
+        if (!YLPageBitmapCacheEvictOne(cache, rank)) {
+            return false;
+        }
+    }
+    if (cache->entryCount == cache->entryCapacity) {
+        size_t capacity = cache->entryCapacity ? cache->entryCapacity * 2 : 8;
+        YLPageBitmapEntry *entries = realloc(cache->entries, capacity * sizeof(YLPageBitmapEntry));
+        if (entries == NULL) {
+            return false;
+        }
+        cache->entries = entries;
+        cache->entryCapacity = capacity;
+    }
+    cache->entries[cache->entryCount++] = (YLPageBitmapEntry){page, bitmap};
+    cache->byteCount += bitmap.byteCount;
+    return true;
+}
+
+size_t YLPageBitmapCacheRenderPending(YLPageBitmapCache *cache, size_t maxCount){
+    size_t rendered = 0;
+    while (rendered < maxCount) {
+        pthread_mutex_lock(&cache->mutex);
+        size_t page;
+        if (!YLPageBitmapCacheNextPage(cache, &page) || !YLPageBitmapCacheMarkRendering(cache, page)) {
+            pthread_mutex_unlock(&cache->mutex);
+            break;
+        }
+        size_t generation = cache->generation;
+        pthread_mutex_unlock(&cache->mutex);
+
+        //渲染时不持有锁，翻页与取位图不会被阻塞
+        YLPageBitmap bitmap = {NULL, 0};
+        bool success = cache->rasterizer.render(cache->rasterizer.context, page, &bitmap);
+
+        pthread_mutex_lock(&cache->mutex);
+        YLPageBitmapCacheUnmarkRendering(cache, page);
+        bool stored = false;
+        if (success && generation == cache->generation && page < cache->pageCount) {
+            stored = YLPageBitmapCacheStore(cache, page, bitmap);
+        }
+        pthread_mutex_unlock(&cache->mutex);
+        //渲染失败、预算不足或期间内容已变化时停止，之后的翻页会重新开始渲染
+        if (!stored) {
+            if (success) {
+                cache->rasterizer.release(cache->rasterizer.context, bitmap);
+            }
+            break;
+        }
+        rendered++;
+    }
+    return rendered;
+}
+
+size_t YLPageBitmapCacheCount(YLPageBitmapCache *cache){
+    pthread_mutex_lock(&cache->mutex);
+    size_t count = cache->entryCount;
+    pthread_mutex_unlock(&cache->mutex);
+    return count;
+}
+
+size_t YLPageBitmapCacheByteCount(YLPageBitmapCache *cache){
+    pthread_mutex_lock(&cache->mutex);
+    size_t byteCount = cache->byteCount;
+    pthread_mutex_unlock(&cache->mutex);
+    return byteCount;
+}
@@ -0,0 +1,78 @@
+//
+//  YLPageBitmapCache.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  翻页时预先渲染的页面位图缓存：每次翻页后，在后台按优先级渲染当前页、阅读方向上的后 N 页与反方向的前 (N + 1) / 2 页。
+//  缓存有字节预算，超出时先淘汰离当前页最远的位图，阅读方向反方向的页按两倍距离计算。
+//  渲染通过 YLPageRasterizer 回调完成，位图对缓存而言是不透明的句柄，可以用桩实现测试缓存与预取策略。
+//  所有函数都是线程安全的。
+//
+
+#ifndef YLPageBitmapCache_h
+#define YLPageBitmapCache_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct YLPageBitmap {
+    void *image;      //渲染结果的句柄，如 CGImageRef
+    size_t byteCount; //占用的内存，计入字节预算
+} YLPageBitmap;
+
+typedef struct YLPageRasterizer {
+    void *context;
+    /// 渲染第 page 页，在调用 YLPageBitmapCacheRenderPending 的线程上执行；bitmap 的所有权交给缓存
+    bool (*render)(void *context, size_t page, YLPageBitmap *bitmap);
+    void (*retain)(void *context, YLPageBitmap bitmap);
+    void (*release)(void *context, YLPageBitmap bitmap);
+} YLPageRasterizer;
+
+typedef struct YLPageBitmapCache YLPageBitmapCache;
+
+/** @param byteBudget 位图占用内存的上限
+ * @param prefetchCount 阅读方向上预先渲染的页数 N
+ */
+YLPageBitmapCache *YLPageBitmapCacheCreate(YLPageRasterizer rasterizer, size_t byteBudget, size_t prefetchCount);
+void YLPageBitmapCacheDestroy(YLPageBitmapCache *cache);
+
+/// 设置总页数，超出的位图被丢弃
+void YLPageBitmapCacheSetPageCount(YLPageBitmapCache *cache, size_t pageCount);
+
+/// 翻到第 page 页，阅读方向由上一次的页码推断
+void YLPageBitmapCacheSetCurrentPage(YLPageBitmapCache *cache, size_t page);
+
+/// 阅读方向：1 为向后，-1 为向前
+int YLPageBitmapCacheDirection(YLPageBitmapCache *cache);
+
+/// 页面内容变化后丢弃所有位图，正在渲染的结果也会被丢弃
+void YLPageBitmapCacheRemoveAll(YLPageBitmapCache *cache);
+
+/** 取出第 page 页的位图
+ * @param bitmap 已 retain，用完后调用 YLPageBitmapCacheReleaseBitmap
+ * @return 尚未渲染时返回 false
+ */
+bool YLPageBitmapCacheCopyBitmap(YLPageBitmapCache *cache, size_t page, YLPageBitmap *bitmap);
+void YLPageBitmapCacheReleaseBitmap(YLPageBitmapCache *cache, YLPageBitmap bitmap);
+
+/** 按优先级渲染当前窗口中缺少的页，应在后台线程调用
+ * 翻页或 RemoveAll 后，新的窗口从下一次渲染开始生效；预算已被更重要的页占满时停止
+ * @param maxCount 最多渲染的页数
+ * @return 渲染的页数
+ */
+size_t YLPageBitmapCacheRenderPending(YLPageBitmapCache *cache, size_t maxCount);
+
+/// 已缓存的位图数量与占用的内存
+size_t YLPageBitmapCacheCount(YLPageBitmapCache *cache);
+size_t YLPageBitmapCacheByteCount(YLPageBitmapCache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLPageBitmapCache_h */
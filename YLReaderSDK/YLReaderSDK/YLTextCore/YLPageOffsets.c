@@ -0,0 +1,98 @@
+//
+//  YLPageOffsets.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLPageOffsets.h"
+#include <stdlib.h>
+#include <string.h>
+
+void YLPageOffsetsInit(YLPageOffsets *table){
+    memset(table, 0, sizeof(YLPageOffsets));
+}
+
+void YLPageOffsetsDestroy(YLPageOffsets *table){
+    free(table->offsets);
+    YLPageOffsetsInit(table);
+}
+
+void YLPageOffsetsRemoveAll(YLPageOffsets *table){
+    table->count = 0;
+    if (table->offsets) {
+        table->offsets[0] = 0;
+    }
+}
+
+bool YLPageOffsetsAppend(YLPageOffsets *table, double height){
+    //offsets 比页数多一项
+    if (table->count + 1 >= table->capacity) {
+        size_t capacity = table->capacity ? table->capacity * 2 : 64;
+        double *offsets = realloc(table->offsets, capacity * sizeof(double));
+        if (offsets == NULL) {
+            return false;
+        }
+        if (table->offsets == NULL) {
+            offsets[0] = 0;
+        }
+        table->offsets = offsets;
+        table->capacity = capacity;
+    }
+    double origin = table->offsets[table->count];
+    table->offsets[++table->count] = origin + (height > 0 ? height : 0);
+    return true;
+}
+
+double YLPageOffsetsOrigin(const YLPageOffsets *table, size_t index){
+    return index < table->count ? table->offsets[index] : YLPageOffsetsTotal(table);
+}
+
+double YLPageOffsetsHeight(const YLPageOffsets *table, size_t index){
+    return index < table->count ? table->offsets[index + 1] - table->offsets[index] : 0;
+}
+
+double YLPageOffsetsTotal(const YLPageOffsets *table){
+    return table->count ? table->offsets[table->count] : 0;
+}
+
+/// 第一个终点大于 offset 的页，没有时返回 count
+static size_t YLPageOffsetsFirstEndAfter(const YLPageOffsets *table, double offset){
+    size_t low = 0, high = table->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (table->offsets[mid + 1] <= offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+size_t YLPageOffsetsPageAt(const YLPageOffsets *table, double offset){
+    if (table->count == 0) {
+        return YLPageOffsetsNotFound;
+    }
+    size_t page = YLPageOffsetsFirstEndAfter(table, offset);
+    return page < table->count ? page : table->count - 1;
+}
+
+size_t YLPageOffsetsVisibleRange(const YLPageOffsets *table, double minOffset, double maxOffset, size_t *first){
+    size_t start = YLPageOffsetsFirstEndAfter(table, minOffset);
+    *first = start;
+    if (maxOffset <= minOffset) {
+        return 0;
+    }
+    //第一个起点不小于 maxOffset 的页
+    size_t low = start, high = table->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (table->offsets[mid] < maxOffset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low - start;
+}
@@ -0,0 +1,61 @@
+//
+//  YLPageOffsets.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  滚动阅读时各页的纵向位置：按页高建立前缀和，offsets[i] 为第 i 页的起点，offsets[count] 为内容总高度。
+//  滚动时按偏移量二分查找可见的页，不再逐页询问高度。
+//
+
+#ifndef YLPageOffsets_h
+#define YLPageOffsets_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 查找失败时返回的索引
+#define YLPageOffsetsNotFound ((size_t)-1)
+
+typedef struct YLPageOffsets {
+    double *offsets; //count + 1 项，非递减
+    size_t count;
+    size_t capacity;
+} YLPageOffsets;
+
+void YLPageOffsetsInit(YLPageOffsets *table);
+void YLPageOffsetsDestroy(YLPageOffsets *table);
+
+/// 移除所有页，保留已分配的内存
+void YLPageOffsetsRemoveAll(YLPageOffsets *table);
+
+/// 末尾追加一页，负数高度按 0 处理
+bool YLPageOffsetsAppend(YLPageOffsets *table, double height);
+
+/// 第 index 页的起点与高度
+double YLPageOffsetsOrigin(const YLPageOffsets *table, size_t index);
+double YLPageOffsetsHeight(const YLPageOffsets *table, size_t index);
+
+/// 内容总高度
+double YLPageOffsetsTotal(const YLPageOffsets *table);
+
+/** offset 所在的页：最后一个起点不大于 offset 的非空页
+ * offset 小于 0 时返回第一页，不小于总高度时返回最后一页；没有页时返回 YLPageOffsetsNotFound
+ */
+size_t YLPageOffsetsPageAt(const YLPageOffsets *table, double offset);
+
+/** 与区间 [minOffset, maxOffset) 相交的页
+ * @param first 输出第一页的索引
+ * @return 相交的页数，页的索引连续
+ */
+size_t YLPageOffsetsVisibleRange(const YLPageOffsets *table, double minOffset, double maxOffset, size_t *first);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLPageOffsets_h */
@@ -0,0 +1,286 @@
+//
+//  YLTextAdvanceCache.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextAdvanceCache.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YLTextAdvanceSSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define YLTextAdvanceNEON 1
+#endif
+
+/// 使用统一宽度的区块
+typedef struct YLTextAdvanceBlock {
+    uint16_t first;
+    uint16_t last;
+} YLTextAdvanceBlock;
+
+static const YLTextAdvanceBlock kYLTextAdvanceBlocks[] = {
+    {0x3000, 0x30FF}, //CJK 标点、假名
+    {0x3400, 0x4DBF}, //CJK 扩展 A
+    {0x4E00, 0x9FFF}, //CJK 统一汉字
+    {0xAC00, 0xD7A3}, //谚文音节
+    {0xFF01, 0xFF5E}, //全角 ASCII
+};
+
+#define YLTextAdvanceBlockCount (sizeof(kYLTextAdvanceBlocks) / sizeof(kYLTextAdvanceBlocks[0]))
+/// CJK 统一汉字在 kYLTextAdvanceBlocks 中的位置，测量时优先判断
+#define YLTextAdvanceUnifiedBlock 2
+
+struct YLTextAdvanceTable {
+    double ascii[128];
+    /// 区块中出现最多的宽度
+    double blockAdvances[YLTextAdvanceBlockCount];
+    /// 每个区块一个位图，宽度与统一宽度不同的字符对应的位为 1
+    const uint64_t *exceptions[YLTextAdvanceBlockCount];
+    uint64_t *bits;
+};
+
+static inline size_t blockLength(size_t block){
+    return (size_t)kYLTextAdvanceBlocks[block].last - kYLTextAdvanceBlocks[block].first + 1;
+}
+
+/// c 所在的区块，不在任何区块中时返回 -1
+static inline int blockIndex(uint16_t c){
+    if (c >= 0x4E00 && c <= 0x9FFF) {
+        return YLTextAdvanceUnifiedBlock;
+    }
+    if (c < 0x3000) {
+        return -1;
+    }
+    for (size_t i = 0; i < YLTextAdvanceBlockCount; i++) {
+        if (c >= kYLTextAdvanceBlocks[i].first && c <= kYLTextAdvanceBlocks[i].last) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static inline bool isException(const uint64_t *bits, size_t offset){
+    return (bits[offset >> 6] >> (offset & 63)) & 1;
+}
+
+/// 宽度表中 c 的宽度，不在表中时返回 false
+static inline bool lookupAdvance(const YLTextAdvanceTable *table, uint16_t c, double *advance){
+    if (c < 0x80) {
+        *advance = table->ascii[c];
+        return true;
+    }
+    int block = blockIndex(c);
+    if (block < 0 || isException(table->exceptions[block], c - kYLTextAdvanceBlocks[block].first)) {
+        return false;
+    }
+    *advance = table->blockAdvances[block];
+    return true;
+}
+
+// MARK: - 建立
+
+YLTextAdvanceTable *YLTextAdvanceTableCreate(YLTextMeasureFunction measure, void *context, YLTextStyleID style){
+    size_t wordCount = 0, maxLength = 128;
+    for (size_t block = 0; block < YLTextAdvanceBlockCount; block++) {
+        wordCount += (blockLength(block) + 63) / 64;
+        maxLength = blockLength(block) > maxLength ? blockLength(block) : maxLength;
+    }
+    YLTextAdvanceTable *table = calloc(1, sizeof(YLTextAdvanceTable));
+    uint64_t *bits = calloc(wordCount, sizeof(uint64_t));
+    uint16_t *chars = malloc(maxLength * sizeof(uint16_t));
+    double *advances = malloc(maxLength * sizeof(double));
+    if (table == NULL || bits == NULL || chars == NULL || advances == NULL) {
+        free(table);
+        free(bits);
+        free(chars);
+        free(advances);
+        return NULL;
+    }
+    table->bits = bits;
+
+    for (uint16_t c = 0; c < 128; c++) {
+        chars[c] = c;
+    }
+    measure(context, style, chars, 128, table->ascii);
+
+    for (size_t block = 0; block < YLTextAdvanceBlockCount; block++) {
+        size_t length = blockLength(block);
+        for (size_t i = 0; i < length; i++) {
+            chars[i] = (uint16_t)(kYLTextAdvanceBlocks[block].first + i);
+        }
+        measure(context, style, chars, length, advances);
+        //多数投票选出统一宽度，其余字符记为例外
+        double candidate = advances[0];
+        size_t votes = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (votes == 0) {
+                candidate = advances[i];
+            }
+            if (advances[i] == candidate) {
+                votes++;
+            } else {
+                votes--;
+            }
+        }
+        table->blockAdvances[block] = candidate;
+        table->exceptions[block] = bits;
+        for (size_t i = 0; i < length; i++) {
+            if (advances[i] != candidate) {
+                bits[i >> 6] |= (uint64_t)1 << (i & 63);
+            }
+        }
+        bits += (length + 63) / 64;
+    }
+    free(chars);
+    free(advances);
+    return table;
+}
+
+void YLTextAdvanceTableDestroy(YLTextAdvanceTable *table){
+    if (table) {
+        free(table->bits);
+        free(table);
+    }
+}
+
+// MARK: - 测量
+
+/// 8 个码元都是 ASCII，或都是没有例外的统一汉字时整组写入，返回 true
+static inline bool measureGroup(const YLTextAdvanceTable *table, const uint16_t *chars, double *advances){
+#if YLTextAdvanceSSE2
+    __m128i units = _mm_loadu_si128((const __m128i *)chars);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short)0xFF80)), _mm_setzero_si128())) == 0xFFFF) {
+        for (size_t i = 0; i < 8; i++) {
+            advances[i] = table->ascii[chars[i]];
+        }
+        return true;
+    }
+    //无符号比较 c - 0x4E00 < 0x5200：两侧同时翻转符号位后按有符号比较
+    __m128i offsets = _mm_xor_si128(_mm_sub_epi16(units, _mm_set1_epi16(0x4E00)), _mm_set1_epi16((short)0x8000));
+    if (_mm_movemask_epi8(_mm_cmplt_epi16(offsets, _mm_set1_epi16((short)(0x5200 ^ 0x8000)))) != 0xFFFF) {
+        return false;
+    }
+#elif YLTextAdvanceNEON
+    uint16x8_t units = vld1q_u16(chars);
+    if (vmaxvq_u16(units) < 0x80) {
+        for (size_t i = 0; i < 8; i++) {
+            advances[i] = table->ascii[chars[i]];
+        }
+        return true;
+    }
+    if (vmaxvq_u16(vsubq_u16(units, vdupq_n_u16(0x4E00))) >= 0x5200) {
+        return false;
+    }
+#else
+    for (size_t i = 0; i < 8; i++) {
+        if (chars[i] < 0x4E00 || chars[i] > 0x9FFF) {
+            return false;
+        }
+    }
+#endif
+    const uint64_t *exceptions = table->exceptions[YLTextAdvanceUnifiedBlock];
+    for (size_t i = 0; i < 8; i++) {
+        if (isException(exceptions, chars[i] - 0x4E00u)) {
+            return false;
+        }
+    }
+    double advance = table->blockAdvances[YLTextAdvanceUnifiedBlock];
+#if YLTextAdvanceSSE2
+    __m128d value = _mm_set1_pd(advance);
+    for (size_t i = 0; i < 8; i += 2) {
+        _mm_storeu_pd(advances + i, value);
+    }
+#elif YLTextAdvanceNEON
+    float64x2_t value = vdupq_n_f64(advance);
+    for (size_t i = 0; i < 8; i += 2) {
+        vst1q_f64(advances + i, value);
+    }
+#else
+    for (size_t i = 0; i < 8; i++) {
+        advances[i] = advance;
+    }
+#endif
+    return true;
+}
+
+size_t YLTextAdvanceTableMeasurePrefix(const YLTextAdvanceTable *table, const uint16_t *chars, size_t length, double *advances){
+    size_t i = 0;
+    while (i < length) {
+        if (i + 8 <= length && measureGroup(table, chars + i, advances + i)) {
+            i += 8;
+            continue;
+        }
+        //混合的一组逐个查表
+        size_t end = i + 8 < length ? i + 8 : length;
+        for (; i < end; i++) {
+            if (!lookupAdvance(table, chars[i], &advances[i])) {
+                return i;
+            }
+        }
+    }
+    return i;
+}
+
+void YLTextAdvanceTableMeasure(const YLTextAdvanceTable *table, const uint16_t *chars, size_t length, double *advances,
+                               YLTextMeasureFunction measure, void *context, YLTextStyleID style){
+    size_t i = 0;
+    while (i < length) {
+        i += YLTextAdvanceTableMeasurePrefix(table, chars + i, length - i, advances + i);
+        if (i == length) {
+            break;
+        }
+        //表中没有的码元连同之后同样没有的码元一起测量，代理对不会被拆开
+        size_t end = i + 1;
+        double advance;
+        while (end < length && !lookupAdvance(table, chars[end], &advance)) {
+            end++;
+        }
+        measure(context, style, chars + i, end - i, advances + i);
+        i = end;
+    }
+}
+
+// MARK: - 共享缓存
+
+typedef struct YLTextAdvanceCacheEntry {
+    struct YLTextAdvanceCacheEntry *next;
+    char *fontKey;
+    YLTextAdvanceTable *table;
+} YLTextAdvanceCacheEntry;
+
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+static YLTextAdvanceCacheEntry *cacheEntries;
+
+const YLTextAdvanceTable *YLTextAdvanceCacheGet(const char *fontKey, YLTextMeasureFunction measure, void *context, YLTextStyleID style){
+    pthread_mutex_lock(&cacheLock);
+    for (YLTextAdvanceCacheEntry *entry = cacheEntries; entry; entry = entry->next) {
+        if (strcmp(entry->fontKey, fontKey) == 0) {
+            pthread_mutex_unlock(&cacheLock);
+            return entry->table;
+        }
+    }
+    //建立期间持有锁，同一字体不会重复建立
+    size_t keyLength = strlen(fontKey) + 1;
+    YLTextAdvanceCacheEntry *entry = malloc(sizeof(YLTextAdvanceCacheEntry));
+    char *key = malloc(keyLength);
+    YLTextAdvanceTable *table = entry && key ? YLTextAdvanceTableCreate(measure, context, style) : NULL;
+    if (table == NULL) {
+        free(entry);
+        free(key);
+        pthread_mutex_unlock(&cacheLock);
+        return NULL;
+    }
+    memcpy(key, fontKey, keyLength);
+    entry->fontKey = key;
+    entry->table = table;
+    entry->next = cacheEntries;
+    cacheEntries = entry;
+    pthread_mutex_unlock(&cacheLock);
+    return table;
+}
@@ -0,0 +1,55 @@
+//
+//  YLTextAdvanceCache.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  按字体缓存字符宽度，测量时不必每次调用字体接口。
+//  ASCII 按码位直接索引；汉字、假名、谚文等区块里几乎所有字符宽度相同，只记录区块的统一宽度，
+//  以及宽度与之不同的字符（位图）。宽度表由原始的测量方法逐个测量建立，表中的值与原始方法完全一致；
+//  不在表中的字符（其它文字、代理对、统一宽度的例外）仍交给原始方法测量。
+//
+
+#ifndef YLTextAdvanceCache_h
+#define YLTextAdvanceCache_h
+
+#include "YLTextMetrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 原始的测量方法，与 YLTextMetrics.measure 相同
+typedef void (*YLTextMeasureFunction)(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances);
+
+/// 一种字体的宽度表，建立后只读，可在多个线程同时使用
+typedef struct YLTextAdvanceTable YLTextAdvanceTable;
+
+/** 用 measure 测量 ASCII 与各区块的全部字符，建立宽度表
+ * @return 内存不足时返回 NULL
+ */
+YLTextAdvanceTable *YLTextAdvanceTableCreate(YLTextMeasureFunction measure, void *context, YLTextStyleID style);
+void YLTextAdvanceTableDestroy(YLTextAdvanceTable *table);
+
+/** 测量开头连续的、宽度表中有的码元
+ * @return 测量的码元数；chars[返回值] 需要用原始方法测量
+ */
+size_t YLTextAdvanceTableMeasurePrefix(const YLTextAdvanceTable *table, const uint16_t *chars, size_t length, double *advances);
+
+/** 测量一批码元：表中有的直接取值，其余连续的码元一起交给 measure
+ * 结果与直接调用 measure 测量整批码元相同
+ */
+void YLTextAdvanceTableMeasure(const YLTextAdvanceTable *table, const uint16_t *chars, size_t length, double *advances,
+                               YLTextMeasureFunction measure, void *context, YLTextStyleID style);
+
+/** 按字体描述（如 PostScript 名称与字号）取得进程内共享的宽度表，第一次取得时用 measure 建立
+ * 线程安全；宽度表一直保留到进程结束
+ * @return 内存不足时返回 NULL
+ */
+const YLTextAdvanceTable *YLTextAdvanceCacheGet(const char *fontKey, YLTextMeasureFunction measure, void *context, YLTextStyleID style);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextAdvanceCache_h */
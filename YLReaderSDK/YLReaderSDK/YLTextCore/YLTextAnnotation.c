@@ -0,0 +1,533 @@
+//
+//  YLTextAnnotation.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextAnnotation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define YLTextAnnotationMagic "YLAN"
+#define YLTextAnnotationVersion 1
+#define YLTextAnnotationNil UINT32_MAX
+/// AVL 树的高度不超过 1.44 * log2(n)，节点数不超过 UINT32_MAX 时远小于此值
+#define YLTextAnnotationMaxHeight 64
+
+/// 节点保存在连续的数组中，以序号互相引用；删除的节点串成空闲链表（left 指向下一个）
+typedef struct YLTextAnnotationNode {
+    uint64_t identifier;
+    size_t location;
+    size_t end;
+    size_t maxEnd; //子树中最大的 end
+    char *note;
+    uint32_t style;
+    uint32_t left;
+    uint32_t right;
+    int32_t height;
+} YLTextAnnotationNode;
+
+struct YLTextAnnotationStore {
+    YLTextAnnotationNode *nodes;
+    size_t capacity;
+    size_t used;
+    uint32_t freeList;
+    uint32_t root;
+    size_t count;
+    uint64_t nextIdentifier;
+};
+
+/** 文件头，之后是 length 字节的标注，按 (location, identifier) 升序；按本机字节序存储
+ * 每条标注依次为变长整数：与上一条的位置差、length、identifier、style、笔记字节数，之后是笔记
+ */
+typedef struct YLTextAnnotationHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t nextIdentifier;
+    uint64_t length;
+} YLTextAnnotationHeader;
+
+YLTextAnnotationStore *YLTextAnnotationStoreCreate(void){
+    YLTextAnnotationStore *store = calloc(1, sizeof(YLTextAnnotationStore));
+    if (store) {
+        store->freeList = YLTextAnnotationNil;
+        store->root = YLTextAnnotationNil;
+        store->nextIdentifier = 1;
+    }
+    return store;
+}
+
+void YLTextAnnotationStoreDestroy(YLTextAnnotationStore *store){
+    if (store == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < store->used; i++) {
+        free(store->nodes[i].note);
+    }
+    free(store->nodes);
+    free(store);
+}
+
+size_t YLTextAnnotationStoreCount(const YLTextAnnotationStore *store){
+    return store->count;
+}
+
+// MARK: - AVL 树
+
+static inline int32_t nodeHeight(const YLTextAnnotationStore *store, uint32_t index){
+    return index == YLTextAnnotationNil ? 0 : store->nodes[index].height;
+}
+
+static inline size_t nodeMaxEnd(const YLTextAnnotationStore *store, uint32_t index){
+    return index == YLTextAnnotationNil ? 0 : store->nodes[index].maxEnd;
+}
+
+/// 按子节点重新计算高度与 maxEnd
+static void updateNode(YLTextAnnotationStore *store, uint32_t index){
+    YLTextAnnotationNode *node = &store->nodes[index];
+    int32_t left = nodeHeight(store, node->left), right = nodeHeight(store, node->right);
+    node->height = (left > right ? left : right) + 1;
+    size_t maxEnd = node->end;
+    size_t childEnd = nodeMaxEnd(store, node->left);
+    maxEnd = childEnd > maxEnd ? childEnd : maxEnd;
+    childEnd = nodeMaxEnd(store, node->right);
+    node->maxEnd = childEnd > maxEnd ? childEnd : maxEnd;
+}
+
+static uint32_t rotateRight(YLTextAnnotationStore *store, uint32_t index){
+    uint32_t left = store->nodes[index].left;
+    store->nodes[index].left = store->nodes[left].right;
+    store->nodes[left].right = index;
+    updateNode(store, index);
+    updateNode(store, left);
+    return left;
+}
+
+static uint32_t rotateLeft(YLTextAnnotationStore *store, uint32_t index){
+    uint32_t right = store->nodes[index].right;
+    store->nodes[index].right = store->nodes[right].left;
+    store->nodes[right].left = index;
+    updateNode(store, index);
+    updateNode(store, right);
+    return right;
+}
+
+/// 子树变化后更新节点，左右高度差超过 1 时旋转，返回新的子树根
+static uint32_t rebalance(YLTextAnnotationStore *store, uint32_t index){
+    updateNode(store, index);
+    YLTextAnnotationNode *node = &store->nodes[index];
+    int32_t balance = nodeHeight(store, node->left) - nodeHeight(store, node->right);
+    if (balance > 1) {
+        uint32_t left = node->left;
+        if (nodeHeight(store, store->nodes[left].left) < nodeHeight(store, store->nodes[left].right)) {
+            node->left = rotateLeft(store, left);
+        }
+        return rotateRight(store, index);
+    }
+    if (balance < -1) {
+        uint32_t right = node->right;
+        if (nodeHeight(store, store->nodes[right].right) < nodeHeight(store, store->nodes[right].left)) {
+            node->right = rotateRight(store, right);
+        }
+        return rotateLeft(store, index);
+    }
+    return index;
+}
+
+/// 按 (location, identifier) 比较
+static inline int compareKey(size_t location, uint64_t identifier, const YLTextAnnotationNode *node){
+    if (location != node->location) {
+        return location < node->location ? -1 : 1;
+    }
+    if (identifier != node->identifier) {
+        return identifier < node->identifier ? -1 : 1;
+    }
+    return 0;
+}
+
+static uint32_t insertNode(YLTextAnnotationStore *store, uint32_t root, uint32_t index){
+    if (root == YLTextAnnotationNil) {
+        return index;
+    }
+    YLTextAnnotationNode *node = &store->nodes[index];
+    if (compareKey(node->location, node->identifier, &store->nodes[root]) < 0) {
+        store->nodes[root].left = insertNode(store, store->nodes[root].left, index);
+    } else {
+        store->nodes[root].right = insertNode(store, store->nodes[root].right, index);
+    }
+    return rebalance(store, root);
+}
+
+/// 从子树中摘下最小的节点
+static uint32_t removeMinNode(YLTextAnnotationStore *store, uint32_t root, uint32_t *minimum){
+    if (store->nodes[root].left == YLTextAnnotationNil) {
+        *minimum = root;
+        return store->nodes[root].right;
+    }
+    store->nodes[root].left = removeMinNode(store, store->nodes[root].left, minimum);
+    return rebalance(store, root);
+}
+
+/// 从子树中摘下 (location, identifier) 对应的节点，没有时 removed 不变
+static uint32_t removeNode(YLTextAnnotationStore *store, uint32_t root, size_t location, uint64_t identifier, uint32_t *removed){
+    if (root == YLTextAnnotationNil) {
+        return YLTextAnnotationNil;
+    }
+    int order = compareKey(location, identifier, &store->nodes[root]);
+    if (order < 0) {
+        store->nodes[root].left = removeNode(store, store->nodes[root].left, location, identifier, removed);
+    } else if (order > 0) {
+        store->nodes[root].right = removeNode(store, store->nodes[root].right, location, identifier, removed);
+    } else {
+        *removed = root;
+        uint32_t left = store->nodes[root].left, right = store->nodes[root].right;
+        if (right == YLTextAnnotationNil) {
+            return left;
+        }
+        uint32_t successor;
+        right = removeMinNode(store, right, &successor);
+        store->nodes[successor].left = left;
+        store->nodes[successor].right = right;
+        return rebalance(store, successor);
+    }
+    return rebalance(store, root);
+}
+
+static YLTextAnnotationNode *findNode(const YLTextAnnotationStore *store, size_t location, uint64_t identifier){
+    uint32_t index = store->root;
+    while (index != YLTextAnnotationNil) {
+        YLTextAnnotationNode *node = &store->nodes[index];
+        int order = compareKey(location, identifier, node);
+        if (order == 0) {
+            return node;
+        }
+        index = order < 0 ? node->left : node->right;
+    }
+    return NULL;
+}
+
+/// 取一个空闲节点，数组满时扩容；节点的内容由调用方设置
+static uint32_t allocateNode(YLTextAnnotationStore *store){
+    if (store->freeList != YLTextAnnotationNil) {
+        uint32_t index = store->freeList;
+        store->freeList = store->nodes[index].left;
+        return index;
+    }
+    if (store->used == store->capacity) {
+        size_t capacity = store->capacity ? store->capacity * 2 : 64;
+        if (capacity >= YLTextAnnotationNil) {
+            capacity = YLTextAnnotationNil - 1;
+        }
+        if (capacity <= store->used) {
+            return YLTextAnnotationNil;
+        }
+        YLTextAnnotationNode *nodes = realloc(store->nodes, capacity * sizeof(YLTextAnnotationNode));
+        if (nodes == NULL) {
+            return YLTextAnnotationNil;
+        }
+        store->nodes = nodes;
+        store->capacity = capacity;
+    }
+    store->nodes[store->used].note = NULL;
+    return (uint32_t)store->used++;
+}
+
+static void freeNode(YLTextAnnotationStore *store, uint32_t index){
+    free(store->nodes[index].note);
+    store->nodes[index].note = NULL;
+    store->nodes[index].left = store->freeList;
+    store->freeList = index;
+}
+
+/// 复制笔记，空字符串按没有笔记处理
+static bool copyNote(const char *note, char **copy){
+    *copy = NULL;
+    if (note == NULL || note[0] == '\0') {
+        return true;
+    }
+    size_t length = strlen(note) + 1;
+    *copy = malloc(length);
+    if (*copy == NULL) {
+        return false;
+    }
+    memcpy(*copy, note, length);
+    return true;
+}
+
+// MARK: - 增删改查
+
+uint64_t YLTextAnnotationStoreAdd(YLTextAnnotationStore *store, size_t location, size_t length, uint32_t style, const char *note){
+    if (length == 0 || location + length < location) {
+        return 0;
+    }
+    char *copy;
+    if (!copyNote(note, &copy)) {
+        return 0;
+    }
+    uint32_t index = allocateNode(store);
+    if (index == YLTextAnnotationNil) {
+        free(copy);
+        return 0;
+    }
+    YLTextAnnotationNode *node = &store->nodes[index];
+    node->identifier = store->nextIdentifier++;
+    node->location = location;
+    node->end = node->maxEnd = location + length;
+    node->note = copy;
+    node->style = style;
+    node->left = node->right = YLTextAnnotationNil;
+    node->height = 1;
+    store->root = insertNode(store, store->root, index);
+    store->count++;
+    return node->identifier;
+}
+
+bool YLTextAnnotationStoreRemove(YLTextAnnotationStore *store, size_t location, uint64_t identifier){
+    if (findNode(store, location, identifier) == NULL) {
+        return false;
+    }
+    uint32_t removed = YLTextAnnotationNil;
+    store->root = removeNode(store, store->root, location, identifier, &removed);
+    freeNode(store, removed);
+    store->count--;
+    return true;
+}
+
+bool YLTextAnnotationStoreUpdate(YLTextAnnotationStore *store, size_t location, uint64_t identifier, uint32_t style, const char *note){
+    YLTextAnnotationNode *node = findNode(store, location, identifier);
+    char *copy;
+    if (node == NULL || !copyNote(note, &copy)) {
+        return false;
+    }
+    free(node->note);
+    node->note = copy;
+    node->style = style;
+    return true;
+}
+
+typedef struct YLTextAnnotationQuery {
+    size_t start;
+    size_t end;
+    YLTextAnnotation *results;
+    size_t maxResults;
+    size_t count;
+} YLTextAnnotationQuery;
+
+/** 中序遍历子树，输出与查询相交的标注
+ * 子树的 maxEnd 不超过查询的起点时整棵跳过；节点的起点不小于查询的终点时，其右子树也不必遍历
+ */
+static void collectNodes(const YLTextAnnotationStore *store, uint32_t index, YLTextAnnotationQuery *query){
+    while (index != YLTextAnnotationNil) {
+        const YLTextAnnotationNode *node = &store->nodes[index];
+        if (node->maxEnd <= query->start) {
+            return;
+        }
+        collectNodes(store, node->left, query);
+        if (node->location >= query->end) {
+            return;
+        }
+        if (node->end > query->start) {
+            if (query->count < query->maxResults) {
+                query->results[query->count] = (YLTextAnnotation){node->identifier, node->location, node->end - node->location, node->style, node->note};
+            }
+            query->count++;
+        }
+        index = node->right;
+    }
+}
+
+size_t YLTextAnnotationStoreFind(const YLTextAnnotationStore *store, size_t location, size_t length, YLTextAnnotation *results, size_t maxResults){
+    if (length == 0) {
+        return 0;
+    }
+    YLTextAnnotationQuery query = {location, location + length < location ? SIZE_MAX : location + length, results, results ? maxResults : 0, 0};
+    collectNodes(store, store->root, &query);
+    return query.count;
+}
+
+// MARK: - 读写
+
+static size_t writeVarint(uint8_t *bytes, uint64_t value){
+    size_t count = 0;
+    while (value >= 0x80) {
+        bytes[count++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (uint8_t)value;
+    return count;
+}
+
+static bool readVarint(const uint8_t *bytes, size_t length, size_t *offset, uint64_t *value){
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64 && *offset < length; shift += 7) {
+        uint8_t byte = bytes[(*offset)++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// 按中序（即位置顺序）编码全部标注，bytes 为 NULL 时只计算长度
+static size_t encodeNodes(const YLTextAnnotationStore *store, uint8_t *bytes){
+    uint8_t scratch[10];
+    size_t offset = 0;
+    size_t previous = 0;
+    uint32_t stack[YLTextAnnotationMaxHeight];
+    size_t depth = 0;
+    uint32_t index = store->root;
+    while (index != YLTextAnnotationNil || depth > 0) {
+        while (index != YLTextAnnotationNil) {
+            stack[depth++] = index;
+            index = store->nodes[index].left;
+        }
+        const YLTextAnnotationNode *node = &store->nodes[stack[--depth]];
+        size_t noteLength = node->note ? strlen(node->note) : 0;
+        uint64_t fields[] = {node->location - previous, node->end - node->location, node->identifier, node->style, noteLength};
+        for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+            offset += writeVarint(bytes ? bytes + offset : scratch, fields[i]);
+        }
+        if (bytes && noteLength) {
+            memcpy(bytes + offset, node->note, noteLength);
+        }
+        offset += noteLength;
+        previous = node->location;
+        index = node->right;
+    }
+    return offset;
+}
+
+bool YLTextAnnotationStoreWrite(const YLTextAnnotationStore *store, const char *path){
+    size_t length = encodeNodes(store, NULL);
+    uint8_t *bytes = malloc(length ? length : 1);
+    size_t pathLength = strlen(path);
+    char *temporaryPath = malloc(pathLength + 5);
+    if (bytes == NULL || temporaryPath == NULL) {
+        free(bytes);
+        free(temporaryPath);
+        return false;
+    }
+    encodeNodes(store, bytes);
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE *file = fopen(temporaryPath, "wb");
+    bool success = file != NULL;
+    if (file) {
+        YLTextAnnotationHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, YLTextAnnotationMagic, 4);
+        header.version = YLTextAnnotationVersion;
+        header.count = store->count;
+        header.nextIdentifier = store->nextIdentifier;
+        header.length = length;
+        success = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(bytes, 1, length, file) == length;
+        success = fclose(file) == 0 && success;
+        success = success && rename(temporaryPath, path) == 0;
+        if (!success) {
+            remove(temporaryPath);
+        }
+    }
+    free(temporaryPath);
+    free(bytes);
+    return success;
+}
+
+/// 由按位置排列的节点 [low, high) 建立平衡的子树
+static uint32_t buildBalanced(YLTextAnnotationStore *store, uint32_t low, uint32_t high){
+    if (low >= high) {
+        return YLTextAnnotationNil;
+    }
+    uint32_t middle = low + (high - low) / 2;
+    store->nodes[middle].left = buildBalanced(store, low, middle);
+    store->nodes[middle].right = buildBalanced(store, middle + 1, high);
+    updateNode(store, middle);
+    return middle;
+}
+
+/// 解析标注到 store->nodes，校验顺序与范围
+static bool parseNodes(YLTextAnnotationStore *store, const uint8_t *bytes, size_t length){
+    size_t offset = 0;
+    size_t location = 0;
+    for (size_t i = 0; i < store->count; i++) {
+        uint64_t fields[5];
+        for (size_t j = 0; j < 5; j++) {
+            if (!readVarint(bytes, length, &offset, &fields[j])) {
+                return false;
+            }
+        }
+        if (fields[0] > SIZE_MAX - location || fields[1] == 0 || fields[1] > SIZE_MAX - location - fields[0] ||
+            fields[2] == 0 || fields[2] >= store->nextIdentifier || fields[3] > UINT32_MAX || fields[4] > length - offset) {
+            return false;
+        }
+        YLTextAnnotationNode *node = &store->nodes[i];
+        node->location = location + (size_t)fields[0];
+        node->end = node->location + (size_t)fields[1];
+        node->identifier = fields[2];
+        node->style = (uint32_t)fields[3];
+        if (i > 0 && compareKey(node->location, node->identifier, &store->nodes[i - 1]) <= 0) {
+            return false;
+        }
+        size_t noteLength = (size_t)fields[4];
+        if (noteLength) {
+            if (memchr(bytes + offset, '\0', noteLength)) {
+                return false;
+            }
+            node->note = malloc(noteLength + 1);
+            if (node->note == NULL) {
+                return false;
+            }
+            memcpy(node->note, bytes + offset, noteLength);
+            node->note[noteLength] = '\0';
+            offset += noteLength;
+        }
+        location = node->location;
+        store->used = i + 1;
+    }
+    return offset == length;
+}
+
+YLTextAnnotationStore *YLTextAnnotationStoreRead(const char *path){
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    YLTextAnnotationHeader header;
+    //每条标注至少 5 字节
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, YLTextAnnotationMagic, 4) != 0 || header.version != YLTextAnnotationVersion ||
+        header.length > SIZE_MAX || header.count > header.length / 5 || header.count >= YLTextAnnotationNil) {
+        fclose(file);
+        return NULL;
+    }
+    size_t length = (size_t)header.length;
+    size_t count = (size_t)header.count;
+    uint8_t *bytes = malloc(length ? length : 1);
+    YLTextAnnotationStore *store = YLTextAnnotationStoreCreate();
+    bool success = bytes && store && fread(bytes, 1, length, file) == length && fgetc(file) == EOF;
+    fclose(file);
+    if (success && count) {
+        store->nodes = calloc(count, sizeof(YLTextAnnotationNode));
+        store->capacity = count;
+        store->count = count;
+        store->nextIdentifier = header.nextIdentifier;
+        success = store->nodes && parseNodes(store, bytes, length);
+        if (success) {
+            store->root = buildBalanced(store, 0, (uint32_t)count);
+        }
+    } else if (success) {
+        store->nextIdentifier = header.nextIdentifier ? header.nextIdentifier : 1;
+        success = length == 0;
+    }
+    free(bytes);
+    if (!success) {
+        YLTextAnnotationStoreDestroy(store);
+        return NULL;
+    }
+    return store;
+}
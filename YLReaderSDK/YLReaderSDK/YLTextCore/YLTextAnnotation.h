@@ -0,0 +1,76 @@
+//
+//  YLTextAnnotation.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  划线与笔记的存储：按全书字符位置（UTF-16，处理标签之前的原文位置）建立的区间树。
+//  AVL 树按起始位置排序，每个节点记录子树中最大的结束位置；查询与某页相交的标注时，
+//  起始位置在页内的标注在中序上连续，起始于页之前的标注借助最大结束位置剪枝，不必逐个检查。
+//  位置与分页无关，更换字体重新分页后按新的页面范围查询即可。
+//  可以写入文件：标注按位置排序，位置以差值、各字段以变长整数存储。
+//
+
+#ifndef YLTextAnnotation_h
+#define YLTextAnnotation_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 一条标注
+typedef struct YLTextAnnotation {
+    /// 添加时分配，从 1 开始递增，不会重复使用
+    uint64_t identifier;
+    /// 全书字符范围 [location, location + length)
+    size_t location;
+    size_t length;
+    /// 调用方定义的样式（如划线颜色）
+    uint32_t style;
+    /// 笔记，UTF-8；没有笔记时为 NULL。标注删除或修改后失效
+    const char *note;
+} YLTextAnnotation;
+
+typedef struct YLTextAnnotationStore YLTextAnnotationStore;
+
+YLTextAnnotationStore *YLTextAnnotationStoreCreate(void);
+void YLTextAnnotationStoreDestroy(YLTextAnnotationStore *store);
+
+size_t YLTextAnnotationStoreCount(const YLTextAnnotationStore *store);
+
+/** 添加标注，笔记会被复制
+ * @return 标注的 identifier；length 为 0 或内存不足时返回 0
+ */
+uint64_t YLTextAnnotationStoreAdd(YLTextAnnotationStore *store, size_t location, size_t length, uint32_t style, const char *note);
+
+/** 删除标注，按 location 与 identifier 查找
+ * @return 没有该标注时返回 false
+ */
+bool YLTextAnnotationStoreRemove(YLTextAnnotationStore *store, size_t location, uint64_t identifier);
+
+/** 修改标注的样式与笔记，范围不变
+ * @return 没有该标注或内存不足时返回 false
+ */
+bool YLTextAnnotationStoreUpdate(YLTextAnnotationStore *store, size_t location, uint64_t identifier, uint32_t style, const char *note);
+
+/** 查找与 [location, location + length) 相交的标注
+ * @param results 输出按 location（相同时按 identifier）升序排列的标注，最多 maxResults 个；可以为 NULL 只计数
+ * @return 相交的标注总数，可能大于 maxResults
+ */
+size_t YLTextAnnotationStoreFind(const YLTextAnnotationStore *store, size_t location, size_t length, YLTextAnnotation *results, size_t maxResults);
+
+/// 写入文件：先写入临时文件再替换，写入失败时原文件不变
+bool YLTextAnnotationStoreWrite(const YLTextAnnotationStore *store, const char *path);
+
+/// 读取文件，文件不存在或损坏时返回 NULL
+YLTextAnnotationStore *YLTextAnnotationStoreRead(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextAnnotation_h */
@@ -0,0 +1,621 @@
+//
+//  YLTextEncoding.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextEncoding.h"
+#include "YLGB18030Table.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YLTextEncodingSSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define YLTextEncodingNEON 1
+#endif
+
+/// 非法的字节序列，输出时转为 U+FFFD
+#define YLTextInvalidCodePoint UINT32_MAX
+
+/// 字符的最大字节数（UTF-8 与 GB18030 为 4，UTF-16 代理对为 4）
+#define YLTextMaxSequenceLength 4
+
+/// 没有 BOM 时判为 UTF-16 所需的最少字节数，更短的样本里 0 字节的分布不足以区分编码
+#define YLTextUTF16MinDetectLength 32
+
+struct YLTextTranscoder {
+    YLTextEncoding encoding;
+    /// 上一块末尾不完整的字符
+    uint8_t pending[YLTextMaxSequenceLength];
+    size_t pendingLength;
+};
+
+// MARK: - ASCII 快速路径
+
+/// 开头连续 ASCII 字节的个数
+static size_t asciiLength(const uint8_t *bytes, size_t length){
+    size_t i = 0;
+#if YLTextEncodingSSE2
+    for (; i + 16 <= length; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(bytes + i)));
+        if (mask) {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+#elif YLTextEncodingNEON
+    for (; i + 16 <= length; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(bytes + i)) >= 0x80) {
+            break;
+        }
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+#endif
+    while (i < length && bytes[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+static inline uint16_t readUTF16(const uint8_t *bytes, bool bigEndian){
+    return bigEndian ? (uint16_t)(bytes[0] << 8 | bytes[1]) : (uint16_t)(bytes[1] << 8 | bytes[0]);
+}
+
+/** 将开头连续的 ASCII 码元（U+0000～U+007F）收窄为单字节写入 output
+ * @param count 输入的码元数
+ * @return 处理的码元数
+ */
+static size_t narrowASCIIUTF16(const uint8_t *input, size_t count, bool bigEndian, uint8_t *output){
+    size_t i = 0;
+#if YLTextEncodingSSE2
+    const __m128i highBits = _mm_set1_epi16((short)0xFF80);
+    for (; i + 16 <= count; i += 16) {
+        __m128i low = _mm_loadu_si128((const __m128i *)(input + i * 2));
+        __m128i high = _mm_loadu_si128((const __m128i *)(input + i * 2 + 16));
+        if (bigEndian) {
+            low = _mm_or_si128(_mm_slli_epi16(low, 8), _mm_srli_epi16(low, 8));
+            high = _mm_or_si128(_mm_slli_epi16(high, 8), _mm_srli_epi16(high, 8));
+        }
+        __m128i test = _mm_and_si128(_mm_or_si128(low, high), highBits);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(test, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packus_epi16(low, high));
+    }
+#elif YLTextEncodingNEON
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t lowBytes = vld1q_u8(input + i * 2);
+        uint8x16_t highBytes = vld1q_u8(input + i * 2 + 16);
+        if (bigEndian) {
+            lowBytes = vrev16q_u8(lowBytes);
+            highBytes = vrev16q_u8(highBytes);
+        }
+        uint16x8_t low = vreinterpretq_u16_u8(lowBytes);
+        uint16x8_t high = vreinterpretq_u16_u8(highBytes);
+        if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(output + i, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t unit = readUTF16(input + i * 2, bigEndian);
+        if (unit >= 0x80) {
+            break;
+        }
+        output[i] = (uint8_t)unit;
+    }
+    return i;
+}
+
+
+// MARK: - 解码一个字符
+
+/* 以下函数返回占用的字节数，序列不完整、需要更多输入时返回 0
+ * 非法序列的码点为 YLTextInvalidCodePoint
+ */
+
+/// 非法序列只占用其中能作为合法前缀的部分，后面的字节重新解码
+static size_t decodeUTF8(const uint8_t *bytes, size_t length, uint32_t *codePoint){
+    uint8_t c = bytes[0];
+    if (c < 0x80) {
+        *codePoint = c;
+        return 1;
+    }
+    size_t count;
+    uint32_t value;
+    uint8_t lower = 0x80, upper = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        count = 2; value = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        count = 3; value = c & 0x0F;
+        if (c == 0xE0) lower = 0xA0;//过长编码
+        if (c == 0xED) upper = 0x9F;//代理区
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        count = 4; value = c & 0x07;
+        if (c == 0xF0) lower = 0x90;
+        if (c == 0xF4) upper = 0x8F;//超过 U+10FFFF
+    } else {
+        *codePoint = YLTextInvalidCodePoint;
+        return 1;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if (i >= length) {
+            return 0;
+        }
+        uint8_t trail = bytes[i];
+        if (trail < lower || trail > upper) {
+            *codePoint = YLTextInvalidCodePoint;
+            return i;
+        }
+        lower = 0x80;
+        upper = 0xBF;
+        value = (value << 6) | (trail & 0x3F);
+    }
+    *codePoint = value;
+    return count;
+}
+
+static size_t decodeUTF16(const uint8_t *bytes, size_t length, bool bigEndian, uint32_t *codePoint){
+    if (length < 2) {
+        return 0;
+    }
+    uint16_t unit = readUTF16(bytes, bigEndian);
+    if (unit < 0xD800 || unit > 0xDFFF) {
+        *codePoint = unit;
+        return 2;
+    }
+    if (unit >= 0xDC00) {//单独的低代理
+        *codePoint = YLTextInvalidCodePoint;
+        return 2;
+    }
+    if (length < 4) {
+        return 0;
+    }
+    uint16_t low = readUTF16(bytes + 2, bigEndian);
+    if (low < 0xDC00 || low > 0xDFFF) {
+        *codePoint = YLTextInvalidCodePoint;
+        return 2;
+    }
+    *codePoint = 0x10000 + ((uint32_t)(unit - 0xD800) << 10) + (low - 0xDC00);
+    return 4;
+}
+
+uint16_t YLTextGB18030DecodeTwoByte(uint8_t lead, uint8_t trail){
+    if (lead < 0x81 || lead > 0xFE || trail < 0x40 || trail > 0xFE || trail == 0x7F) {
+        return 0;
+    }
+    return YLGB18030TwoByteTable[(lead - 0x81) * 190 + (trail - 0x40) - (trail > 0x7F)];
+}
+
+/// 四字节 BMP 区的线性序号对应的码点
+static uint32_t gb18030FourByteBMP(uint32_t index){
+    size_t low = 0, high = sizeof(YLGB18030FourByteRanges) / sizeof(YLGB18030FourByteRanges[0]);
+    while (low + 1 < high) {
+        size_t mid = low + (high - low) / 2;
+        if (YLGB18030FourByteRanges[mid].index <= index) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return YLGB18030FourByteRanges[low].codePoint + (index - YLGB18030FourByteRanges[low].index);
+}
+
+/// 不能组成字符时只占用第一个字节，不吞掉后面的 ASCII
+static size_t decodeGB18030(const uint8_t *bytes, size_t length, uint32_t *codePoint){
+    uint8_t c = bytes[0];
+    if (c < 0x80) {
+        *codePoint = c;
+        return 1;
+    }
+    *codePoint = YLTextInvalidCodePoint;
+    if (c == 0x80 || c == 0xFF) {
+        return 1;
+    }
+    if (length < 2) {
+        return 0;
+    }
+    uint8_t c1 = bytes[1];
+    if (c1 < 0x30 || c1 > 0x39) {
+        uint16_t value = YLTextGB18030DecodeTwoByte(c, c1);
+        if (value == 0) {
+            return 1;
+        }
+        *codePoint = value;
+        return 2;
+    }
+    if (length < 3) {
+        return 0;
+    }
+    uint8_t c2 = bytes[2];
+    if (c2 < 0x81 || c2 > 0xFE) {
+        return 1;
+    }
+    if (length < 4) {
+        return 0;
+    }
+    uint8_t c3 = bytes[3];
+    if (c3 < 0x30 || c3 > 0x39) {
+        return 1;
+    }
+    uint32_t index = (uint32_t)(c - 0x81) * 12600 + (uint32_t)(c1 - 0x30) * 1260 + (uint32_t)(c2 - 0x81) * 10 + (uint32_t)(c3 - 0x30);
+    if (index < 39420) {
+        *codePoint = gb18030FourByteBMP(index);
+    } else if (index >= 189000 && index < 189000 + 0x100000) {//0x90308130 起为增补平面
+        *codePoint = 0x10000 + (index - 189000);
+    } else {//没有映射的四字节码位
+        return 1;
+    }
+    return 4;
+}
+
+static size_t decodeCharacter(YLTextEncoding encoding, const uint8_t *bytes, size_t length, uint32_t *codePoint){
+    switch (encoding) {
+        case YLTextEncodingUTF16LE:
+            return decodeUTF16(bytes, length, false, codePoint);
+        case YLTextEncodingUTF16BE:
+            return decodeUTF16(bytes, length, true, codePoint);
+        case YLTextEncodingGB18030:
+            return decodeGB18030(bytes, length, codePoint);
+        case YLTextEncodingUTF8:
+        default:
+            return decodeUTF8(bytes, length, codePoint);
+    }
+}
+
+static inline uint8_t *writeUTF8(uint8_t *output, uint32_t c){
+    if (c == YLTextInvalidCodePoint) {
+        c = 0xFFFD;
+    }
+    if (c < 0x80) {
+        *output++ = (uint8_t)c;
+    } else if (c < 0x800) {
+        *output++ = (uint8_t)(0xC0 | (c >> 6));
+        *output++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        *output++ = (uint8_t)(0xE0 | (c >> 12));
+        *output++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+        *output++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else {
+        *output++ = (uint8_t)(0xF0 | (c >> 18));
+        *output++ = (uint8_t)(0x80 | ((c >> 12) & 0x3F));
+        *output++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+        *output++ = (uint8_t)(0x80 | (c & 0x3F));
+    }
+    return output;
+}
+
+
+// MARK: - 识别
+
+#if YLTextEncodingSSE2 || YLTextEncodingNEON
+
+/// 64 字节中各类字节的位图，第 i 位对应第 i 个字节
+typedef struct YLUTF8Masks {
+    uint64_t continuation; //0x80～0xBF
+    uint64_t lead2;        //0xC2～0xDF
+    uint64_t lead3;        //0xE0～0xEF
+    uint64_t lead4;        //0xF0～0xF4
+    uint64_t invalid;      //0xC0、0xC1、0xF5～0xFF
+    uint64_t e0, ed, f0, f4;
+    uint64_t atLeastA0, atLeast90;
+} YLUTF8Masks;
+
+#if YLTextEncodingNEON
+/// 每字节为 0xFF 或 0 的比较结果压缩为 16 位
+static inline uint64_t neonMovemask(uint8x16_t v){
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vandq_u8(v, vld1q_u8(weights));
+    return (uint64_t)vaddv_u8(vget_low_u8(bits)) | (uint64_t)vaddv_u8(vget_high_u8(bits)) << 8;
+}
+#endif
+
+/// 统计 16 个字节，写入 masks 的第 shift～shift + 15 位；全部是 ASCII 时返回 false
+static inline bool classifyBytes(const uint8_t *bytes, unsigned shift, YLUTF8Masks *masks){
+#if YLTextEncodingSSE2
+    __m128i x = _mm_loadu_si128((const __m128i *)bytes);
+    uint64_t high = (uint64_t)_mm_movemask_epi8(x);
+    if (high == 0) {
+        return false;
+    }
+#define YLAtLeast(k) (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8((char)(k))), x))
+#define YLEqual(k) (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8((char)(k))))
+#else
+    uint8x16_t x = vld1q_u8(bytes);
+    if (vmaxvq_u8(x) < 0x80) {
+        return false;
+    }
+    uint64_t high = neonMovemask(vcgeq_u8(x, vdupq_n_u8(0x80)));
+#define YLAtLeast(k) neonMovemask(vcgeq_u8(x, vdupq_n_u8(k)))
+#define YLEqual(k) neonMovemask(vceqq_u8(x, vdupq_n_u8(k)))
+#endif
+    uint64_t c0 = YLAtLeast(0xC0), c2 = YLAtLeast(0xC2), e0 = YLAtLeast(0xE0), f0 = YLAtLeast(0xF0), f5 = YLAtLeast(0xF5);
+    masks->continuation |= (high & ~c0) << shift;
+    masks->lead2 |= (c2 & ~e0) << shift;
+    masks->lead3 |= (e0 & ~f0) << shift;
+    masks->lead4 |= (f0 & ~f5) << shift;
+    masks->invalid |= ((c0 & ~c2) | f5) << shift;
+    masks->e0 |= YLEqual(0xE0) << shift;
+    masks->ed |= YLEqual(0xED) << shift;
+    masks->f0 |= YLEqual(0xF0) << shift;
+    masks->f4 |= YLEqual(0xF4) << shift;
+    masks->atLeastA0 |= YLAtLeast(0xA0) << shift;
+    masks->atLeast90 |= YLAtLeast(0x90) << shift;
+#undef YLAtLeast
+#undef YLEqual
+    return true;
+}
+
+/** 按 64 字节一组校验，返回开头已确认合法的字节数，结果总在字符边界上
+ * 每组统计各类字节的位图：前导字节之后应有的后续字节与实际的后续字节逐位相同，
+ * 且没有非法字节、过长编码、代理区与超出 U+10FFFF 的码位；跨组的字符由 carry 带到下一组
+ */
+static size_t utf8ValidBlockLength(const uint8_t *bytes, size_t length){
+    size_t i = 0;
+    //上一组末尾的前导字节要求本组开头为后续字节的位置，及上一组最后一个字节是否为 E0、ED、F0、F4
+    uint64_t carry = 0, lastE0 = 0, lastED = 0, lastF0 = 0, lastF4 = 0;
+    for (; i + 64 <= length; i += 64) {
+        YLUTF8Masks masks;
+        memset(&masks, 0, sizeof(masks));
+        bool ascii = true;
+        for (unsigned j = 0; j < 64; j += 16) {
+            ascii = !classifyBytes(bytes + i + j, j, &masks) && ascii;
+        }
+        if (ascii) {
+            if (carry) {
+                break;
+            }
+            lastE0 = lastED = lastF0 = lastF4 = 0;
+            continue;
+        }
+        uint64_t expected = carry | masks.lead2 << 1 | masks.lead3 << 1 | masks.lead3 << 2 | masks.lead4 << 1 | masks.lead4 << 2 | masks.lead4 << 3;
+        //后续字节已确认在 0x80～0xBF，只需检查 E0、ED、F0、F4 之后的第一个字节
+        uint64_t e0 = masks.e0 << 1 | lastE0, ed = masks.ed << 1 | lastED, f0 = masks.f0 << 1 | lastF0, f4 = masks.f4 << 1 | lastF4;
+        uint64_t error = masks.invalid | (expected ^ masks.continuation) |
+            (e0 & ~masks.atLeastA0) | (ed & masks.atLeastA0) | (f0 & ~masks.atLeast90) | (f4 & masks.atLeast90);
+        if (error) {
+            break;
+        }
+        carry = masks.lead2 >> 63 | masks.lead3 >> 63 | masks.lead3 >> 62 | masks.lead4 >> 63 | masks.lead4 >> 62 | masks.lead4 >> 61;
+        lastE0 = masks.e0 >> 63;
+        lastED = masks.ed >> 63;
+        lastF0 = masks.f0 >> 63;
+        lastF4 = masks.f4 >> 63;
+    }
+    //i 处于字符中间时退回到该字符的前导字节
+    if (carry) {
+        while (i > 0 && (bytes[i - 1] & 0xC0) == 0x80) {
+            i--;
+        }
+        i--;
+    }
+    return i;
+}
+
+#endif
+
+size_t YLTextUTF8ValidLength(const uint8_t *bytes, size_t length){
+    size_t i = 0;
+#if YLTextEncodingSSE2 || YLTextEncodingNEON
+    i = utf8ValidBlockLength(bytes, length);
+#endif
+    //不足 64 字节的末尾，或找到非法序列的那一组，逐个字符确认
+    while (i < length) {
+        if (bytes[i] < 0x80) {
+            i += asciiLength(bytes + i, length - i);
+            continue;
+        }
+        //三字节字符（汉字）的快速路径
+        if ((bytes[i] & 0xF0) == 0xE0 && i + 3 <= length) {
+            uint8_t c = bytes[i], c1 = bytes[i + 1];
+            if ((c1 & 0xC0) == 0x80 && (bytes[i + 2] & 0xC0) == 0x80 && (c != 0xE0 || c1 >= 0xA0) && (c != 0xED || c1 < 0xA0)) {
+                i += 3;
+                continue;
+            }
+        }
+        uint32_t codePoint;
+        size_t consumed = decodeUTF8(bytes + i, length - i, &codePoint);
+        if (consumed == 0 || codePoint == YLTextInvalidCodePoint) {
+            break;
+        }
+        i += consumed;
+    }
+    return i;
+}
+
+static bool isTextUnit(uint16_t unit){
+    return (unit >= 0x20 && unit < 0x7F) || unit == '\n' || unit == '\r' || unit == '\t'
+        || (unit >= 0x4E00 && unit <= 0x9FFF)//CJK 统一汉字
+        || (unit >= 0x3000 && unit <= 0x303F)//CJK 标点
+        || (unit >= 0xFF00 && unit <= 0xFFEF);//全角字符
+}
+
+static YLTextEncoding detectWithoutBOM(const uint8_t *bytes, size_t length, bool truncated){
+    //UTF-16 中 ASCII 等字符的高位字节为 0，0 字节集中在奇数位置（LE）或偶数位置（BE）；UTF-8、GB18030 的正文没有 0 字节
+    size_t units = length / 2, zerosLE = 0, zerosBE = 0;
+    for (size_t i = 0; i < units; i++) {
+        zerosBE += bytes[i * 2] == 0;
+        zerosLE += bytes[i * 2 + 1] == 0;
+    }
+    bool allowsUTF16 = length >= YLTextUTF16MinDetectLength;
+    //汉字的低位字节也可能是 0（如“一”U+4E00），只要求一侧明显多于另一侧
+    if (allowsUTF16 && zerosLE > zerosBE * 2 && zerosLE * 4 >= units) {
+        return YLTextEncodingUTF16LE;
+    }
+    if (allowsUTF16 && zerosBE > zerosLE * 2 && zerosBE * 4 >= units) {
+        return YLTextEncodingUTF16BE;
+    }
+
+    size_t valid = YLTextUTF8ValidLength(bytes, length);
+    if (valid == length || (truncated && length - valid < YLTextMaxSequenceLength)) {
+        return YLTextEncodingUTF8;
+    }
+
+    //以汉字为主的 UTF-16 中 0 字节较少：有 0 字节，且按 UTF-16 读取时大部分码元是 ASCII 或汉字；
+    //GB18030 的中文按两字节组合几乎落不到这些范围里
+    if (allowsUTF16 && zerosLE + zerosBE > 0) {
+        size_t textLE = 0, textBE = 0;
+        for (size_t i = 0; i < units; i++) {
+            textLE += isTextUnit(readUTF16(bytes + i * 2, false));
+            textBE += isTextUnit(readUTF16(bytes + i * 2, true));
+        }
+        if ((textLE > textBE ? textLE : textBE) * 10 >= units * 7) {
+            return textLE >= textBE ? YLTextEncodingUTF16LE : YLTextEncodingUTF16BE;
+        }
+    }
+
+    //GB18030 中非法序列不超过 1% 时按 GB18030 处理
+    size_t characters = 0, invalid = 0;
+    for (size_t i = 0; i < length;) {
+        uint32_t codePoint;
+        size_t consumed = decodeGB18030(bytes + i, length - i, &codePoint);
+        if (consumed == 0) {
+            invalid += !truncated;
+            break;
+        }
+        characters++;
+        invalid += codePoint == YLTextInvalidCodePoint;
+        i += consumed;
+    }
+    if (invalid * 100 <= characters) {
+        return YLTextEncodingGB18030;
+    }
+    return YLTextEncodingUTF8;
+}
+
+YLTextEncoding YLTextEncodingDetect(const uint8_t *bytes, size_t length, size_t *bomLength){
+    size_t bom = 0;
+    YLTextEncoding encoding;
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        encoding = YLTextEncodingUTF8; bom = 3;
+    } else if (length >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE) {
+        encoding = YLTextEncodingUTF16LE; bom = 2;
+    } else if (length >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF) {
+        encoding = YLTextEncodingUTF16BE; bom = 2;
+    } else if (length >= 4 && bytes[0] == 0x84 && bytes[1] == 0x31 && bytes[2] == 0x95 && bytes[3] == 0x33) {
+        encoding = YLTextEncodingGB18030; bom = 4;
+    } else {
+        size_t sample = length < YLTextEncodingDetectLength ? length : YLTextEncodingDetectLength;
+        encoding = detectWithoutBOM(bytes, sample, sample < length);
+    }
+    if (bomLength) {
+        *bomLength = bom;
+    }
+    return encoding;
+}
+
+
+// MARK: - 流式转码
+
+YLTextTranscoder *YLTextTranscoderCreate(YLTextEncoding encoding){
+    YLTextTranscoder *transcoder = calloc(1, sizeof(YLTextTranscoder));
+    if (transcoder) {
+        transcoder->encoding = encoding;
+    }
+    return transcoder;
+}
+
+void YLTextTranscoderDestroy(YLTextTranscoder *transcoder){
+    free(transcoder);
+}
+
+size_t YLTextTranscoderMaxOutputLength(size_t inputLength){
+    //每个输入字节最多输出 3 个字节（非法字节转为 U+FFFD），另加上一块留下的字符
+    return (inputLength + YLTextMaxSequenceLength) * 3;
+}
+
+/** 转码 [0, length)，末尾不完整的字符写入 pending
+ * @return 写入 output 的结束位置
+ */
+static uint8_t *convertBytes(YLTextTranscoder *transcoder, const uint8_t *input, size_t length, bool final, uint8_t *output){
+    YLTextEncoding encoding = transcoder->encoding;
+    bool utf16 = encoding == YLTextEncodingUTF16LE || encoding == YLTextEncodingUTF16BE;
+    size_t i = 0;
+    bool bigEndian = encoding == YLTextEncodingUTF16BE;
+    while (i < length) {
+        if (utf16) {
+            //BMP 中代理区以外的码元直接编码，不经过 decodeCharacter
+            while (i + 2 <= length) {
+                uint16_t unit = readUTF16(input + i, bigEndian);
+                if (unit < 0x80) {
+                    size_t count = narrowASCIIUTF16(input + i, (length - i) / 2, bigEndian, output);
+                    i += count * 2;
+                    output += count;
+                } else if (unit < 0xD800 || unit > 0xDFFF) {
+                    output = writeUTF8(output, unit);
+                    i += 2;
+                } else {
+                    break;
+                }
+            }
+        } else if (input[i] < 0x80) {
+            size_t count = asciiLength(input + i, length - i);
+            memcpy(output, input + i, count);
+            i += count;
+            output += count;
+        } else if (encoding == YLTextEncodingGB18030) {
+            //双字节字符直接查表
+            uint16_t value;
+            while (i + 2 <= length && (value = YLTextGB18030DecodeTwoByte(input[i], input[i + 1])) != 0) {
+                output = writeUTF8(output, value);
+                i += 2;
+            }
+        }
+        if (i >= length) {
+            break;
+        }
+        uint32_t codePoint;
+        size_t consumed = decodeCharacter(encoding, input + i, length - i, &codePoint);
+        if (consumed == 0) {
+            if (final) {
+                output = writeUTF8(output, YLTextInvalidCodePoint);
+            } else {
+                transcoder->pendingLength = length - i;
+                memcpy(transcoder->pending, input + i, length - i);
+            }
+            break;
+        }
+        output = writeUTF8(output, codePoint);
+        i += consumed;
+    }
+    return output;
+}
+
+size_t YLTextTranscoderConvert(YLTextTranscoder *transcoder, const uint8_t *input, size_t length, bool final, uint8_t *output){
+    uint8_t *cursor = output;
+    if (transcoder->pendingLength > 0) {
+        //上一块留下的字节与本块开头拼接，解码到越过拼接处为止
+        uint8_t joined[YLTextMaxSequenceLength * 2];
+        size_t pending = transcoder->pendingLength;
+        size_t taken = length < YLTextMaxSequenceLength ? length : YLTextMaxSequenceLength;
+        memcpy(joined, transcoder->pending, pending);
+        memcpy(joined + pending, input, taken);
+        transcoder->pendingLength = 0;
+
+        size_t j = 0;
+        while (j < pending) {
+            uint32_t codePoint;
+            size_t consumed = decodeCharacter(transcoder->encoding, joined + j, pending + taken - j, &codePoint);
+            if (consumed == 0) {
+                //拼接后仍不完整，说明本块已全部用完
+                return (size_t)(convertBytes(transcoder, joined + j, pending + taken - j, final, cursor) - output);
+            }
+            cursor = writeUTF8(cursor, codePoint);
+            j += consumed;
+        }
+        input += j - pending;
+        length -= j - pending;
+    }
+    return (size_t)(convertBytes(transcoder, input, length, final, cursor) - output);
+}
@@ -0,0 +1,75 @@
+//
+//  YLTextEncoding.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  书籍编码的识别与转码：排版流水线只处理 UTF-8，GB18030、UTF-16 的书籍在打开时流式转码为 UTF-8。
+//  ASCII 连续段以 16 字节为单位（SSE2 / NEON，其他平台按 8 字节）判断与复制，多字节字符逐个解码。
+//
+
+#ifndef YLTextEncoding_h
+#define YLTextEncoding_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum YLTextEncoding {
+    YLTextEncodingUTF8 = 0,
+    YLTextEncodingUTF16LE,
+    YLTextEncodingUTF16BE,
+    YLTextEncodingGB18030,
+} YLTextEncoding;
+
+/// 识别编码时最多检查的字节数
+#define YLTextEncodingDetectLength 65536
+
+/** 识别编码
+ * 有 BOM 时以 BOM 为准；否则统计开头 YLTextEncodingDetectLength 字节：
+ * 0 字节集中在奇数或偶数位置时按 UTF-16 处理；其次合法的 UTF-8（末尾可以是不完整的字符）按 UTF-8 处理；
+ * 否则有 0 字节且大部分码元是 ASCII 或汉字时按 UTF-16，再尝试 GB18030，都不合法时按 UTF-8 处理；
+ * 不足 32 字节且没有 BOM 的文本不判为 UTF-16
+ * @param bomLength 输出 BOM 的字节数，可以为 NULL
+ */
+YLTextEncoding YLTextEncodingDetect(const uint8_t *bytes, size_t length, size_t *bomLength);
+
+/** 开头合法 UTF-8 的字节数
+ * 返回 length 表示整段合法；末尾不完整的字符视为不合法
+ */
+size_t YLTextUTF8ValidLength(const uint8_t *bytes, size_t length);
+
+/** 解码一个 GB18030 双字节字符
+ * @return lead、trail 不是双字节码位时返回 0
+ */
+uint16_t YLTextGB18030DecodeTwoByte(uint8_t lead, uint8_t trail);
+
+
+// MARK: - 流式转码
+
+typedef struct YLTextTranscoder YLTextTranscoder;
+
+/// 将 encoding 转码为 UTF-8，非法的字节序列转为 U+FFFD
+YLTextTranscoder *YLTextTranscoderCreate(YLTextEncoding encoding);
+void YLTextTranscoderDestroy(YLTextTranscoder *transcoder);
+
+/// 转码 inputLength 字节输入时输出缓冲区所需的字节数（含上一块留下的不完整字符）
+size_t YLTextTranscoderMaxOutputLength(size_t inputLength);
+
+/** 转码一块输入
+ * 块末尾不完整的字符保存在转码器中，与下一块拼接；分块方式不影响结果
+ * @param final 最后一块；仍不完整的字符转为 U+FFFD
+ * @param output 容量不小于 YLTextTranscoderMaxOutputLength(length)
+ * @return 写入 output 的字节数
+ */
+size_t YLTextTranscoderConvert(YLTextTranscoder *transcoder, const uint8_t *input, size_t length, bool final, uint8_t *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextEncoding_h */
@@ -0,0 +1,180 @@
+//
+//  YLTextGeometry.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextGeometry.h"
+#include <stdlib.h>
+#include <string.h>
+
+void YLTextGeometryInit(YLTextGeometry *geometry){
+    memset(geometry, 0, sizeof(YLTextGeometry));
+}
+
+void YLTextGeometryDestroy(YLTextGeometry *geometry){
+    free(geometry->lines);
+    free(geometry->runs);
+    YLTextGeometryInit(geometry);
+}
+
+bool YLTextGeometryAddLine(YLTextGeometry *geometry, YLTextGeometryRect frame, YLTextFontMetrics metrics, size_t location, size_t length){
+    if (geometry->lineCount == geometry->lineCapacity) {
+        size_t capacity = geometry->lineCapacity ? geometry->lineCapacity * 2 : 32;
+        YLTextGeometryLine *lines = realloc(geometry->lines, capacity * sizeof(YLTextGeometryLine));
+        if (lines == NULL) {
+            return false;
+        }
+        geometry->lines = lines;
+        geometry->lineCapacity = capacity;
+    }
+    YLTextGeometryLine *line = &geometry->lines[geometry->lineCount++];
+    line->frame = frame;
+    line->metrics = metrics;
+    line->location = location;
+    line->length = length;
+    line->trimStart = 0;
+    line->trimEnd = 0;
+    line->firstRun = geometry->runCount;
+    line->runCount = 0;
+    return true;
+}
+
+bool YLTextGeometryAddRun(YLTextGeometry *geometry, double minX, double maxX, size_t location, size_t length){
+    if (geometry->lineCount == 0) {
+        return false;
+    }
+    if (geometry->runCount == geometry->runCapacity) {
+        size_t capacity = geometry->runCapacity ? geometry->runCapacity * 2 : 64;
+        YLTextGeometryRun *runs = realloc(geometry->runs, capacity * sizeof(YLTextGeometryRun));
+        if (runs == NULL) {
+            return false;
+        }
+        geometry->runs = runs;
+        geometry->runCapacity = capacity;
+    }
+    YLTextGeometryLine *line = &geometry->lines[geometry->lineCount - 1];
+    YLTextGeometryRun run = {minX, maxX, location, length, line->runCount};
+
+    //插入排序：一行中的段很少，且通常已按从左到右的顺序追加
+    size_t i = geometry->runCount;
+    while (i > line->firstRun && geometry->runs[i - 1].minX > minX) {
+        geometry->runs[i] = geometry->runs[i - 1];
+        i--;
+    }
+    geometry->runs[i] = run;
+    geometry->runCount++;
+    line->runCount++;
+    return true;
+}
+
+size_t YLTextGeometryLineAtPoint(const YLTextGeometry *geometry, double x, double y, double inset){
+    //第一个下边界（扩展后）在 y 之下的行
+    size_t low = 0, high = geometry->lineCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const YLTextGeometryRect *frame = &geometry->lines[mid].frame;
+        if (frame->y + frame->height + inset <= y) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    //扩展后的矩形可能重叠，向下检查仍覆盖 y 的行
+    for (size_t i = low; i < geometry->lineCount; i++) {
+        const YLTextGeometryRect *frame = &geometry->lines[i].frame;
+        if (frame->y - inset > y) {
+            break;
+        }
+        if (x >= frame->x - inset && x < frame->x + frame->width + inset) {
+            return i;
+        }
+    }
+    return YLTextGeometryNotFound;
+}
+
+size_t YLTextGeometryRunAtX(const YLTextGeometry *geometry, size_t line, double x){
+    if (line >= geometry->lineCount) {
+        return YLTextGeometryNotFound;
+    }
+    const YLTextGeometryLine *info = &geometry->lines[line];
+    //最后一个左边界不大于 x 的段
+    size_t low = info->firstRun, high = info->firstRun + info->runCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (geometry->runs[mid].minX <= x) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == info->firstRun) {
+        return YLTextGeometryNotFound;
+    }
+    const YLTextGeometryRun *run = &geometry->runs[low - 1];
+    return x < run->maxX ? low - 1 : YLTextGeometryNotFound;
+}
+
+size_t YLTextGeometryLineAtLocation(const YLTextGeometry *geometry, size_t location){
+    size_t low = 0, high = geometry->lineCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const YLTextGeometryLine *line = &geometry->lines[mid];
+        if (line->location + line->length <= location) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < geometry->lineCount && geometry->lines[low].location <= location) {
+        return low;
+    }
+    return YLTextGeometryNotFound;
+}
+
+void YLTextGeometrySetTrims(YLTextGeometry *geometry, const uint16_t *chars, size_t length){
+    for (size_t i = 0; i < geometry->lineCount; i++) {
+        YLTextGeometryLine *line = &geometry->lines[i];
+        size_t start = line->location;
+        size_t end = line->location + line->length;
+        if (end > length) {
+            end = length;
+        }
+        if (start >= end) {
+            line->trimStart = line->trimEnd = 0;
+            continue;
+        }
+        size_t newlineStart = end;
+        if (chars[newlineStart - 1] == '\n' || chars[newlineStart - 1] == 0x2029) {
+            newlineStart--;
+            if (newlineStart > start && chars[newlineStart - 1] == '\r') {
+                newlineStart--;
+            }
+        } else if (chars[newlineStart - 1] == '\r') {
+            newlineStart--;
+        }
+        size_t spaceEnd = start;
+        while (spaceEnd < newlineStart && (chars[spaceEnd] == ' ' || chars[spaceEnd] == '\t' || chars[spaceEnd] == 0x3000)) {
+            spaceEnd++;
+        }
+        line->trimStart = spaceEnd - start;
+        line->trimEnd = end - newlineStart;
+    }
+}
+
+bool YLTextGeometryClipRange(const YLTextGeometry *geometry, size_t line, size_t location, size_t length, bool trim, size_t *start, size_t *end){
+    if (line >= geometry->lineCount) {
+        return false;
+    }
+    const YLTextGeometryLine *info = &geometry->lines[line];
+    size_t lineStart = info->location;
+    size_t lineEnd = info->location + info->length;
+    if (trim) {
+        lineStart += info->trimStart;
+        lineEnd -= info->trimEnd;
+    }
+    *start = location > lineStart ? location : lineStart;
+    *end = location + length < lineEnd ? location + length : lineEnd;
+    return *start < *end;
+}
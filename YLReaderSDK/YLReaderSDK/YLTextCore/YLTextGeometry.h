@@ -0,0 +1,99 @@
+//
+//  YLTextGeometry.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  页面的行、段几何索引：排版完成后记录一次每行的矩形、字形度量与文字范围、每段（run）的横向区间，
+//  点击与拖动选择时按 y 二分查找行、按 x 二分查找段，不再逐行计算字形度量。
+//  坐标均为视图坐标系（左上角为原点，y 向下）。
+//
+
+#ifndef YLTextGeometry_h
+#define YLTextGeometry_h
+
+#include "YLTextMetrics.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 查找失败时返回的索引
+#define YLTextGeometryNotFound ((size_t)-1)
+
+typedef struct YLTextGeometryRect {
+    double x;
+    double y;
+    double width;
+    double height;
+} YLTextGeometryRect;
+
+typedef struct YLTextGeometryRun {
+    double minX;
+    double maxX;
+    size_t location; //文字范围，以 UTF-16 码元计
+    size_t length;
+    size_t index;    //在所在行中的原始顺序（逻辑顺序）
+} YLTextGeometryRun;
+
+typedef struct YLTextGeometryLine {
+    YLTextGeometryRect frame;
+    YLTextFontMetrics metrics;
+    size_t location;
+    size_t length;
+    size_t trimStart; //行首空白的码元数，由 YLTextGeometrySetTrims 计算
+    size_t trimEnd;   //行尾换行符的码元数
+    size_t firstRun; //runs 中的起始位置，同一行的段按 minX 升序排列
+    size_t runCount;
+} YLTextGeometryLine;
+
+typedef struct YLTextGeometry {
+    YLTextGeometryLine *lines; //自上而下排列
+    size_t lineCount;
+    size_t lineCapacity;
+    YLTextGeometryRun *runs;
+    size_t runCount;
+    size_t runCapacity;
+} YLTextGeometry;
+
+void YLTextGeometryInit(YLTextGeometry *geometry);
+void YLTextGeometryDestroy(YLTextGeometry *geometry);
+
+/// 追加一行，必须位于已有行的下方
+bool YLTextGeometryAddLine(YLTextGeometry *geometry, YLTextGeometryRect frame, YLTextFontMetrics metrics, size_t location, size_t length);
+
+/// 为最后一行追加一段，段可以按任意顺序追加
+bool YLTextGeometryAddRun(YLTextGeometry *geometry, double minX, double maxX, size_t location, size_t length);
+
+/** 点 (x, y) 所在的行
+ * @param inset 行矩形向外扩展的距离，便于点中行间空隙；扩展后重叠时取靠上的行
+ */
+size_t YLTextGeometryLineAtPoint(const YLTextGeometry *geometry, double x, double y, double inset);
+
+/// 第 line 行中 x 处的段，返回在 runs 中的位置
+size_t YLTextGeometryRunAtX(const YLTextGeometry *geometry, size_t line, double x);
+
+/// 包含文字位置 location 的行
+size_t YLTextGeometryLineAtLocation(const YLTextGeometry *geometry, size_t location);
+
+/** 根据页面文字计算每行的行首空白（空格、制表符、全角空格）与行尾换行符
+ * @param chars 页面文字，行的文字范围以它为准
+ */
+void YLTextGeometrySetTrims(YLTextGeometry *geometry, const uint16_t *chars, size_t length);
+
+/** 选中范围 [location, location + length) 落在第 line 行的部分
+ * @param trim 是否去掉行首空白与行尾换行符
+ * @param start 输出起始位置
+ * @param end 输出结束位置（不包含）
+ * @return 该行没有选中的文字时返回 false
+ */
+bool YLTextGeometryClipRange(const YLTextGeometry *geometry, size_t line, size_t location, size_t length, bool trim, size_t *start, size_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextGeometry_h */
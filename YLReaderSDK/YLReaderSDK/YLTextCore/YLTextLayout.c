@@ -0,0 +1,406 @@
+//
+//  YLTextLayout.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextLayout.h"
+#include <stdlib.h>
+#include <string.h>
+
+// MARK: - 断行类别
+
+/// 简化的 UAX #14 断行类别
+typedef enum {
+    YLBreakAlphabetic = 0, //字母、数字等：相互之间不可断行
+    YLBreakIdeographic,    //汉字、假名、附件等：两侧可断行
+    YLBreakSpace,          //空格：之后可断行
+    YLBreakHyphen,         //连字符：之后可断行
+    YLBreakOpen,           //开始标点：之后不可断行（行尾禁则）
+    YLBreakClose,          //结束标点：之前不可断行（行首禁则）
+    YLBreakMandatory,      //换行符
+} YLBreakClass;
+
+static YLBreakClass breakClass(uint32_t c){
+    if (c < 0x80) {
+        switch (c) {
+            case '\n': case '\r': case 0x0B: case 0x0C:
+                return YLBreakMandatory;
+            case ' ': case '\t':
+                return YLBreakSpace;
+            case '-':
+                return YLBreakHyphen;
+            case '(': case '[': case '{':
+                return YLBreakOpen;
+            case ')': case ']': case '}': case ',': case '.': case '!': case '?': case ':': case ';': case '%':
+                return YLBreakClose;
+            default:
+                return YLBreakAlphabetic;
+        }
+    }
+    switch (c) {
+        case 0x0085: case 0x2028: case 0x2029:
+            return YLBreakMandatory;
+        case 0x00A0: case 0x2060: case 0xFEFF:
+            return YLBreakAlphabetic;
+        case 0x2018: case 0x201C: case 0x3008: case 0x300A: case 0x300C: case 0x300E: case 0x3010:
+        case 0x3014: case 0x3016: case 0x3018: case 0x301A: case 0x301D: case 0xFF08: case 0xFF3B:
+        case 0xFF5B: case 0xFF5F: case 0xFF62:
+            return YLBreakOpen;
+        case 0x2019: case 0x201D: case 0x2014: case 0x2026: case 0x3001: case 0x3002: case 0x3005:
+        case 0x3009: case 0x300B: case 0x300D: case 0x300F: case 0x3011: case 0x3015: case 0x3017:
+        case 0x3019: case 0x301B: case 0x301E: case 0x301F: case 0x3041: case 0x3043: case 0x3045:
+        case 0x3047: case 0x3049: case 0x3063: case 0x3083: case 0x3085: case 0x3087: case 0x308E:
+        case 0x309D: case 0x309E: case 0x30A1: case 0x30A3: case 0x30A5: case 0x30A7: case 0x30A9:
+        case 0x30C3: case 0x30E3: case 0x30E5: case 0x30E7: case 0x30EE: case 0x30F5: case 0x30F6:
+        case 0x30FB: case 0x30FC: case 0x30FD: case 0x30FE: case 0xFF01: case 0xFF09: case 0xFF0C:
+        case 0xFF0E: case 0xFF1A: case 0xFF1B: case 0xFF1F: case 0xFF3D: case 0xFF5D: case 0xFF60:
+        case 0xFF61: case 0xFF63: case 0xFF64:
+            return YLBreakClose;
+        case 0x2002: case 0x2003: case 0x2009: case 0x200B:
+            return YLBreakSpace;
+        case YLTextAttachmentCharacter:
+            return YLBreakIdeographic;
+        default:
+            return YLTextIsWideCharacter(c) ? YLBreakIdeographic : YLBreakAlphabetic;
+    }
+}
+
+/// before 与 after 之间是否可以断行
+static bool canBreakBetween(YLBreakClass before, YLBreakClass after){
+    if (after == YLBreakClose || after == YLBreakSpace || before == YLBreakOpen) {
+        return false;
+    }
+    if (before == YLBreakSpace || before == YLBreakIdeographic || after == YLBreakIdeographic) {
+        return true;
+    }
+    return before == YLBreakHyphen && after == YLBreakAlphabetic;
+}
+
+
+// MARK: - 测量游标
+
+#define YLTextCursorBufferSize 256
+
+/// 顺序读取字符宽度与样式，按样式分批调用 measure
+typedef struct YLTextCursor {
+    const YLTextSource *source;
+    const YLTextMetrics *metrics;
+    size_t runIndex;
+    size_t bufferStart;
+    size_t bufferLength;
+    double advances[YLTextCursorBufferSize];
+} YLTextCursor;
+
+static void cursorInit(YLTextCursor *cursor, const YLTextSource *source, const YLTextMetrics *metrics){
+    cursor->source = source;
+    cursor->metrics = metrics;
+    cursor->runIndex = 0;
+    cursor->bufferStart = 0;
+    cursor->bufferLength = 0;
+}
+
+/// 定位 index 所在的样式段
+static size_t cursorSeekRun(YLTextCursor *cursor, size_t index){
+    const YLTextSource *source = cursor->source;
+    if (source->runs == NULL || source->runCount == 0) {
+        return 0;
+    }
+    const YLTextStyleRun *run = &source->runs[cursor->runIndex];
+    if (index >= run->location && index < run->location + run->length) {
+        return cursor->runIndex;
+    }
+    if (cursor->runIndex + 1 < source->runCount && index >= run[1].location && index < run[1].location + run[1].length) {
+        return ++cursor->runIndex;
+    }
+    size_t low = 0, high = source->runCount;
+    while (low + 1 < high) {
+        size_t mid = low + (high - low) / 2;
+        if (source->runs[mid].location <= index) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    cursor->runIndex = low;
+    return low;
+}
+
+static YLTextStyleID cursorStyle(YLTextCursor *cursor, size_t index){
+    if (cursor->source->runs == NULL || cursor->source->runCount == 0) {
+        return 0;
+    }
+    return cursor->source->runs[cursorSeekRun(cursor, index)].style;
+}
+
+/// 样式段的结束位置
+static size_t cursorRunEnd(YLTextCursor *cursor, size_t index){
+    if (cursor->source->runs == NULL || cursor->source->runCount == 0) {
+        return cursor->source->length;
+    }
+    const YLTextStyleRun *run = &cursor->source->runs[cursorSeekRun(cursor, index)];
+    return run->location + run->length;
+}
+
+static double cursorAdvance(YLTextCursor *cursor, size_t index){
+    if (index < cursor->bufferStart || index >= cursor->bufferStart + cursor->bufferLength) {
+        const uint16_t *chars = cursor->source->chars;
+        size_t end = cursorRunEnd(cursor, index);
+        if (end > cursor->source->length) {
+            end = cursor->source->length;
+        }
+        size_t length = end - index;
+        if (length > YLTextCursorBufferSize) {
+            length = YLTextCursorBufferSize;
+        }
+        //不拆分代理对
+        if (length > 1 && index + length < cursor->source->length &&
+            chars[index + length - 1] >= 0xD800 && chars[index + length - 1] <= 0xDBFF) {
+            length--;
+        }
+        cursor->metrics->measure(cursor->metrics->context, cursorStyle(cursor, index), chars + index, length, cursor->advances);
+        cursor->bufferStart = index;
+        cursor->bufferLength = length;
+    }
+    return cursor->advances[index - cursor->bufferStart];
+}
+
+/// 读取 index 处的码点，units 返回占用的码元数
+static uint32_t decodeCharacter(const YLTextSource *source, size_t index, size_t limit, size_t *units){
+    uint32_t c = source->chars[index];
+    *units = 1;
+    if (c >= 0xD800 && c <= 0xDBFF && index + 1 < limit) {
+        uint32_t low = source->chars[index + 1];
+        if (low >= 0xDC00 && low <= 0xDFFF) {
+            *units = 2;
+            return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+        }
+    }
+    return c;
+}
+
+static void mergeFontMetrics(YLTextLine *line, YLTextFontMetrics font){
+    if (font.ascent > line->ascent) line->ascent = font.ascent;
+    if (font.descent > line->descent) line->descent = font.descent;
+    if (font.leading > line->leading) line->leading = font.leading;
+}
+
+
+// MARK: - 断行
+
+static size_t layoutLine(YLTextCursor *cursor, const YLTextLayoutConfig *config, size_t start, size_t limit, YLTextLine *line){
+    const YLTextSource *source = cursor->source;
+    const YLTextMetrics *metrics = cursor->metrics;
+
+    double width = 0;            //当前宽度（含空格）
+    double visibleWidth = 0;     //不含行尾空格的宽度
+    double attachmentHeight = 0; //附件最大高度
+
+    size_t breakIndex = start;   //最近的可断行位置
+    double breakWidth = 0;
+    double breakAttachmentHeight = 0;
+
+    size_t end = limit;
+    bool paragraphEnd = false;
+    YLBreakClass previous = YLBreakMandatory;
+
+    size_t i = start;
+    while (i < limit) {
+        size_t units;
+        uint32_t c = decodeCharacter(source, i, limit, &units);
+        YLBreakClass current = breakClass(c);
+
+        if (current == YLBreakMandatory) {
+            end = i + units;
+            if (c == '\r' && end < limit && source->chars[end] == '\n') {
+                end++;
+            }
+            paragraphEnd = (c != 0x2028);
+            break;
+        }
+        if (i > start && canBreakBetween(previous, current)) {
+            breakIndex = i;
+            breakWidth = visibleWidth;
+            breakAttachmentHeight = attachmentHeight;
+        }
+
+        double advance;
+        double height = 0;
+        if (c == YLTextAttachmentCharacter && metrics->attachmentSize) {
+            YLTextSize size = metrics->attachmentSize(metrics->context, i);
+            advance = size.width;
+            height = size.height;
+        } else {
+            advance = cursorAdvance(cursor, i);
+            if (units == 2) {
+                advance += cursorAdvance(cursor, i + 1);
+            }
+        }
+
+        //行尾空格悬挂，不会导致换行
+        if (current != YLBreakSpace && i > start && width + advance > config->width) {
+            if (breakIndex > start) {
+                end = breakIndex;
+                visibleWidth = breakWidth;
+                attachmentHeight = breakAttachmentHeight;
+            } else {
+                end = i;//没有可断行的位置，按字符强制断行
+            }
+            break;
+        }
+
+        width += advance;
+        if (current != YLBreakSpace) {
+            visibleWidth = width;
+        }
+        if (height > attachmentHeight) {
+            attachmentHeight = height;
+        }
+        previous = current;
+        i += units;
+    }
+
+    memset(line, 0, sizeof(YLTextLine));
+    line->location = start;
+    line->length = end - start;
+    line->width = visibleWidth;
+    line->paragraphEnd = paragraphEnd;
+
+    //行高取该行所有字体与附件的最大值
+    size_t index = start;
+    do {
+        mergeFontMetrics(line, metrics->fontMetrics(metrics->context, cursorStyle(cursor, index)));
+        index = cursorRunEnd(cursor, index);
+    } while (index < end);
+    if (attachmentHeight > line->ascent) {
+        line->ascent = attachmentHeight;
+    }
+    return end;
+}
+
+size_t YLTextLayoutLine(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t limit, YLTextLine *line){
+    YLTextCursor cursor;
+    cursorInit(&cursor, source, metrics);
+    return layoutLine(&cursor, config, start, limit, line);
+}
+
+
+// MARK: - 分页
+
+void YLTextLayoutResultInit(YLTextLayoutResult *result){
+    memset(result, 0, sizeof(YLTextLayoutResult));
+}
+
+void YLTextLayoutResultDestroy(YLTextLayoutResult *result){
+    free(result->pages);
+    free(result->lines);
+    memset(result, 0, sizeof(YLTextLayoutResult));
+}
+
+static bool appendPage(YLTextLayoutResult *result, const YLTextPage *page){
+    if (result->pageCount == result->pageCapacity) {
+        size_t capacity = result->pageCapacity ? result->pageCapacity * 2 : 64;
+        YLTextPage *pages = realloc(result->pages, capacity * sizeof(YLTextPage));
+        if (pages == NULL) {
+            return false;
+        }
+        result->pages = pages;
+        result->pageCapacity = capacity;
+    }
+    result->pages[result->pageCount++] = *page;
+    return true;
+}
+
+static bool appendLine(YLTextLayoutResult *result, const YLTextLine *line){
+    if (result->lineCount == result->lineCapacity) {
+        size_t capacity = result->lineCapacity ? result->lineCapacity * 2 : 256;
+        YLTextLine *lines = realloc(result->lines, capacity * sizeof(YLTextLine));
+        if (lines == NULL) {
+            return false;
+        }
+        result->lines = lines;
+        result->lineCapacity = capacity;
+    }
+    result->lines[result->lineCount++] = *line;
+    return true;
+}
+
+/// 将 [start, end) 分页，其间没有强制分页的位置
+static bool paginateSegment(YLTextCursor *cursor, const YLTextLayoutConfig *config, size_t start, size_t end, YLTextLayoutResult *result){
+    YLTextPage page = {start, 0, 0, 0, 0};
+    size_t lineIndex = 0;//所有页的行数之和，未保留行时用于计算 firstLine
+    if (result->pageCount > 0) {
+        const YLTextPage *last = &result->pages[result->pageCount - 1];
+        lineIndex = last->firstLine + last->lineCount;
+    }
+    page.firstLine = lineIndex;
+
+    double y = 0;
+    bool previousParagraphEnd = false;
+    size_t location = start;
+    while (location < end) {
+        YLTextLine line;
+        size_t next = layoutLine(cursor, config, location, end, &line);
+        double lineHeight = line.ascent + line.descent + line.leading;
+        double gap = 0;
+        if (page.lineCount > 0) {
+            gap = config->lineSpacing + (previousParagraphEnd ? config->paragraphSpacing : 0);
+            if (y + gap + lineHeight > config->height) {
+                //当前页放不下，换页
+                page.length = location - page.location;
+                page.contentHeight = y;
+                if (!appendPage(result, &page)) {
+                    return false;
+                }
+                page.location = location;
+                page.firstLine += page.lineCount;
+                page.lineCount = 0;
+                y = 0;
+                gap = 0;
+            }
+        }
+        line.top = y + gap;
+        y = line.top + lineHeight;
+        if (config->storesLines && !appendLine(result, &line)) {
+            return false;
+        }
+        page.lineCount++;
+        previousParagraphEnd = line.paragraphEnd;
+        location = next;
+    }
+    if (page.lineCount > 0) {
+        page.length = location - page.location;
+        page.contentHeight = y;
+        return appendPage(result, &page);
+    }
+    return true;
+}
+
+bool YLTextLayoutPaginate(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t end, YLTextLayoutResult *result){
+    if (end > source->length) {
+        end = source->length;
+    }
+    YLTextCursor cursor;
+    cursorInit(&cursor, source, metrics);
+
+    //跳过 start 之前的强制分页位置
+    size_t low = 0, high = config->pageBreakCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (config->pageBreaks[mid] <= start) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    size_t location = start;
+    for (size_t i = low; i < config->pageBreakCount && config->pageBreaks[i] < end; i++) {
+        if (!paginateSegment(&cursor, config, location, config->pageBreaks[i], result)) {
+            return false;
+        }
+        location = config->pageBreaks[i];
+    }
+    return paginateSegment(&cursor, config, location, end, result);
+}
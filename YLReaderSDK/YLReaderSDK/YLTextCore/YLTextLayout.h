@@ -0,0 +1,105 @@
+//
+//  YLTextLayout.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  可移植的断行与分页引擎（纯 C，不依赖 CoreText）
+//  文字位置均以 UTF-16 码元计，与 NSString / NSRange 一致
+//
+
+#ifndef YLTextLayout_h
+#define YLTextLayout_h
+
+#include "YLTextMetrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 一段样式相同的文字
+typedef struct YLTextStyleRun {
+    size_t location;
+    size_t length;
+    YLTextStyleID style;
+} YLTextStyleRun;
+
+/// 待排版的文本
+typedef struct YLTextSource {
+    const uint16_t *chars;
+    size_t length;
+    const YLTextStyleRun *runs; //按 location 升序且连续；为 NULL 时全文使用样式 0
+    size_t runCount;
+} YLTextSource;
+
+/// 排版参数
+typedef struct YLTextLayoutConfig {
+    double width;            //绘制区域宽度
+    double height;           //绘制区域高度
+    double lineSpacing;      //行间距
+    double paragraphSpacing; //段间距，加在段落最后一行之后
+    bool storesLines;        //是否在结果中保留每一行；只需要页码范围时可关闭以节省内存
+
+    const size_t *pageBreaks; //强制分页的位置（如章节标题的行首），升序排列，可为 NULL
+    size_t pageBreakCount;
+} YLTextLayoutConfig;
+
+/// 一行
+typedef struct YLTextLine {
+    size_t location;  //行首位置
+    size_t length;    //行长度，包含行尾空白与换行符
+    double width;     //行宽，不含行尾空白
+    double ascent;    //上行高度
+    double descent;   //下行高度
+    double leading;   //行距
+    double top;       //行顶部到页面顶部的距离
+    bool paragraphEnd;//该行以段落结束
+} YLTextLine;
+
+/// 一页
+typedef struct YLTextPage {
+    size_t location;
+    size_t length;
+    size_t firstLine;     //第一行在 YLTextLayoutResult.lines 中的下标
+    size_t lineCount;
+    double contentHeight; //内容高度
+} YLTextPage;
+
+/// 排版结果
+typedef struct YLTextLayoutResult {
+    YLTextPage *pages;
+    size_t pageCount;
+    size_t pageCapacity;
+
+    YLTextLine *lines; //仅当 YLTextLayoutConfig.storesLines 时填充
+    size_t lineCount;
+    size_t lineCapacity;
+} YLTextLayoutResult;
+
+void YLTextLayoutResultInit(YLTextLayoutResult *result);
+void YLTextLayoutResultDestroy(YLTextLayoutResult *result);
+
+
+/** 从 start 开始排版一行
+ * @param limit 排版不超过该位置
+ * @param line 输出该行的信息（top 为 0）
+ * @return 下一行的起始位置
+ * @note 断行规则：换行符强制断行；汉字、假名等全角字符两侧可断行；
+ *       空格之后可断行，行尾空格悬挂不计入行宽；
+ *       行首禁则（，。」等不出现在行首）与行尾禁则（「（等不出现在行尾）；
+ *       单词长于行宽时按字符强制断行
+ */
+size_t YLTextLayoutLine(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t limit, YLTextLine *line);
+
+/** 将 [start, end) 范围的文字分页，结果追加到 result 中
+ * 每页至少包含一行；单行高度超过页面高度时（如大图）独占一页；
+ * config.pageBreaks 中的位置总是从新的一页开始
+ * @return 内存分配失败时返回 false
+ */
+bool YLTextLayoutPaginate(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t end, YLTextLayoutResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextLayout_h */
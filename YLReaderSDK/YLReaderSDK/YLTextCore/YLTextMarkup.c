@@ -0,0 +1,110 @@
+//
+//  YLTextMarkup.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextMarkup.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+/// index 处是否为 keyword（ASCII 小写），不区分大小写
+static bool matchKeyword(const uint16_t *chars, size_t length, size_t index, const char *keyword){
+    for (; *keyword; keyword++, index++) {
+        if (index >= length) {
+            return false;
+        }
+        uint16_t c = chars[index];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != (uint8_t)*keyword) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 解析 WebLink 的 link= 与 title= 字段
+static void parseWebFields(const uint16_t *chars, size_t start, size_t end, YLTextMarkupToken *token){
+    size_t field = start;
+    while (field < end) {
+        //字段在下一个「,link=」或「,title=」处结束
+        size_t fieldEnd = field;
+        while (fieldEnd < end && !(chars[fieldEnd] == ',' &&
+                                   (matchKeyword(chars, end, fieldEnd + 1, "link=") || matchKeyword(chars, end, fieldEnd + 1, "title=")))) {
+            fieldEnd++;
+        }
+        YLTextMarkupRange *target = NULL;
+        size_t valueStart = field;
+        if (matchKeyword(chars, fieldEnd, field, "link=")) {
+            target = &token->link;
+            valueStart = field + 5;
+        } else if (matchKeyword(chars, fieldEnd, field, "title=")) {
+            target = &token->title;
+            valueStart = field + 6;
+        }
+        if (target) {
+            target->location = valueStart;
+            target->length = fieldEnd - valueStart;
+        }
+        field = fieldEnd + 1;
+    }
+}
+
+size_t YLTextMarkupScan(const uint16_t *chars, size_t length, YLTextMarkupToken **tokens){
+    *tokens = NULL;
+    size_t count = 0, capacity = 0;
+    size_t i = 0;
+    while (i < length) {
+        if (chars[i] != '<') {
+            i++;
+            continue;
+        }
+        YLTextMarkupKind kind;
+        size_t valueStart;
+        if (matchKeyword(chars, length, i + 1, "imagelink:")) {
+            kind = YLTextMarkupImageLink;
+            valueStart = i + 11;
+        } else if (matchKeyword(chars, length, i + 1, "weblink:")) {
+            kind = YLTextMarkupWebLink;
+            valueStart = i + 9;
+        } else {
+            i++;
+            continue;
+        }
+
+        size_t end = valueStart;
+        while (end < length && chars[end] != '>' && chars[end] != '\n' && chars[end] != '\r') {
+            end++;
+        }
+        if (end >= length || chars[end] != '>') {
+            //本行之后没有 >，从 i 到 end 之间开始的标签都不可能闭合
+            i = end;
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            YLTextMarkupToken *buffer = realloc(*tokens, capacity * sizeof(YLTextMarkupToken));
+            if (buffer == NULL) {
+                break;
+            }
+            *tokens = buffer;
+        }
+        YLTextMarkupToken *token = &(*tokens)[count++];
+        token->kind = kind;
+        token->range.location = i;
+        token->range.length = end + 1 - i;
+        token->value.location = valueStart;
+        token->value.length = end - valueStart;
+        token->link.location = token->title.location = valueStart;
+        token->link.length = token->title.length = 0;
+        if (kind == YLTextMarkupWebLink) {
+            parseWebFields(chars, valueStart, end, token);
+        }
+        i = end + 1;
+    }
+    return count;
+}
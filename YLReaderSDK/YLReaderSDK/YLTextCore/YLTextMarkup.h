@@ -0,0 +1,53 @@
+//
+//  YLTextMarkup.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  正文中内嵌标签的词法分析：
+//    <ImageLink:图片地址>
+//    <WebLink:link=网页地址,title=标题>
+//  一次线性扫描找出全部标签，标签不跨行，标签名不区分大小写。
+//
+
+#ifndef YLTextMarkup_h
+#define YLTextMarkup_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum YLTextMarkupKind {
+    YLTextMarkupImageLink = 0,
+    YLTextMarkupWebLink,
+} YLTextMarkupKind;
+
+typedef struct YLTextMarkupRange {
+    size_t location;
+    size_t length;
+} YLTextMarkupRange;
+
+/// 一个标签，位置均以 UTF-16 码元计
+typedef struct YLTextMarkupToken {
+    YLTextMarkupKind kind;
+    YLTextMarkupRange range; //整个标签，包含 < 与 >
+    YLTextMarkupRange value; //标签名之后、> 之前的内容；ImageLink 即图片地址
+    YLTextMarkupRange link;  //WebLink 的 link 字段，不存在时 length 为 0
+    YLTextMarkupRange title; //WebLink 的 title 字段，不存在时 length 为 0
+} YLTextMarkupToken;
+
+/** 扫描文本中的全部标签
+ * WebLink 的字段以逗号分隔，只有逗号之后紧跟 link= 或 title= 时才视为字段分隔，因此地址与标题中可以包含逗号
+ * @param tokens 输出按位置升序排列的标签，需调用方 free；没有标签时为 NULL
+ * @return 标签数量
+ */
+size_t YLTextMarkupScan(const uint16_t *chars, size_t length, YLTextMarkupToken **tokens);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextMarkup_h */
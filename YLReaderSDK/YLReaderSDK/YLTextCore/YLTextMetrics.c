@@ -0,0 +1,104 @@
+//
+//  YLTextMetrics.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextMetrics.h"
+
+bool YLTextIsWideCharacter(uint32_t codePoint){
+    if (codePoint < 0x1100) {
+        return false;
+    }
+    return (codePoint <= 0x115F) ||                          //谚文字母
+           (codePoint >= 0x2E80 && codePoint <= 0x303E) ||   //CJK 部首、标点、全角空格
+           (codePoint >= 0x3041 && codePoint <= 0x33FF) ||   //假名、注音、CJK 兼容字符
+           (codePoint >= 0x3400 && codePoint <= 0x4DBF) ||   //CJK 扩展 A
+           (codePoint >= 0x4E00 && codePoint <= 0x9FFF) ||   //CJK 统一汉字
+           (codePoint >= 0xA000 && codePoint <= 0xA4CF) ||   //彝文
+           (codePoint >= 0xAC00 && codePoint <= 0xD7A3) ||   //谚文音节
+           (codePoint >= 0xF900 && codePoint <= 0xFAFF) ||   //CJK 兼容汉字
+           (codePoint >= 0xFE30 && codePoint <= 0xFE4F) ||   //CJK 兼容形式
+           (codePoint >= 0xFF00 && codePoint <= 0xFF60) ||   //全角 ASCII
+           (codePoint >= 0xFFE0 && codePoint <= 0xFFE6) ||   //全角符号
+           (codePoint >= 0x20000 && codePoint <= 0x3FFFD);   //CJK 扩展 B 及以后
+}
+
+
+// MARK: - 固定度量表
+
+void YLFixedTextStyleInit(YLFixedTextStyle *style, double fontSize){
+    style->font.ascent = fontSize * 0.8;
+    style->font.descent = fontSize * 0.2;
+    style->font.leading = 0;
+    for (int i = 0; i < 128; i++) {
+        style->asciiAdvances[i] = (i < 0x20 || i == 0x7F) ? 0 : fontSize * 0.5;
+    }
+    style->wideAdvance = fontSize;
+    style->defaultAdvance = fontSize * 0.5;
+}
+
+static const YLFixedTextStyle *fixedStyle(const YLFixedTextMetrics *fixed, YLTextStyleID style){
+    if (fixed->styleCount == 0) {
+        return NULL;
+    }
+    return &fixed->styles[style < fixed->styleCount ? style : 0];
+}
+
+static void fixedMeasure(void *context, YLTextStyleID styleID, const uint16_t *chars, size_t length, double *advances){
+    const YLFixedTextStyle *style = fixedStyle(context, styleID);
+    for (size_t i = 0; i < length; i++) {
+        uint32_t c = chars[i];
+        if (style == NULL) {
+            advances[i] = 0;
+            continue;
+        }
+        if (c < 128) {
+            advances[i] = style->asciiAdvances[c];
+            continue;
+        }
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < length && chars[i + 1] >= 0xDC00 && chars[i + 1] <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+            advances[i] = YLTextIsWideCharacter(c) ? style->wideAdvance : style->defaultAdvance;
+            advances[++i] = 0;
+            continue;
+        }
+        advances[i] = YLTextIsWideCharacter(c) ? style->wideAdvance : style->defaultAdvance;
+    }
+}
+
+static YLTextFontMetrics fixedFontMetrics(void *context, YLTextStyleID styleID){
+    const YLFixedTextStyle *style = fixedStyle(context, styleID);
+    if (style == NULL) {
+        YLTextFontMetrics empty = {0, 0, 0};
+        return empty;
+    }
+    return style->font;
+}
+
+static YLTextSize fixedAttachmentSize(void *context, size_t index){
+    const YLFixedTextMetrics *fixed = context;
+    size_t low = 0, high = fixed->attachmentCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (fixed->attachments[mid].index < index) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < fixed->attachmentCount && fixed->attachments[low].index == index) {
+        return fixed->attachments[low].size;
+    }
+    return fixed->defaultAttachmentSize;
+}
+
+YLTextMetrics YLFixedTextMetricsMake(const YLFixedTextMetrics *fixed){
+    YLTextMetrics metrics;
+    metrics.context = (void *)fixed;
+    metrics.measure = fixedMeasure;
+    metrics.fontMetrics = fixedFontMetrics;
+    metrics.attachmentSize = fixedAttachmentSize;
+    return metrics;
+}
@@ -0,0 +1,103 @@
+//
+//  YLTextMetrics.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  排版引擎的字形度量接口：引擎只通过这里的回调测量文字，不依赖任何平台框架；
+//  iOS 上由 YLCoreTextMetrics 基于 CoreText 实现，测试与服务端使用下面的固定度量表实现。
+//
+
+#ifndef YLTextMetrics_h
+#define YLTextMetrics_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 对象替换符：富文本中图片等附件的占位字符
+#define YLTextAttachmentCharacter 0xFFFC
+
+/// 文本样式（字体）标识，由度量接口的实现方自行分配
+typedef uint32_t YLTextStyleID;
+
+typedef struct YLTextSize {
+    double width;
+    double height;
+} YLTextSize;
+
+/// 字体的行度量
+typedef struct YLTextFontMetrics {
+    double ascent;  //上行高度
+    double descent; //下行高度
+    double leading; //行距
+} YLTextFontMetrics;
+
+/// 字形度量接口
+typedef struct YLTextMetrics {
+    void *context;
+
+    /** 批量测量字符宽度
+     * @param chars UTF-16 码元，同一批次内样式相同
+     * @param advances 输出每个码元的前进宽度；代理对的低位码元写 0
+     */
+    void (*measure)(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances);
+
+    /// 获取字体的行度量
+    YLTextFontMetrics (*fontMetrics)(void *context, YLTextStyleID style);
+
+    /** 获取占位附件（0xFFFC）的尺寸，可为 NULL
+     * @param index 占位符在全文中的位置
+     * @note 与 CTRunDelegate 的回调一致：上行高度为 height，下行高度为 0
+     */
+    YLTextSize (*attachmentSize)(void *context, size_t index);
+} YLTextMetrics;
+
+
+/// 是否为东亚全角字符（汉字、假名、谚文、全角标点等）
+bool YLTextIsWideCharacter(uint32_t codePoint);
+
+
+// MARK: - 固定度量表
+
+/// 固定度量表中的一种样式
+typedef struct YLFixedTextStyle {
+    YLTextFontMetrics font;
+    double asciiAdvances[128]; //ASCII 字符宽度，按码位直接索引
+    double wideAdvance;        //东亚全角字符宽度
+    double defaultAdvance;     //其它字符宽度
+} YLFixedTextStyle;
+
+/// 指定位置附件的尺寸
+typedef struct YLFixedTextAttachment {
+    size_t index;
+    YLTextSize size;
+} YLFixedTextAttachment;
+
+/// 表驱动的固定度量：不依赖字体文件，用于测试与 Linux 上的页数预计算
+typedef struct YLFixedTextMetrics {
+    const YLFixedTextStyle *styles;
+    size_t styleCount;
+
+    const YLFixedTextAttachment *attachments; //按 index 升序排列，可为 NULL
+    size_t attachmentCount;
+    YLTextSize defaultAttachmentSize;         //不在 attachments 中的附件使用该尺寸
+} YLFixedTextMetrics;
+
+/** 按字号生成一个等宽样式
+ * ASCII 字符宽度为字号的一半，全角字符宽度等于字号，上行高度 0.8 倍字号，下行高度 0.2 倍字号
+ */
+void YLFixedTextStyleInit(YLFixedTextStyle *style, double fontSize);
+
+/// 以固定度量表创建度量接口；fixed 的生命周期需长于返回的接口
+YLTextMetrics YLFixedTextMetricsMake(const YLFixedTextMetrics *fixed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextMetrics_h */
@@ -0,0 +1,244 @@
+//
+//  YLTextParallelLayout.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextParallelLayout.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// 每个任务至少包含的码元数，避免章节过短时线程调度的开销超过排版本身
+#define YLTextParallelMinTaskLength 4096
+
+// MARK: - 强制分页位置
+
+static bool isIndentCharacter(uint16_t c){
+    return c == ' ' || c == '\t' || c == 0x3000 || c == 0x00A0;
+}
+
+bool YLTextIsChapterNumeral(uint32_t codePoint){
+    if (codePoint >= '0' && codePoint <= '9') {
+        return true;
+    }
+    if (codePoint >= 0xFF10 && codePoint <= 0xFF19) {//全角数字
+        return true;
+    }
+    switch (codePoint) {
+        case 0x96F6: case 0x3007: case 0x4E00: case 0x4E8C: case 0x4E24: case 0x4E09: case 0x56DB: //零〇一二两三四
+        case 0x4E94: case 0x516D: case 0x4E03: case 0x516B: case 0x4E5D: case 0x5341: case 0x767E: //五六七八九十百
+        case 0x5343: case 0x4E07: case 0x58F9: case 0x8D30: case 0x53C1: case 0x8086: case 0x4F0D: //千万壹贰叁肆伍
+        case 0x9646: case 0x67D2: case 0x634C: case 0x7396: case 0x62FE: case 0x4F70: case 0x4EDF: //陆柒捌玖拾佰仟
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool YLTextIsChapterUnit(uint32_t codePoint){
+    switch (codePoint) {
+        case 0x7AE0: case 0x56DE: case 0x8282: case 0x5377: case 0x90E8: case 0x7BC7: case 0x96C6: //章回节卷部篇集
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// location 处的段落是否为章节标题
+static bool isChapterHeading(const uint16_t *chars, size_t location, size_t end){
+    while (location < end && isIndentCharacter(chars[location])) {
+        location++;
+    }
+    if (location >= end || chars[location] != 0x7B2C) {//第
+        return false;
+    }
+    size_t numerals = 0;
+    while (++location < end && YLTextIsChapterNumeral(chars[location])) {
+        numerals++;
+    }
+    return numerals > 0 && location < end && YLTextIsChapterUnit(chars[location]);
+}
+
+bool YLTextFindPageBreaks(const YLTextSource *source, size_t start, size_t end, size_t **breaks, size_t *count){
+    *breaks = NULL;
+    *count = 0;
+    if (end > source->length) {
+        end = source->length;
+    }
+    const uint16_t *chars = source->chars;
+    size_t capacity = 0;
+    bool paragraphStart = true;
+    bool afterFormFeed = false;
+    for (size_t i = start; i < end; i++) {
+        if (paragraphStart && i > start && (afterFormFeed || isChapterHeading(chars, i, end))) {
+            if (*count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                size_t *buffer = realloc(*breaks, capacity * sizeof(size_t));
+                if (buffer == NULL) {
+                    //缺少分页位置的结果与顺序分页不一致，不返回
+                    free(*breaks);
+                    *breaks = NULL;
+                    *count = 0;
+                    return false;
+                }
+                *breaks = buffer;
+            }
+            (*breaks)[(*count)++] = i;
+        }
+        uint16_t c = chars[i];
+        paragraphStart = (c == '\n' || c == 0x0C || c == 0x2029 || (c == '\r' && (i + 1 >= end || chars[i + 1] != '\n')));
+        if (paragraphStart) {
+            afterFormFeed = (c == 0x0C);
+        }
+    }
+    return true;
+}
+
+
+// MARK: - 并行分页
+
+/// 一个分页任务：连续的若干章节
+typedef struct YLTextLayoutTask {
+    size_t start;
+    size_t end;
+    YLTextLayoutResult result;
+} YLTextLayoutTask;
+
+typedef struct YLTextLayoutJob {
+    const YLTextSource *source;
+    const YLTextMetrics *metrics;
+    const YLTextLayoutConfig *config;
+    YLTextLayoutTask *tasks;
+    size_t taskCount;
+    atomic_size_t nextTask;
+    atomic_bool failed;
+} YLTextLayoutJob;
+
+static void *layoutWorker(void *argument){
+    YLTextLayoutJob *job = argument;
+    size_t index;
+    while ((index = atomic_fetch_add(&job->nextTask, 1)) < job->taskCount) {
+        YLTextLayoutTask *task = &job->tasks[index];
+        if (!YLTextLayoutPaginate(job->source, job->metrics, job->config, task->start, task->end, &task->result)) {
+            atomic_store(&job->failed, true);
+        }
+    }
+    return NULL;
+}
+
+/// 按顺序把各任务的结果拼接到 result 中，修正 firstLine
+static bool stitchResults(YLTextLayoutTask *tasks, size_t taskCount, YLTextLayoutResult *result){
+    size_t pageCount = result->pageCount, lineCount = result->lineCount;
+    for (size_t i = 0; i < taskCount; i++) {
+        pageCount += tasks[i].result.pageCount;
+        lineCount += tasks[i].result.lineCount;
+    }
+    if (pageCount > result->pageCapacity) {
+        YLTextPage *pages = realloc(result->pages, pageCount * sizeof(YLTextPage));
+        if (pages == NULL) {
+            return false;
+        }
+        result->pages = pages;
+        result->pageCapacity = pageCount;
+    }
+    if (lineCount > result->lineCapacity) {
+        YLTextLine *lines = realloc(result->lines, lineCount * sizeof(YLTextLine));
+        if (lines == NULL) {
+            return false;
+        }
+        result->lines = lines;
+        result->lineCapacity = lineCount;
+    }
+
+    for (size_t i = 0; i < taskCount; i++) {
+        const YLTextLayoutResult *part = &tasks[i].result;
+        size_t lineBase = 0;
+        if (result->pageCount > 0) {
+            const YLTextPage *last = &result->pages[result->pageCount - 1];
+            lineBase = last->firstLine + last->lineCount;
+        }
+        for (size_t j = 0; j < part->pageCount; j++) {
+            YLTextPage page = part->pages[j];
+            page.firstLine += lineBase;
+            result->pages[result->pageCount++] = page;
+        }
+        if (part->lineCount > 0) {
+            memcpy(result->lines + result->lineCount, part->lines, part->lineCount * sizeof(YLTextLine));
+            result->lineCount += part->lineCount;
+        }
+    }
+    return true;
+}
+
+bool YLTextLayoutPaginateParallel(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t end, size_t threadCount, YLTextLayoutResult *result){
+    if (end > source->length) {
+        end = source->length;
+    }
+    if (threadCount == 0) {
+        long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = cpuCount > 0 ? (size_t)cpuCount : 1;
+    }
+    if (threadCount <= 1 || config->pageBreakCount == 0 || end <= start) {
+        return YLTextLayoutPaginate(source, metrics, config, start, end, result);
+    }
+
+    //在强制分页位置切块，过短的章节与后面的合并
+    size_t minLength = (end - start) / (threadCount * 8);
+    if (minLength < YLTextParallelMinTaskLength) {
+        minLength = YLTextParallelMinTaskLength;
+    }
+    YLTextLayoutTask *tasks = calloc(config->pageBreakCount + 1, sizeof(YLTextLayoutTask));
+    if (tasks == NULL) {
+        return false;
+    }
+    size_t taskCount = 0;
+    size_t taskStart = start;
+    for (size_t i = 0; i < config->pageBreakCount; i++) {
+        size_t position = config->pageBreaks[i];
+        if (position <= taskStart || position >= end || position - taskStart < minLength) {
+            continue;
+        }
+        tasks[taskCount].start = taskStart;
+        tasks[taskCount++].end = position;
+        taskStart = position;
+    }
+    tasks[taskCount].start = taskStart;
+    tasks[taskCount++].end = end;
+
+    YLTextLayoutJob job;
+    job.source = source;
+    job.metrics = metrics;
+    job.config = config;
+    job.tasks = tasks;
+    job.taskCount = taskCount;
+    atomic_init(&job.nextTask, 0);
+    atomic_init(&job.failed, false);
+
+    if (threadCount > taskCount) {
+        threadCount = taskCount;
+    }
+    pthread_t *threads = malloc((threadCount - 1) * sizeof(pthread_t) + 1);
+    size_t started = 0;
+    if (threads) {
+        while (started < threadCount - 1 && pthread_create(&threads[started], NULL, layoutWorker, &job) == 0) {
+            started++;
+        }
+    }
+    //当前线程同样参与排版；线程创建失败时由当前线程完成剩余任务
+    layoutWorker(&job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    bool success = !atomic_load(&job.failed) && stitchResults(tasks, taskCount, result);
+    for (size_t i = 0; i < taskCount; i++) {
+        YLTextLayoutResultDestroy(&tasks[i].result);
+    }
+    free(tasks);
+    return success;
+}
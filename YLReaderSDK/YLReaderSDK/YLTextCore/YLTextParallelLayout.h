@@ -0,0 +1,47 @@
+//
+//  YLTextParallelLayout.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  章节级并行分页：强制分页位置两侧的排版互不影响，
+//  因此在这些位置把文本切成若干块，多线程分别分页后按顺序拼接，结果与顺序分页完全一致。
+//
+
+#ifndef YLTextParallelLayout_h
+#define YLTextParallelLayout_h
+
+#include "YLTextLayout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 是否为章节序号中的字符：阿拉伯数字、全角数字、中文数字（含大写）
+bool YLTextIsChapterNumeral(uint32_t codePoint);
+
+/// 是否为章节单位：章、回、节、卷、部、篇、集
+bool YLTextIsChapterUnit(uint32_t codePoint);
+
+/** 查找 [start, end) 中应当强制分页的位置
+ * 包括：以「第…章/回/节/卷/部/篇/集」开头的段落（允许行首缩进），以及换页符（0x0C）之后的段落
+ * 空行不是强制分页位置：空行之后的段落通常与前文同页，作为分页位置会改变顺序分页的结果
+ * @param breaks 输出升序排列的位置，需调用方 free；没有时为 NULL
+ * @param count 输出位置数量
+ * @return 内存分配失败时返回 false，此时 breaks 为 NULL、count 为 0
+ */
+bool YLTextFindPageBreaks(const YLTextSource *source, size_t start, size_t end, size_t **breaks, size_t *count);
+
+/** 多线程分页，结果追加到 result 中，与 YLTextLayoutPaginate 的结果完全一致
+ * 文本在 config.pageBreaks 处切块，没有强制分页位置时退化为单线程
+ * @param threadCount 线程数；为 0 时使用 CPU 核数
+ * @note metrics 的回调会被多个线程同时调用，须可重入
+ * @return 内存分配或线程创建失败时返回 false
+ */
+bool YLTextLayoutPaginateParallel(const YLTextSource *source, const YLTextMetrics *metrics, const YLTextLayoutConfig *config, size_t start, size_t end, size_t threadCount, YLTextLayoutResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextParallelLayout_h */
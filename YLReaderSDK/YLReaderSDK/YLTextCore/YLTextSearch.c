@@ -0,0 +1,416 @@
+//
+//  YLTextSearch.c
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+
+#include "YLTextSearch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define YLTextSearchMagic "YLSI"
+#define YLTextSearchVersion 1
+
+struct YLTextSearchIndex {
+    uint16_t *text; //归一化后的全文
+    size_t length;
+    size_t capacity;
+
+    bool finished;
+    uint32_t *keys;     //升序排列的 bigram
+    size_t keyCount;
+    uint32_t *starts;   //keys[i] 的倒排表为 postings[starts[i] ..< starts[i + 1]]
+    uint32_t *postings; //每个 bigram 出现的位置，升序
+};
+
+/// 文件头，之后依次为 text、keys、starts、postings；按本机字节序存储
+typedef struct YLTextSearchHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t stamp;
+    uint64_t length;
+    uint64_t keyCount;
+} YLTextSearchHeader;
+
+// MARK: - 归一化
+
+/// ASCII 字母转为小写，全角字母数字转为半角
+static inline uint16_t normalizeCharacter(uint16_t c){
+    if (c >= 0xFF01 && c <= 0xFF5E) {
+        c = (uint16_t)(c - 0xFF01 + 0x21);
+    }
+    if (c >= 'A' && c <= 'Z') {
+        c += 'a' - 'A';
+    }
+    return c;
+}
+
+static inline uint32_t bigramAt(const uint16_t *text, size_t i){
+    return ((uint32_t)text[i] << 16) | text[i + 1];
+}
+
+// MARK: - 创建
+
+YLTextSearchIndex *YLTextSearchIndexCreate(void){
+    return calloc(1, sizeof(YLTextSearchIndex));
+}
+
+void YLTextSearchIndexDestroy(YLTextSearchIndex *index){
+    if (index == NULL) {
+        return;
+    }
+    free(index->text);
+    free(index->keys);
+    free(index->starts);
+    free(index->postings);
+    free(index);
+}
+
+bool YLTextSearchIndexAppend(YLTextSearchIndex *index, const uint16_t *chars, size_t length){
+    if (index->finished || length > UINT32_MAX - index->length) {
+        return false;
+    }
+    if (index->length + length > index->capacity) {
+        size_t capacity = index->capacity ? index->capacity : 4096;
+        while (capacity < index->length + length) {
+            capacity *= 2;
+        }
+        uint16_t *text = realloc(index->text, capacity * sizeof(uint16_t));
+        if (text == NULL) {
+            return false;
+        }
+        index->text = text;
+        index->capacity = capacity;
+    }
+    uint16_t *text = index->text + index->length;
+    for (size_t i = 0; i < length; i++) {
+        text[i] = normalizeCharacter(chars[i]);
+    }
+    index->length += length;
+    return true;
+}
+
+size_t YLTextSearchIndexLength(const YLTextSearchIndex *index){
+    return index->length;
+}
+
+// MARK: - 建立倒排表
+
+/// bigram → 计数（建表时）或 keys 中的位置 + 1（填充倒排表时）；value 为 0 表示空位
+typedef struct YLBigramTable {
+    uint32_t *keys;
+    uint32_t *values;
+    size_t mask;
+    size_t count;
+} YLBigramTable;
+
+static inline size_t hashBigram(uint32_t key, size_t mask){
+    return (size_t)((key * 2654435761u) ^ (key >> 15)) & mask;
+}
+
+static bool tableInit(YLBigramTable *table, size_t capacity){
+    table->keys = malloc(capacity * sizeof(uint32_t));
+    table->values = calloc(capacity, sizeof(uint32_t));
+    table->mask = capacity - 1;
+    table->count = 0;
+    return table->keys && table->values;
+}
+
+static void tableDestroy(YLBigramTable *table){
+    free(table->keys);
+    free(table->values);
+}
+
+static inline uint32_t *tableSlot(const YLBigramTable *table, uint32_t key){
+    size_t i = hashBigram(key, table->mask);
+    while (table->values[i] != 0 && table->keys[i] != key) {
+        i = (i + 1) & table->mask;
+    }
+    return &table->values[i];
+}
+
+static bool tableGrow(YLBigramTable *table){
+    YLBigramTable larger;
+    if (!tableInit(&larger, (table->mask + 1) * 2)) {
+        tableDestroy(&larger);
+        return false;
+    }
+    for (size_t i = 0; i <= table->mask; i++) {
+        if (table->values[i] == 0) {
+            continue;
+        }
+        uint32_t *value = tableSlot(&larger, table->keys[i]);
+        larger.keys[value - larger.values] = table->keys[i];
+        *value = table->values[i];
+    }
+    larger.count = table->count;
+    tableDestroy(table);
+    *table = larger;
+    return true;
+}
+
+static int compareKeys(const void *a, const void *b){
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+bool YLTextSearchIndexFinish(YLTextSearchIndex *index){
+    if (index->finished) {
+        return true;
+    }
+    if (index->text == NULL && (index->text = malloc(sizeof(uint16_t))) == NULL) {
+        return false;
+    }
+    size_t bigramCount = index->length > 1 ? index->length - 1 : 0;
+    YLBigramTable table;
+    if (!tableInit(&table, 1 << 12)) {
+        tableDestroy(&table);
+        return false;
+    }
+    //第一遍：统计每个 bigram 的出现次数
+    for (size_t i = 0; i < bigramCount; i++) {
+        uint32_t key = bigramAt(index->text, i);
+        uint32_t *value = tableSlot(&table, key);
+        if (*value == 0) {
+            if ((table.count + 1) * 2 > table.mask + 1) {
+                if (!tableGrow(&table)) {
+                    tableDestroy(&table);
+                    return false;
+                }
+                value = tableSlot(&table, key);
+            }
+            table.keys[value - table.values] = key;
+            table.count++;
+        }
+        (*value)++;
+    }
+
+    index->keyCount = table.count;
+    index->keys = malloc((table.count ? table.count : 1) * sizeof(uint32_t));
+    index->starts = malloc((table.count + 1) * sizeof(uint32_t));
+    index->postings = malloc((bigramCount ? bigramCount : 1) * sizeof(uint32_t));
+    uint32_t *cursors = malloc((table.count ? table.count : 1) * sizeof(uint32_t));
+    if (index->keys == NULL || index->starts == NULL || index->postings == NULL || cursors == NULL) {
+        free(cursors);
+        tableDestroy(&table);
+        return false;
+    }
+    size_t keyCount = 0;
+    for (size_t i = 0; i <= table.mask; i++) {
+        if (table.values[i] != 0) {
+            index->keys[keyCount++] = table.keys[i];
+        }
+    }
+    qsort(index->keys, keyCount, sizeof(uint32_t), compareKeys);
+
+    //计数换成 keys 中的位置，并计算每个倒排表的起点
+    uint32_t start = 0;
+    for (size_t i = 0; i < keyCount; i++) {
+        uint32_t *value = tableSlot(&table, index->keys[i]);
+        index->starts[i] = start;
+        cursors[i] = start;
+        start += *value;
+        *value = (uint32_t)i + 1;
+    }
+    index->starts[keyCount] = start;
+
+    //第二遍：按位置顺序填充，倒排表自然有序
+    for (size_t i = 0; i < bigramCount; i++) {
+        uint32_t slot = *tableSlot(&table, bigramAt(index->text, i)) - 1;
+        index->postings[cursors[slot]++] = (uint32_t)i;
+    }
+    free(cursors);
+    tableDestroy(&table);
+    index->finished = true;
+    return true;
+}
+
+// MARK: - 查询
+
+/// 二分查找 bigram，返回在 keys 中的位置，不存在时返回 keyCount
+static size_t findKey(const YLTextSearchIndex *index, uint32_t key){
+    size_t low = 0, high = index->keyCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (index->keys[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < index->keyCount && index->keys[low] == key) ? low : index->keyCount;
+}
+
+size_t YLTextSearchIndexFind(const YLTextSearchIndex *index, const uint16_t *query, size_t queryLength, size_t from, size_t *hits, size_t maxHits){
+    if (!index->finished || queryLength == 0 || maxHits == 0 || queryLength > index->length) {
+        return 0;
+    }
+    uint16_t stackQuery[64];
+    uint16_t *normalized = queryLength <= 64 ? stackQuery : malloc(queryLength * sizeof(uint16_t));
+    if (normalized == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < queryLength; i++) {
+        normalized[i] = normalizeCharacter(query[i]);
+    }
+
+    size_t count = 0;
+    const uint16_t *text = index->text;
+    size_t last = index->length - queryLength;//最后一个可能的起点
+    if (queryLength == 1) {
+        //单个字符没有 bigram，直接扫描
+        for (size_t i = from; i <= last && count < maxHits; i++) {
+            if (text[i] == normalized[0]) {
+                hits[count++] = i;
+            }
+        }
+    } else {
+        //选出现次数最少的 bigram，它在查询串中的偏移为 shift
+        size_t best = index->keyCount, shift = 0;
+        uint32_t bestCount = UINT32_MAX;
+        for (size_t j = 0; j + 1 < queryLength; j++) {
+            size_t key = findKey(index, bigramAt(normalized, j));
+            if (key == index->keyCount) {
+                best = key;
+                break;//有 bigram 从未出现，不可能匹配
+            }
+            uint32_t keyCount = index->starts[key + 1] - index->starts[key];
+            if (keyCount < bestCount) {
+                bestCount = keyCount;
+                best = key;
+                shift = j;
+            }
+        }
+        if (best < index->keyCount) {
+            const uint32_t *postings = index->postings + index->starts[best];
+            size_t postingCount = index->starts[best + 1] - index->starts[best];
+            //跳过起点小于 from 的候选
+            size_t low = 0, high = postingCount;
+            while (low < high) {
+                size_t mid = low + (high - low) / 2;
+                if (postings[mid] < from + shift) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            for (size_t i = low; i < postingCount && count < maxHits; i++) {
+                if (postings[i] < shift) {
+                    continue;
+                }
+                size_t start = postings[i] - shift;
+                if (start > last) {
+                    break;
+                }
+                if (memcmp(text + start, normalized, queryLength * sizeof(uint16_t)) == 0) {
+                    hits[count++] = start;
+                }
+            }
+        }
+    }
+    if (normalized != stackQuery) {
+        free(normalized);
+    }
+    return count;
+}
+
+// MARK: - 读写
+
+bool YLTextSearchIndexWrite(const YLTextSearchIndex *index, const char *path, uint64_t stamp){
+    if (!index->finished) {
+        return false;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    YLTextSearchHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, YLTextSearchMagic, 4);
+    header.version = YLTextSearchVersion;
+    header.stamp = stamp;
+    header.length = index->length;
+    header.keyCount = index->keyCount;
+    size_t bigramCount = index->length > 1 ? index->length - 1 : 0;
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(index->text, sizeof(uint16_t), index->length, file) == index->length &&
+        fwrite(index->keys, sizeof(uint32_t), index->keyCount, file) == index->keyCount &&
+        fwrite(index->starts, sizeof(uint32_t), index->keyCount + 1, file) == index->keyCount + 1 &&
+        fwrite(index->postings, sizeof(uint32_t), bigramCount, file) == bigramCount;
+    success = fclose(file) == 0 && success;
+    if (!success) {
+        remove(path);
+    }
+    return success;
+}
+
+/// 读入的倒排表须自洽：keys 严格递增，starts 单调且不超过 bigram 总数，位置都在正文之内
+static bool indexIsValid(const YLTextSearchIndex *index, size_t bigramCount){
+    if (index->starts[0] != 0 || index->starts[index->keyCount] != bigramCount) {
+        return false;
+    }
+    for (size_t i = 0; i < index->keyCount; i++) {
+        if (index->starts[i] > index->starts[i + 1] || (i > 0 && index->keys[i - 1] >= index->keys[i])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < bigramCount; i++) {
+        if (index->postings[i] >= bigramCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+YLTextSearchIndex *YLTextSearchIndexRead(const char *path, uint64_t stamp){
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    YLTextSearchHeader header;
+    long fileLength = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        fileLength = ftell(file);
+    }
+    if (fileLength < 0 || fseek(file, 0, SEEK_SET) != 0 ||
+        fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, YLTextSearchMagic, 4) != 0 || header.version != YLTextSearchVersion ||
+        header.stamp != stamp || header.length > UINT32_MAX || header.keyCount > header.length) {
+        fclose(file);
+        return NULL;
+    }
+    size_t length = (size_t)header.length;
+    size_t keyCount = (size_t)header.keyCount;
+    size_t bigramCount = length > 1 ? length - 1 : 0;
+    //分配之前先核对文件长度，避免按损坏的文件头申请内存
+    uint64_t expected = sizeof(header) + (uint64_t)length * sizeof(uint16_t) +
+        ((uint64_t)keyCount * 2 + 1 + bigramCount) * sizeof(uint32_t);
+    if ((uint64_t)fileLength != expected) {
+        fclose(file);
+        return NULL;
+    }
+    YLTextSearchIndex *index = YLTextSearchIndexCreate();
+    if (index) {
+        index->length = index->capacity = length;
+        index->keyCount = keyCount;
+        index->text = malloc((length ? length : 1) * sizeof(uint16_t));
+        index->keys = malloc((keyCount ? keyCount : 1) * sizeof(uint32_t));
+        index->starts = malloc((keyCount + 1) * sizeof(uint32_t));
+        index->postings = malloc((bigramCount ? bigramCount : 1) * sizeof(uint32_t));
+    }
+    bool success = index && index->text && index->keys && index->starts && index->postings &&
+        fread(index->text, sizeof(uint16_t), length, file) == length &&
+        fread(index->keys, sizeof(uint32_t), keyCount, file) == keyCount &&
+        fread(index->starts, sizeof(uint32_t), keyCount + 1, file) == keyCount + 1 &&
+        fread(index->postings, sizeof(uint32_t), bigramCount, file) == bigramCount &&
+        indexIsValid(index, bigramCount);
+    fclose(file);
+    if (!success) {
+        YLTextSearchIndexDestroy(index);
+        return NULL;
+    }
+    index->finished = true;
+    return index;
+}
@@ -0,0 +1,60 @@
+//
+//  YLTextSearch.h
+//  YLReaderSDK
+//
+//  Created by long on 2026/10/19.
+//
+//  全文检索索引：中文没有词边界，按相邻两个码元（bigram）建立倒排表。
+//  查询时取查询串中出现次数最少的 bigram，只校验它的倒排表中的候选位置；
+//  结果按位置升序返回，可以从上次的位置继续查询，便于分批输出。
+//  索引保存了归一化后的全文（ASCII 与全角字母数字不区分大小写与全半角），可以写入文件，与书籍放在一起。
+//
+
+#ifndef YLTextSearch_h
+#define YLTextSearch_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct YLTextSearchIndex YLTextSearchIndex;
+
+YLTextSearchIndex *YLTextSearchIndexCreate(void);
+void YLTextSearchIndexDestroy(YLTextSearchIndex *index);
+
+/** 按顺序追加文本，位置在所有追加的文本中连续计算
+ * @return 内存不足或总长度超过 UINT32_MAX 时返回 false
+ */
+bool YLTextSearchIndexAppend(YLTextSearchIndex *index, const uint16_t *chars, size_t length);
+
+/// 追加完成后建立倒排表；之后不能再追加
+bool YLTextSearchIndexFinish(YLTextSearchIndex *index);
+
+/// 已追加的文本长度（UTF-16 码元）
+size_t YLTextSearchIndexLength(const YLTextSearchIndex *index);
+
+/** 查找 query 出现的位置
+ * @param from 只返回不小于 from 的位置
+ * @param hits 输出按升序排列的位置
+ * @param maxHits hits 的容量；返回值等于 maxHits 时，可以从最后一个位置 + 1 继续查找
+ * @return 找到的数量；索引尚未建立时返回 0
+ */
+size_t YLTextSearchIndexFind(const YLTextSearchIndex *index, const uint16_t *query, size_t queryLength, size_t from, size_t *hits, size_t maxHits);
+
+/** 写入文件
+ * @param stamp 调用方定义的版本标记（如书籍的大小与修改时间），读取时用于判断索引是否过期
+ */
+bool YLTextSearchIndexWrite(const YLTextSearchIndex *index, const char *path, uint64_t stamp);
+
+/// 读取文件，文件不存在、损坏或 stamp 不一致时返回 NULL
+YLTextSearchIndex *YLTextSearchIndexRead(const char *path, uint64_t stamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YLTextSearch_h */
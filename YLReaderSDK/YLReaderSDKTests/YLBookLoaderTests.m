@@ -0,0 +1,116 @@
+//
+//  YLBookLoaderTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLBookLoader.h"
+#import "YLBookFile.h"
+
+@interface YLBookLoaderTests : XCTestCase
+
+@property (nonatomic, copy) NSString *path;
+
+@end
+
+@implementation YLBookLoaderTests
+
+- (void)setUp {
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YLBookLoaderTests.txt"];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtPath:self.path error:nil];
+}
+
+- (void)writeBookWithText:(NSString *)text {
+    NSMutableData *data = [NSMutableData dataWithBytes:"\xEF\xBB\xBF" length:3];
+    [data appendData:[text dataUsingEncoding:NSUTF8StringEncoding]];
+    [data writeToFile:self.path atomically:YES];
+}
+
+- (void)testChaptersCoverWholeBook {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 40; i++) {
+        [text appendFormat:@"　　第%lu章 标题\n", (unsigned long)i + 1];
+        for (NSUInteger j = 0; j < 200; j++) {
+            [text appendString:@"　　夜已深，漆黑一片😀，景物不可见。Mountain\n"];
+        }
+    }
+    [self writeBookWithText:text];
+
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    XCTAssertNotNil(loader);
+    XCTAssertEqual(loader.contentStart, 3);
+
+    NSMutableString *joined = [NSMutableString string];
+    NSUInteger chapterCount = 0;
+    NSUInteger byteOffset = loader.contentStart;
+    YLBookChapter *chapter;
+    while ((chapter = [loader chapterAtByteOffset:byteOffset])) {
+        XCTAssertEqual(chapter.byteRange.location, byteOffset);
+        XCTAssertEqual(chapter.characterRange.location, joined.length);
+        XCTAssertTrue([chapter.text hasPrefix:@"　　第"]);
+        XCTAssertEqual([loader byteOffsetForCharacterOffset:chapter.characterRange.location], byteOffset);
+        [joined appendString:chapter.text];
+        byteOffset = NSMaxRange(chapter.byteRange);
+        chapterCount++;
+    }
+    XCTAssertEqual(chapterCount, 40);
+    XCTAssertEqualObjects(joined, text);
+    XCTAssertEqual([loader characterOffsetForByteOffset:loader.byteLength], text.length);
+}
+
+- (void)testLongChapterIsSplitAtParagraph {
+    NSMutableString *text = [NSMutableString string];
+    while (text.length < YLBookFileDefaultChapterLength) {
+        [text appendString:@"没有章节标题的长文本，按段落切分。\n"];
+    }
+    [self writeBookWithText:text];
+
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    YLBookChapter *chapter = [loader chapterAtByteOffset:0];
+    XCTAssertLessThanOrEqual(chapter.byteRange.length, YLBookFileDefaultChapterLength);
+    XCTAssertTrue([chapter.text hasSuffix:@"\n"]);
+    YLBookChapter *next = [loader chapterAtByteOffset:NSMaxRange(chapter.byteRange)];
+    XCTAssertEqual(next.characterRange.location, NSMaxRange(chapter.characterRange));
+}
+
+- (void)testOffsetsInsideMultibyteCharacter {
+    [self writeBookWithText:@"a中b"];
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    XCTAssertEqual([loader characterOffsetForByteOffset:4], 1);
+    XCTAssertEqual([loader characterOffsetForByteOffset:5], 1);
+    XCTAssertEqual([loader characterOffsetForByteOffset:7], 2);
+    XCTAssertEqual([loader byteOffsetForCharacterOffset:2], 7);
+}
+
+- (void)testGB18030Book {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 3; i++) {
+        [text appendFormat:@"　　第%lu章 标题\n　　夜已深，漆黑一片😀，景物不可见。\n", (unsigned long)i + 1];
+    }
+    NSStringEncoding encoding = CFStringConvertEncodingToNSStringEncoding(kCFStringEncodingGB_18030_2000);
+    [[text dataUsingEncoding:encoding] writeToFile:self.path atomically:YES];
+
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    XCTAssertEqual(loader.sourceEncoding, encoding);
+    XCTAssertEqual(loader.contentStart, 0);
+    XCTAssertEqual(loader.byteLength, [text lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    NSMutableString *joined = [NSMutableString string];
+    YLBookChapter *chapter;
+    NSUInteger byteOffset = 0;
+    while ((chapter = [loader chapterAtByteOffset:byteOffset])) {
+        [joined appendString:chapter.text];
+        byteOffset = NSMaxRange(chapter.byteRange);
+    }
+    XCTAssertEqualObjects(joined, text);
+}
+
+- (void)testMissingFile {
+    XCTAssertNil([[YLBookLoader alloc] initWithPath:@"/nonexistent/book.txt"]);
+}
+
+@end
@@ -0,0 +1,142 @@
+//
+//  YLBookTOCTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLBookTOC.h"
+#import "YLBookLoader.h"
+
+@interface YLBookTOCTests : XCTestCase
+
+@property (nonatomic, copy) NSString *path;
+
+@end
+
+@implementation YLBookTOCTests
+
+- (void)setUp {
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YLBookTOCTests.txt"];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtPath:self.path error:nil];
+}
+
+/// chapterCount 章，每章约 paragraphCount 段；段落分隔符轮流使用 \n、\r\n、\r
+- (NSString *)bookTextWithChapterCount:(NSUInteger)chapterCount paragraphCount:(NSUInteger)paragraphCount {
+    NSArray<NSString *> *separators = @[@"\n", @"\r\n", @"\r"];
+    NSMutableString *text = [NSMutableString stringWithString:@"书名\n"];
+    for (NSUInteger i = 0; i < chapterCount; i++) {
+        [text appendFormat:@"　　第%lu章 标题%lu%@", (unsigned long)i + 1, (unsigned long)i + 1, separators[i % 3]];
+        for (NSUInteger j = 0; j < paragraphCount; j++) {
+            [text appendFormat:@"　　夜已深，第%lu章并不在段落开头😀。%@", (unsigned long)j, separators[(i + j) % 3]];
+        }
+    }
+    return text;
+}
+
+- (BOOL)matchPattern:(const char *)pattern text:(NSString *)text {
+    YLBookTOCMatcher *matcher = YLBookTOCMatcherCreate(&pattern, 1);
+    const char *bytes = text.UTF8String;
+    BOOL matched = YLBookTOCMatcherMatch(matcher, (const uint8_t *)bytes, strlen(bytes)) == 0;
+    YLBookTOCMatcherDestroy(matcher);
+    return matched;
+}
+
+- (void)testPatterns {
+    XCTAssertTrue([self matchPattern:"第\\d+\\u" text:@"第一百二十章 重逢"]);
+    XCTAssertTrue([self matchPattern:"第\\d+\\u" text:@"第１２回"]);
+    XCTAssertFalse([self matchPattern:"第\\d+\\u" text:@"第章"]);
+    XCTAssertTrue([self matchPattern:"chapter\\s+\\d+" text:@"CHAPTER 12"]);
+    XCTAssertFalse([self matchPattern:"chapter\\s+\\d+" text:@"Chapters 1"]);
+    XCTAssertTrue([self matchPattern:"卷[一二三]" text:@"卷二"]);
+    XCTAssertTrue([self matchPattern:"[^a-c]x" text:@"dx"]);
+    XCTAssertFalse([self matchPattern:"[^a-c]x" text:@"Ax"]);
+    XCTAssertTrue([self matchPattern:"楔子$" text:@"楔子  "]);
+    XCTAssertFalse([self matchPattern:"楔子$" text:@"楔子 初见"]);
+    XCTAssertFalse([self matchPattern:"x*" text:@"abc"]);//标题不能为空
+
+    const char *invalid[] = {"", "+a", "a**", "[abc", "a\\"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        XCTAssertTrue(YLBookTOCMatcherCreate(&invalid[i], 1) == NULL);
+    }
+}
+
+- (void)testParallelBuildMatchesSequential {
+    //约 2MB，切成多块，块的边界会落在标题与 \r\n 中间
+    NSData *data = [[self bookTextWithChapterCount:1000 paragraphCount:60] dataUsingEncoding:NSUTF8StringEncoding];
+    YLBookTOCMatcher *matcher = YLBookTOCMatcherCreate(YLBookTOCDefaultPatterns, YLBookTOCDefaultPatternCount);
+    YLBookTOCEntry *sequential, *parallel;
+    size_t sequentialCount, parallelCount;
+    XCTAssertTrue(YLBookTOCBuild(matcher, data.bytes, 0, data.length, 1, &sequential, &sequentialCount));
+    XCTAssertEqual(sequentialCount, 1000);
+    for (size_t threadCount = 2; threadCount <= 8; threadCount *= 2) {
+        XCTAssertTrue(YLBookTOCBuild(matcher, data.bytes, 0, data.length, threadCount, &parallel, &parallelCount));
+        XCTAssertEqual(parallelCount, sequentialCount);
+        XCTAssertEqual(memcmp(parallel, sequential, sequentialCount * sizeof(YLBookTOCEntry)), 0);
+        free(parallel);
+    }
+    const uint8_t *bytes = data.bytes;
+    XCTAssertEqual(memcmp(bytes + sequential[0].titleOffset, "第1章 标题1", sequential[0].titleLength), 0);
+    free(sequential);
+    YLBookTOCMatcherDestroy(matcher);
+}
+
+- (void)testFormFeedStartsChapter {
+    const char *text = "front\n\fAppendix\nbody\n";
+    YLBookTOCMatcher *matcher = YLBookTOCMatcherCreate(YLBookTOCDefaultPatterns, YLBookTOCDefaultPatternCount);
+    YLBookTOCEntry *entries;
+    size_t count;
+    XCTAssertTrue(YLBookTOCBuild(matcher, (const uint8_t *)text, 0, strlen(text), 0, &entries, &count));
+    XCTAssertEqual(count, 1);
+    XCTAssertEqual(entries[0].byteOffset, 7);
+    XCTAssertEqual(entries[0].titleLength, 8);
+    XCTAssertEqual(entries[0].pattern, -1);
+    free(entries);
+    YLBookTOCMatcherDestroy(matcher);
+}
+
+- (void)testLoaderChaptersFollowTableOfContents {
+    NSString *text = [self bookTextWithChapterCount:20 paragraphCount:10];
+    [[text dataUsingEncoding:NSUTF8StringEncoding] writeToFile:self.path atomically:YES];
+    YLBookLoader *loader = [[YLBookLoader alloc] initWithPath:self.path];
+    NSArray<YLBookTOCItem *> *items = [loader buildTableOfContentsWithPatterns:nil];
+    XCTAssertEqual(items.count, 20);
+    XCTAssertEqualObjects(items.firstObject.title, @"第1章 标题1");
+    XCTAssertEqualObjects(loader.tableOfContents, items);
+
+    //书名单独成为第一章，其余章节从标题开始
+    NSArray<NSValue *> *ranges = [loader chapterByteRanges];
+    XCTAssertEqual(ranges.count, 21);
+    for (NSUInteger i = 0; i < items.count; i++) {
+        XCTAssertEqual(ranges[i + 1].rangeValue.location, items[i].byteOffset);
+        YLBookChapter *chapter = [loader chapterAtByteOffset:items[i].byteOffset];
+        XCTAssertEqual(chapter.byteRange.location, ranges[i + 1].rangeValue.location);
+        XCTAssertEqual(chapter.byteRange.length, ranges[i + 1].rangeValue.length);
+        XCTAssertTrue([chapter.text hasPrefix:@"　　第"]);
+    }
+
+    //自定义模式：只有前 9 章是一位数
+    items = [loader buildTableOfContentsWithPatterns:@[@"第[1-9]章"]];
+    XCTAssertEqual(items.count, 9);
+    XCTAssertNil([loader buildTableOfContentsWithPatterns:@[@"[abc"]]);
+    XCTAssertEqual(loader.tableOfContents.count, 9);
+}
+
+- (void)testPerformanceBuild {
+    //约 20MB
+    NSData *data = [[self bookTextWithChapterCount:10000 paragraphCount:60] dataUsingEncoding:NSUTF8StringEncoding];
+    YLBookTOCMatcher *matcher = YLBookTOCMatcherCreate(YLBookTOCDefaultPatterns, YLBookTOCDefaultPatternCount);
+    [self measureBlock:^{
+        YLBookTOCEntry *entries;
+        size_t count;
+        YLBookTOCBuild(matcher, data.bytes, 0, data.length, 0, &entries, &count);
+        free(entries);
+    }];
+    YLBookTOCMatcherDestroy(matcher);
+}
+
+@end
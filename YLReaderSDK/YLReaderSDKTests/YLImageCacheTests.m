@@ -0,0 +1,164 @@
+//
+//  YLImageCacheTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLImageCache.h"
+#import "YLCoreText.h"
+
+@interface YLImageCacheTests : XCTestCase
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, strong) YLImageCache *cache;
+
+@end
+
+@implementation YLImageCacheTests
+
+- (void)setUp {
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YLImageCacheTests"];
+    [NSFileManager.defaultManager removeItemAtPath:self.directory error:nil];
+    [NSFileManager.defaultManager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+    self.cache = [[YLImageCache alloc] initWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"]];
+}
+
+- (void)tearDown {
+    [self.cache removeAllCache];
+    [NSFileManager.defaultManager removeItemAtPath:self.directory error:nil];
+}
+
+/// 写入一张 PNG，返回其 file URL
+- (NSString *)writeImageNamed:(NSString *)name size:(CGSize)size {
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat defaultFormat];
+    format.scale = 1;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:size format:format];
+    NSData *data = [renderer PNGDataWithActions:^(UIGraphicsImageRendererContext * _Nonnull context) {
+        [UIColor.redColor setFill];
+        [context fillRect:CGRectMake(0, 0, size.width, size.height)];
+    }];
+    NSString *path = [self.directory stringByAppendingPathComponent:name];
+    [data writeToFile:path atomically:YES];
+    return [NSURL fileURLWithPath:path].absoluteString;
+}
+
+- (UIImage *)loadImageWithURL:(NSString *)url {
+    XCTestExpectation *expectation = [self expectationWithDescription:url];
+    __block UIImage *result;
+    [self.cache loadImageWithURL:url completion:^(UIImage * _Nullable image) {
+        XCTAssertTrue(NSThread.isMainThread);
+        result = image;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    return result;
+}
+
+- (void)testLoadFileURL {
+    NSString *url = [self writeImageNamed:@"a.png" size:CGSizeMake(40, 30)];
+    XCTAssertNil([self.cache cachedImageForURL:url]);
+    XCTAssertTrue(CGSizeEqualToSize([self.cache cachedSizeForURL:url], CGSizeZero));
+
+    UIImage *image = [self loadImageWithURL:url];
+    XCTAssertNotNil(image);
+    XCTAssertTrue(CGSizeEqualToSize(image.size, CGSizeMake(40, 30)));
+    XCTAssertEqual([self.cache cachedImageForURL:url], image);
+}
+
+- (void)testCachedSizeFromDisk {
+    NSString *url = [self writeImageNamed:@"a.png" size:CGSizeMake(64, 48)];
+    XCTAssertNotNil([self loadImageWithURL:url]);
+    [NSFileManager.defaultManager removeItemAtPath:[NSURL URLWithString:url].path error:nil];
+
+    //内存清空后，尺寸从磁盘缓存的文件头读取，图片也从磁盘缓存加载
+    [self.cache removeAllMemoryCache];
+    XCTAssertNil([self.cache cachedImageForURL:url]);
+    XCTAssertTrue(CGSizeEqualToSize([self.cache cachedSizeForURL:url], CGSizeMake(64, 48)));
+    UIImage *image = [self loadImageWithURL:url];
+    XCTAssertTrue(CGSizeEqualToSize(image.size, CGSizeMake(64, 48)));
+
+    YLImageCache *other = [[YLImageCache alloc] initWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"]];
+    XCTAssertTrue(CGSizeEqualToSize([other cachedSizeForURL:url], CGSizeMake(64, 48)));
+}
+
+- (void)testMissingFile {
+    NSString *url = [NSURL fileURLWithPath:[self.directory stringByAppendingPathComponent:@"missing.png"]].absoluteString;
+    XCTAssertNil([self loadImageWithURL:url]);
+    XCTAssertNil([self.cache cachedImageForURL:url]);
+}
+
+- (void)testConcurrentRequestsShareResult {
+    NSString *url = [self writeImageNamed:@"a.png" size:CGSizeMake(20, 20)];
+    NSMutableArray<UIImage *> *images = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 8; i++) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@(i).stringValue];
+        [self.cache loadImageWithURL:url completion:^(UIImage * _Nullable image) {
+            [images addObject:image];
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(images.count, 8);
+    for (UIImage *image in images) {
+        XCTAssertEqual(image, images.firstObject);
+    }
+}
+
+- (void)testDiskLimit {
+    NSString *cacheDirectory = [self.directory stringByAppendingPathComponent:@"cache"];
+    NSString *first = [self writeImageNamed:@"first.png" size:CGSizeMake(200, 200)];
+    XCTAssertNotNil([self loadImageWithURL:first]);
+    NSUInteger fileSize = [[NSFileManager.defaultManager attributesOfItemAtPath:[NSURL URLWithString:first].path error:nil] fileSize];
+    self.cache.diskLimit = fileSize * 2 + fileSize / 2;
+
+    [NSThread sleepForTimeInterval:1.1];//修改时间精度为秒
+    for (NSUInteger i = 0; i < 3; i++) {
+        NSString *url = [self writeImageNamed:[NSString stringWithFormat:@"%lu.png", (unsigned long)i] size:CGSizeMake(200, 200)];
+        XCTAssertNotNil([self loadImageWithURL:url]);
+    }
+    NSArray *files = [NSFileManager.defaultManager contentsOfDirectoryAtPath:cacheDirectory error:nil];
+    XCTAssertLessThanOrEqual(files.count, 2);
+
+    //最早写入的文件最先淘汰
+    [self.cache removeAllMemoryCache];
+    XCTAssertTrue(CGSizeEqualToSize([self.cache cachedSizeForURL:first], CGSizeZero));
+}
+
+- (void)testPlaceholderUsesDeclaredSize {
+    NSString *url = [NSURL fileURLWithPath:[self.directory stringByAppendingPathComponent:@"declared.png"]].absoluteString;
+    NSAttributedString *placeholder = [YLCoreText parseImageFromeTextWithURL:[url stringByAppendingString:@" 400x300"] drawSize:CGSizeMake(200, 600)];
+    XCTAssertEqual(placeholder.length, 1);
+    YLAttachment *attachment = [placeholder attribute:kYLAttachmentAttributeName atIndex:0 effectiveRange:NULL];
+    XCTAssertEqualObjects(attachment.url, url);
+    XCTAssertTrue(CGSizeEqualToSize(attachment.imageFrame.size, CGSizeMake(200, 150)));
+
+    //图片不存在：加载完成后不再占位，需要重新分页
+    XCTNSNotificationExpectation *expectation = [[XCTNSNotificationExpectation alloc] initWithName:YLAttachmentImageDidLoadNotification object:attachment];
+    expectation.handler = ^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[YLAttachmentImageSizeChangedKey] boolValue];
+    };
+    [self waitForExpectations:@[expectation] timeout:5];
+    XCTAssertNil(attachment.image);
+    XCTAssertTrue(CGSizeEqualToSize(attachment.imageFrame.size, CGSizeZero));
+}
+
+- (void)testPlaceholderUsesLoadedSize {
+    NSString *url = [self writeImageNamed:@"loaded.png" size:CGSizeMake(100, 50)];
+    NSAttributedString *placeholder = [YLCoreText parseImageFromeTextWithURL:url drawSize:CGSizeMake(200, 600)];
+    YLAttachment *attachment = [placeholder attribute:kYLAttachmentAttributeName atIndex:0 effectiveRange:NULL];
+    XCTNSNotificationExpectation *expectation = [[XCTNSNotificationExpectation alloc] initWithName:YLAttachmentImageDidLoadNotification object:attachment];
+    [self waitForExpectations:@[expectation] timeout:5];
+    XCTAssertNotNil(attachment.image);
+    XCTAssertTrue(CGSizeEqualToSize(attachment.imageFrame.size, CGSizeMake(100, 50)));
+
+    //已缓存的图片直接按实际尺寸占位，不再异步加载
+    placeholder = [YLCoreText parseImageFromeTextWithURL:url drawSize:CGSizeMake(200, 600)];
+    attachment = [placeholder attribute:kYLAttachmentAttributeName atIndex:0 effectiveRange:NULL];
+    XCTAssertNotNil(attachment.image);
+    XCTAssertTrue(CGSizeEqualToSize(attachment.imageFrame.size, CGSizeMake(100, 50)));
+    [YLImageCache.sharedCache removeAllCache];
+}
+
+@end
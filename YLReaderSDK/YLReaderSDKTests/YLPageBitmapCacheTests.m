@@ -0,0 +1,169 @@
+//
+//  YLPageBitmapCacheTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "YLPageBitmapCache.h"
+
+/// 桩渲染器：位图是记录了页码与引用计数的结构体，不做真正的绘制
+typedef struct YLStubRasterizer {
+    size_t byteCount;
+    atomic_int liveCount;
+    size_t order[64];
+    atomic_size_t renderCount;
+} YLStubRasterizer;
+
+typedef struct YLStubImage {
+    atomic_int refCount;
+    size_t page;
+} YLStubImage;
+
+static bool YLStubRender(void *context, size_t page, YLPageBitmap *bitmap){
+    YLStubRasterizer *stub = context;
+    YLStubImage *image = malloc(sizeof(YLStubImage));
+    atomic_init(&image->refCount, 1);
+    image->page = page;
+    bitmap->image = image;
+    bitmap->byteCount = stub->byteCount;
+    atomic_fetch_add(&stub->liveCount, 1);
+    size_t index = atomic_fetch_add(&stub->renderCount, 1);
+    if (index < 64) {
+        stub->order[index] = page;
+    }
+    return true;
+}
+
+static void YLStubRetain(void *context, YLPageBitmap bitmap){
+    atomic_fetch_add(&((YLStubImage *)bitmap.image)->refCount, 1);
+}
+
+static void YLStubRelease(void *context, YLPageBitmap bitmap){
+    YLStubRasterizer *stub = context;
+    if (atomic_fetch_sub(&((YLStubImage *)bitmap.image)->refCount, 1) == 1) {
+        free(bitmap.image);
+        atomic_fetch_sub(&stub->liveCount, 1);
+    }
+}
+
+@interface YLPageBitmapCacheTests : XCTestCase
+{
+    YLStubRasterizer _stub;
+}
+@end
+
+@implementation YLPageBitmapCacheTests
+
+- (YLPageBitmapCache *)createCacheWithBudget:(size_t)budget prefetchCount:(size_t)prefetchCount {
+    memset(&_stub, 0, sizeof(_stub));
+    _stub.byteCount = 100;
+    YLPageRasterizer rasterizer = {&_stub, YLStubRender, YLStubRetain, YLStubRelease};
+    YLPageBitmapCache *cache = YLPageBitmapCacheCreate(rasterizer, budget, prefetchCount);
+    YLPageBitmapCacheSetPageCount(cache, 50);
+    return cache;
+}
+
+- (NSArray<NSNumber *> *)renderedPagesFrom:(size_t)start {
+    NSMutableArray<NSNumber *> *pages = [NSMutableArray array];
+    for (size_t i = start; i < atomic_load(&_stub.renderCount); i++) {
+        [pages addObject:@(_stub.order[i])];
+    }
+    return pages;
+}
+
+- (void)testPrefetchOrderFollowsDirection {
+    YLPageBitmapCache *cache = [self createCacheWithBudget:1000 prefetchCount:4];
+    YLPageBitmapCacheSetCurrentPage(cache, 10);
+    //当前页，然后向后 4 页、向前 2 页交替
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 7);
+    XCTAssertEqualObjects([self renderedPagesFrom:0], (@[@10, @11, @9, @12, @8, @13, @14]));
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 0);
+
+    //向前翻页后，前面的页优先
+    YLPageBitmapCacheSetCurrentPage(cache, 9);
+    XCTAssertEqual(YLPageBitmapCacheDirection(cache), -1);
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 3);
+    XCTAssertEqualObjects([self renderedPagesFrom:7], (@[@7, @6, @5]));
+    XCTAssertEqual(YLPageBitmapCacheByteCount(cache), 1000);
+
+    //边界处不渲染不存在的页
+    YLPageBitmapCacheRemoveAll(cache);
+    YLPageBitmapCacheSetCurrentPage(cache, 49);
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 3);
+    XCTAssertEqualObjects([self renderedPagesFrom:10], (@[@49, @48, @47]));
+    YLPageBitmapCacheDestroy(cache);
+    XCTAssertEqual(atomic_load(&_stub.liveCount), 0);
+}
+
+- (void)testBudgetEvictsPagesBehindFirst {
+    YLPageBitmapCache *cache = [self createCacheWithBudget:300 prefetchCount:4];
+    YLPageBitmapCacheSetCurrentPage(cache, 20);
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 3);
+    XCTAssertEqualObjects([self renderedPagesFrom:0], (@[@20, @21, @19]));
+
+    //向后翻一页：淘汰身后的 19，为 22 腾出空间；23 不比已缓存的页重要，停止渲染
+    YLPageBitmapCacheSetCurrentPage(cache, 21);
+    XCTAssertEqual(YLPageBitmapCacheRenderPending(cache, SIZE_MAX), 1);
+    XCTAssertEqualObjects([self renderedPagesFrom:3], (@[@22]));
+    YLPageBitmap bitmap;
+    XCTAssertFalse(YLPageBitmapCacheCopyBitmap(cache, 19, &bitmap));
+    XCTAssertTrue(YLPageBitmapCacheCopyBitmap(cache, 22, &bitmap));
+    XCTAssertEqual(((YLStubImage *)bitmap.image)->page, 22);
+    YLPageBitmapCacheReleaseBitmap(cache, bitmap);
+    XCTAssertLessThanOrEqual(YLPageBitmapCacheByteCount(cache), 300);
+    YLPageBitmapCacheDestroy(cache);
+    XCTAssertEqual(atomic_load(&_stub.liveCount), 0);
+}
+
+- (void)testCopiedBitmapOutlivesRemoval {
+    YLPageBitmapCache *cache = [self createCacheWithBudget:1000 prefetchCount:2];
+    YLPageBitmapCacheSetCurrentPage(cache, 0);
+    YLPageBitmapCacheRenderPending(cache, SIZE_MAX);
+    YLPageBitmap bitmap;
+    XCTAssertTrue(YLPageBitmapCacheCopyBitmap(cache, 1, &bitmap));
+    YLPageBitmapCacheRemoveAll(cache);
+    XCTAssertEqual(YLPageBitmapCacheCount(cache), 0);
+    XCTAssertEqual(atomic_load(&_stub.liveCount), 1);
+    YLPageBitmapCacheReleaseBitmap(cache, bitmap);
+    XCTAssertEqual(atomic_load(&_stub.liveCount), 0);
+
+    //页数减少时丢弃超出的位图
+    YLPageBitmapCacheRenderPending(cache, SIZE_MAX);
+    YLPageBitmapCacheSetPageCount(cache, 1);
+    XCTAssertEqual(YLPageBitmapCacheCount(cache), 1);
+    YLPageBitmapCacheDestroy(cache);
+}
+
+- (void)testConcurrentPaging {
+    YLPageBitmapCache *cache = [self createCacheWithBudget:1000 prefetchCount:4];
+    __block atomic_bool stop;
+    atomic_init(&stop, false);
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < 3; i++) {
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            while (!atomic_load(&stop)) {
+                YLPageBitmapCacheRenderPending(cache, 3);
+            }
+        });
+    }
+    for (NSUInteger i = 0; i < 50000; i++) {
+        YLPageBitmapCacheSetCurrentPage(cache, arc4random_uniform(50));
+        if (i % 1000 == 0) {
+            YLPageBitmapCacheRemoveAll(cache);
+        }
+        YLPageBitmap bitmap;
+        if (YLPageBitmapCacheCopyBitmap(cache, arc4random_uniform(50), &bitmap)) {
+            YLPageBitmapCacheReleaseBitmap(cache, bitmap);
+        }
+        XCTAssertLessThanOrEqual(YLPageBitmapCacheByteCount(cache), 1000);
+    }
+    atomic_store(&stop, true);
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    YLPageBitmapCacheDestroy(cache);
+    XCTAssertEqual(atomic_load(&_stub.liveCount), 0);
+}
+
+@end
@@ -0,0 +1,227 @@
+//
+//  YLPageGeometryTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextGeometry.h"
+#import "YLPageGeometry.h"
+#import "YLCoreText.h"
+
+@interface YLPageGeometryTests : XCTestCase
+
+@end
+
+@implementation YLPageGeometryTests
+
+- (CTFrameRef)createFrame {
+    NSMutableAttributedString *string = [[NSMutableAttributedString alloc] init];
+    for (NSUInteger i = 0; i < 30; i++) {
+        [string appendAttributedString:[[NSAttributedString alloc] initWithString:@"　　夜已深，漆黑一片，景物不可见。" attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}]];
+        [string appendAttributedString:[[NSAttributedString alloc] initWithString:@"Mountain" attributes:@{NSFontAttributeName: [UIFont boldSystemFontOfSize:17]}]];
+        [string appendAttributedString:[[NSAttributedString alloc] initWithString:@"但山中并不宁静。\n" attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}]];
+    }
+    return getCTFrameWithAttrString(string, CGRectMake(0, 0, 300, 600));
+}
+
+/// 逐行查找，与建立索引之前的实现相同
+- (NSInteger)linearLineIndexAtPoint:(CGPoint)point frame:(CTFrameRef)frameRef {
+    CGRect bounds = CGPathGetBoundingBox(CTFrameGetPath(frameRef));
+    CFArrayRef lines = CTFrameGetLines(frameRef);
+    CFIndex lineCount = CFArrayGetCount(lines);
+    CGPoint origins[lineCount];
+    CTFrameGetLineOrigins(frameRef, CFRangeMake(0, 0), origins);
+    for (CFIndex i = 0; i < lineCount; i++) {
+        CGFloat ascent = 0, descent = 0, leading = 0;
+        CTLineGetTypographicBounds(CFArrayGetValueAtIndex(lines, i), &ascent, &descent, &leading);
+        CGRect lineFrame = CGRectMake(origins[i].x, CGRectGetHeight(bounds) - (origins[i].y + ascent), CGRectGetWidth(bounds), ascent + fabs(descent) + leading);
+        if (CGRectContainsPoint(CGRectInset(lineFrame, -5, -5), point)) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+- (void)testLineSearchMatchesLinearScan {
+    CTFrameRef frameRef = [self createFrame];
+    YLPageGeometry *geometry = [[YLPageGeometry alloc] initWithCTFrame:frameRef];
+    XCTAssertEqual(geometry.lineCount, CFArrayGetCount(CTFrameGetLines(frameRef)));
+    for (CGFloat y = -10; y < 620; y += 0.5) {
+        for (CGFloat x = -10; x < 320; x += 37) {
+            CGPoint point = CGPointMake(x, y);
+            XCTAssertEqual([geometry lineIndexAtPoint:point], [self linearLineIndexAtPoint:point frame:frameRef]);
+        }
+    }
+    CFRelease(frameRef);
+}
+
+- (void)testRunsAndLocations {
+    CTFrameRef frameRef = [self createFrame];
+    YLPageGeometry *geometry = [[YLPageGeometry alloc] initWithCTFrame:frameRef];
+    CFArrayRef lines = CTFrameGetLines(frameRef);
+    for (NSUInteger i = 0; i < geometry.lineCount; i++) {
+        CTLineRef line = CFArrayGetValueAtIndex(lines, i);
+        CFRange lineRange = CTLineGetStringRange(line);
+        XCTAssertTrue(NSEqualRanges([geometry lineRangeAtIndex:i], NSMakeRange(lineRange.location, lineRange.length)));
+        XCTAssertEqual([geometry lineIndexAtLocation:lineRange.location], i);
+        XCTAssertEqual([geometry lineIndexAtLocation:lineRange.location + lineRange.length - 1], i);
+
+        //每个 CTRun 中点处查到的都是它自己
+        CGRect lineFrame = [geometry lineFrameAtIndex:i];
+        CGFloat y = CGRectGetMidY(lineFrame);
+        if ([geometry lineIndexAtPoint:CGPointMake(0, y)] != i) {
+            continue;
+        }
+        CFArrayRef runs = CTLineGetGlyphRuns(line);
+        for (CFIndex j = 0; j < CFArrayGetCount(runs); j++) {
+            CTRunRef run = CFArrayGetValueAtIndex(runs, j);
+            CFRange runRange = CTRunGetStringRange(run);
+            CGFloat xStart = CTLineGetOffsetForStringIndex(line, runRange.location, NULL);
+            CGFloat xEnd = CTLineGetOffsetForStringIndex(line, runRange.location + runRange.length, NULL);
+            if (xEnd - xStart < 1) {
+                continue;
+            }
+            XCTAssertEqual([geometry runAtPoint:CGPointMake((xStart + xEnd) / 2, y)], run);
+        }
+    }
+    XCTAssertEqual([geometry lineIndexAtLocation:NSUIntegerMax / 2], NSNotFound);
+    CFRelease(frameRef);
+}
+
+- (void)testTouchFunctions {
+    CTFrameRef frameRef = [self createFrame];
+    CGPoint point = CGPointMake(20, 30);
+    YLPageGeometry *geometry = [[YLPageGeometry alloc] initWithCTFrame:frameRef];
+    XCTAssertEqual(getTouchLine(point, frameRef), [geometry lineAtPoint:point]);
+    XCTAssertEqual(getTouchRun(point, frameRef), [geometry runAtPoint:point]);
+    XCTAssertTrue(NSEqualRanges(getTouchLineRange(point, frameRef), [geometry lineRangeAtPoint:point]));
+    XCTAssertEqual(getTouchLocation(point, frameRef), [geometry locationAtPoint:point]);
+    XCTAssertEqual(getTouchLocation(CGPointMake(20, 5000), frameRef), -1);
+    XCTAssertTrue(getTouchLine(point, nil) == NULL);
+    CFRelease(frameRef);
+}
+
+- (void)testGeometryOverlappingLines {
+    YLTextGeometry geometry;
+    YLTextGeometryInit(&geometry);
+    for (size_t i = 0; i < 10; i++) {
+        YLTextGeometryRect frame = {0, i * 20.0, 300, 18};
+        YLTextFontMetrics metrics = {14, 4, 0};
+        XCTAssertTrue(YLTextGeometryAddLine(&geometry, frame, metrics, i * 10, 10));
+        //逆序追加的段按 minX 排序
+        XCTAssertTrue(YLTextGeometryAddRun(&geometry, 150, 300, i * 10 + 5, 5));
+        XCTAssertTrue(YLTextGeometryAddRun(&geometry, 0, 150, i * 10, 5));
+    }
+    XCTAssertEqual(YLTextGeometryLineAtPoint(&geometry, 10, 19, 0), YLTextGeometryNotFound);
+    XCTAssertEqual(YLTextGeometryLineAtPoint(&geometry, 10, 21, 5), 0);//扩展后重叠，取上一行
+    XCTAssertEqual(YLTextGeometryLineAtPoint(&geometry, 10, 23.5, 5), 1);
+    XCTAssertEqual(YLTextGeometryLineAtPoint(&geometry, 400, 5, 0), YLTextGeometryNotFound);
+
+    size_t run = YLTextGeometryRunAtX(&geometry, 3, 10);
+    XCTAssertEqual(geometry.runs[run].location, 30);
+    XCTAssertEqual(geometry.runs[run].index, 1);
+    XCTAssertEqual(YLTextGeometryRunAtX(&geometry, 3, 300), YLTextGeometryNotFound);
+    XCTAssertEqual(YLTextGeometryLineAtLocation(&geometry, 57), 5);
+    XCTAssertEqual(YLTextGeometryLineAtLocation(&geometry, 100), YLTextGeometryNotFound);
+    YLTextGeometryDestroy(&geometry);
+}
+
+- (void)testTrims {
+    NSString *text = @"　　ab\n  c\r\n\n   ";
+    unichar characters[32];
+    [text getCharacters:characters range:NSMakeRange(0, text.length)];
+    YLTextGeometry geometry;
+    YLTextGeometryInit(&geometry);
+    NSRange lines[] = {{0, 5}, {5, 5}, {10, 1}, {11, 3}};
+    for (size_t i = 0; i < 4; i++) {
+        YLTextGeometryRect frame = {0, i * 20.0, 300, 18};
+        YLTextFontMetrics metrics = {14, 4, 0};
+        YLTextGeometryAddLine(&geometry, frame, metrics, lines[i].location, lines[i].length);
+    }
+    YLTextGeometrySetTrims(&geometry, characters, text.length);
+    XCTAssertEqual(geometry.lines[0].trimStart, 2);
+    XCTAssertEqual(geometry.lines[0].trimEnd, 1);
+    XCTAssertEqual(geometry.lines[1].trimStart, 2);
+    XCTAssertEqual(geometry.lines[1].trimEnd, 2);
+    XCTAssertEqual(geometry.lines[2].trimStart, 0);
+    XCTAssertEqual(geometry.lines[2].trimEnd, 1);
+    XCTAssertEqual(geometry.lines[3].trimStart, 3);
+    XCTAssertEqual(geometry.lines[3].trimEnd, 0);
+
+    size_t start, end;
+    XCTAssertTrue(YLTextGeometryClipRange(&geometry, 0, 0, 14, true, &start, &end));
+    XCTAssertEqual(start, 2);
+    XCTAssertEqual(end, 4);
+    XCTAssertTrue(YLTextGeometryClipRange(&geometry, 0, 0, 14, false, &start, &end));
+    XCTAssertEqual(start, 0);
+    XCTAssertEqual(end, 5);
+    XCTAssertTrue(YLTextGeometryClipRange(&geometry, 1, 3, 5, true, &start, &end));
+    XCTAssertEqual(start, 7);
+    XCTAssertEqual(end, 8);
+    XCTAssertFalse(YLTextGeometryClipRange(&geometry, 2, 0, 14, true, &start, &end));
+    XCTAssertFalse(YLTextGeometryClipRange(&geometry, 3, 0, 14, true, &start, &end));
+    YLTextGeometryDestroy(&geometry);
+}
+
+- (void)testRangeRects {
+    NSString *text = @"　　夜已深，漆黑一片，景物不可见。但山中并不宁静。夜已深，漆黑一片，景物不可见。\n　　但山中并不宁静。\n";
+    NSAttributedString *string = [[NSAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}];
+    CTFrameRef frameRef = getCTFrameWithAttrString(string, CGRectMake(0, 0, 200, 400));
+    CFArrayRef lines = CTFrameGetLines(frameRef);
+    CFIndex lineCount = CFArrayGetCount(lines);
+    XCTAssertGreaterThan(lineCount, 2);
+
+    //不去除空白时，整行选中的矩形与逐行计算的结果一致
+    CGPoint origins[lineCount];
+    CTFrameGetLineOrigins(frameRef, CFRangeMake(0, 0), origins);
+    NSArray<NSValue *> *rects = getRangeRects_0(NSMakeRange(0, text.length), frameRef);
+    XCTAssertEqual(rects.count, lineCount);
+    for (CFIndex i = 0; i < lineCount; i++) {
+        CTLineRef line = CFArrayGetValueAtIndex(lines, i);
+        CFRange lineRange = CTLineGetStringRange(line);
+        CGFloat ascent = 0, descent = 0, leading = 0;
+        CTLineGetTypographicBounds(line, &ascent, &descent, &leading);
+        CGFloat xStart = CTLineGetOffsetForStringIndex(line, lineRange.location, NULL);
+        CGFloat xEnd = CTLineGetOffsetForStringIndex(line, lineRange.location + lineRange.length, NULL);
+        CGRect expected = CGRectMake(origins[i].x + xStart, origins[i].y - descent, fabs(xEnd - xStart), ascent + descent + leading);
+        CGRect rect = rects[i].CGRectValue;
+        XCTAssertEqualWithAccuracy(rect.origin.x, expected.origin.x, 0.01);
+        XCTAssertEqualWithAccuracy(rect.origin.y, expected.origin.y, 0.01);
+        XCTAssertEqualWithAccuracy(rect.size.width, expected.size.width, 0.01);
+        XCTAssertEqualWithAccuracy(rect.size.height, expected.size.height, 0.01);
+    }
+
+    //去除行首空白后，第一行的矩形从第三个字开始
+    NSArray<NSValue *> *trimmed = getRangeRects(NSMakeRange(0, text.length), frameRef, text);
+    CTLineRef firstLine = CFArrayGetValueAtIndex(lines, 0);
+    XCTAssertEqualWithAccuracy(trimmed.firstObject.CGRectValue.origin.x, origins[0].x + CTLineGetOffsetForStringIndex(firstLine, 2, NULL), 0.01);
+    XCTAssertEqual(getRangeRects(NSMakeRange(0, 0), frameRef, text).count, 0);
+    CFRelease(frameRef);
+}
+
+- (void)testPerformanceRangeRects {
+    CTFrameRef frameRef = [self createFrame];
+    CFRange visible = CTFrameGetVisibleStringRange(frameRef);
+    NSString *content = [@"" stringByPaddingToLength:visible.length withString:@"　　夜已深。\n" startingAtIndex:0];
+    [self measureBlock:^{
+        //模拟拖动选择：每次移动都重新计算选中区域
+        for (NSUInteger i = 1; i < 2000; i++) {
+            getRangeRects(NSMakeRange(3, i % visible.length), frameRef, content);
+        }
+    }];
+    CFRelease(frameRef);
+}
+
+- (void)testPerformanceTouchQueries {
+    CTFrameRef frameRef = [self createFrame];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20000; i++) {
+            getTouchRun(CGPointMake(i % 300, i % 600), frameRef);
+        }
+    }];
+    CFRelease(frameRef);
+}
+
+@end
@@ -0,0 +1,112 @@
+//
+//  YLPageOffsetsTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLPageOffsets.h"
+
+@interface YLPageOffsetsTests : XCTestCase
+
+@end
+
+@implementation YLPageOffsetsTests
+
+- (void)testEmpty {
+    YLPageOffsets table;
+    YLPageOffsetsInit(&table);
+    size_t first = 0;
+    XCTAssertEqual(YLPageOffsetsTotal(&table), 0);
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, 10), YLPageOffsetsNotFound);
+    XCTAssertEqual(YLPageOffsetsVisibleRange(&table, 0, 100, &first), 0);
+    YLPageOffsetsDestroy(&table);
+}
+
+- (void)testOffsets {
+    YLPageOffsets table;
+    YLPageOffsetsInit(&table);
+    double heights[] = {100, 0, 50, 200, -10, 30};
+    for (size_t i = 0; i < 6; i++) {
+        YLPageOffsetsAppend(&table, heights[i]);
+    }
+    XCTAssertEqual(YLPageOffsetsTotal(&table), 380);
+    XCTAssertEqual(YLPageOffsetsOrigin(&table, 3), 150);
+    XCTAssertEqual(YLPageOffsetsHeight(&table, 4), 0);
+
+    //高度为 0 的页不会被点中
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, -5), 0);
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, 99.5), 0);
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, 100), 2);
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, 350), 5);
+    XCTAssertEqual(YLPageOffsetsPageAt(&table, 1000), 5);
+
+    size_t first = 0;
+    XCTAssertEqual(YLPageOffsetsVisibleRange(&table, 120, 160, &first), 2);
+    XCTAssertEqual(first, 2);
+    XCTAssertEqual(YLPageOffsetsVisibleRange(&table, 0, 100, &first), 1);
+    XCTAssertEqual(first, 0);
+    XCTAssertEqual(YLPageOffsetsVisibleRange(&table, 400, 500, &first), 0);
+
+    YLPageOffsetsRemoveAll(&table);
+    XCTAssertEqual(YLPageOffsetsTotal(&table), 0);
+    YLPageOffsetsAppend(&table, 20);
+    XCTAssertEqual(YLPageOffsetsOrigin(&table, 0), 0);
+    XCTAssertEqual(YLPageOffsetsTotal(&table), 20);
+    YLPageOffsetsDestroy(&table);
+}
+
+/// 与逐页累加比较
+- (void)testVisibleRangeMatchesLinearScan {
+    YLPageOffsets table;
+    YLPageOffsetsInit(&table);
+    srand(7);
+    double heights[500];
+    double total = 0;
+    for (size_t i = 0; i < 500; i++) {
+        heights[i] = rand() % 6 == 0 ? 0 : rand() % 800;
+        total += heights[i];
+        YLPageOffsetsAppend(&table, heights[i]);
+    }
+    for (NSUInteger q = 0; q < 5000; q++) {
+        double minOffset = rand() % (int)(total + 400) - 200;
+        double maxOffset = minOffset + 1 + rand() % 2000;
+        size_t expectedFirst = 0, expectedCount = 0;
+        double origin = 0;
+        for (size_t i = 0; i < 500; i++) {
+            if (origin < maxOffset && origin + heights[i] > minOffset) {
+                if (expectedCount == 0) {
+                    expectedFirst = i;
+                }
+                expectedCount++;
+            }
+            origin += heights[i];
+        }
+        size_t first = 0;
+        XCTAssertEqual(YLPageOffsetsVisibleRange(&table, minOffset, maxOffset, &first), expectedCount);
+        if (expectedCount) {
+            XCTAssertEqual(first, expectedFirst);
+        }
+    }
+    YLPageOffsetsDestroy(&table);
+}
+
+- (void)testPerformanceVisibleRange {
+    YLPageOffsets table;
+    YLPageOffsetsInit(&table);
+    for (size_t i = 0; i < 100000; i++) {
+        YLPageOffsetsAppend(&table, 600 + i % 7);
+    }
+    double total = YLPageOffsetsTotal(&table);
+    [self measureBlock:^{
+        //模拟滚动：每一帧查找可见的页
+        size_t first = 0;
+        for (double offset = 0; offset < total; offset += 97) {
+            YLPageOffsetsVisibleRange(&table, offset, offset + 800, &first);
+        }
+    }];
+    YLPageOffsetsDestroy(&table);
+}
+
+@end
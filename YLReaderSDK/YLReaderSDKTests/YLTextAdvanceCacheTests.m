@@ -0,0 +1,143 @@
+//
+//  YLTextAdvanceCacheTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextAdvanceCache.h"
+#import "YLCoreTextMetrics.h"
+#import "YLCoreText.h"
+
+/// 在固定度量表上制造一些与区块统一宽度不同的字符
+static void perturbedMeasure(void *context, YLTextStyleID style, const uint16_t *chars, size_t length, double *advances){
+    const YLTextMetrics *metrics = context;
+    metrics->measure(metrics->context, style, chars, length, advances);
+    for (size_t i = 0; i < length; i++) {
+        if (chars[i] >= 0x9FF0 && chars[i] <= 0x9FFF) {
+            advances[i] = 7.25;
+        } else if (chars[i] == 0x3002 || (chars[i] >= 0xAC00 && chars[i] < 0xAC10)) {
+            advances[i] = 3.5;
+        } else if (chars[i] == 'A' || chars[i] == 0x7F) {
+            advances[i] += 0.125;
+        }
+    }
+}
+
+/// 随机的汉字、ASCII、假名、谚文、全角字符、代理对与孤立的代理码元
+static uint16_t randomCharacter(void){
+    switch (lrand48() % 10) {
+        case 0: return lrand48() % 128;
+        case 1: case 2: case 3: return 0x4E00 + lrand48() % 0x5200;
+        case 4: return 0x3000 + lrand48() % 0x100;
+        case 5: return 0xD800 + lrand48() % 0x800;
+        case 6: return 0xAC00 + lrand48() % 0x40;
+        case 7: return 0xFF00 + lrand48() % 0x100;
+        case 8: return 0x9FF0 + lrand48() % 16;
+        default: return lrand48() % 0x10000;
+    }
+}
+
+@interface YLTextAdvanceCacheTests : XCTestCase
+{
+    YLFixedTextStyle _styles[2];
+    YLFixedTextMetrics _fixedMetrics;
+    YLTextMetrics _metrics;
+}
+@end
+
+@implementation YLTextAdvanceCacheTests
+
+- (void)setUp {
+    YLFixedTextStyleInit(&_styles[0], 15);
+    YLFixedTextStyleInit(&_styles[1], 18);
+    memset(&_fixedMetrics, 0, sizeof(YLFixedTextMetrics));
+    _fixedMetrics.styles = _styles;
+    _fixedMetrics.styleCount = 2;
+    _metrics = YLFixedTextMetricsMake(&_fixedMetrics);
+}
+
+- (void)testTableMatchesOriginalMeasure {
+    srand48(1);
+    uint16_t chars[300];
+    double expected[300], advances[300];
+    for (YLTextStyleID style = 0; style < 2; style++) {
+        YLTextAdvanceTable *table = YLTextAdvanceTableCreate(perturbedMeasure, &_metrics, style);
+        XCTAssertTrue(table != NULL);
+        for (NSUInteger i = 0; i < 5000; i++) {
+            //整段汉字、整段 ASCII 与混合文字
+            size_t length = lrand48() % 300, mode = lrand48() % 3;
+            for (size_t j = 0; j < length; j++) {
+                chars[j] = mode == 0 ? 0x4E00 + lrand48() % 0x5200 : mode == 1 ? lrand48() % 128 : randomCharacter();
+            }
+            perturbedMeasure(&_metrics, style, chars, length, expected);
+            YLTextAdvanceTableMeasure(table, chars, length, advances, perturbedMeasure, &_metrics, style);
+            XCTAssertEqual(memcmp(expected, advances, length * sizeof(double)), 0);
+        }
+
+        const uint16_t prefix[] = {'a', 0x4E00, 0x9FF5, 'b'};
+        XCTAssertEqual(YLTextAdvanceTableMeasurePrefix(table, prefix, 4, advances), 2);
+        YLTextAdvanceTableDestroy(table);
+    }
+}
+
+- (void)testCacheSharesTablePerFont {
+    const YLTextAdvanceTable *table = YLTextAdvanceCacheGet("YLTextAdvanceCacheTests 15", perturbedMeasure, &_metrics, 0);
+    XCTAssertTrue(table != NULL);
+    XCTAssertEqual(YLTextAdvanceCacheGet("YLTextAdvanceCacheTests 15", perturbedMeasure, &_metrics, 0), table);
+    XCTAssertNotEqual(YLTextAdvanceCacheGet("YLTextAdvanceCacheTests 18", perturbedMeasure, &_metrics, 1), table);
+}
+
+- (void)testCoreTextMetricsMatchWithoutCache {
+    NSString *dataPath = [[NSBundle bundleForClass:YLCoreText.class] pathForResource:@"Data" ofType:@"txt"];
+    NSString *text = [NSString stringWithContentsOfFile:dataPath encoding:NSUTF8StringEncoding error:nil];
+    text = [text stringByAppendingString:@"Emoji 😀👍🏻，한국어 텍스트，カタカナ、ｆｕｌｌｗｉｄｔｈ。\n"];
+    NSMutableAttributedString *string = [[NSMutableAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}];
+    [string addAttribute:NSFontAttributeName value:[UIFont fontWithName:@"PingFangSC-Regular" size:17] range:NSMakeRange(text.length / 3, text.length / 3)];
+
+    YLCoreTextMetrics *cached = [[YLCoreTextMetrics alloc] initWithAttributedString:string usesAdvanceCache:YES];
+    YLCoreTextMetrics *uncached = [[YLCoreTextMetrics alloc] initWithAttributedString:string usesAdvanceCache:NO];
+    const YLTextSource *source = cached.source;
+    NSMutableData *expected = [NSMutableData dataWithLength:MAX(source->length, 1) * sizeof(double)];
+    NSMutableData *advances = [NSMutableData dataWithLength:MAX(source->length, 1) * sizeof(double)];
+    for (size_t i = 0; i < source->runCount; i++) {
+        YLTextStyleRun run = source->runs[i];
+        uncached.metrics->measure(uncached.metrics->context, run.style, source->chars + run.location, run.length, (double *)expected.mutableBytes + run.location);
+        cached.metrics->measure(cached.metrics->context, run.style, source->chars + run.location, run.length, (double *)advances.mutableBytes + run.location);
+    }
+    XCTAssertEqualObjects(expected, advances);
+
+    YLTextLayoutConfig config = {300, 500, 4, 8, true};
+    YLTextLayoutResult cachedResult, uncachedResult;
+    YLTextLayoutResultInit(&cachedResult);
+    YLTextLayoutResultInit(&uncachedResult);
+    XCTAssertTrue(YLTextLayoutPaginate(cached.source, cached.metrics, &config, 0, source->length, &cachedResult));
+    XCTAssertTrue(YLTextLayoutPaginate(uncached.source, uncached.metrics, &config, 0, source->length, &uncachedResult));
+    XCTAssertEqual(cachedResult.pageCount, uncachedResult.pageCount);
+    XCTAssertEqual(cachedResult.lineCount, uncachedResult.lineCount);
+    XCTAssertEqual(memcmp(cachedResult.pages, uncachedResult.pages, MIN(cachedResult.pageCount, uncachedResult.pageCount) * sizeof(YLTextPage)), 0);
+    for (size_t i = 0; i < MIN(cachedResult.lineCount, uncachedResult.lineCount); i++) {
+        XCTAssertEqual(cachedResult.lines[i].location, uncachedResult.lines[i].location);
+        XCTAssertEqual(cachedResult.lines[i].length, uncachedResult.lines[i].length);
+        XCTAssertEqual(cachedResult.lines[i].width, uncachedResult.lines[i].width);
+    }
+    YLTextLayoutResultDestroy(&cachedResult);
+    YLTextLayoutResultDestroy(&uncachedResult);
+}
+
+- (void)testPerformanceCachedPagination {
+    NSString *dataPath = [[NSBundle bundleForClass:YLCoreText.class] pathForResource:@"Data" ofType:@"txt"];
+    NSString *text = [NSString stringWithContentsOfFile:dataPath encoding:NSUTF8StringEncoding error:nil];
+    NSAttributedString *string = [[NSAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}];
+    [self measureBlock:^{
+        YLCoreTextMetrics *metrics = [[YLCoreTextMetrics alloc] initWithAttributedString:string];
+        YLTextLayoutConfig config = {300, 500, 0, 0, false};
+        YLTextLayoutResult result;
+        YLTextLayoutResultInit(&result);
+        YLTextLayoutPaginate(metrics.source, metrics.metrics, &config, 0, metrics.source->length, &result);
+        YLTextLayoutResultDestroy(&result);
+    }];
+}
+
+@end
@@ -0,0 +1,161 @@
+//
+//  YLTextAnnotationTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextAnnotation.h"
+#import "YLBookAnnotations.h"
+
+@interface YLTextAnnotationTests : XCTestCase
+
+@property (nonatomic, copy) NSString *path;
+
+@end
+
+@implementation YLTextAnnotationTests
+
+- (void)setUp {
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YLTextAnnotationTests.txt"];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtPath:self.path error:nil];
+    [NSFileManager.defaultManager removeItemAtPath:[self.path stringByAppendingPathExtension:@"ylnotes"] error:nil];
+}
+
+/// 逐个检查得到的相交标注，按 (location, identifier) 排序
+- (NSArray<NSArray<NSNumber *> *> *)expectedIn:(NSArray<NSArray<NSNumber *> *> *)annotations location:(size_t)location length:(size_t)length {
+    NSMutableArray *result = [NSMutableArray array];
+    for (NSArray<NSNumber *> *item in annotations) {
+        size_t start = item[1].unsignedLongValue, end = start + item[2].unsignedLongValue;
+        if (length && start < location + length && end > location) {
+            [result addObject:item];
+        }
+    }
+    [result sortUsingComparator:^NSComparisonResult(NSArray<NSNumber *> *a, NSArray<NSNumber *> *b) {
+        NSComparisonResult order = [a[1] compare:b[1]];
+        return order != NSOrderedSame ? order : [a[0] compare:b[0]];
+    }];
+    return result;
+}
+
+- (void)assertStore:(YLTextAnnotationStore *)store matches:(NSArray<NSArray<NSNumber *> *> *)annotations {
+    srand48(7);
+    YLTextAnnotation results[512];
+    for (NSUInteger i = 0; i < 200; i++) {
+        size_t location = lrand48() % 20000, length = lrand48() % 800;
+        NSArray<NSArray<NSNumber *> *> *expected = [self expectedIn:annotations location:location length:length];
+        size_t count = YLTextAnnotationStoreFind(store, location, length, results, 512);
+        XCTAssertEqual(count, expected.count);
+        for (size_t j = 0; j < MIN(count, expected.count); j++) {
+            XCTAssertEqual(results[j].identifier, expected[j][0].unsignedLongLongValue);
+            XCTAssertEqual(results[j].location, expected[j][1].unsignedLongValue);
+            XCTAssertEqual(results[j].length, expected[j][2].unsignedLongValue);
+        }
+        XCTAssertEqual(YLTextAnnotationStoreFind(store, location, length, NULL, 0), expected.count);
+    }
+}
+
+- (void)testFindMatchesLinearScan {
+    YLTextAnnotationStore *store = YLTextAnnotationStoreCreate();
+    NSMutableArray<NSArray<NSNumber *> *> *annotations = [NSMutableArray array];
+    srand48(1);
+    for (NSUInteger i = 0; i < 3000; i++) {
+        if (annotations.count && lrand48() % 3 == 0) {
+            NSUInteger index = lrand48() % annotations.count;
+            NSArray<NSNumber *> *item = annotations[index];
+            XCTAssertTrue(YLTextAnnotationStoreRemove(store, item[1].unsignedLongValue, item[0].unsignedLongLongValue));
+            XCTAssertFalse(YLTextAnnotationStoreRemove(store, item[1].unsignedLongValue, item[0].unsignedLongLongValue));
+            [annotations removeObjectAtIndex:index];
+            continue;
+        }
+        //偶尔有跨越多页的长标注
+        size_t location = lrand48() % 20000, length = 1 + (lrand48() % 10 ? lrand48() % 60 : lrand48() % 4000);
+        uint64_t identifier = YLTextAnnotationStoreAdd(store, location, length, 0, NULL);
+        XCTAssertNotEqual(identifier, 0);
+        [annotations addObject:@[@(identifier), @(location), @(length)]];
+    }
+    XCTAssertEqual(YLTextAnnotationStoreCount(store), annotations.count);
+    XCTAssertEqual(YLTextAnnotationStoreAdd(store, 10, 0, 0, NULL), 0);
+    [self assertStore:store matches:annotations];
+
+    NSString *storagePath = [self.path stringByAppendingPathExtension:@"ylnotes"];
+    XCTAssertTrue(YLTextAnnotationStoreWrite(store, storagePath.fileSystemRepresentation));
+    YLTextAnnotationStore *loaded = YLTextAnnotationStoreRead(storagePath.fileSystemRepresentation);
+    XCTAssertTrue(loaded != NULL);
+    [self assertStore:loaded matches:annotations];
+    //identifier 不会重复使用
+    XCTAssertEqual(YLTextAnnotationStoreAdd(loaded, 1, 1, 0, NULL), YLTextAnnotationStoreAdd(store, 1, 1, 0, NULL));
+    YLTextAnnotationStoreDestroy(loaded);
+    YLTextAnnotationStoreDestroy(store);
+}
+
+- (void)testNotesAndCorruptFile {
+    YLTextAnnotationStore *store = YLTextAnnotationStoreCreate();
+    uint64_t first = YLTextAnnotationStoreAdd(store, 100, 5, 2, "笔记");
+    YLTextAnnotationStoreAdd(store, 100, 20, 1, "");
+    XCTAssertTrue(YLTextAnnotationStoreUpdate(store, 100, first, 3, "修改后的笔记"));
+    XCTAssertFalse(YLTextAnnotationStoreUpdate(store, 101, first, 3, NULL));
+
+    YLTextAnnotation results[2];
+    XCTAssertEqual(YLTextAnnotationStoreFind(store, 104, 1, results, 2), 2);
+    XCTAssertEqual(results[0].identifier, first);
+    XCTAssertEqual(results[0].style, 3);
+    XCTAssertEqual(strcmp(results[0].note, "修改后的笔记"), 0);
+    XCTAssertTrue(results[1].note == NULL);
+    XCTAssertEqual(YLTextAnnotationStoreFind(store, 105, 100, results, 2), 1);
+    XCTAssertEqual(YLTextAnnotationStoreFind(store, 0, 100, results, 2), 0);
+
+    NSString *storagePath = [self.path stringByAppendingPathExtension:@"ylnotes"];
+    XCTAssertTrue(YLTextAnnotationStoreWrite(store, storagePath.fileSystemRepresentation));
+    YLTextAnnotationStoreDestroy(store);
+    NSData *data = [NSData dataWithContentsOfFile:storagePath];
+    [[data subdataWithRange:NSMakeRange(0, data.length - 1)] writeToFile:storagePath atomically:YES];
+    XCTAssertTrue(YLTextAnnotationStoreRead(storagePath.fileSystemRepresentation) == NULL);
+}
+
+- (void)testBookAnnotationsPersist {
+    [@"书籍内容" writeToFile:self.path atomically:YES encoding:NSUTF8StringEncoding error:nil];
+    YLBookAnnotations *annotations = [[YLBookAnnotations alloc] initWithPath:self.path];
+    XCTAssertEqualObjects(annotations.storagePath, [self.path stringByAppendingPathExtension:@"ylnotes"]);
+    YLBookAnnotation *highlight = [annotations addAnnotationWithRange:NSMakeRange(10, 30) style:1 note:nil];
+    YLBookAnnotation *note = [annotations addAnnotationWithRange:NSMakeRange(35, 10) style:2 note:@"伏笔"];
+    XCTAssertNil([annotations addAnnotationWithRange:NSMakeRange(5, 0) style:0 note:nil]);
+    note = [annotations updateAnnotation:note style:3 note:@"前后呼应"];
+    XCTAssertEqual(note.style, 3);
+
+    NSArray<YLBookAnnotation *> *found = [annotations annotationsInRange:NSMakeRange(36, 1)];
+    XCTAssertEqual(found.count, 2);
+    XCTAssertEqual(found[0].identifier, highlight.identifier);
+    XCTAssertEqualObjects(found[1].note, @"前后呼应");
+    XCTAssertTrue([annotations save]);
+
+    YLBookAnnotations *reopened = [[YLBookAnnotations alloc] initWithPath:self.path];
+    XCTAssertEqual(reopened.count, 2);
+    XCTAssertTrue([reopened removeAnnotation:highlight]);
+    XCTAssertFalse([reopened removeAnnotation:highlight]);
+    found = [reopened annotationsInRange:NSMakeRange(0, 100)];
+    XCTAssertEqual(found.count, 1);
+    XCTAssertEqual(found[0].range.location, 35);
+    XCTAssertEqualObjects(found[0].note, @"前后呼应");
+}
+
+- (void)testPerformanceFindPage {
+    YLTextAnnotationStore *store = YLTextAnnotationStoreCreate();
+    srand48(3);
+    for (NSUInteger i = 0; i < 100000; i++) {
+        YLTextAnnotationStoreAdd(store, lrand48() % 20000000, 5 + lrand48() % 200, 0, NULL);
+    }
+    [self measureBlock:^{
+        YLTextAnnotation results[64];
+        for (NSUInteger i = 0; i < 100000; i++) {
+            YLTextAnnotationStoreFind(store, lrand48() % 20000000, 600, results, 64);
+        }
+    }];
+    YLTextAnnotationStoreDestroy(store);
+}
+
+@end
@@ -0,0 +1,164 @@
+//
+//  YLTextEncodingTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextEncoding.h"
+
+@interface YLTextEncodingTests : XCTestCase
+
+@end
+
+@implementation YLTextEncodingTests
+
+- (NSStringEncoding)gb18030 {
+    return CFStringConvertEncodingToNSStringEncoding(kCFStringEncodingGB_18030_2000);
+}
+
+- (NSString *)bookText {
+    NSArray<NSString *> *sentences = @[@"　　第一章 风起\n", @"　　夜已深，漆黑一片😀，景物不可见。", @"Mountain village, 石村。\n", @"€©￥丂丄"];
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 2000; i++) {
+        [text appendString:sentences[(i * 7) % sentences.count]];
+    }
+    return text;
+}
+
+/// 按 chunkLength 分块转码
+- (NSString *)transcodeData:(NSData *)data encoding:(YLTextEncoding)encoding chunkLength:(NSUInteger)chunkLength {
+    YLTextTranscoder *transcoder = YLTextTranscoderCreate(encoding);
+    NSMutableData *output = [NSMutableData data];
+    const uint8_t *bytes = data.bytes;
+    NSUInteger offset = 0;
+    do {
+        NSUInteger length = MIN(chunkLength, data.length - offset);
+        uint8_t *buffer = malloc(YLTextTranscoderMaxOutputLength(length));
+        size_t count = YLTextTranscoderConvert(transcoder, bytes + offset, length, offset + length >= data.length, buffer);
+        [output appendBytes:buffer length:count];
+        free(buffer);
+        offset += length;
+    } while (offset < data.length);
+    YLTextTranscoderDestroy(transcoder);
+    return [[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding];
+}
+
+- (void)testDetect {
+    NSString *text = [self bookText];
+    size_t bomLength;
+    NSData *data = [text dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, &bomLength), YLTextEncodingUTF8);
+    XCTAssertEqual(bomLength, 0);
+    data = [text dataUsingEncoding:[self gb18030]];
+    XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, &bomLength), YLTextEncodingGB18030);
+    data = [text dataUsingEncoding:NSUTF16LittleEndianStringEncoding];
+    XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, &bomLength), YLTextEncodingUTF16LE);
+    XCTAssertEqual(bomLength, 0);
+    data = [text dataUsingEncoding:NSUTF16BigEndianStringEncoding];
+    XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, &bomLength), YLTextEncodingUTF16BE);
+
+    XCTAssertEqual(YLTextEncodingDetect((const uint8_t *)"\xFF\xFE" "a\0", 4, &bomLength), YLTextEncodingUTF16LE);
+    XCTAssertEqual(bomLength, 2);
+    XCTAssertEqual(YLTextEncodingDetect((const uint8_t *)"\xEF\xBB\xBF" "a", 4, &bomLength), YLTextEncodingUTF8);
+    XCTAssertEqual(bomLength, 3);
+    XCTAssertEqual(YLTextEncodingDetect((const uint8_t *)"ascii", 5, NULL), YLTextEncodingUTF8);
+    XCTAssertEqual(YLTextEncodingDetect((const uint8_t *)"短", 3, NULL), YLTextEncodingUTF8);
+    //样本太短时不根据 0 字节判为 UTF-16
+    XCTAssertEqual(YLTextEncodingDetect((const uint8_t *)"ab\0c", 4, NULL), YLTextEncodingUTF8);
+}
+
+- (void)testDetectWithoutBOM {
+    //两个 ASCII 字节按 UTF-16 读取时可能落在汉字区（如 "as" = U+7361），不能因此判为 UTF-16
+    NSMutableString *english = [NSMutableString string];
+    NSMutableString *chinese = [NSMutableString string];
+    for (NSUInteger i = 0; i < 500; i++) {
+        [english appendString:@"Chapter One. It was a dark and stormy night; the rain fell in torrents.\n"];
+        [chinese appendString:@"　　夜已深，漆黑一片，景物不可见。远处传来几声犬吠，他推开门走了出去。\n"];
+    }
+    for (NSString *text in @[english, chinese]) {
+        NSData *data = [text dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, NULL), YLTextEncodingUTF8);
+        data = [text dataUsingEncoding:NSUTF16LittleEndianStringEncoding];
+        XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, NULL), YLTextEncodingUTF16LE);
+        data = [text dataUsingEncoding:NSUTF16BigEndianStringEncoding];
+        XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, NULL), YLTextEncodingUTF16BE);
+    }
+    NSData *data = [chinese dataUsingEncoding:[self gb18030]];
+    XCTAssertEqual(YLTextEncodingDetect(data.bytes, data.length, NULL), YLTextEncodingGB18030);
+}
+
+- (void)testTranscodeMatchesFoundation {
+    NSString *text = [self bookText];
+    NSArray<NSArray *> *cases = @[@[@(YLTextEncodingUTF8), @(NSUTF8StringEncoding)],
+                                  @[@(YLTextEncodingGB18030), @([self gb18030])],
+                                  @[@(YLTextEncodingUTF16LE), @(NSUTF16LittleEndianStringEncoding)],
+                                  @[@(YLTextEncodingUTF16BE), @(NSUTF16BigEndianStringEncoding)]];
+    for (NSArray *item in cases) {
+        NSData *data = [text dataUsingEncoding:[item[1] unsignedIntegerValue]];
+        //分块的边界落在多字节字符中间时结果不变
+        for (NSUInteger chunkLength = 1; chunkLength <= 7; chunkLength++) {
+            XCTAssertEqualObjects([self transcodeData:data encoding:[item[0] intValue] chunkLength:chunkLength], text);
+        }
+        XCTAssertEqualObjects([self transcodeData:data encoding:[item[0] intValue] chunkLength:data.length], text);
+    }
+}
+
+- (void)testGB18030FourByte {
+    //U+00A5、U+FFFF 位于四字节 BMP 区，U+20000 位于增补平面
+    NSString *text = @"\u00A5\uFFFF\U00020000";
+    NSData *data = [text dataUsingEncoding:[self gb18030]];
+    XCTAssertEqual(data.length, 12);
+    XCTAssertEqualObjects([self transcodeData:data encoding:YLTextEncodingGB18030 chunkLength:3], text);
+    XCTAssertEqual(YLTextGB18030DecodeTwoByte(0xD6, 0xD0), 0x4E2D);//中
+    XCTAssertEqual(YLTextGB18030DecodeTwoByte(0x81, 0x7F), 0);
+}
+
+- (void)testInvalidBytes {
+    NSData *data = [NSData dataWithBytes:"a\xFF" "b\xE4\xB8" length:5];
+    XCTAssertEqualObjects([self transcodeData:data encoding:YLTextEncodingUTF8 chunkLength:2], @"a�b�");
+    data = [NSData dataWithBytes:"\x80" "a\x81 \x81\x30" length:6];
+    XCTAssertEqualObjects([self transcodeData:data encoding:YLTextEncodingGB18030 chunkLength:1], @"�a� �");
+    data = [NSData dataWithBytes:"\x00\xDC" "a\x00\x00\xD8" length:6];
+    XCTAssertEqualObjects([self transcodeData:data encoding:YLTextEncodingUTF16LE chunkLength:4], @"�a�");
+}
+
+- (void)testUTF8ValidLength {
+    XCTAssertEqual(YLTextUTF8ValidLength((const uint8_t *)"abc\xE4\xB8\xAD", 6), 6);
+    XCTAssertEqual(YLTextUTF8ValidLength((const uint8_t *)"abc\xE4\xB8", 5), 3);
+    XCTAssertEqual(YLTextUTF8ValidLength((const uint8_t *)"abc\xED\xA0\x80", 6), 3);//代理区
+    XCTAssertEqual(YLTextUTF8ValidLength((const uint8_t *)"abc\xC0\x80", 5), 3);//过长编码
+
+    //按 64 字节分组校验时，非法序列或截断的字符落在组内任意位置（包括跨组）结果不变
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 20; i++) {
+        [text appendString:@"中文a😀é"];
+    }
+    NSData *data = [text dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual(YLTextUTF8ValidLength(data.bytes, data.length), data.length);
+    const uint8_t *bytes = data.bytes;
+    for (NSUInteger offset = 0; offset < data.length; offset++) {
+        NSUInteger start = offset;
+        while (start > 0 && (bytes[start] & 0xC0) == 0x80) {
+            start--;
+        }
+        XCTAssertEqual(YLTextUTF8ValidLength(bytes, offset), start);
+        NSMutableData *invalid = data.mutableCopy;
+        ((uint8_t *)invalid.mutableBytes)[offset] = 0xFF;
+        XCTAssertEqual(YLTextUTF8ValidLength(invalid.bytes, invalid.length), start);
+    }
+}
+
+- (void)testPerformanceTranscodeGB18030 {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 10; i++) {
+        [text appendString:[self bookText]];
+    }
+    NSData *data = [text dataUsingEncoding:[self gb18030]];
+    [self measureBlock:^{
+        [self transcodeData:data encoding:YLTextEncodingGB18030 chunkLength:YLTextEncodingDetectLength];
+    }];
+}
+
+@end
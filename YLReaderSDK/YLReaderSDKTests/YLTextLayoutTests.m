@@ -0,0 +1,134 @@
+//
+//  YLTextLayoutTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextLayout.h"
+#import "YLCoreText.h"
+
+@interface YLTextLayoutTests : XCTestCase
+{
+    YLFixedTextStyle _style;
+    YLFixedTextMetrics _fixedMetrics;
+    YLTextMetrics _metrics;
+}
+
+@property (nonatomic, strong) NSMutableData *charactersData;
+
+@end
+
+@implementation YLTextLayoutTests
+
+- (void)setUp {
+    /// 字号 10：全角字符宽 10，ASCII 宽 5，行高 10；附件 50 x 30
+    YLFixedTextStyleInit(&_style, 10);
+    memset(&_fixedMetrics, 0, sizeof(YLFixedTextMetrics));
+    _fixedMetrics.styles = &_style;
+    _fixedMetrics.styleCount = 1;
+    _fixedMetrics.defaultAttachmentSize = (YLTextSize){50, 30};
+    _metrics = YLFixedTextMetricsMake(&_fixedMetrics);
+}
+
+- (YLTextSource)sourceWithString:(NSString *)string {
+    self.charactersData = [NSMutableData dataWithLength:MAX(string.length, 1) * sizeof(unichar)];
+    [string getCharacters:self.charactersData.mutableBytes range:NSMakeRange(0, string.length)];
+    YLTextSource source = {self.charactersData.bytes, string.length, NULL, 0};
+    return source;
+}
+
+- (NSUInteger)lineEndForString:(NSString *)string width:(double)width line:(YLTextLine *)line {
+    YLTextSource source = [self sourceWithString:string];
+    YLTextLayoutConfig config = {width, 1000, 0, 0, true};
+    return YLTextLayoutLine(&source, &_metrics, &config, 0, source.length, line);
+}
+
+- (void)testCJKWrapsAtAnyIdeograph {
+    YLTextLine line;
+    XCTAssertEqual([self lineEndForString:@"一二三四五六" width:40 line:&line], 4);
+    XCTAssertEqual(line.width, 40);
+}
+
+- (void)testClosingPunctuationNeverStartsLine {
+    YLTextLine line;
+    XCTAssertEqual([self lineEndForString:@"一二三，四" width:30 line:&line], 2);
+    XCTAssertEqual([self lineEndForString:@"一二「三四" width:30 line:&line], 2);
+}
+
+- (void)testLatinBreaksAfterSpacesAndHangsTrailingSpaces {
+    YLTextLine line;
+    XCTAssertEqual([self lineEndForString:@"ab cd  ef" width:25 line:&line], 7);
+    XCTAssertEqual(line.width, 25);
+    XCTAssertEqual([self lineEndForString:@"abcdefghij" width:20 line:&line], 4);
+}
+
+- (void)testParagraphBreakEndsLine {
+    YLTextLine line;
+    XCTAssertEqual([self lineEndForString:@"一二\r\n三" width:100 line:&line], 4);
+    XCTAssertTrue(line.paragraphEnd);
+}
+
+- (void)testAttachmentUsesDeclaredSize {
+    YLTextLine line;
+    NSString *string = [NSString stringWithFormat:@"文%C文", (unichar)YLTextAttachmentCharacter];
+    XCTAssertEqual([self lineEndForString:string width:100 line:&line], 3);
+    XCTAssertEqual(line.width, 70);
+    XCTAssertEqual(line.ascent, 30);
+}
+
+- (void)testSurrogatePairsAreNotSplit {
+    YLTextLine line;
+    XCTAssertEqual([self lineEndForString:@"😀😀😀" width:12 line:&line], 4);
+}
+
+- (void)testPaginationAppliesLineAndParagraphSpacing {
+    YLTextSource source = [self sourceWithString:@"一二三四五六七\nhello world"];
+    YLTextLayoutConfig config = {40, 35, 2, 5, true};
+    YLTextLayoutResult result;
+    YLTextLayoutResultInit(&result);
+    XCTAssertTrue(YLTextLayoutPaginate(&source, &_metrics, &config, 0, source.length, &result));
+
+    XCTAssertEqual(result.lineCount, 4);
+    XCTAssertEqual(result.lines[1].top, 12);
+    XCTAssertEqual(result.pageCount, 2);
+    XCTAssertEqual(result.pages[0].location, 0);
+    XCTAssertEqual(result.pages[0].length, 8);
+    XCTAssertEqual(result.pages[0].contentHeight, 22);
+    XCTAssertEqual(result.pages[1].location, 8);
+    XCTAssertEqual(result.pages[1].firstLine, 2);
+    XCTAssertEqual(result.pages[1].lineCount, 2);
+    YLTextLayoutResultDestroy(&result);
+}
+
+- (void)testOversizedLineGetsItsOwnPage {
+    _fixedMetrics.defaultAttachmentSize = (YLTextSize){20, 500};
+    NSString *string = [NSString stringWithFormat:@"一\n%C\n二", (unichar)YLTextAttachmentCharacter];
+    YLTextSource source = [self sourceWithString:string];
+    YLTextLayoutConfig config = {100, 100, 0, 0, false};
+    YLTextLayoutResult result;
+    YLTextLayoutResultInit(&result);
+    XCTAssertTrue(YLTextLayoutPaginate(&source, &_metrics, &config, 0, source.length, &result));
+    XCTAssertEqual(result.pageCount, 3);
+    XCTAssertEqual(result.pages[1].location, 2);
+    XCTAssertEqual(result.pages[1].length, 2);
+    YLTextLayoutResultDestroy(&result);
+}
+
+- (void)testCoreTextAdapterCoversWholeText {
+    NSString *dataPath = [[NSBundle bundleForClass:YLCoreText.class] pathForResource:@"Data" ofType:@"txt"];
+    NSString *text = [NSString stringWithContentsOfFile:dataPath encoding:NSUTF8StringEncoding error:nil];
+    NSAttributedString *string = [[NSAttributedString alloc] initWithString:text attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}];
+    NSArray<NSValue *> *ranges = getPageRangesWithTextLayout(string, CGRectMake(0, 0, 300, 500));
+
+    NSUInteger location = 0;
+    for (NSValue *value in ranges) {
+        XCTAssertEqual(value.rangeValue.location, location);
+        XCTAssertGreaterThan(value.rangeValue.length, 0);
+        location = NSMaxRange(value.rangeValue);
+    }
+    XCTAssertEqual(location, string.length);
+}
+
+@end
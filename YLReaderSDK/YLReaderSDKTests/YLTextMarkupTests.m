@@ -0,0 +1,88 @@
+//
+//  YLTextMarkupTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextMarkup.h"
+#import "YLCoreText.h"
+
+@interface YLTextMarkupTests : XCTestCase
+
+@end
+
+@implementation YLTextMarkupTests
+
+- (NSMutableAttributedString *)handleString:(NSString *)string {
+    NSMutableAttributedString *attrString = [[NSMutableAttributedString alloc] initWithString:string attributes:@{NSFontAttributeName: [UIFont systemFontOfSize:15]}];
+    handleAttrString(attrString, CGRectMake(0, 0, 300, 500));
+    return attrString;
+}
+
+/// 包含 count 个网页链接的正文
+- (NSString *)textWithLinkCount:(NSUInteger)count {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < count; i++) {
+        [text appendFormat:@"　　夜已深，漆黑一片，景物不可见。<WebLink:link=https://www.baidu.com/s?wd=%lu,title=链接%lu>但山中并不宁静。\n", (unsigned long)i % 10, (unsigned long)i];
+    }
+    return text;
+}
+
+- (void)testWebLinkFields {
+    NSMutableAttributedString *attrString = [self handleString:@"前<WebLink:link=https://a.com/?q=1,2,title=《完美世界》>后"];
+    XCTAssertEqualObjects(attrString.string, @"前《完美世界》后");
+    YLAttachment *web = [attrString attribute:kYLAttachmentAttributeName atIndex:1 effectiveRange:NULL];
+    XCTAssertEqualObjects(web.url, @"https://a.com/?q=1,2");
+    XCTAssertEqualObjects(web.title, @"《完美世界》");
+    XCTAssertNil([attrString attribute:kYLAttachmentAttributeName atIndex:0 effectiveRange:NULL]);
+    XCTAssertNotNil([attrString attribute:NSFontAttributeName atIndex:attrString.length - 1 effectiveRange:NULL]);
+}
+
+- (void)testDuplicateLinksKeepTheirPositions {
+    NSMutableAttributedString *attrString = [self handleString:@"一<WebLink:link=a,title=甲>二<WebLink:link=b,title=乙>三<WebLink:link=a,title=甲>"];
+    XCTAssertEqualObjects(attrString.string, @"一甲二乙三甲");
+    XCTAssertEqualObjects([[attrString attribute:kYLAttachmentAttributeName atIndex:3 effectiveRange:NULL] url], @"b");
+    XCTAssertEqualObjects([[attrString attribute:kYLAttachmentAttributeName atIndex:5 effectiveRange:NULL] url], @"a");
+}
+
+- (void)testUnclosedTagsAreKept {
+    NSString *text = @"<ImageLink:abc\n> <WebLink:link=a";
+    XCTAssertEqualObjects([self handleString:text].string, text);
+}
+
+- (void)testScanIsCaseInsensitive {
+    NSString *text = @"<imagelink:x><WEBLINK:title=t>";
+    unichar characters[64];
+    [text getCharacters:characters range:NSMakeRange(0, text.length)];
+    YLTextMarkupToken *tokens = NULL;
+    XCTAssertEqual(YLTextMarkupScan(characters, text.length, &tokens), 2);
+    XCTAssertEqual(tokens[0].kind, YLTextMarkupImageLink);
+    XCTAssertEqual(tokens[1].kind, YLTextMarkupWebLink);
+    XCTAssertEqual(tokens[1].title.location, 28);
+    free(tokens);
+}
+
+/// 5000 个链接的正文转换耗时
+- (void)testHandleAttrStringPerformance {
+    NSString *text = [self textWithLinkCount:5000];
+    [self measureBlock:^{
+        NSMutableAttributedString *attrString = [self handleString:text];
+        XCTAssertEqual([attrString.string rangeOfString:@"<WebLink:"].location, NSNotFound);
+    }];
+}
+
+/// 5000 个链接的词法分析耗时
+- (void)testScanPerformance {
+    NSString *text = [self textWithLinkCount:5000];
+    NSMutableData *data = [NSMutableData dataWithLength:text.length * sizeof(unichar)];
+    [text getCharacters:data.mutableBytes range:NSMakeRange(0, text.length)];
+    [self measureBlock:^{
+        YLTextMarkupToken *tokens = NULL;
+        XCTAssertEqual(YLTextMarkupScan(data.bytes, text.length, &tokens), 5000);
+        free(tokens);
+    }];
+}
+
+@end
@@ -0,0 +1,125 @@
+//
+//  YLTextParallelLayoutTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextParallelLayout.h"
+#import "YLCoreText.h"
+
+@interface YLTextParallelLayoutTests : XCTestCase
+{
+    YLFixedTextStyle _style;
+    YLFixedTextMetrics _fixedMetrics;
+    YLTextMetrics _metrics;
+}
+
+@property (nonatomic, strong) NSMutableData *charactersData;
+
+@end
+
+@implementation YLTextParallelLayoutTests
+
+- (void)setUp {
+    YLFixedTextStyleInit(&_style, 15);
+    memset(&_fixedMetrics, 0, sizeof(YLFixedTextMetrics));
+    _fixedMetrics.styles = &_style;
+    _fixedMetrics.styleCount = 1;
+    _fixedMetrics.defaultAttachmentSize = (YLTextSize){100, 100};
+    _metrics = YLFixedTextMetricsMake(&_fixedMetrics);
+}
+
+- (YLTextSource)sourceWithString:(NSString *)string {
+    self.charactersData = [NSMutableData dataWithLength:MAX(string.length, 1) * sizeof(unichar)];
+    [string getCharacters:self.charactersData.mutableBytes range:NSMakeRange(0, string.length)];
+    YLTextSource source = {self.charactersData.bytes, string.length, NULL, 0};
+    return source;
+}
+
+/// 生成 chapterCount 章的测试文本，每章若干长短不一的段落
+- (NSString *)bookWithChapterCount:(NSUInteger)chapterCount {
+    NSString *dataPath = [[NSBundle bundleForClass:YLCoreText.class] pathForResource:@"Data" ofType:@"txt"];
+    NSString *text = [NSString stringWithContentsOfFile:dataPath encoding:NSUTF8StringEncoding error:nil];
+    NSMutableString *book = [NSMutableString string];
+    for (NSUInteger i = 0; i < chapterCount; i++) {
+        [book appendFormat:@"第%lu章 标题\n", (unsigned long)i + 1];
+        [book appendString:[text substringToIndex:text.length / (i % 3 + 1)]];
+        [book appendString:@"\n"];
+    }
+    return book;
+}
+
+- (void)testFindPageBreaks {
+    YLTextSource source = [self sourceWithString:@"第一章 开始\n正文第二章\n　　第十二章 中\n第章\n\f下一页\n第3回"];
+    size_t *breaks = NULL;
+    size_t count = 0;
+    XCTAssertTrue(YLTextFindPageBreaks(&source, 0, source.length, &breaks, &count));
+    XCTAssertEqual(count, 3);
+    XCTAssertEqual(breaks[0], 13);
+    XCTAssertEqual(breaks[1], 26);
+    XCTAssertEqual(breaks[2], 30);
+    free(breaks);
+}
+
+- (void)testParallelMatchesSequential {
+    YLTextSource source = [self sourceWithString:[self bookWithChapterCount:60]];
+    size_t *breaks = NULL;
+    size_t breakCount = 0;
+    XCTAssertTrue(YLTextFindPageBreaks(&source, 0, source.length, &breaks, &breakCount));
+    XCTAssertEqual(breakCount, 59);
+
+    YLTextLayoutConfig config = {300, 500, 4, 8, true, breaks, breakCount};
+    YLTextLayoutResult sequential;
+    YLTextLayoutResultInit(&sequential);
+    XCTAssertTrue(YLTextLayoutPaginate(&source, &_metrics, &config, 0, source.length, &sequential));
+
+    //每个强制分页位置都是某一页的起点
+    size_t pageIndex = 0;
+    for (size_t i = 0; i < breakCount; i++) {
+        while (pageIndex < sequential.pageCount && sequential.pages[pageIndex].location < breaks[i]) {
+            pageIndex++;
+        }
+        XCTAssertTrue(pageIndex < sequential.pageCount && sequential.pages[pageIndex].location == breaks[i]);
+    }
+
+    for (size_t threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        YLTextLayoutResult parallel;
+        YLTextLayoutResultInit(&parallel);
+        XCTAssertTrue(YLTextLayoutPaginateParallel(&source, &_metrics, &config, 0, source.length, threadCount, &parallel));
+        XCTAssertEqual(parallel.pageCount, sequential.pageCount);
+        XCTAssertEqual(parallel.lineCount, sequential.lineCount);
+        XCTAssertEqual(memcmp(parallel.pages, sequential.pages, sequential.pageCount * sizeof(YLTextPage)), 0);
+        XCTAssertEqual(memcmp(parallel.lines, sequential.lines, sequential.lineCount * sizeof(YLTextLine)), 0);
+        YLTextLayoutResultDestroy(&parallel);
+    }
+    YLTextLayoutResultDestroy(&sequential);
+    free(breaks);
+}
+
+/// 对比 1、2、4、8 线程的分页耗时，结果输出到日志
+- (void)testParallelSpeedup {
+    YLTextSource source = [self sourceWithString:[self bookWithChapterCount:2000]];
+    size_t *breaks = NULL;
+    size_t breakCount = 0;
+    XCTAssertTrue(YLTextFindPageBreaks(&source, 0, source.length, &breaks, &breakCount));
+    YLTextLayoutConfig config = {355, 700, 4, 8, false, breaks, breakCount};
+
+    CFAbsoluteTime baseline = 0;
+    for (size_t threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        YLTextLayoutResult result;
+        YLTextLayoutResultInit(&result);
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        XCTAssertTrue(YLTextLayoutPaginateParallel(&source, &_metrics, &config, 0, source.length, threadCount, &result));
+        CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+        if (threadCount == 1) {
+            baseline = duration;
+        }
+        NSLog(@"分页 %zu 字，%zu 页，%zu 线程：%.1f ms，加速比 %.2f", source.length, result.pageCount, threadCount, duration * 1000, baseline / duration);
+        YLTextLayoutResultDestroy(&result);
+    }
+    free(breaks);
+}
+
+@end
@@ -0,0 +1,231 @@
+//
+//  YLTextSearchTests.m
+//  YLReaderSDKTests
+//
+//  Created by long on 2026/10/19.
+//
+
+#import <XCTest/XCTest.h>
+#import "YLTextSearch.h"
+#import "YLBookSearch.h"
+#import "YLCoreText.h"
+
+@interface YLTextSearchTests : XCTestCase
+
+@property (nonatomic, copy) NSString *path;
+
+@end
+
+@implementation YLTextSearchTests
+
+- (void)setUp {
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YLTextSearchTests.txt"];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtPath:self.path error:nil];
+    [NSFileManager.defaultManager removeItemAtPath:[self.path stringByAppendingPathExtension:@"ylsearch"] error:nil];
+}
+
+- (NSString *)bookText {
+    NSArray<NSString *> *sentences = @[@"　　夜已深，漆黑一片，景物不可见。", @"但山中并不宁静。", @"Mountain 的 ＭＯＵＮＴＡＩＮ ", @"石村，石村，石村😀。\n"];
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 30; i++) {
+        [text appendFormat:@"　　第%lu章 标题\n", (unsigned long)i + 1];
+        for (NSUInteger j = 0; j < 100; j++) {
+            [text appendString:sentences[(i * 7 + j) % sentences.count]];
+        }
+    }
+    return text;
+}
+
+- (YLTextSearchIndex *)createIndexWithText:(NSString *)text {
+    NSUInteger length = text.length;
+    unichar *characters = malloc(length * sizeof(unichar));
+    [text getCharacters:characters range:NSMakeRange(0, length)];
+    YLTextSearchIndex *index = YLTextSearchIndexCreate();
+    //分两次追加，位置连续
+    YLTextSearchIndexAppend(index, characters, length / 2);
+    YLTextSearchIndexAppend(index, characters + length / 2, length - length / 2);
+    YLTextSearchIndexFinish(index);
+    free(characters);
+    return index;
+}
+
+- (NSArray<NSNumber *> *)findText:(NSString *)query inIndex:(YLTextSearchIndex *)index batch:(size_t)batch {
+    NSUInteger length = query.length;
+    unichar characters[length + 1];
+    [query getCharacters:characters range:NSMakeRange(0, length)];
+    NSMutableArray<NSNumber *> *result = [NSMutableArray array];
+    size_t hits[batch];
+    size_t from = 0;
+    while (YES) {
+        size_t count = YLTextSearchIndexFind(index, characters, length, from, hits, batch);
+        for (size_t i = 0; i < count; i++) {
+            [result addObject:@(hits[i])];
+        }
+        if (count < batch) {
+            break;
+        }
+        from = hits[count - 1] + 1;
+    }
+    return result;
+}
+
+/// 逐个位置比较，重叠的位置也算
+- (NSArray<NSNumber *> *)scanText:(NSString *)query inText:(NSString *)text {
+    NSMutableArray<NSNumber *> *result = [NSMutableArray array];
+    NSRange range = NSMakeRange(0, text.length);
+    NSStringCompareOptions options = NSCaseInsensitiveSearch | NSWidthInsensitiveSearch | NSLiteralSearch;
+    while (range.length) {
+        NSRange found = [text rangeOfString:query options:options range:range];
+        if (found.location == NSNotFound) {
+            break;
+        }
+        [result addObject:@(found.location)];
+        range = NSMakeRange(found.location + 1, text.length - found.location - 1);
+    }
+    return result;
+}
+
+- (void)testFindMatchesLinearScan {
+    NSString *text = [self bookText];
+    YLTextSearchIndex *index = [self createIndexWithText:text];
+    XCTAssertEqual(YLTextSearchIndexLength(index), text.length);
+    for (NSString *query in @[@"石村", @"石村，石", @"村", @"山中并不宁静", @"mountain", @"MOUNTAIN", @"ｍｏｕｎ", @"😀", @"第12章", @"不存在的文字", @"\n　　第"]) {
+        NSArray<NSNumber *> *expected = [self scanText:query inText:text];
+        XCTAssertEqualObjects([self findText:query inIndex:index batch:1000000], expected, @"%@", query);
+        //分批查询的结果与一次查询相同
+        XCTAssertEqualObjects([self findText:query inIndex:index batch:7], expected, @"%@", query);
+    }
+    YLTextSearchIndexDestroy(index);
+}
+
+- (void)testWriteAndRead {
+    NSString *text = [self bookText];
+    YLTextSearchIndex *index = [self createIndexWithText:text];
+    const char *path = [self.path stringByAppendingPathExtension:@"ylsearch"].fileSystemRepresentation;
+    XCTAssertTrue(YLTextSearchIndexWrite(index, path, 42));
+    //版本标记不一致时视为过期
+    XCTAssertTrue(YLTextSearchIndexRead(path, 43) == NULL);
+
+    YLTextSearchIndex *loaded = YLTextSearchIndexRead(path, 42);
+    XCTAssertTrue(loaded != NULL);
+    XCTAssertEqual(YLTextSearchIndexLength(loaded), text.length);
+    for (NSString *query in @[@"石村", @"宁静", @"Mountain 的"]) {
+        XCTAssertEqualObjects([self findText:query inIndex:loaded batch:64], [self findText:query inIndex:index batch:64]);
+    }
+    YLTextSearchIndexDestroy(loaded);
+    YLTextSearchIndexDestroy(index);
+}
+
+- (void)testReadCorruptedIndex {
+    YLTextSearchIndex *index = [self createIndexWithText:[self bookText]];
+    NSString *path = [self.path stringByAppendingPathExtension:@"ylsearch"];
+    XCTAssertTrue(YLTextSearchIndexWrite(index, path.fileSystemRepresentation, 42));
+    YLTextSearchIndexDestroy(index);
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    //文件头之后依次为 text、keys、starts
+    uint64_t length, keyCount;
+    [data getBytes:&length range:NSMakeRange(16, 8)];
+    [data getBytes:&keyCount range:NSMakeRange(24, 8)];
+    NSUInteger starts = 32 + length * sizeof(uint16_t) + keyCount * sizeof(uint32_t);
+    NSArray<NSArray<NSNumber *> *> *patches = @[@[@(starts), @(UINT32_MAX / 2)],          //starts[0] 越界
+                                                @[@(starts + 4), @(0)],                    //starts 不单调
+                                                @[@(starts - 4 * keyCount), @(UINT32_MAX)],//keys 不递增
+                                                @[@(24), @(UINT32_MAX)]];                  //文件头与文件长度不符
+    for (NSArray<NSNumber *> *patch in patches) {
+        NSMutableData *corrupted = data.mutableCopy;
+        uint32_t value = patch[1].unsignedIntValue;
+        [corrupted replaceBytesInRange:NSMakeRange(patch[0].unsignedIntegerValue, sizeof(value)) withBytes:&value];
+        [corrupted writeToFile:path atomically:YES];
+        XCTAssertTrue(YLTextSearchIndexRead(path.fileSystemRepresentation, 42) == NULL);
+    }
+    [[data subdataWithRange:NSMakeRange(0, data.length - 1)] writeToFile:path atomically:YES];
+    XCTAssertTrue(YLTextSearchIndexRead(path.fileSystemRepresentation, 42) == NULL);
+}
+
+- (void)testSourceMap {
+    NSString *source = @"一<WebLink:link=b,title=乙>二<WebLink:link=c>三";
+    NSMutableAttributedString *attrString = [[NSMutableAttributedString alloc] initWithString:source];
+    NSMutableArray<NSValue *> *sourceMap = [NSMutableArray array];
+    handleAttrStringWithSourceMap(attrString, CGRectMake(0, 0, 300, 600), sourceMap);
+    XCTAssertEqualObjects(attrString.string, @"一乙二c三");
+    XCTAssertEqual(getSourceLocation(sourceMap, 0), 0);
+    XCTAssertEqual(getSourceLocation(sourceMap, 2), [source rangeOfString:@"二"].location);
+    XCTAssertEqual(getSourceLocation(sourceMap, 4), [source rangeOfString:@"三"].location);
+
+    //逆运算：处理后的每个位置往返不变，标签内的原文位置对应到替换内容的末尾
+    for (NSUInteger location = 0; location <= attrString.length; location++) {
+        XCTAssertEqual(getHandledLocation(sourceMap, getSourceLocation(sourceMap, location)), location);
+    }
+    XCTAssertEqual(getHandledLocation(sourceMap, [source rangeOfString:@"title"].location), 2);
+}
+
+- (void)writeBookWithText:(NSString *)text {
+    NSMutableData *data = [NSMutableData dataWithBytes:"\xEF\xBB\xBF" length:3];
+    [data appendData:[text dataUsingEncoding:NSUTF8StringEncoding]];
+    [data writeToFile:self.path atomically:YES];
+}
+
+- (void)testBookSearch {
+    NSString *text = [self bookText];
+    [self writeBookWithText:text];
+
+    YLBookSearch *search = [[YLBookSearch alloc] initWithPath:self.path];
+    XCTAssertEqualObjects(search.indexPath, [self.path stringByAppendingPathExtension:@"ylsearch"]);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"search"];
+    NSMutableArray<NSNumber *> *locations = [NSMutableArray array];
+    [search searchText:@"石村" resultHandler:^(NSArray<NSNumber *> *batch, BOOL finished) {
+        XCTAssertTrue(NSThread.isMainThread);
+        [locations addObjectsFromArray:batch];
+        if (finished) {
+            [expectation fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertTrue(search.indexReady);
+    XCTAssertEqualObjects(locations, [self scanText:@"石村" inText:text]);
+    XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:search.indexPath]);
+
+    //读取已保存的索引
+    YLBookSearch *reopened = [[YLBookSearch alloc] initWithPath:self.path];
+    XCTestExpectation *prepared = [self expectationWithDescription:@"prepare"];
+    [reopened prepareIndexWithCompletion:^(BOOL success) {
+        XCTAssertTrue(success);
+        [prepared fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertEqualObjects([reopened locationsOfText:@"宁静" limit:3], [[self scanText:@"宁静" inText:text] subarrayWithRange:NSMakeRange(0, 3)]);
+}
+
+- (void)testCancelSearch {
+    [self writeBookWithText:[self bookText]];
+    YLBookSearch *search = [[YLBookSearch alloc] initWithPath:self.path];
+    [search searchText:@"石村" resultHandler:^(NSArray<NSNumber *> *batch, BOOL finished) {
+        XCTFail(@"cancelled search should not call back");
+    }];
+    [search cancelSearch];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"prepare"];
+    [search prepareIndexWithCompletion:^(BOOL success) {
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+- (void)testPerformanceFind {
+    NSMutableString *text = [NSMutableString string];
+    for (NSUInteger i = 0; i < 20; i++) {
+        [text appendString:[self bookText]];
+    }
+    YLTextSearchIndex *index = [self createIndexWithText:text];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100; i++) {
+            [self findText:@"山中并不宁静" inIndex:index batch:256];
+        }
+    }];
+    YLTextSearchIndexDestroy(index);
+}
+
+@end
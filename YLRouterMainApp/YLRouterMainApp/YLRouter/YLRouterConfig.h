@@ -6,6 +6,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import <JLRoutes/JLRRouteDeclaration.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -58,9 +59,49 @@ FOUNDATION_EXPORT NSString* const kYLRouteURL_User_Set_NickName;
 
 
 
+/********* 路由元数据 ******/
+
+/// 跳转方式
+typedef NS_ENUM(uint8_t, YLRouterSegue) {
+    YLRouterSeguePush = 0,
+    YLRouterSegueModal,
+};
+
+typedef NS_OPTIONS(uint8_t, YLRouterSegueOptions) {
+    YLRouterSegueAnimated = 1 << 0,           //动画切换，默认开启
+    YLRouterSegueHidesBottomBar = 1 << 1,     //hidesBottomBarWhenPushed，默认开启
+    YLRouterSegueModalNavigation = 1 << 2,    //Modal 时包一层导航控制器
+    YLRouterSegueModalNavigationSpecified = 1 << 3, //指定过 kYLRouterSegueModalIsNeedNavigationKey
+};
+
+/** 路由的元数据：注册时由配置字典解析一次，跳转与拦截时直接读取，不再查字典
+ */
+typedef struct YLRouterMetadata {
+    NSInteger permissionLevel; //kYLRouterUserPermissionLevel，默认 0
+    YLRouterSegue segue;       //kYLRouterSegueKey，默认 Push
+    YLRouterSegueOptions options;
+} YLRouterMetadata;
+
+/// 默认的元数据：Push、动画、隐藏 TabBar
+FOUNDATION_EXPORT YLRouterMetadata const YLRouterMetadataDefault;
+
+/// 由配置字典生成路由的元数据，注册时调用
+FOUNDATION_EXPORT YLRouterMetadata YLRouterMetadataMake(NSDictionary *routerMap);
+
+/** 以调用时传入的参数覆盖跳转方式
+ * 权限等级只由配置决定，不能通过 URL 或参数修改
+ */
+FOUNDATION_EXPORT YLRouterMetadata YLRouterMetadataApplyParameters(YLRouterMetadata metadata, NSDictionary *_Nullable parameters);
+
+
+/** 控制器路由在各自的源文件中用 JLR_ROUTE_DECLARE 声明，scheme 为 kYLRouterMainScheme，不必在启动时注册：
+ * JLR_ROUTE_DECLARE(userSet, "YLRouterMain", "User/set", 0, "UserSetViewController", "navigationItemTitle=用户设置&User_Permission_Level=0");
+ * target 为控制器类名；metadata 形如 key=value&key=value，key 为上面的参数名，value 可以百分号编码
+ */
 @interface YLRouterConfig : NSObject
 
-+ (NSDictionary *)configMapInfo;
+/// 声明路由对应的配置字典：kYLRouterViewController 为 target，其余为 metadata 中的参数
++ (NSDictionary *)routerMapWithDeclaration:(const jlr_route_declaration *)declaration;
 
 @end
 
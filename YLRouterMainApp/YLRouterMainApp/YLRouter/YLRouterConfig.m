@@ -48,28 +48,69 @@ NSString* const kYLRouteURLWebview = @"YLRouterMain://webView?usert=123456&nickN
 NSString* const kYLRouteURL_User_Set = @"YLRouterMain://User/set";
 NSString* const kYLRouteURL_User_Set_NickName = @"YLRouterMain://User/set/nickName";
 
+YLRouterMetadata const YLRouterMetadataDefault = {0, YLRouterSeguePush, YLRouterSegueAnimated | YLRouterSegueHidesBottomBar};
+
+static inline YLRouterSegueOptions setOption(YLRouterSegueOptions options, YLRouterSegueOptions option, BOOL on){
+    return on ? (options | option) : (options & ~option);
+}
+
+YLRouterMetadata YLRouterMetadataApplyParameters(YLRouterMetadata metadata, NSDictionary *parameters){
+    if (parameters.count == 0) {
+        return metadata;
+    }
+    id value = parameters[kYLRouterSegueKey];
+    if (value) {
+        //只有 kYLRouterSeguePush 执行 Push，其余取值都执行 Modal
+        metadata.segue = [value isEqual:kYLRouterSeguePush] ? YLRouterSeguePush : YLRouterSegueModal;
+    }
+    value = parameters[kYLRouterSegueAnimatedKey];
+    if (value) {
+        metadata.options = setOption(metadata.options, YLRouterSegueAnimated, [value boolValue]);
+    }
+    value = parameters[kYLRouterSegueHidesBottomBarKey];
+    if (value) {
+        metadata.options = setOption(metadata.options, YLRouterSegueHidesBottomBar, [value boolValue]);
+    }
+    value = parameters[kYLRouterSegueModalIsNeedNavigationKey];
+    if (value) {
+        metadata.options = setOption(metadata.options, YLRouterSegueModalNavigation, [value boolValue]);
+        metadata.options |= YLRouterSegueModalNavigationSpecified;
+    }
+    return metadata;
+}
+
+YLRouterMetadata YLRouterMetadataMake(NSDictionary *routerMap){
+    YLRouterMetadata metadata = YLRouterMetadataApplyParameters(YLRouterMetadataDefault, routerMap);
+    metadata.permissionLevel = [routerMap[kYLRouterUserPermissionLevel] integerValue];
+    return metadata;
+}
+
+/// App 内控制器的路由：链接进 __DATA,__jlr_routes 段，第一次跳转时由 JLRoutes 注册
+JLR_ROUTE_DECLARE(webView, "YLRouterMain", "webView", 0, "YLWebViewController", "navigationItemTitle=WebView&User_Permission_Level=0");
+JLR_ROUTE_DECLARE(reader, "YLRouterMain", "reader", 0, "YLReaderViewController", "navigationItemTitle=阅读器&User_Permission_Level=0");
+JLR_ROUTE_DECLARE(userSet, "YLRouterMain", "User/set", 0, "UserSetViewController", "navigationItemTitle=用户设置&User_Permission_Level=0");
+JLR_ROUTE_DECLARE(userSetNickName, "YLRouterMain", "User/set/nickName", 0, "UserSetNickNameViewController", "navigationItemTitle=用户昵称设置&User_Permission_Level=0");
+
 @implementation YLRouterConfig
 
-+ (NSDictionary *)configMapInfo {
-    
-    return @{
-        kYLRouteURLWebview: @{kYLRouterViewController: @"YLWebViewController",
-                             kYLRouterControllerTitle: @"WebView",
-                             kYLRouterUserPermissionLevel: @(0),
-        },
-        kYLRouteURLReader: @{kYLRouterViewController: @"YLReaderViewController",
-                            kYLRouterControllerTitle: @"阅读器",
-                            kYLRouterUserPermissionLevel: @(0),
-        },
-        kYLRouteURL_User_Set: @{kYLRouterViewController: @"UserSetViewController",
-                               kYLRouterControllerTitle: @"用户设置",
-                               kYLRouterUserPermissionLevel: @(0),
-        },
-        kYLRouteURL_User_Set_NickName: @{kYLRouterViewController: @"UserSetNickNameViewController",
-                               kYLRouterControllerTitle: @"用户昵称设置",
-                               kYLRouterUserPermissionLevel: @(0),
-        },
-    };
++ (NSDictionary *)routerMapWithDeclaration:(const jlr_route_declaration *)declaration {
+    NSMutableDictionary *routerMap = [NSMutableDictionary dictionary];
+    if (declaration->target) {
+        routerMap[kYLRouterViewController] = [NSString stringWithUTF8String:declaration->target];
+    }
+    NSString *metadata = declaration->metadata ? [NSString stringWithUTF8String:declaration->metadata] : nil;
+    for (NSString *pair in [metadata componentsSeparatedByString:@"&"]) {
+        NSRange range = [pair rangeOfString:@"="];
+        if (range.location == NSNotFound) {
+            continue;
+        }
+        NSString *key = [[pair substringToIndex:range.location] stringByRemovingPercentEncoding];
+        NSString *value = [[pair substringFromIndex:NSMaxRange(range)] stringByRemovingPercentEncoding];
+        if (key.length && value) {
+            routerMap[key] = value;
+        }
+    }
+    return [routerMap copy];
 }
 
 @end
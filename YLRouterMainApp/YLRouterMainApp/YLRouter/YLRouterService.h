@@ -17,11 +17,31 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (void)addRoute:(NSString* )route handler:(BOOL (^)(NSDictionary *parameters))handlerBlock;//注册 Router,调用 Router 时会触发回调;
 
+/** 拦截器：跳转到控制器之前按添加顺序调用，直接读取路由的元数据
+ * @param route 配置中的路由
+ * @param metadata 注册时解析的元数据，已合并调用参数中的跳转方式
+ * @return 返回 NO 时中断跳转，openURL 返回 NO
+ */
+typedef BOOL(^YLRouterInterceptor)(NSString *route, const YLRouterMetadata *metadata, NSDictionary *parameters);
+
+/// 在主线程添加拦截器
++ (void)addInterceptor:(YLRouterInterceptor)interceptor;
+
+/// 当前用户的权限等级，低于路由的 kYLRouterUserPermissionLevel 时拦截跳转（在所有拦截器之前检查）；默认 0
+@property (class, nonatomic, assign) NSInteger userPermissionLevel;
+/// 因权限不足被拦截时回调，如跳转到登录页
+@property (class, nonatomic, copy, nullable) void(^permissionDeniedHandler)(NSString *route, const YLRouterMetadata *metadata);
+
 @end
 
 
 @interface YLRouterService (Handler)
 
+/** 配置路由，在 application:didFinishLaunchingWithOptions: 中、任何跳转之前调用；重复调用无效
+ * 声明的路由本身在第一次跳转时才由 JLRoutes 注册
+ */
++ (void)registerRouter;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -21,6 +21,11 @@ static inline JLRoutes *YLRouter(void){
     return [JLRoutes routesForScheme:kYLRouterMainScheme];
 }
 
+/// 拦截器列表，添加时整体替换，遍历时不必加锁
+static NSArray<YLRouterInterceptor> *routerInterceptors;
+static NSInteger routerUserPermissionLevel;
+static void(^routerPermissionDeniedHandler)(NSString *route, const YLRouterMetadata *metadata);
+
 @implementation YLRouterService
 
 + (BOOL)openURL:(NSString *)url {
@@ -35,18 +40,61 @@ static inline JLRoutes *YLRouter(void){
     [YLRouter() addRoute:routePatternFromUrl(route) handler:handlerBlock];
 }
 
+#pragma mark - 拦截器
+
++ (void)addInterceptor:(YLRouterInterceptor)interceptor {
+    NSMutableArray<YLRouterInterceptor> *interceptors = routerInterceptors ? [routerInterceptors mutableCopy] : [NSMutableArray array];
+    [interceptors addObject:[interceptor copy]];
+    routerInterceptors = [interceptors copy];
+}
+
++ (NSInteger)userPermissionLevel {
+    return routerUserPermissionLevel;
+}
+
++ (void)setUserPermissionLevel:(NSInteger)userPermissionLevel {
+    routerUserPermissionLevel = userPermissionLevel;
+}
+
++ (void (^)(NSString * _Nonnull, const YLRouterMetadata * _Nonnull))permissionDeniedHandler {
+    return routerPermissionDeniedHandler;
+}
+
++ (void)setPermissionDeniedHandler:(void (^)(NSString * _Nonnull, const YLRouterMetadata * _Nonnull))permissionDeniedHandler {
+    routerPermissionDeniedHandler = [permissionDeniedHandler copy];
+}
+
+/// 依次检查权限等级与拦截器，任一不通过即中断跳转
++ (BOOL)shouldRoute:(NSString *)route metadata:(const YLRouterMetadata *)metadata parameters:(NSDictionary *)parameters {
+    if (metadata->permissionLevel > routerUserPermissionLevel) {
+        if (routerPermissionDeniedHandler) {
+            routerPermissionDeniedHandler(route, metadata);
+        }
+        return NO;
+    }
+    for (YLRouterInterceptor interceptor in routerInterceptors) {
+        if (!interceptor(route, metadata, parameters)) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
 #pragma mark - mark JLRouter
 
 /** 如果线上App出现紧急bug了，如何不用JSPatch，就能做到简单的热修复功能？
  *  可以考虑把页面动态降级成 H5 ；或者是直接换成一个本地的错误界面
  */
 + (BOOL)routeURL:(NSString *)url parameters:(NSDictionary *)parameters{
+    JLR_TRACE_BEGIN("YLRouterService.openURL", url.UTF8String, kYLRouterMainScheme.UTF8String);
+    BOOL didRoute = NO;
     if ([url hasPrefix:kYLRouterMainScheme]) {
-        return [YLRouter() routeURL:[NSURL URLWithString:routePatternFromUrl(url)] withParameters:parameters];
+        didRoute = [YLRouter() routeURL:[NSURL URLWithString:routePatternFromUrl(url)] withParameters:parameters];
     }else if ([url hasPrefix:@"http:"] || [url hasPrefix:@"https:"]){
-        return [YLRouter() routeURL:[NSURL URLWithString:routePatternFromUrl(kYLRouteURLWebview)] withParameters:@{@"url":url}];
+        didRoute = [YLRouter() routeURL:[NSURL URLWithString:routePatternFromUrl(kYLRouteURLWebview)] withParameters:@{@"url":url}];
     }
-    return NO;
+    JLR_TRACE_END("YLRouterService.openURL");
+    return didRoute;
 }
 
 @end
@@ -96,35 +144,43 @@ static inline JLRoutes *YLRouter(void){
 
 @implementation YLRouterService (Handler)
 
-+ (void)load {
++ (void)registerRouter {
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        /// 注册 Router
-        [self performSelectorOnMainThread:@selector(registerRouter) withObject:nil waitUntilDone:false];
+        [self configureRoutes];
     });
 }
 
-+ (void)registerRouter {
++ (void)configureRoutes {
 //    [JLRoutes setAlwaysTreatsHostAsPathComponent:YES];
-    //获取全局 RouterMapInfo
-    NSDictionary *routerMapInfo = [YLRouterConfig configMapInfo];
-    // router 对应控制器路径, 使用其来注册 Route, 当调用当前 Route 时会执行回调; 回调参数 parameters: 在执行 Route 时传入的参数;
-    for (NSString* router in routerMapInfo.allKeys) {
-        NSDictionary* routerMap = routerMapInfo[router];
+    // JLR_ROUTE_DECLARE 声明的路由: target 为控制器类名, metadata 为配置参数; 回调参数 parameters: 在执行 Route 时传入的参数;
+    [JLRoutes setDeclaredRouteHandlerProvider:^BOOL (^(const jlr_route_declaration *declaration))(NSDictionary<NSString *, id> *) {
+        // 其他 scheme 的声明由各自的模块处理
+        if (declaration->scheme == NULL || strcmp(declaration->scheme, kYLRouterMainScheme.UTF8String) != 0) {
+            return nil;
+        }
+        NSDictionary* routerMap = [YLRouterConfig routerMapWithDeclaration:declaration];
         NSString* className = routerMap[kYLRouterViewController];
-        if (className && [className isKindOfClass:NSString.class] && className.length) {
-            
-            /// 注册所有控制器 Router
-            [YLRouter() addRoute:routePatternFromUrl(router) handler:^BOOL(NSDictionary * _Nonnull parameters) {
-                /// 执行路由匹配成功之后，跳转逻辑回调;
-                /** 执行 Route 回调; 处理控制器跳转 + 传参;
-                 * routerMap: 当前 route 映射的  routeMap; 我们在 RouterConfig 配置的 Map;
-                 * parameters: 调用 route 时, 传入的参数;
-                 */
-                return [self executeRouterClassName:className routerMap:routerMap parameters:parameters];
-            }];
+        if (className.length == 0) {
+            return nil;
         }
-    }
+        // 注册时解析一次元数据与控制器类, 跳转时不再查配置字典;
+        YLRouterMetadata metadata = YLRouterMetadataMake(routerMap);
+        Class controllerClass = NSClassFromString(className);
+#if DEBUG
+        NSAssert([controllerClass isSubclassOfClass:UIViewController.class], @"%s: %@ is not kind of UIViewController class, routerMap: %@",__func__ ,className, routerMap);
+#endif
+        NSString *router = [NSString stringWithFormat:@"%s://%s", declaration->scheme, declaration->pattern];
+        return ^BOOL(NSDictionary * _Nonnull parameters) {
+            /// 执行路由匹配成功之后，跳转逻辑回调;
+            /** 执行 Route 回调; 处理控制器跳转 + 传参;
+             * metadata: 当前 route 的元数据; 由声明中的 metadata 解析;
+             * parameters: 调用 route 时, 传入的参数;
+             */
+            YLRouterMetadata routeMetadata = YLRouterMetadataApplyParameters(metadata, parameters);
+            return [self executeRouter:router controllerClass:controllerClass metadata:&routeMetadata parameters:parameters];
+        };
+    }];
     
     [YLRouter() addRoute:@"mainTabBar/:name" handler:^BOOL(NSDictionary * _Nonnull parameters) {
         return [MainTabBarController setSelectedVC:parameters[@"name"] parameters:parameters];
@@ -137,35 +193,37 @@ static inline JLRoutes *YLRouter(void){
 
 #pragma mark - execute Router VC
 // 当查找到指定 Router 时, 触发路由回调逻辑; 找不到已注册 Router 则直接返回 NO; 如需要的话, 也可以在这里注册一个全局未匹配到 Router 执行的回调进行异常处理;
-+ (BOOL)executeRouterClassName:(NSString *)className routerMap:(NSDictionary* )routerMap parameters:(NSDictionary* )parameters {
-    // 拦截 Router 映射参数,是否需要登录才可跳转;
-//    BOOL needLogin = [routerMap[kJSDVCRouteClassNeedLogin] boolValue];
-//    if (needLogin && !userIsLogin) {
-//        [JSDVCRouter openURL:JSDVCRouteLogin];
-//        return NO;
-//    }
++ (BOOL)executeRouter:(NSString *)router controllerClass:(Class)controllerClass metadata:(const YLRouterMetadata *)metadata parameters:(NSDictionary* )parameters {
+    // 拦截 Router: 权限等级不足(如需要登录)或拦截器不通过时不跳转;
+    JLR_TRACE_BEGIN("YLRouterService.shouldRoute", router.UTF8String, kYLRouterMainScheme.UTF8String);
+    BOOL shouldRoute = [self shouldRoute:router metadata:metadata parameters:parameters];
+    JLR_TRACE_END("YLRouterService.shouldRoute");
+    if (!shouldRoute) {
+        return NO;
+    }
     //统一初始化控制器,传参和跳转;
-    UIViewController* vc = [self viewControllerWithClassName:className routerMap:routerMap parameters:parameters];
+    JLR_TRACE_BEGIN("YLRouterService.viewController", router.UTF8String, kYLRouterMainScheme.UTF8String);
+    UIViewController* vc = [self viewControllerWithClass:controllerClass parameters:parameters];
+    JLR_TRACE_END("YLRouterService.viewController");
     if (vc) {
-        [self gotoViewController:vc parameters:parameters];
+        JLR_TRACE_BEGIN("YLRouterService.gotoViewController", router.UTF8String, kYLRouterMainScheme.UTF8String);
+        [self gotoViewController:vc metadata:metadata parameters:parameters];
+        JLR_TRACE_END("YLRouterService.gotoViewController");
         return YES;
     } else {
         return NO;
     }
 }
-// 根据 Router 映射到的类名实例化控制器;
-+ (UIViewController *)viewControllerWithClassName:(NSString *)className routerMap:(NSDictionary *)routerMap parameters:(NSDictionary* )parameters {
-    
-    id vc = [[NSClassFromString(className) alloc] init];
-    if (![vc isKindOfClass:[UIViewController class]]) {
-        vc = nil;
+// 根据 Router 映射到的类实例化控制器;
++ (UIViewController *)viewControllerWithClass:(Class)controllerClass parameters:(NSDictionary* )parameters {
+    if (![controllerClass isSubclassOfClass:UIViewController.class]) {
+        return nil;
     }
-#if DEBUG
-    //vc不是UIViewController
-    NSAssert(vc, @"%s: %@ is not kind of UIViewController class, routerMap: %@",__func__ ,className, routerMap);
-#endif
+    UIViewController *vc = [[controllerClass alloc] init];
     //参数赋值
+    JLR_TRACE_BEGIN("YLRouterService.setupParameters", NSStringFromClass(controllerClass).UTF8String, kYLRouterMainScheme.UTF8String);
     [self setupParameters:parameters forViewController:vc];
+    JLR_TRACE_END("YLRouterService.setupParameters");
     
     return vc;
 }
@@ -190,22 +248,20 @@ static inline JLRoutes *YLRouter(void){
     };
 }
 // 跳转和参数设置;
-+ (void)gotoViewController:(UIViewController *)vc parameters:(NSDictionary *)parameters {
++ (void)gotoViewController:(UIViewController *)vc metadata:(const YLRouterMetadata *)metadata parameters:(NSDictionary *)parameters {
     if (parameters[kYLRouterSegueTabNameKey]) {
         [MainTabBarController setSelectedVC:parameters[kYLRouterSegueTabNameKey] parameters:@{}];
     }
     
     UIViewController* currentVC = [UIViewController yl_GetCurrentViewController];
     
-    /// 决定 present 或者 Push; 默认值 Push
-    NSString *segue = parameters[kYLRouterSegueKey] ? parameters[kYLRouterSegueKey] : kYLRouterSeguePush;
     /// 转场动画
-    BOOL animated = parameters[kYLRouterSegueAnimatedKey] ? [parameters[kYLRouterSegueAnimatedKey] boolValue] : YES;
+    BOOL animated = (metadata->options & YLRouterSegueAnimated) != 0;
     
-    BOOL hidesBottomBarWhenPushed = parameters[kYLRouterSegueHidesBottomBarKey] ? [parameters[kYLRouterSegueHidesBottomBarKey] boolValue] : YES;
+    BOOL hidesBottomBarWhenPushed = (metadata->options & YLRouterSegueHidesBottomBar) != 0;
     
 
-    if ([segue isEqualToString:kYLRouterSeguePush]) { //PUSH
+    if (metadata->segue == YLRouterSeguePush) { //PUSH
         if (currentVC.navigationController) {
             vc.hidesBottomBarWhenPushed = hidesBottomBarWhenPushed;
 
@@ -227,7 +283,7 @@ static inline JLRoutes *YLRouter(void){
             }
         }
         else { //由于无导航栏, 直接执行 Modal
-            BOOL needNavigation = parameters[kYLRouterSegueModalIsNeedNavigationKey] ? NO : YES;
+            BOOL needNavigation = (metadata->options & YLRouterSegueModalNavigationSpecified) == 0;
             if (needNavigation) {
                 UINavigationController* navigationVC = [[UINavigationController alloc] initWithRootViewController:vc];
                 //vc.modalPresentationStyle = UIModalPresentationFullScreen;
@@ -240,7 +296,7 @@ static inline JLRoutes *YLRouter(void){
         }
     }
     else { //Modal
-        BOOL needNavigation = parameters[kYLRouterSegueModalIsNeedNavigationKey] ? parameters[kYLRouterSegueModalIsNeedNavigationKey] : NO;
+        BOOL needNavigation = (metadata->options & YLRouterSegueModalNavigation) != 0;
         if (needNavigation) {
             UINavigationController* navigationVC = [[UINavigationController alloc] initWithRootViewController:vc];
             //vc.modalPresentationStyle = UIModalPresentationFullScreen;